@@ -0,0 +1,248 @@
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <array>
+#include <charconv>
+#include <EngineCore/Application.hpp>
+#include <EngineCore/SoftwareRendererCheck.hpp>
+
+// Usage: EngineBench [--single-threaded] [--workers N] [--trace trace.json] [--mesh model.mesh] [--upload-budget KiB] [--camera x y z tx ty tz fov] [--textured] [--no-dsa] [--software] [--check-software] [frames] [width] [height] [objects] [output.json]
+// Results are written as JSON to output.json, or to stdout when no path is given.
+// --single-threaded executes render commands on the main thread instead of the render thread.
+// --workers sets the number of job system worker threads (default: one per extra hardware thread).
+// --trace writes the profiler zones of the last frames as a Chrome trace (chrome://tracing).
+// --mesh draws a baked mesh (see MeshBaker) for every object instead of the built-in quad.
+// --upload-budget limits how much of the streamed mesh is uploaded per frame (default 8 MiB).
+// --camera views the objects' grid, which spans -1 to 1 in x and y at z 0, from (x, y, z) towards (tx, ty, tz) with a
+//   vertical field of view of fov degrees; without it the grid is drawn straight in clip space, so nothing is culled.
+// --textured samples a texture atlas in every object's shader.
+// --no-dsa uses the bind-to-edit path for buffers and vertex arrays even when GL 4.5 direct state access is available.
+// --software rasterizes on the CPU instead of with OpenGL; --textured is ignored.
+// --check-software runs check_software_renderer instead of the benchmark, writes its results as JSON and exits with 1 if it failed.
+
+class BenchApp : public GraphicsEngine::Application {
+};
+
+int print_usage()
+{
+    std::cerr << "Usage: EngineBench [--single-threaded] [--workers N] [--trace trace.json] [--mesh model.mesh] [--upload-budget KiB] "
+                 "[--camera x y z tx ty tz fov] [--textured] [--no-dsa] [--software] [--check-software] [frames] [width] [height] [objects] [output.json]" << std::endl;
+    return 1;
+}
+
+// The whole text must be a number that fits in value
+template <typename T>
+bool parse_number(const std::string& text, T& value)
+{
+    const char* end = text.data() + text.size();
+    const std::from_chars_result result = std::from_chars(text.data(), end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+double percentile(const std::vector<double>& sorted_values, const double fraction)
+{
+    if (sorted_values.empty())
+    {
+        return 0.0;
+    }
+    const size_t index = static_cast<size_t>(fraction * static_cast<double>(sorted_values.size() - 1) + 0.5);
+    return sorted_values[std::min(index, sorted_values.size() - 1)];
+}
+
+void write_report(std::ostream& out, const std::vector<GraphicsEngine::FrameStats>& frames_stats, const unsigned int width, const unsigned int height, const unsigned int objects)
+{
+    std::vector<double> frame_times;
+    frame_times.reserve(frames_stats.size());
+
+    double total_frame_time = 0.0;
+    size_t total_draw_calls = 0;
+    size_t total_triangles = 0;
+    size_t total_upload_bytes = 0;
+    size_t total_fence_waits = 0;
+    size_t total_state_changes_issued = 0;
+    size_t total_state_changes_skipped = 0;
+    size_t total_objects_visible = 0;
+    size_t total_objects_culled = 0;
+    size_t total_frame_arena_bytes = 0;
+    size_t max_frame_arena_bytes = 0;
+    for (const GraphicsEngine::FrameStats& frame_stats : frames_stats)
+    {
+        frame_times.push_back(frame_stats.cpu_frame_time_ms);
+        total_frame_time += frame_stats.cpu_frame_time_ms;
+        total_draw_calls += frame_stats.draw_calls;
+        total_triangles += frame_stats.triangles;
+        total_upload_bytes += frame_stats.upload_bytes;
+        total_fence_waits += frame_stats.fence_waits;
+        total_state_changes_issued += frame_stats.state_changes_issued;
+        total_state_changes_skipped += frame_stats.state_changes_skipped;
+        total_objects_visible += frame_stats.objects_visible;
+        total_objects_culled += frame_stats.objects_culled;
+        total_frame_arena_bytes += frame_stats.frame_arena_bytes;
+        max_frame_arena_bytes = std::max(max_frame_arena_bytes, frame_stats.frame_arena_bytes);
+    }
+    std::sort(frame_times.begin(), frame_times.end());
+
+    const double frames_count = frames_stats.empty() ? 1.0 : static_cast<double>(frames_stats.size());
+
+    out << "{\n"
+        << "  \"frames\": " << frames_stats.size() << ",\n"
+        << "  \"width\": " << width << ",\n"
+        << "  \"height\": " << height << ",\n"
+        << "  \"objects\": " << objects << ",\n"
+        << "  \"cpu_frame_time_ms\": {\n"
+        << "    \"mean\": " << total_frame_time / frames_count << ",\n"
+        << "    \"min\": " << (frame_times.empty() ? 0.0 : frame_times.front()) << ",\n"
+        << "    \"p50\": " << percentile(frame_times, 0.50) << ",\n"
+        << "    \"p95\": " << percentile(frame_times, 0.95) << ",\n"
+        << "    \"p99\": " << percentile(frame_times, 0.99) << ",\n"
+        << "    \"max\": " << (frame_times.empty() ? 0.0 : frame_times.back()) << "\n"
+        << "  },\n"
+        << "  \"draw_calls\": { \"total\": " << total_draw_calls << ", \"per_frame\": " << static_cast<double>(total_draw_calls) / frames_count << " },\n"
+        << "  \"triangles\": { \"total\": " << total_triangles << ", \"per_frame\": " << static_cast<double>(total_triangles) / frames_count << " },\n"
+        << "  \"upload_bytes\": { \"total\": " << total_upload_bytes << ", \"per_frame\": " << static_cast<double>(total_upload_bytes) / frames_count << " },\n"
+        << "  \"fence_waits\": { \"total\": " << total_fence_waits << ", \"per_frame\": " << static_cast<double>(total_fence_waits) / frames_count << " },\n"
+        << "  \"state_changes\": { \"issued\": " << total_state_changes_issued << ", \"skipped\": " << total_state_changes_skipped << " },\n"
+        << "  \"culling\": { \"visible_per_frame\": " << static_cast<double>(total_objects_visible) / frames_count
+        << ", \"culled_per_frame\": " << static_cast<double>(total_objects_culled) / frames_count << " },\n"
+        << "  \"frame_arena_bytes\": { \"per_frame\": " << static_cast<double>(total_frame_arena_bytes) / frames_count
+        << ", \"max\": " << max_frame_arena_bytes << " }\n"
+        << "}\n";
+}
+
+int check_software(std::ostream& out)
+{
+    GraphicsEngine::SoftwareRendererCheckStats stats;
+    const bool passed = GraphicsEngine::check_software_renderer(&stats);
+    out << "{\n"
+        << "  \"passed\": " << (passed ? "true" : "false") << ",\n"
+        << "  \"simd_available\": " << (stats.simd_available ? "true" : "false") << ",\n"
+        << "  \"coverage_errors\": " << stats.coverage_errors << ",\n"
+        << "  \"reference_hash\": \"" << std::hex << stats.reference_hash << std::dec << "\",\n"
+        << "  \"configurations\": " << stats.configurations << ",\n"
+        << "  \"mismatches\": " << stats.mismatches << "\n"
+        << "}\n";
+    return passed ? 0 : 1;
+}
+
+int main(int argc, char** argv){
+    bool multithreaded = true;
+    int workers = -1;
+    std::string trace_path;
+    std::string mesh_path;
+    size_t upload_budget = 0;
+    bool textured = false;
+    bool direct_state_access = true;
+    bool software = false;
+    bool has_camera = false;
+    std::array<float, 3> camera_eye = {};
+    std::array<float, 3> camera_target = {};
+    float camera_fov_y = 0.0f;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::string(argv[i]) == "--single-threaded")
+        {
+            multithreaded = false;
+        }
+        else if (std::string(argv[i]) == "--workers" && i + 1 < argc)
+        {
+            if (!parse_number(argv[++i], workers))
+            {
+                return print_usage();
+            }
+        }
+        else if (std::string(argv[i]) == "--trace" && i + 1 < argc)
+        {
+            trace_path = argv[++i];
+        }
+        else if (std::string(argv[i]) == "--mesh" && i + 1 < argc)
+        {
+            mesh_path = argv[++i];
+        }
+        else if (std::string(argv[i]) == "--upload-budget" && i + 1 < argc)
+        {
+            if (!parse_number(argv[++i], upload_budget))
+            {
+                return print_usage();
+            }
+            upload_budget *= 1024;
+        }
+        else if (std::string(argv[i]) == "--camera" && i + 7 < argc)
+        {
+            if (!parse_number(argv[i + 1], camera_eye[0]) || !parse_number(argv[i + 2], camera_eye[1]) || !parse_number(argv[i + 3], camera_eye[2]) ||
+                !parse_number(argv[i + 4], camera_target[0]) || !parse_number(argv[i + 5], camera_target[1]) ||
+                !parse_number(argv[i + 6], camera_target[2]) || !parse_number(argv[i + 7], camera_fov_y))
+            {
+                return print_usage();
+            }
+            has_camera = true;
+            i += 7;
+        }
+        else if (std::string(argv[i]) == "--textured")
+        {
+            textured = true;
+        }
+        else if (std::string(argv[i]) == "--no-dsa")
+        {
+            direct_state_access = false;
+        }
+        else if (std::string(argv[i]) == "--software")
+        {
+            software = true;
+        }
+        else if (std::string(argv[i]) == "--check-software")
+        {
+            return check_software(std::cout);
+        }
+        else
+        {
+            args.push_back(argv[i]);
+        }
+    }
+
+    unsigned int frames = 1000;
+    unsigned int width = 1024;
+    unsigned int height = 768;
+    unsigned int objects = 1;
+    if (args.size() > 5 || (args.size() > 0 && !parse_number(args[0], frames)) || (args.size() > 1 && !parse_number(args[1], width)) ||
+        (args.size() > 2 && !parse_number(args[2], height)) || (args.size() > 3 && !parse_number(args[3], objects)))
+    {
+        return print_usage();
+    }
+
+    auto benchApp = std::make_unique<BenchApp>();
+    benchApp->set_multithreaded_rendering(multithreaded);
+    benchApp->set_worker_threads_count(workers);
+    benchApp->set_trace_path(trace_path);
+    benchApp->set_mesh_path(mesh_path);
+    benchApp->set_asset_budgets(0, upload_budget);
+    benchApp->set_textured(textured);
+    benchApp->set_direct_state_access(direct_state_access);
+    benchApp->set_software_rendering(software);
+    if (has_camera)
+    {
+        benchApp->set_camera(camera_eye, camera_target, camera_fov_y);
+    }
+
+    int returnCode = benchApp->start_headless(width, height, frames, objects);
+    if (returnCode != 0)
+    {
+        std::cerr << "Failed to start headless application: " << returnCode << std::endl;
+        return returnCode;
+    }
+
+    if (args.size() > 4)
+    {
+        std::ofstream out(args[4]);
+        write_report(out, benchApp->get_frames_stats(), width, height, objects);
+    }
+    else
+    {
+        write_report(std::cout, benchApp->get_frames_stats(), width, height, objects);
+    }
+
+    return 0;
+}
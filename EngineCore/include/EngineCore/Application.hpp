@@ -1,8 +1,12 @@
 #pragma once
 
 #include "EngineCore/Event.hpp"
+#include "EngineCore/FrameStats.hpp"
 
+#include <array>
 #include <memory>
+#include <vector>
+#include <string>
 
 namespace GraphicsEngine {
     class Application
@@ -17,11 +21,90 @@ namespace GraphicsEngine {
         Application& operator=(Application&&) = delete;
 
         virtual int start(unsigned int window_width, unsigned int window_height, const char* title);
+        // Renders frames_count frames of objects_count objects into an offscreen framebuffer
+        // without creating a visible window
+        int start_headless(unsigned int width, unsigned int height, unsigned int frames_count, unsigned int objects_count = 1);
 
         virtual void on_update(){}
 
+        // Linked shader programs are cached in this directory; empty disables the cache
+        void set_shader_cache_directory(std::string directory) { m_shader_cache_directory = std::move(directory); }
+
+        // Rendering runs on a dedicated thread by default; disable before start() to execute
+        // the recorded commands on the main thread, which is easier to debug
+        void set_multithreaded_rendering(const bool multithreaded) { m_multithreaded_rendering = multithreaded; }
+
+        // Worker threads started next to the main thread; negative picks one per remaining hardware thread
+        void set_worker_threads_count(const int workers_count) { m_worker_threads_count = workers_count; }
+
+        // When set, the profiler's recent frames are written there as a Chrome trace when start() returns
+        void set_trace_path(std::string path) { m_trace_path = std::move(path); }
+
+        // Baked mesh (.mesh, see MeshBaker.hpp) drawn for every object instead of the built-in quad
+        void set_mesh_path(std::string path) { m_mesh_path = std::move(path); }
+
+        // Objects are drawn with textures from an atlas instead of vertex colors only
+        void set_textured(const bool textured) { m_textured = textured; }
+
+        // GL 4.5 direct state access is used when the context supports it; disable before start()
+        // to create and edit buffers and vertex arrays through the bind-to-edit fallback instead
+        void set_direct_state_access(const bool enabled) { m_direct_state_access = enabled; }
+
+        // start_headless() rasterizes on the CPU, over the job system's threads, instead of with
+        // OpenGL. Objects are drawn with vertex colors only
+        void set_software_rendering(const bool software) { m_software_rendering = software; }
+
+        // The scene is viewed from eye towards target, with +y up, through a perspective projection
+        // of fov_y_degrees that follows the window's aspect ratio. Without a camera the objects'
+        // grid fills the window, drawn straight in clip space
+        void set_camera(const std::array<float, 3>& eye, const std::array<float, 3>& target, const float fov_y_degrees)
+        {
+            m_camera = { eye, target, fov_y_degrees };
+            m_has_camera = true;
+        }
+
+        // Streamed assets are evicted beyond memory_bytes of GPU memory and uploaded at most
+        // upload_bytes_per_frame per frame; 0 keeps the defaults
+        void set_asset_budgets(const size_t memory_bytes, const size_t upload_bytes_per_frame)
+        {
+            m_asset_memory_budget = memory_bytes;
+            m_asset_upload_budget = upload_bytes_per_frame;
+        }
+
+        const std::vector<FrameStats>& get_frames_stats() const { return m_frames_stats; }
+
     private:
+        struct Camera
+        {
+            std::array<float, 3> eye;
+            std::array<float, 3> target;
+            float fov_y_degrees;
+        };
+
+        void init_event_listeners();
+        void apply_camera(const unsigned int width, const unsigned int height);
+        void start_job_system();
+        void dispatch_and_update();
+        void write_trace();
+        void load_assets();
+
+        std::unique_ptr<class JobSystem> m_job_system;
+        // Reset at the end of every main loop iteration
+        std::unique_ptr<class FrameArena> m_frame_arena;
         std::unique_ptr<class Window> m_window;
+        std::vector<FrameStats> m_frames_stats;
+        std::string m_shader_cache_directory;
+        std::string m_trace_path;
+        std::string m_mesh_path;
+        size_t m_asset_memory_budget = 0;
+        size_t m_asset_upload_budget = 0;
+        bool m_textured = false;
+        bool m_direct_state_access = true;
+        bool m_software_rendering = false;
+        bool m_multithreaded_rendering = true;
+        Camera m_camera = {};
+        bool m_has_camera = false;
+        int m_worker_threads_count = -1;
 
         EventDispatcher m_event_dispatcher;
         bool m_bCloseWindow = false;
@@ -1,22 +1,71 @@
 #pragma once
 
-#include <spdlog/spdlog.h>
+#include "EngineCore/Log.hpp"
 
-namespace GraphicsEngine{
-// перенести в cpp
-#ifdef NDEBUG
+// Levels below ENGINE_LOG_ACTIVE_LEVEL are compiled out; the rest are filtered at runtime per
+// module with Log::set_level. Values match ELogLevel.
+#define ENGINE_LOG_LEVEL_TRACE 0
+#define ENGINE_LOG_LEVEL_DEBUG 1
+#define ENGINE_LOG_LEVEL_INFO 2
+#define ENGINE_LOG_LEVEL_WARN 3
+#define ENGINE_LOG_LEVEL_ERROR 4
+#define ENGINE_LOG_LEVEL_CRITICAL 5
+#define ENGINE_LOG_LEVEL_OFF 6
 
-#define LOG_INFO(...)
-#define LOG_WARN(...)
-#define LOG_ERROR(...)
-#define LOG_CRITICAL(...)
+#ifndef ENGINE_LOG_ACTIVE_LEVEL
+#define ENGINE_LOG_ACTIVE_LEVEL ENGINE_LOG_LEVEL_INFO
+#endif
+
+// Define before including this header to log a translation unit under another ELogModule
+#ifndef ENGINE_LOG_MODULE
+#define ENGINE_LOG_MODULE Core
+#endif
 
+#define ENGINE_LOG(level, ...) \
+    do { \
+        if (GraphicsEngine::Log::should_log(GraphicsEngine::ELogModule::ENGINE_LOG_MODULE, level)) \
+        { \
+            GraphicsEngine::Log::write(GraphicsEngine::ELogModule::ENGINE_LOG_MODULE, level, __VA_ARGS__); \
+        } \
+    } while (false)
+
+#if ENGINE_LOG_ACTIVE_LEVEL <= ENGINE_LOG_LEVEL_TRACE
+#define LOG_TRACE(...) ENGINE_LOG(GraphicsEngine::ELogLevel::Trace, __VA_ARGS__)
 #else
+#define LOG_TRACE(...) (void)0
+#endif
 
-#define LOG_INFO(...) spdlog::info(__VA_ARGS__)
-#define LOG_WARN(...) spdlog::warn(__VA_ARGS__)
-#define LOG_ERROR(...) spdlog::error(__VA_ARGS__)
-#define LOG_CRITICAL(...) spdlog::critical(__VA_ARGS__)
+#if ENGINE_LOG_ACTIVE_LEVEL <= ENGINE_LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) ENGINE_LOG(GraphicsEngine::ELogLevel::Debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) (void)0
+#endif
 
+#if ENGINE_LOG_ACTIVE_LEVEL <= ENGINE_LOG_LEVEL_INFO
+#define LOG_INFO(...) ENGINE_LOG(GraphicsEngine::ELogLevel::Info, __VA_ARGS__)
+#else
+#define LOG_INFO(...) (void)0
+#endif
+
+#if ENGINE_LOG_ACTIVE_LEVEL <= ENGINE_LOG_LEVEL_WARN
+#define LOG_WARN(...) ENGINE_LOG(GraphicsEngine::ELogLevel::Warn, __VA_ARGS__)
+#else
+#define LOG_WARN(...) (void)0
+#endif
+
+#if ENGINE_LOG_ACTIVE_LEVEL <= ENGINE_LOG_LEVEL_ERROR
+#define LOG_ERROR(...) ENGINE_LOG(GraphicsEngine::ELogLevel::Error, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) (void)0
+#endif
+
+// Critical messages usually precede a failure, so they are written out before returning
+#if ENGINE_LOG_ACTIVE_LEVEL <= ENGINE_LOG_LEVEL_CRITICAL
+#define LOG_CRITICAL(...) \
+    do { \
+        ENGINE_LOG(GraphicsEngine::ELogLevel::Critical, __VA_ARGS__); \
+        GraphicsEngine::Log::flush(); \
+    } while (false)
+#else
+#define LOG_CRITICAL(...) (void)0
 #endif
-}
\ No newline at end of file
@@ -1,7 +1,9 @@
 #pragma once
 
-#include <functional>
 #include <array>
+#include <vector>
+#include <variant>
+#include <cstddef>
 
 namespace GraphicsEngine
 {
@@ -22,62 +24,176 @@ namespace GraphicsEngine
 
     struct Event
     {
-        virtual ~Event() = default;
-        virtual EventType get_type() const = 0;
-    };
-
-    class EventDispatcher
-    {
-    public:
-        template <typename EventType>
-        void add_event_listener(std::function<void(EventType &)> callback)
-        {
-            auto baseCallback = [func = std::move(callback)](Event &event)
-            {
-                if (event.get_type() == EventType::type)
-                {
-                    func(static_cast<EventType &>(event));
-                }
-            };
-            m_eventsCallbacks[static_cast<size_t>(EventType::type)] = std::move(baseCallback);
-        }
-
-        void dispatch(Event &event){
-            auto& callback = m_eventsCallbacks[static_cast<size_t>(event.get_type())];
-            if(callback)
-                callback(event);
-        }
-    private:
-        std::array<std::function<void(Event &)>, static_cast<size_t>(EventType::EventsCount)> m_eventsCallbacks;
     };
 
     struct EventMouseMoved : public Event
     {
         EventMouseMoved(const double x, const double y) : x(x), y(y) {}
 
-        virtual EventType get_type() const override { return type; }
-
         double x;
         double y;
 
-        static const EventType type = EventType::MouseMoved;
+        static constexpr EventType type = EventType::MouseMoved;
+        // Only the latest position of a run of moves is delivered
+        static constexpr bool coalesced = true;
     };
 
     struct EventWindowResized : public Event
     {
         EventWindowResized(const unsigned int width, const unsigned int height) : width(width), height(height) {}
 
-        virtual EventType get_type() const override { return type; }
-
         unsigned int width;
         unsigned int height;
 
-        static const EventType type = EventType::WindowResize;
+        static constexpr EventType type = EventType::WindowResize;
+        static constexpr bool coalesced = true;
     };
 
     struct EventWindowClose : Event {
-        virtual EventType get_type() const override { return type; }
+        static constexpr EventType type = EventType::WindowClose;
+        static constexpr bool coalesced = false;
+    };
+
+    // Any event that can be queued; the variant index replaces a virtual type query
+    using QueuedEvent = std::variant<EventMouseMoved, EventWindowResized, EventWindowClose>;
+
+    // Several listeners per event type. A listener is a plain function pointer plus a user
+    // pointer, so registering and dispatching never allocate a closure.
+    // Events posted during a frame are queued and delivered together by dispatch_queued();
+    // consecutive coalesced events of the same type collapse into the latest one.
+    // Listeners may add and remove listeners: added ones get the next event, removed ones
+    // none after the removal.
+    class EventDispatcher
+    {
+    public:
+        using ListenerId = size_t;
+
+        template <typename EventT>
+        using Callback = void (*)(EventT&, void*);
+
+        template <typename EventT>
+        ListenerId add_event_listener(Callback<EventT> callback, void* user_data = nullptr)
+        {
+            const ListenerId id = ++m_last_listener_id;
+            m_listeners[static_cast<size_t>(EventT::type)].push_back({ reinterpret_cast<ErasedCallback>(callback), user_data, id });
+            return id;
+        }
+
+        // Calls (instance->*Method)(event)
+        template <typename EventT, auto Method, typename Class>
+        ListenerId add_event_listener(Class* instance)
+        {
+            return add_event_listener<EventT>([](EventT& event, void* user_data) {
+                (static_cast<Class*>(user_data)->*Method)(event);
+            }, instance);
+        }
+
+        void remove_event_listener(const ListenerId id)
+        {
+            for (std::vector<Listener>& listeners : m_listeners)
+            {
+                for (auto it = listeners.begin(); it != listeners.end(); ++it)
+                {
+                    if (it->id == id)
+                    {
+                        // A dispatch in progress may be iterating the list: erased once it is done
+                        if (m_dispatch_depth > 0)
+                        {
+                            it->callback = nullptr;
+                            m_has_removed_listeners = true;
+                        }
+                        else
+                        {
+                            listeners.erase(it);
+                        }
+                        return;
+                    }
+                }
+            }
+        }
+
+        // Delivers the event right away
+        template <typename EventT>
+        void dispatch(EventT& event)
+        {
+            // By index over the listeners present now, as callbacks may add listeners and reallocate the list
+            std::vector<Listener>& listeners = m_listeners[static_cast<size_t>(EventT::type)];
+            const size_t listeners_count = listeners.size();
+            ++m_dispatch_depth;
+            for (size_t i = 0; i < listeners_count; ++i)
+            {
+                const Listener listener = listeners[i];
+                if (listener.callback)
+                {
+                    reinterpret_cast<Callback<EventT>>(listener.callback)(event, listener.user_data);
+                }
+            }
+            if (--m_dispatch_depth == 0 && m_has_removed_listeners)
+            {
+                erase_removed_listeners();
+            }
+        }
+
+        template <typename EventT>
+        void post(const EventT& event)
+        {
+            if constexpr (EventT::coalesced)
+            {
+                if (!m_queue.empty() && std::holds_alternative<EventT>(m_queue.back()))
+                {
+                    std::get<EventT>(m_queue.back()) = event;
+                    return;
+                }
+            }
+            m_queue.emplace_back(event);
+        }
+
+        // Listeners may post new events; those are delivered on the next call. A call from a
+        // listener while the queue is being delivered does nothing, as the outer call owns it.
+        void dispatch_queued()
+        {
+            if (m_dispatching_queued)
+            {
+                return;
+            }
+            m_dispatching_queued = true;
+            m_dispatching_queue.swap(m_queue);
+            for (QueuedEvent& event : m_dispatching_queue)
+            {
+                std::visit([this](auto& typed_event) { dispatch(typed_event); }, event);
+            }
+            m_dispatching_queue.clear();
+            m_dispatching_queued = false;
+        }
+
+        size_t get_queued_count() const { return m_queue.size(); }
 
-        static const EventType type = EventType::WindowClose;
+    private:
+        using ErasedCallback = void (*)();
+
+        void erase_removed_listeners()
+        {
+            for (std::vector<Listener>& listeners : m_listeners)
+            {
+                std::erase_if(listeners, [](const Listener& listener) { return listener.callback == nullptr; });
+            }
+            m_has_removed_listeners = false;
+        }
+
+        struct Listener
+        {
+            ErasedCallback callback;
+            void* user_data;
+            ListenerId id;
+        };
+
+        std::array<std::vector<Listener>, static_cast<size_t>(EventType::EventsCount)> m_listeners;
+        std::vector<QueuedEvent> m_queue;
+        std::vector<QueuedEvent> m_dispatching_queue;
+        ListenerId m_last_listener_id = 0;
+        // Dispatches in progress, nested when a listener dispatches
+        size_t m_dispatch_depth = 0;
+        bool m_has_removed_listeners = false;
+        bool m_dispatching_queued = false;
     };
-}
\ No newline at end of file
+}
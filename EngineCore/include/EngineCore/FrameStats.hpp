@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+namespace GraphicsEngine {
+    struct FrameStats
+    {
+        double cpu_frame_time_ms = 0.0;
+        size_t draw_calls = 0;
+        size_t triangles = 0;
+        size_t upload_bytes = 0;
+        size_t fence_waits = 0;
+        size_t state_changes_issued = 0;
+        size_t state_changes_skipped = 0;
+        size_t objects_visible = 0;
+        size_t objects_culled = 0;
+        size_t frame_arena_bytes = 0;
+    };
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <spdlog/fmt/fmt.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <tuple>
+#include <type_traits>
+
+namespace GraphicsEngine {
+    // Same order and values as spdlog::level::level_enum
+    enum class ELogLevel : uint8_t
+    {
+        Trace,
+        Debug,
+        Info,
+        Warn,
+        Error,
+        Critical,
+        Off
+    };
+
+    enum class ELogModule : uint8_t
+    {
+        Core,
+        Rendering,
+        ECS,
+        Jobs,
+        Memory,
+        Profiling,
+        Assets,
+        Count
+    };
+
+    // One slot of the log queue. The producer either copies the arguments and a formatting
+    // function (trivially copyable arguments only, formatted on the logger thread), or
+    // formats the message itself when an argument may not outlive the call.
+    struct alignas(64) LogRecord
+    {
+        using FormatFunction = void(*)(const LogRecord& record, fmt::memory_buffer& out);
+
+        static constexpr size_t payload_size = 176;
+
+        std::atomic<size_t> sequence;
+        // Converted to wall time by the logger thread
+        int64_t timestamp;
+        size_t thread_id;
+        FormatFunction format;
+        fmt::string_view format_string;
+        // Messages formatted on the producer that do not fit into the payload
+        char* long_text;
+        uint32_t text_size;
+        ELogLevel level;
+        ELogModule module;
+        alignas(16) unsigned char payload[payload_size];
+    };
+
+    // Asynchronous logging. Producers copy the message into a bounded lock-free queue and
+    // return; a logger thread formats it and writes it to the spdlog sinks. When the queue
+    // is full the message is dropped and counted. Before init() and after shutdown()
+    // messages are written synchronously.
+    class Log
+    {
+    public:
+        static constexpr size_t queue_capacity = 4096;
+
+        // Starts the logger thread; calls are reference counted
+        static void init();
+        // Writes the queued messages and stops the logger thread
+        static void shutdown();
+        // Blocks until every message queued before the call has been written
+        static void flush();
+
+        static void set_level(ELogModule module, ELogLevel level)
+        {
+            s_levels[static_cast<size_t>(module)].store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+        }
+        static void set_level(ELogLevel level);
+        static ELogLevel get_level(ELogModule module)
+        {
+            return static_cast<ELogLevel>(s_levels[static_cast<size_t>(module)].load(std::memory_order_relaxed));
+        }
+        static bool should_log(const ELogModule module, const ELogLevel level)
+        {
+            return static_cast<uint8_t>(level) >= s_levels[static_cast<size_t>(module)].load(std::memory_order_relaxed);
+        }
+
+        static const char* get_module_name(ELogModule module);
+        static size_t get_dropped_count();
+
+        template<typename... Args>
+        static void write(const ELogModule module, const ELogLevel level, fmt::format_string<Args...> format_string, Args&&... args)
+        {
+            if constexpr ((is_deferrable<std::remove_cvref_t<Args>>() && ...) &&
+                          sizeof(std::tuple<std::remove_cvref_t<Args>...>) <= LogRecord::payload_size)
+            {
+                if (!is_async())
+                {
+                    write_sync(module, level, fmt::vformat(format_string, fmt::make_format_args(args...)));
+                    return;
+                }
+                LogRecord* record = begin_record(module, level);
+                if (record)
+                {
+                    using ArgsTuple = std::tuple<std::remove_cvref_t<Args>...>;
+                    new (record->payload) ArgsTuple(args...);
+                    record->format = &format_deferred<std::remove_cvref_t<Args>...>;
+                    record->format_string = format_string.get();
+                    commit_record(record);
+                }
+            }
+            else
+            {
+                fmt::basic_memory_buffer<char, LogRecord::payload_size> buffer;
+                fmt::vformat_to(fmt::appender(buffer), format_string.get(), fmt::make_format_args(args...));
+                write_text(module, level, fmt::string_view(buffer.data(), buffer.size()));
+            }
+        }
+
+    private:
+        // Strings and pointers to chars may dangle by the time the logger thread runs
+        template<typename T>
+        static constexpr bool is_deferrable()
+        {
+            if constexpr (std::is_pointer_v<T>)
+            {
+                using Pointee = std::remove_cv_t<std::remove_pointer_t<T>>;
+                return !std::is_same_v<Pointee, char> && !std::is_same_v<Pointee, signed char> &&
+                       !std::is_same_v<Pointee, unsigned char> && !std::is_same_v<Pointee, wchar_t>;
+            }
+            else
+            {
+                return std::is_arithmetic_v<T> && alignof(T) <= 16;
+            }
+        }
+
+        template<typename... Args>
+        static void format_deferred(const LogRecord& record, fmt::memory_buffer& out)
+        {
+            const auto& args = *std::launder(reinterpret_cast<const std::tuple<Args...>*>(record.payload));
+            std::apply([&](const Args&... values) {
+                fmt::vformat_to(fmt::appender(out), record.format_string, fmt::make_format_args(values...));
+            }, args);
+        }
+
+        static bool is_async() { return s_async.load(std::memory_order_relaxed); }
+        // Returns nullptr when the queue is full
+        static LogRecord* begin_record(ELogModule module, ELogLevel level);
+        static void commit_record(LogRecord* record);
+        static void write_text(ELogModule module, ELogLevel level, fmt::string_view text);
+        static void write_sync(ELogModule module, ELogLevel level, fmt::string_view text);
+
+        inline static std::atomic<bool> s_async = false;
+        inline static std::atomic<uint8_t> s_levels[static_cast<size_t>(ELogModule::Count)] = {
+            static_cast<uint8_t>(ELogLevel::Info), static_cast<uint8_t>(ELogLevel::Info),
+            static_cast<uint8_t>(ELogLevel::Info), static_cast<uint8_t>(ELogLevel::Info),
+            static_cast<uint8_t>(ELogLevel::Info), static_cast<uint8_t>(ELogLevel::Info),
+            static_cast<uint8_t>(ELogLevel::Info)
+        };
+    };
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace GraphicsEngine {
+    enum class EBakedVertexFormat
+    {
+        // Float3 position, Float4 color, Float2 texture coordinate: 36 bytes, the layout the engine draws scene meshes with
+        Full,
+        // Float3 position, UByte4Norm color, Half2 texture coordinate: 20 bytes, for applications that load meshes with
+        // MeshAsset::get_layout(); the shader inputs stay vec3, vec4 and vec2
+        Compact
+    };
+
+    struct MeshBakeSettings
+    {
+        EBakedVertexFormat vertex_format = EBakedVertexFormat::Full;
+        // Levels of detail stored, the full mesh included; generation stops early once
+        // simplification can't reach the next level within max_lod_error
+        size_t lods_count = 4;
+        // Triangles of each LOD relative to the previous one
+        float lod_reduction = 0.5f;
+        // Largest deviation from the full mesh a LOD may have, relative to the bounds' radius
+        float max_lod_error = 0.05f;
+    };
+
+    struct MeshBakeLodStats
+    {
+        size_t triangles = 0;
+        // Relative to the bounds' radius, as stored in MeshLod
+        float error = 0.0f;
+    };
+
+    struct MeshBakeStats
+    {
+        size_t source_faces = 0;
+        size_t vertices = 0;
+        size_t vertex_stride = 0;
+        size_t indices = 0;
+        // Bytes per stored index
+        size_t index_size = 0;
+        // Vertex shader invocations per triangle (see compute_acmr) in OBJ order and after optimization
+        float acmr_before = 0.0f;
+        float acmr_after = 0.0f;
+        std::vector<MeshBakeLodStats> lods;
+    };
+
+    // Converts a Wavefront OBJ file into a baked .mesh with a position, color and texture
+    // coordinate per vertex, stored as settings.vertex_format describes. Polygons are triangulated,
+    // vertices shared between faces are merged and a chain of LODs is simplified from the result
+    // (see simplify_mesh). Each LOD's triangles are reordered for the post-transform vertex cache
+    // and vertices are stored in the order the LODs first use them, coarsest LOD first, so each
+    // LOD's vertices are a prefix of the vertex stream. Indices are stored in the narrowest type
+    // that addresses every vertex.
+    // Vertex colors are read from the "v x y z r g b" extension and default to white.
+    bool bake_obj_mesh(const std::string& source_path, const std::string& output_path, MeshBakeStats* stats = nullptr,
+                       const MeshBakeSettings& settings = MeshBakeSettings());
+}
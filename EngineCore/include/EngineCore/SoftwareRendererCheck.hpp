@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace GraphicsEngine {
+    struct SoftwareRendererCheckStats
+    {
+        // Without AVX2 the SIMD configurations render with the scalar path too
+        bool simd_available = false;
+        // Pixels of a triangulated grid, drawn one triangle at a time, that were covered zero or several times
+        size_t coverage_errors = 0;
+        // FNV-1a hash of the reference image's color and depth: the scalar path without a job system
+        uint64_t reference_hash = 0;
+        // Images rendered with SIMD on and off over several worker counts, and how many differed from the reference
+        size_t configurations = 0;
+        size_t mismatches = 0;
+    };
+
+    // Checks what the software renderer promises. A grid of triangles covering the viewport,
+    // jittered and snapped to pixel centers, must cover every pixel exactly once, and a scene of
+    // overlapping, clipped perspective triangles must hash to the same color and depth whether
+    // SIMD is used and however many job system threads rasterize it.
+    // Creates its own job systems, so the calling thread must not belong to another one.
+    bool check_software_renderer(SoftwareRendererCheckStats* stats = nullptr);
+}
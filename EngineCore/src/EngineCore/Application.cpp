@@ -1,56 +1,195 @@
 #include "EngineCore/Application.hpp"
 #include "EngineCore/Debug.hpp"
 #include "EngineCore/Window.hpp"
+#include "EngineCore/Rendering/RenderStats.hpp"
+#include "EngineCore/Rendering/OpenGL/ShaderProgramCache.hpp"
+#include "EngineCore/Rendering/OpenGL/Renderer_OpenGL.hpp"
+#include "EngineCore/Jobs/JobSystem.hpp"
+#include "EngineCore/Memory/FrameArena.hpp"
+#include "EngineCore/Profiling/Profiler.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
 
 #include <memory>
+#include <chrono>
 
 namespace GraphicsEngine
 {
+    constexpr float camera_near_plane = 0.01f;
+    constexpr float camera_far_plane = 1000.0f;
+
     Application::Application()
+        : m_frame_arena(std::make_unique<FrameArena>())
     {
-        
+        Log::init();
     }
 
     Application::~Application()
     {
+        Log::shutdown();
+    }
+
+    void Application::dispatch_and_update()
+    {
+        {
+            PROFILE_SCOPE("dispatch events");
+            m_event_dispatcher.dispatch_queued();
+        }
+        PROFILE_SCOPE("Application::on_update");
+        on_update();
+    }
 
+    void Application::write_trace()
+    {
+        if (!m_trace_path.empty())
+        {
+            Profiler::write_chrome_trace(m_trace_path);
+        }
+    }
+
+    void Application::load_assets()
+    {
+        AssetManager& assets = m_window->get_assets();
+        if (m_asset_memory_budget > 0)
+        {
+            assets.set_memory_budget(m_asset_memory_budget);
+        }
+        if (m_asset_upload_budget > 0)
+        {
+            assets.set_upload_budget(m_asset_upload_budget);
+        }
+        m_window->set_textured(m_textured);
+        apply_camera(m_window->get_width(), m_window->get_height());
+        if (!m_mesh_path.empty())
+        {
+            // The built-in quad is drawn until the mesh is resident, or for good if it fails to load
+            m_window->load_mesh(m_mesh_path);
+        }
+    }
+
+    void Application::apply_camera(const unsigned int width, const unsigned int height)
+    {
+        if (!m_has_camera || width == 0 || height == 0)
+        {
+            return;
+        }
+        const glm::vec3 eye(m_camera.eye[0], m_camera.eye[1], m_camera.eye[2]);
+        const glm::vec3 target(m_camera.target[0], m_camera.target[1], m_camera.target[2]);
+        const glm::mat4 projection = glm::perspective(glm::radians(m_camera.fov_y_degrees), static_cast<float>(width) / static_cast<float>(height),
+                                                      camera_near_plane, camera_far_plane);
+        m_window->set_view_projection(projection * glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f)));
+    }
+
+    void Application::start_job_system()
+    {
+        Profiler::set_thread_name("Main");
+        // Started on the thread that runs the main loop, which becomes job thread 0
+        m_job_system = std::make_unique<JobSystem>(m_worker_threads_count < 0 ? JobSystem::default_workers_count
+                                                                              : static_cast<unsigned int>(m_worker_threads_count));
     }
 
     int Application::start(unsigned int window_width, unsigned int window_height, const char *title)
     {
-        m_window = std::make_unique<Window>(title, window_width, window_height);
-        
+        ShaderProgramCache::set_directory(m_shader_cache_directory);
+        Renderer_OpenGL::set_direct_state_access_allowed(m_direct_state_access);
+        start_job_system();
+        m_window = std::make_unique<Window>(title, window_width, window_height, false, m_multithreaded_rendering);
+        m_window->set_job_system(m_job_system.get());
+        m_window->set_frame_arena(m_frame_arena.get());
+        load_assets();
+        init_event_listeners();
+
+        while(!m_bCloseWindow){
+            m_window->on_update();
+            dispatch_and_update();
+            m_frame_arena->end_frame();
+            Profiler::end_frame();
+        }
+        m_window = nullptr;
+        m_job_system = nullptr;
+        write_trace();
+
+        return 0;
+    }
+
+    int Application::start_headless(unsigned int width, unsigned int height, unsigned int frames_count, unsigned int objects_count)
+    {
+        ShaderProgramCache::set_directory(m_shader_cache_directory);
+        Renderer_OpenGL::set_direct_state_access_allowed(m_direct_state_access);
+        start_job_system();
+        m_window = std::make_unique<Window>("Headless", width, height, true, m_multithreaded_rendering,
+                                            m_software_rendering ? ERenderBackend::Software : ERenderBackend::OpenGL);
+        if (!m_window->is_initialized())
+        {
+            LOG_CRITICAL("Failed to create headless context");
+            m_window = nullptr;
+            m_job_system = nullptr;
+            return -1;
+        }
+        m_window->set_job_system(m_job_system.get());
+        m_window->set_frame_arena(m_frame_arena.get());
+        load_assets();
+        m_window->set_objects_count(objects_count);
+        init_event_listeners();
+
+        m_frames_stats.clear();
+        m_frames_stats.reserve(frames_count);
+
+        // The render thread may still be executing the previous frame when the next one starts,
+        // so counters are taken (and zeroed) after each frame rather than reset before it
+        RenderStats::reset();
+        for (unsigned int frame = 0; frame < frames_count && !m_bCloseWindow; ++frame)
+        {
+            const auto frame_start = std::chrono::steady_clock::now();
+
+            m_window->on_update();
+            dispatch_and_update();
+            if (frame + 1 == frames_count)
+            {
+                m_window->finish_rendering();
+            }
+
+            const std::chrono::duration<double, std::milli> frame_time = std::chrono::steady_clock::now() - frame_start;
+            m_frames_stats.push_back({ frame_time.count(), RenderStats::draw_calls.exchange(0), RenderStats::triangles.exchange(0),
+                                       RenderStats::upload_bytes.exchange(0),
+                                       RenderStats::fence_waits.exchange(0), RenderStats::state_changes_issued.exchange(0),
+                                       RenderStats::state_changes_skipped.exchange(0),
+                                       m_window->get_visible_objects_count(), m_window->get_culled_objects_count(),
+                                       m_frame_arena->get_bytes_in_use() });
+            m_frame_arena->end_frame();
+            Profiler::end_frame();
+        }
+        m_window = nullptr;
+        m_job_system = nullptr;
+        write_trace();
+
+        return 0;
+    }
+
+    void Application::init_event_listeners()
+    {
         m_event_dispatcher.add_event_listener<EventMouseMoved>(
-            [](EventMouseMoved &event) {
+            [](EventMouseMoved &event, void*) {
                 //LOG_INFO("Mouse moved to x: {0}, y: {1}", event.x, event.y);
             }
         );
 
         m_event_dispatcher.add_event_listener<EventWindowResized>(
-            [](EventWindowResized &event) {
+            [](EventWindowResized &event, void* application) {
                 //LOG_INFO("Window resized to width: {0}, height: {1}", event.width, event.height);
-            }
+                static_cast<Application*>(application)->apply_camera(event.width, event.height);
+            },
+            this
         );
 
         m_event_dispatcher.add_event_listener<EventWindowClose>(
-            [&](EventWindowClose &event) {
+            [](EventWindowClose &event, void* application) {
                 LOG_INFO("Window closed");
-                m_bCloseWindow = true;
-            }
-        );
-
-        m_window->set_event_callback(
-            [&](Event& event){
-                m_event_dispatcher.dispatch(event);
-            }
+                static_cast<Application*>(application)->m_bCloseWindow = true;
+            },
+            this
         );
 
-        while(!m_bCloseWindow){
-            m_window->on_update();
-            on_update();
-        }
-        m_window = nullptr;
-
-        return 0;
+        m_window->set_event_dispatcher(&m_event_dispatcher);
     }
 }
@@ -0,0 +1,439 @@
+#define ENGINE_LOG_MODULE Assets
+
+#include "AssetManager.hpp"
+#include "EngineCore/Debug.hpp"
+#include "EngineCore/Rendering/OpenGL/StateCache_OpenGL.hpp"
+#include "EngineCore/Rendering/OpenGL/VertexArray.hpp"
+#include "EngineCore/Profiling/Profiler.hpp"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace GraphicsEngine {
+    AssetHandle::AssetHandle(AssetManager* manager, const uint32_t index)
+        : m_manager(manager)
+        , m_index(index)
+    {
+        m_manager->m_slots[m_index].references.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    AssetHandle::~AssetHandle()
+    {
+        if (m_manager)
+        {
+            m_manager->m_slots[m_index].references.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    AssetHandle::AssetHandle(const AssetHandle& handle)
+        : m_manager(handle.m_manager)
+        , m_index(handle.m_index)
+    {
+        if (m_manager)
+        {
+            m_manager->m_slots[m_index].references.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    AssetHandle& AssetHandle::operator=(const AssetHandle& handle)
+    {
+        AssetHandle copy(handle);
+        std::swap(m_manager, copy.m_manager);
+        std::swap(m_index, copy.m_index);
+        return *this;
+    }
+
+    AssetHandle::AssetHandle(AssetHandle&& handle) noexcept
+        : m_manager(std::exchange(handle.m_manager, nullptr))
+        , m_index(handle.m_index)
+    {
+    }
+
+    AssetHandle& AssetHandle::operator=(AssetHandle&& handle) noexcept
+    {
+        std::swap(m_manager, handle.m_manager);
+        std::swap(m_index, handle.m_index);
+        return *this;
+    }
+
+    AssetManager::AssetManager(const size_t memory_budget, const size_t upload_budget)
+        : m_slots(std::make_unique<Slot[]>(max_assets))
+        , m_memory_budget(memory_budget)
+        , m_upload_budget(upload_budget)
+    {
+        m_free_slots.reserve(max_assets);
+        for (size_t i = max_assets; i > 0; --i)
+        {
+            m_free_slots.push_back(static_cast<uint32_t>(i - 1));
+        }
+    }
+
+    AssetManager::~AssetManager()
+    {
+        if (m_job_system)
+        {
+            m_job_system->wait(m_loads_counter);
+        }
+    }
+
+    AssetHandle AssetManager::load_mesh(const std::string& path, const BufferLayout& layout)
+    {
+        const auto it = m_slot_by_path.find(path);
+        if (it != m_slot_by_path.end())
+        {
+            AssetHandle handle(this, it->second);
+            touch(handle);
+            return handle;
+        }
+        if (m_free_slots.empty())
+        {
+            LOG_ERROR("AssetManager: more than {} assets, can't load {}", max_assets, path);
+            return {};
+        }
+
+        const uint32_t index = m_free_slots.back();
+        m_free_slots.pop_back();
+        Slot& slot = m_slots[index];
+        slot.path = path;
+        slot.layout = std::make_unique<BufferLayout>(layout);
+        slot.in_use = true;
+        slot.has_bounds = false;
+        m_slot_by_path.emplace(path, index);
+        ++m_assets_count;
+
+        AssetHandle handle(this, index);
+        touch(handle);
+        return handle;
+    }
+
+    void AssetManager::touch(const AssetHandle& handle)
+    {
+        Slot& slot = m_slots[handle.m_index];
+        slot.last_used_frame = m_frame;
+        if (slot.state == EAssetState::Unloaded)
+        {
+            request_load(handle.m_index);
+        }
+    }
+
+    void AssetManager::request_load(const uint32_t index)
+    {
+        m_slots[index].state = EAssetState::Loading;
+        m_pending_loads.push_back(index);
+    }
+
+    void AssetManager::load(const uint32_t index)
+    {
+        PROFILE_SCOPE("load asset");
+        const Slot& slot = m_slots[index];
+        auto asset = std::make_unique<MeshAsset>();
+        if (asset->load(slot.path))
+        {
+            if (!asset->matches_layout(*slot.layout))
+            {
+                LOG_ERROR("AssetManager: {} does not have the requested vertex layout", slot.path);
+                asset = nullptr;
+            }
+            else
+            {
+                // Faults the pages in here rather than on the render thread during the upload
+                const unsigned char* data = static_cast<const unsigned char*>(asset->get_vertices());
+                const size_t size = asset->get_vertices_size() + asset->get_indices_size();
+                volatile unsigned char sink = 0;
+                for (size_t offset = 0; offset < size; offset += 4096)
+                {
+                    sink = sink + data[offset];
+                }
+            }
+        }
+        else
+        {
+            asset = nullptr;
+        }
+
+        std::lock_guard lock(m_loaded_mutex);
+        m_loaded.push_back({ index, std::move(asset) });
+    }
+
+    void AssetManager::update()
+    {
+        PROFILE_SCOPE("AssetManager::update");
+        ++m_frame;
+
+        const bool has_workers = m_job_system && m_job_system->get_threads_count() > 1;
+        if (has_workers)
+        {
+            for (const uint32_t index : m_pending_loads)
+            {
+                m_job_system->run([this, index]() { load(index); }, &m_loads_counter);
+            }
+            m_pending_loads.clear();
+        }
+        else if (!m_pending_loads.empty())
+        {
+            load(m_pending_loads.front());
+            m_pending_loads.pop_front();
+        }
+
+        std::vector<LoadResult> loaded;
+        {
+            std::lock_guard lock(m_loaded_mutex);
+            loaded.swap(m_loaded);
+        }
+        std::vector<uint32_t> completed;
+        {
+            std::lock_guard lock(m_upload_mutex);
+            completed.swap(m_completed_uploads);
+            for (LoadResult& result : loaded)
+            {
+                Slot& slot = m_slots[result.index];
+                if (!result.asset)
+                {
+                    slot.state = EAssetState::Failed;
+                    continue;
+                }
+                slot.bounds = result.asset->get_bounds();
+                slot.lods.clear();
+                for (size_t lod = 0; lod < result.asset->get_lods_count(); ++lod)
+                {
+                    slot.lods.push_back(result.asset->get_lod(lod));
+                }
+                slot.has_bounds = true;
+                slot.gpu_bytes = result.asset->get_vertices_size() + result.asset->get_indices_size();
+                slot.state = EAssetState::Uploading;
+                m_resident_bytes += slot.gpu_bytes;
+                m_queued_uploads.push_back({ result.index, std::move(result.asset), nullptr, nullptr, 0 });
+            }
+        }
+        for (const uint32_t index : completed)
+        {
+            m_slots[index].state = EAssetState::Resident;
+        }
+
+        evict_over_budget();
+
+        // Slots without handles that hold nothing can be reused
+        for (auto it = m_slot_by_path.begin(); it != m_slot_by_path.end();)
+        {
+            Slot& slot = m_slots[it->second];
+            if (slot.references.load(std::memory_order_relaxed) == 0 &&
+                (slot.state == EAssetState::Unloaded || slot.state == EAssetState::Failed))
+            {
+                slot.in_use = false;
+                slot.state = EAssetState::Unloaded;
+                slot.path.clear();
+                slot.layout = nullptr;
+                m_free_slots.push_back(it->second);
+                --m_assets_count;
+                it = m_slot_by_path.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    void AssetManager::evict_over_budget()
+    {
+        while (m_resident_bytes > m_memory_budget)
+        {
+            // Unreferenced assets go first, then the least recently touched. Assets touched
+            // this frame or the last one may still be drawn and are kept even over budget.
+            uint32_t victim = max_assets;
+            bool victim_referenced = true;
+            uint64_t victim_frame = m_frame - 1;
+            for (const auto& [path, index] : m_slot_by_path)
+            {
+                const Slot& slot = m_slots[index];
+                if (slot.state != EAssetState::Resident)
+                {
+                    continue;
+                }
+                const bool referenced = slot.references.load(std::memory_order_relaxed) > 0;
+                if ((referenced && slot.last_used_frame >= m_frame - 1) || (referenced && !victim_referenced))
+                {
+                    continue;
+                }
+                if ((!referenced && victim_referenced) || slot.last_used_frame < victim_frame)
+                {
+                    victim = index;
+                    victim_referenced = referenced;
+                    victim_frame = slot.last_used_frame;
+                }
+            }
+            if (victim == max_assets)
+            {
+                return;
+            }
+            evict(victim);
+        }
+    }
+
+    void AssetManager::evict(const uint32_t index)
+    {
+        Slot& slot = m_slots[index];
+        slot.state = EAssetState::Unloaded;
+        m_resident_bytes -= slot.gpu_bytes;
+        slot.gpu_bytes = 0;
+        ++m_evictions_count;
+
+        std::lock_guard lock(m_upload_mutex);
+        m_queued_evictions.push_back(index);
+    }
+
+    EAssetState AssetManager::get_state(const AssetHandle& handle) const
+    {
+        return m_slots[handle.m_index].state;
+    }
+
+    bool AssetManager::get_bounds(const AssetHandle& handle, AABB& bounds) const
+    {
+        const Slot& slot = m_slots[handle.m_index];
+        if (slot.has_bounds)
+        {
+            bounds = slot.bounds;
+        }
+        return slot.has_bounds;
+    }
+
+    bool AssetManager::get_lods(const AssetHandle& handle, std::vector<MeshLod>& lods) const
+    {
+        const Slot& slot = m_slots[handle.m_index];
+        if (slot.has_bounds)
+        {
+            lods = slot.lods;
+        }
+        return slot.has_bounds;
+    }
+
+    void AssetManager::upload()
+    {
+        PROFILE_SCOPE("AssetManager::upload");
+        {
+            std::vector<uint32_t> evictions;
+            {
+                std::lock_guard lock(m_upload_mutex);
+                evictions.swap(m_queued_evictions);
+                for (Upload& upload : m_queued_uploads)
+                {
+                    m_active_uploads.push_back(std::move(upload));
+                }
+                m_queued_uploads.clear();
+            }
+            // GL keeps the buffers alive until the draws already submitted have read them
+            for (const uint32_t index : evictions)
+            {
+                m_slots[index].gpu_mesh = nullptr;
+            }
+        }
+        if (m_active_uploads.empty())
+        {
+            return;
+        }
+
+        if (!m_staging_buffer_id)
+        {
+            glGenBuffers(1, &m_staging_buffer_id);
+            StateCache_OpenGL::bind_buffer(GL_COPY_READ_BUFFER, m_staging_buffer_id);
+            m_staging.allocate(GL_COPY_READ_BUFFER, m_staging_buffer_id, std::max<size_t>(m_upload_budget, 4096));
+        }
+
+        struct Copy
+        {
+            unsigned int buffer_id;
+            size_t source_offset;
+            size_t destination_offset;
+            size_t size;
+        };
+        std::vector<Copy> copies;
+        uint8_t* staging = static_cast<uint8_t*>(m_staging.map_next_region());
+        const size_t budget = m_staging.get_region_size();
+        size_t staged = 0;
+        std::vector<uint32_t> completed;
+
+        // Index buffers are created with GL_ELEMENT_ARRAY_BUFFER bound, which belongs to the bound VAO
+        VertexArray::unbind();
+        while (!m_active_uploads.empty() && staged < budget)
+        {
+            Upload& upload = m_active_uploads.front();
+            const MeshAsset& asset = *upload.asset;
+            if (!upload.vertex_buffer)
+            {
+                upload.vertex_buffer = std::make_unique<VertexBuffer>(nullptr, asset.get_vertices_size(), *m_slots[upload.index].layout);
+                upload.index_buffer = std::make_unique<IndexBuffer>(nullptr, asset.get_indices_count(), asset.get_index_type());
+            }
+
+            // Vertices, then indices, each sliced to what is left of this frame's budget
+            const size_t vertices_size = asset.get_vertices_size();
+            const size_t total_size = vertices_size + asset.get_indices_size();
+            while (upload.uploaded_bytes < total_size && staged < budget)
+            {
+                const bool vertices = upload.uploaded_bytes < vertices_size;
+                const size_t offset = vertices ? upload.uploaded_bytes : upload.uploaded_bytes - vertices_size;
+                const size_t size = std::min(budget - staged, (vertices ? vertices_size : total_size - vertices_size) - offset);
+                const uint8_t* source = vertices ? static_cast<const uint8_t*>(asset.get_vertices())
+                                                 : reinterpret_cast<const uint8_t*>(asset.get_indices());
+                std::memcpy(staging + staged, source + offset, size);
+                copies.push_back({ vertices ? upload.vertex_buffer->get_id() : upload.index_buffer->get_id(), staged, offset, size });
+                staged += size;
+                upload.uploaded_bytes += size;
+            }
+            if (upload.uploaded_bytes < total_size)
+            {
+                break;
+            }
+
+            Slot& slot = m_slots[upload.index];
+            slot.gpu_mesh = std::make_unique<GpuMesh>();
+            slot.gpu_mesh->source = std::move(*upload.asset);
+            slot.gpu_mesh->vertex_buffer = std::move(upload.vertex_buffer);
+            slot.gpu_mesh->index_buffer = std::move(upload.index_buffer);
+            slot.gpu_mesh->residency_id = m_next_residency_id++;
+            completed.push_back(upload.index);
+            m_active_uploads.pop_front();
+        }
+
+        m_staging.commit(staged);
+        const size_t region_offset = m_staging.get_region_offset();
+        StateCache_OpenGL::bind_buffer(GL_COPY_READ_BUFFER, m_staging_buffer_id);
+        for (const Copy& copy : copies)
+        {
+            StateCache_OpenGL::bind_buffer(GL_COPY_WRITE_BUFFER, copy.buffer_id);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(region_offset + copy.source_offset),
+                                static_cast<GLintptr>(copy.destination_offset), static_cast<GLsizeiptr>(copy.size));
+        }
+        m_staging.fence();
+
+        if (!completed.empty())
+        {
+            std::lock_guard lock(m_upload_mutex);
+            m_completed_uploads.insert(m_completed_uploads.end(), completed.begin(), completed.end());
+        }
+    }
+
+    const GpuMesh* AssetManager::find_resident_mesh(const AssetHandle& handle) const
+    {
+        return m_slots[handle.m_index].gpu_mesh.get();
+    }
+
+    void AssetManager::release_gpu_resources()
+    {
+        m_active_uploads.clear();
+        m_queued_uploads.clear();
+        for (size_t i = 0; i < max_assets; ++i)
+        {
+            m_slots[i].gpu_mesh = nullptr;
+        }
+        m_staging = StreamBuffer();
+        if (m_staging_buffer_id)
+        {
+            StateCache_OpenGL::on_buffer_deleted(m_staging_buffer_id);
+            glDeleteBuffers(1, &m_staging_buffer_id);
+            m_staging_buffer_id = 0;
+        }
+    }
+}
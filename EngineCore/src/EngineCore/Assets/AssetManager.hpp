@@ -0,0 +1,190 @@
+#pragma once
+
+#include "MeshAsset.hpp"
+#include "EngineCore/Rendering/Bounds.hpp"
+#include "EngineCore/Rendering/OpenGL/VertexBuffer.hpp"
+#include "EngineCore/Rendering/OpenGL/IndexBuffer.hpp"
+#include "EngineCore/Rendering/OpenGL/StreamBuffer.hpp"
+#include "EngineCore/Jobs/JobSystem.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace GraphicsEngine {
+    class AssetManager;
+
+    enum class EAssetState : uint8_t
+    {
+        // Not loaded, or evicted; touching the asset loads it again
+        Unloaded,
+        // Mapped and validated on a worker thread
+        Loading,
+        // Copied to the GPU by the render thread, a slice per frame
+        Uploading,
+        Resident,
+        Failed
+    };
+
+    // A mesh as the render thread draws it. Only valid on the render thread, until the mesh is evicted.
+    struct GpuMesh
+    {
+        // Stays mapped for passes that read vertices on the CPU (batching, MeshPool)
+        MeshAsset source;
+        std::unique_ptr<VertexBuffer> vertex_buffer;
+        std::unique_ptr<IndexBuffer> index_buffer;
+        // Differs every time an asset becomes resident, so users can tell a reload apart
+        uint64_t residency_id = 0;
+    };
+
+    // Reference-counted handle to an asset of an AssetManager. Assets without handles are
+    // evicted first; assets with handles are evicted when they have not been touched recently.
+    class AssetHandle
+    {
+    public:
+        AssetHandle() = default;
+        ~AssetHandle();
+        AssetHandle(const AssetHandle& handle);
+        AssetHandle& operator=(const AssetHandle& handle);
+        AssetHandle(AssetHandle&& handle) noexcept;
+        AssetHandle& operator=(AssetHandle&& handle) noexcept;
+
+        bool is_valid() const { return m_manager != nullptr; }
+
+    private:
+        friend class AssetManager;
+        AssetHandle(AssetManager* manager, const uint32_t index);
+
+        AssetManager* m_manager = nullptr;
+        uint32_t m_index = 0;
+    };
+
+    // Streams baked meshes in the background. Files are mapped and paged in on job system
+    // workers, then the render thread copies them into GPU buffers through a persistently
+    // mapped staging ring, at most upload_budget bytes per frame, so loading never stalls a
+    // frame. Resident GPU memory is kept under memory_budget by evicting the least recently
+    // touched assets; until an asset is resident, callers draw a placeholder instead.
+    class AssetManager
+    {
+    public:
+        static constexpr size_t max_assets = 4096;
+        static constexpr size_t default_memory_budget = 256 * 1024 * 1024;
+        static constexpr size_t default_upload_budget = 8 * 1024 * 1024;
+
+        explicit AssetManager(const size_t memory_budget = default_memory_budget, const size_t upload_budget = default_upload_budget);
+        // Waits for outstanding loads; GPU resources must have been released
+        ~AssetManager();
+        AssetManager(const AssetManager&) = delete;
+        AssetManager& operator=(const AssetManager&) = delete;
+
+        // Main thread. Loads run on this job system; without workers they run in update(), one per frame
+        void set_job_system(JobSystem* job_system) { m_job_system = job_system; }
+        void set_memory_budget(const size_t bytes) { m_memory_budget = bytes; }
+        // Takes effect before the first upload, which sizes the staging ring
+        void set_upload_budget(const size_t bytes) { m_upload_budget = bytes; }
+
+        // Main thread. The same path returns the same asset. The mesh must use layout;
+        // returns an invalid handle when max_assets are in use
+        AssetHandle load_mesh(const std::string& path, const BufferLayout& layout);
+        // Marks the asset as used this frame and loads it again if it was evicted
+        void touch(const AssetHandle& handle);
+        // Once per frame: starts loads, hands loaded meshes to the render thread, evicts
+        void update();
+
+        EAssetState get_state(const AssetHandle& handle) const;
+        // Known once the file is loaded, before the mesh is resident
+        bool get_bounds(const AssetHandle& handle, AABB& bounds) const;
+        // The mesh's levels of detail, known together with the bounds
+        bool get_lods(const AssetHandle& handle, std::vector<MeshLod>& lods) const;
+
+        size_t get_resident_bytes() const { return m_resident_bytes; }
+        size_t get_memory_budget() const { return m_memory_budget; }
+        size_t get_evictions_count() const { return m_evictions_count; }
+        size_t get_assets_count() const { return m_assets_count; }
+
+        // Render thread, once per frame before drawing: releases evicted meshes and uploads
+        // up to the upload budget
+        void upload();
+        // Render thread; nullptr until the asset is resident
+        const GpuMesh* find_resident_mesh(const AssetHandle& handle) const;
+        // With the GL context current and the render thread stopped
+        void release_gpu_resources();
+
+    private:
+        friend class AssetHandle;
+
+        struct Slot
+        {
+            std::string path;
+            std::unique_ptr<BufferLayout> layout;
+            std::atomic<uint32_t> references = 0;
+            bool in_use = false;
+
+            // Main thread
+            EAssetState state = EAssetState::Unloaded;
+            uint64_t last_used_frame = 0;
+            size_t gpu_bytes = 0;
+            AABB bounds;
+            std::vector<MeshLod> lods;
+            bool has_bounds = false;
+
+            // Render thread
+            std::unique_ptr<GpuMesh> gpu_mesh;
+        };
+
+        struct LoadResult
+        {
+            uint32_t index;
+            std::unique_ptr<MeshAsset> asset;
+        };
+
+        struct Upload
+        {
+            uint32_t index;
+            std::unique_ptr<MeshAsset> asset;
+            std::unique_ptr<VertexBuffer> vertex_buffer;
+            std::unique_ptr<IndexBuffer> index_buffer;
+            size_t uploaded_bytes = 0;
+        };
+
+        void request_load(const uint32_t index);
+        void load(const uint32_t index);
+        void evict(const uint32_t index);
+        void evict_over_budget();
+
+        std::unique_ptr<Slot[]> m_slots;
+        std::unordered_map<std::string, uint32_t> m_slot_by_path;
+        std::vector<uint32_t> m_free_slots;
+        size_t m_assets_count = 0;
+
+        JobSystem* m_job_system = nullptr;
+        JobCounter m_loads_counter;
+        std::deque<uint32_t> m_pending_loads;
+        size_t m_memory_budget;
+        size_t m_upload_budget;
+        size_t m_resident_bytes = 0;
+        size_t m_evictions_count = 0;
+        uint64_t m_frame = 1;
+
+        // Workers -> main thread
+        std::mutex m_loaded_mutex;
+        std::vector<LoadResult> m_loaded;
+
+        // Main thread <-> render thread
+        std::mutex m_upload_mutex;
+        std::vector<Upload> m_queued_uploads;
+        std::vector<uint32_t> m_queued_evictions;
+        std::vector<uint32_t> m_completed_uploads;
+
+        // Render thread
+        std::deque<Upload> m_active_uploads;
+        unsigned int m_staging_buffer_id = 0;
+        StreamBuffer m_staging;
+        uint64_t m_next_residency_id = 1;
+    };
+}
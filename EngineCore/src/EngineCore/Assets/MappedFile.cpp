@@ -0,0 +1,136 @@
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <utility>
+
+namespace GraphicsEngine {
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& mapped_file) noexcept
+        : m_data(std::exchange(mapped_file.m_data, nullptr))
+        , m_size(std::exchange(mapped_file.m_size, 0))
+#ifdef _WIN32
+        , m_file_handle(std::exchange(mapped_file.m_file_handle, nullptr))
+        , m_mapping_handle(std::exchange(mapped_file.m_mapping_handle, nullptr))
+#endif
+    {
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& mapped_file) noexcept
+    {
+        if (this != &mapped_file)
+        {
+            close();
+            m_data = std::exchange(mapped_file.m_data, nullptr);
+            m_size = std::exchange(mapped_file.m_size, 0);
+#ifdef _WIN32
+            m_file_handle = std::exchange(mapped_file.m_file_handle, nullptr);
+            m_mapping_handle = std::exchange(mapped_file.m_mapping_handle, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+#ifdef _WIN32
+    bool MappedFile::open(const std::string& path)
+    {
+        close();
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return false;
+        }
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping)
+        {
+            CloseHandle(file);
+            return false;
+        }
+        void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!data)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+        m_data = static_cast<const unsigned char*>(data);
+        m_size = static_cast<size_t>(size.QuadPart);
+        m_file_handle = file;
+        m_mapping_handle = mapping;
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data)
+        {
+            UnmapViewOfFile(m_data);
+            CloseHandle(m_mapping_handle);
+            CloseHandle(m_file_handle);
+        }
+        m_data = nullptr;
+        m_size = 0;
+        m_file_handle = nullptr;
+        m_mapping_handle = nullptr;
+    }
+#else
+    bool MappedFile::open(const std::string& path)
+    {
+        close();
+        const int file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            return false;
+        }
+        struct stat file_stat;
+        if (fstat(file, &file_stat) != 0 || file_stat.st_size == 0)
+        {
+            ::close(file);
+            return false;
+        }
+        void* data = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        // The mapping keeps its own reference to the file
+        ::close(file);
+        if (data == MAP_FAILED)
+        {
+            return false;
+        }
+        // Meshes are read front to back once, when they are uploaded
+        madvise(data, static_cast<size_t>(file_stat.st_size), MADV_SEQUENTIAL);
+        madvise(data, static_cast<size_t>(file_stat.st_size), MADV_WILLNEED);
+        m_data = static_cast<const unsigned char*>(data);
+        m_size = static_cast<size_t>(file_stat.st_size);
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data)
+        {
+            munmap(const_cast<unsigned char*>(m_data), m_size);
+        }
+        m_data = nullptr;
+        m_size = 0;
+    }
+#endif
+}
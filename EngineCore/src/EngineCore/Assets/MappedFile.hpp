@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace GraphicsEngine {
+    // Read-only memory mapping of a whole file. Pages are loaded by the OS on first access,
+    // so opening is cheap and the contents are never copied into the process heap.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& mapped_file) noexcept;
+        MappedFile& operator=(MappedFile&& mapped_file) noexcept;
+
+        bool open(const std::string& path);
+        void close();
+
+        bool is_open() const { return m_data != nullptr; }
+        const unsigned char* get_data() const { return m_data; }
+        size_t get_size() const { return m_size; }
+
+    private:
+        const unsigned char* m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        void* m_file_handle = nullptr;
+        void* m_mapping_handle = nullptr;
+#endif
+    };
+}
@@ -0,0 +1,158 @@
+#define ENGINE_LOG_MODULE Assets
+
+#include "MeshAsset.hpp"
+#include "EngineCore/Debug.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace GraphicsEngine {
+    namespace {
+        bool is_range_valid(const uint64_t offset, const uint64_t size, const size_t file_size)
+        {
+            return offset % MeshFileHeader::data_alignment == 0 && offset <= file_size && size <= file_size - offset;
+        }
+
+        bool are_lods_valid(const MeshFileHeader& header)
+        {
+            if (header.lods_count == 0 || header.lods_count > MeshFileHeader::max_lods)
+            {
+                return false;
+            }
+            for (uint32_t i = 0; i < header.lods_count; ++i)
+            {
+                const MeshLod& lod = header.lods[i];
+                if (lod.indices_count == 0 || lod.indices_count % 3 != 0 || lod.first_index > header.indices_count ||
+                    lod.indices_count > header.indices_count - lod.first_index || !(lod.error >= 0.0f))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <typename Index>
+        bool are_indices_in_range(const void* indices, const uint64_t indices_count, const uint64_t vertices_count)
+        {
+            const Index* first = static_cast<const Index*>(indices);
+            Index max_index = 0;
+            for (const Index* index = first; index != first + indices_count; ++index)
+            {
+                max_index = std::max(max_index, *index);
+            }
+            return indices_count == 0 || max_index < vertices_count;
+        }
+
+        // The GPU paths read vertices at these indices unchecked, so they must stay within the mesh
+        bool are_indices_valid(const MeshFileHeader& header, const uint8_t* data)
+        {
+            const void* indices = data + header.indices_offset;
+            switch (header.index_size)
+            {
+                case 1: return are_indices_in_range<uint8_t>(indices, header.indices_count, header.vertices_count);
+                case 2: return are_indices_in_range<uint16_t>(indices, header.indices_count, header.vertices_count);
+                default: return are_indices_in_range<uint32_t>(indices, header.indices_count, header.vertices_count);
+            }
+        }
+    }
+
+    bool MeshAsset::load(const std::string& path)
+    {
+        release();
+        if (!m_file.open(path))
+        {
+            LOG_ERROR("MeshAsset: can't map {}", path);
+            return false;
+        }
+
+        const MeshFileHeader* header = reinterpret_cast<const MeshFileHeader*>(m_file.get_data());
+        if (m_file.get_size() < sizeof(MeshFileHeader) || header->magic != MeshFileHeader::magic_value)
+        {
+            LOG_ERROR("MeshAsset: {} is not a baked mesh", path);
+            m_file.close();
+            return false;
+        }
+        if (header->version != MeshFileHeader::current_version)
+        {
+            LOG_ERROR("MeshAsset: {} has version {}, expected {}; bake it again", path, header->version, MeshFileHeader::current_version);
+            m_file.close();
+            return false;
+        }
+
+        size_t stride = 0;
+        bool attributes_valid = header->attributes_count > 0 && header->attributes_count <= MeshFileHeader::max_attributes;
+        for (uint32_t i = 0; attributes_valid && i < header->attributes_count; ++i)
+        {
+            attributes_valid = header->attributes[i] <= static_cast<uint8_t>(ShaderDataType::Int2_10_10_10_Rev);
+            if (attributes_valid)
+            {
+                stride += BufferElement(static_cast<ShaderDataType>(header->attributes[i])).size;
+            }
+        }
+        const bool index_size_valid = header->index_size == 1 || header->index_size == 2 || header->index_size == 4;
+        if (!attributes_valid || stride != header->vertex_stride || !index_size_valid ||
+            header->vertices_size != static_cast<uint64_t>(header->vertices_count) * header->vertex_stride ||
+            header->indices_size != static_cast<uint64_t>(header->indices_count) * header->index_size ||
+            !is_range_valid(header->vertices_offset, header->vertices_size, m_file.get_size()) ||
+            !is_range_valid(header->indices_offset, header->indices_size, m_file.get_size()) ||
+            !are_lods_valid(*header) || !are_indices_valid(*header, m_file.get_data()))
+        {
+            LOG_ERROR("MeshAsset: {} is corrupted", path);
+            m_file.close();
+            return false;
+        }
+
+        m_header = header;
+        return true;
+    }
+
+    void MeshAsset::release()
+    {
+        m_file.close();
+        m_header = nullptr;
+    }
+
+    bool MeshAsset::matches_layout(const BufferLayout& layout) const
+    {
+        const std::vector<BufferElement>& elements = layout.get_elements();
+        if (elements.size() != m_header->attributes_count || layout.get_stride() != m_header->vertex_stride)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < elements.size(); ++i)
+        {
+            if (static_cast<uint8_t>(elements[i].type) != m_header->attributes[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    BufferLayout MeshAsset::get_layout() const
+    {
+        std::vector<BufferElement> elements;
+        elements.reserve(m_header->attributes_count);
+        for (uint32_t i = 0; i < m_header->attributes_count; ++i)
+        {
+            elements.emplace_back(static_cast<ShaderDataType>(m_header->attributes[i]));
+        }
+        return BufferLayout(std::move(elements));
+    }
+
+    EIndexType MeshAsset::get_index_type() const
+    {
+        switch (m_header->index_size)
+        {
+            case 1:  return EIndexType::UInt8;
+            case 2:  return EIndexType::UInt16;
+            default: return EIndexType::UInt32;
+        }
+    }
+
+    AABB MeshAsset::get_bounds() const
+    {
+        return { glm::vec3(m_header->bounds_min[0], m_header->bounds_min[1], m_header->bounds_min[2]),
+                 glm::vec3(m_header->bounds_max[0], m_header->bounds_max[1], m_header->bounds_max[2]) };
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "MappedFile.hpp"
+#include "MeshFile.hpp"
+#include "EngineCore/Rendering/Bounds.hpp"
+#include "EngineCore/Rendering/OpenGL/IndexBuffer.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace GraphicsEngine {
+    // A baked mesh mapped into memory. Loading validates the header and nothing else: the
+    // vertex and index pointers point into the mapping and can be passed to VertexBuffer,
+    // IndexBuffer or MeshPool as they are.
+    class MeshAsset
+    {
+    public:
+        bool load(const std::string& path);
+        // Unmaps the file; the pointers below become invalid
+        void release();
+
+        bool is_loaded() const { return m_header != nullptr; }
+        // Whether the vertex stream can be drawn with a buffer of this layout
+        bool matches_layout(const BufferLayout& layout) const;
+        BufferLayout get_layout() const;
+
+        const void* get_vertices() const { return m_file.get_data() + m_header->vertices_offset; }
+        size_t get_vertices_size() const { return static_cast<size_t>(m_header->vertices_size); }
+        size_t get_vertices_count() const { return m_header->vertices_count; }
+        const void* get_indices() const { return m_file.get_data() + m_header->indices_offset; }
+        size_t get_indices_size() const { return static_cast<size_t>(m_header->indices_size); }
+        size_t get_indices_count() const { return m_header->indices_count; }
+        EIndexType get_index_type() const;
+        // LOD 0 is the full mesh; index ranges are relative to get_indices()
+        size_t get_lods_count() const { return m_header->lods_count; }
+        const MeshLod& get_lod(const size_t lod) const { return m_header->lods[lod]; }
+        AABB get_bounds() const;
+
+    private:
+        MappedFile m_file;
+        const MeshFileHeader* m_header = nullptr;
+    };
+}
@@ -0,0 +1,418 @@
+#define ENGINE_LOG_MODULE Assets
+
+#include "EngineCore/MeshBaker.hpp"
+#include "EngineCore/Debug.hpp"
+#include "MappedFile.hpp"
+#include "MeshFile.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshSimplifier.hpp"
+#include "EngineCore/Rendering/VertexQuantization.hpp"
+#include "EngineCore/Rendering/OpenGL/IndexBuffer.hpp"
+#include "EngineCore/Rendering/OpenGL/VertexBuffer.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace GraphicsEngine {
+    namespace {
+        // Matches BatchVertex and the layout the engine's shaders read
+        struct BakedVertex
+        {
+            float position[3];
+            float color[4];
+            float tex_coord[2];
+        };
+        constexpr ShaderDataType full_attributes[] = { ShaderDataType::Float3, ShaderDataType::Float4, ShaderDataType::Float2 };
+
+        struct CompactVertex
+        {
+            float position[3];
+            uint8_t color[4];
+            uint16_t tex_coord[2];
+        };
+        static_assert(sizeof(CompactVertex) == 20);
+        constexpr ShaderDataType compact_attributes[] = { ShaderDataType::Float3, ShaderDataType::UByte4Norm, ShaderDataType::Half2 };
+        static_assert(std::size(full_attributes) == std::size(compact_attributes));
+
+        // Quantizes whole attribute streams at once so the SIMD converters see long runs
+        std::vector<uint8_t> compact_vertices(const std::vector<BakedVertex>& vertices)
+        {
+            std::vector<float> colors(vertices.size() * 4);
+            std::vector<float> tex_coords(vertices.size() * 2);
+            for (size_t i = 0; i < vertices.size(); ++i)
+            {
+                std::memcpy(colors.data() + i * 4, vertices[i].color, sizeof(vertices[i].color));
+                std::memcpy(tex_coords.data() + i * 2, vertices[i].tex_coord, sizeof(vertices[i].tex_coord));
+            }
+            std::vector<uint8_t> quantized_colors(colors.size());
+            std::vector<uint16_t> quantized_tex_coords(tex_coords.size());
+            quantize_unorm8(colors.data(), quantized_colors.data(), colors.size());
+            quantize_half(tex_coords.data(), quantized_tex_coords.data(), tex_coords.size());
+
+            std::vector<uint8_t> data(vertices.size() * sizeof(CompactVertex));
+            for (size_t i = 0; i < vertices.size(); ++i)
+            {
+                CompactVertex vertex;
+                std::memcpy(vertex.position, vertices[i].position, sizeof(vertex.position));
+                std::memcpy(vertex.color, quantized_colors.data() + i * 4, sizeof(vertex.color));
+                std::memcpy(vertex.tex_coord, quantized_tex_coords.data() + i * 2, sizeof(vertex.tex_coord));
+                std::memcpy(data.data() + i * sizeof(CompactVertex), &vertex, sizeof(vertex));
+            }
+            return data;
+        }
+
+        struct ObjPosition
+        {
+            float position[3];
+            float color[4];
+        };
+
+        class LineReader
+        {
+        public:
+            LineReader(const char* begin, const char* end) : m_current(begin), m_end(end) {}
+
+            void skip_spaces()
+            {
+                while (m_current < m_end && (*m_current == ' ' || *m_current == '\t'))
+                {
+                    ++m_current;
+                }
+            }
+            bool at_end() const { return m_current >= m_end; }
+            bool read_float(float& value)
+            {
+                skip_spaces();
+                const std::from_chars_result result = std::from_chars(m_current, m_end, value);
+                if (result.ec != std::errc())
+                {
+                    return false;
+                }
+                m_current = result.ptr;
+                return true;
+            }
+            bool read_int(int64_t& value)
+            {
+                const std::from_chars_result result = std::from_chars(m_current, m_end, value);
+                if (result.ec != std::errc())
+                {
+                    return false;
+                }
+                m_current = result.ptr;
+                return true;
+            }
+            bool consume(const char c)
+            {
+                if (m_current < m_end && *m_current == c)
+                {
+                    ++m_current;
+                    return true;
+                }
+                return false;
+            }
+            // Skips whatever follows the indices read so far in a face element ("/normal")
+            void skip_word()
+            {
+                while (m_current < m_end && *m_current != ' ' && *m_current != '\t')
+                {
+                    ++m_current;
+                }
+            }
+
+        private:
+            const char* m_current;
+            const char* m_end;
+        };
+
+        // OBJ indices are 1-based, negative ones count back from the last element read so far
+        bool resolve_index(const int64_t index, const size_t count, uint32_t& resolved)
+        {
+            const int64_t absolute = index > 0 ? index - 1 : static_cast<int64_t>(count) + index;
+            if (index == 0 || absolute < 0 || absolute >= static_cast<int64_t>(count))
+            {
+                return false;
+            }
+            resolved = static_cast<uint32_t>(absolute);
+            return true;
+        }
+
+        // LOD 0 is the whole mesh; each further LOD is simplified from it, so errors don't accumulate
+        void build_lods(const std::vector<BakedVertex>& vertices, const std::vector<uint32_t>& indices, const MeshBakeSettings& settings,
+                        const float radius, std::vector<std::vector<uint32_t>>& lods, std::vector<float>& errors)
+        {
+            lods.assign(1, indices);
+            errors.assign(1, 0.0f);
+            const size_t lods_count = std::clamp<size_t>(settings.lods_count, 1, MeshFileHeader::max_lods);
+            std::vector<uint32_t> simplified(indices.size());
+            while (lods.size() < lods_count)
+            {
+                const size_t previous_count = lods.back().size();
+                const size_t target_count = static_cast<size_t>(static_cast<float>(previous_count / 3) * settings.lod_reduction) * 3;
+                float error = 0.0f;
+                const size_t count = simplify_mesh(vertices.data()->position, sizeof(BakedVertex), vertices.size(), indices.data(), indices.size(),
+                                                   simplified.data(), target_count, settings.max_lod_error * radius, &error);
+                // A level that got less than halfway to its target isn't worth its memory, and the next would fail the same way
+                if (count == 0 || count > (previous_count + target_count) / 2)
+                {
+                    break;
+                }
+                lods.emplace_back(simplified.begin(), simplified.begin() + static_cast<std::ptrdiff_t>(count));
+                errors.push_back(radius > 0.0f ? error / radius : 0.0f);
+            }
+        }
+
+        void write_padding(std::ofstream& out, const uint64_t from, const uint64_t to)
+        {
+            static constexpr char zeros[MeshFileHeader::data_alignment] = {};
+            out.write(zeros, static_cast<std::streamsize>(to - from));
+        }
+    }
+
+    bool bake_obj_mesh(const std::string& source_path, const std::string& output_path, MeshBakeStats* stats, const MeshBakeSettings& settings)
+    {
+        MappedFile source;
+        if (!source.open(source_path))
+        {
+            LOG_ERROR("MeshBaker: can't read {}", source_path);
+            return false;
+        }
+
+        std::vector<ObjPosition> positions;
+        std::vector<float> tex_coords;
+        std::vector<BakedVertex> vertices;
+        std::vector<uint32_t> indices;
+        // (position, texture coordinate + 1) -> baked vertex
+        std::unordered_map<uint64_t, uint32_t> vertex_map;
+        std::vector<uint32_t> face;
+        size_t faces_count = 0;
+
+        const char* cursor = reinterpret_cast<const char*>(source.get_data());
+        const char* const end = cursor + source.get_size();
+        size_t line_number = 0;
+        while (cursor < end)
+        {
+            const char* line_end = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+            line_end = line_end ? line_end : end;
+            LineReader line(cursor, line_end > cursor && line_end[-1] == '\r' ? line_end - 1 : line_end);
+            cursor = line_end + 1;
+            ++line_number;
+
+            line.skip_spaces();
+            if (line.consume('v'))
+            {
+                if (line.consume(' ') || line.consume('\t'))
+                {
+                    ObjPosition position = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f } };
+                    if (!line.read_float(position.position[0]) || !line.read_float(position.position[1]) || !line.read_float(position.position[2]))
+                    {
+                        LOG_ERROR("MeshBaker: {}:{}: invalid vertex", source_path, line_number);
+                        return false;
+                    }
+                    float color[3];
+                    if (line.read_float(color[0]) && line.read_float(color[1]) && line.read_float(color[2]))
+                    {
+                        std::memcpy(position.color, color, sizeof(color));
+                    }
+                    positions.push_back(position);
+                }
+                else if (line.consume('t'))
+                {
+                    float u = 0.0f;
+                    float v = 0.0f;
+                    if (!line.read_float(u))
+                    {
+                        LOG_ERROR("MeshBaker: {}:{}: invalid texture coordinate", source_path, line_number);
+                        return false;
+                    }
+                    line.read_float(v);
+                    tex_coords.push_back(u);
+                    tex_coords.push_back(v);
+                }
+                continue;
+            }
+            if (!line.consume('f') || !(line.consume(' ') || line.consume('\t')))
+            {
+                continue;
+            }
+
+            face.clear();
+            for (line.skip_spaces(); !line.at_end(); line.skip_spaces())
+            {
+                int64_t position_index = 0;
+                int64_t tex_coord_index = 0;
+                uint32_t position = 0;
+                uint32_t tex_coord = 0;
+                bool has_tex_coord = false;
+                if (!line.read_int(position_index) || !resolve_index(position_index, positions.size(), position))
+                {
+                    LOG_ERROR("MeshBaker: {}:{}: invalid face", source_path, line_number);
+                    return false;
+                }
+                if (line.consume('/') && line.read_int(tex_coord_index))
+                {
+                    if (!resolve_index(tex_coord_index, tex_coords.size() / 2, tex_coord))
+                    {
+                        LOG_ERROR("MeshBaker: {}:{}: invalid texture coordinate index", source_path, line_number);
+                        return false;
+                    }
+                    has_tex_coord = true;
+                }
+                line.skip_word();
+
+                const uint64_t key = (static_cast<uint64_t>(position) << 32) | (has_tex_coord ? tex_coord + 1ull : 0ull);
+                const auto [it, inserted] = vertex_map.try_emplace(key, static_cast<uint32_t>(vertices.size()));
+                if (inserted)
+                {
+                    BakedVertex vertex;
+                    std::memcpy(vertex.position, positions[position].position, sizeof(vertex.position));
+                    std::memcpy(vertex.color, positions[position].color, sizeof(vertex.color));
+                    vertex.tex_coord[0] = has_tex_coord ? tex_coords[tex_coord * 2] : 0.0f;
+                    vertex.tex_coord[1] = has_tex_coord ? tex_coords[tex_coord * 2 + 1] : 0.0f;
+                    vertices.push_back(vertex);
+                }
+                face.push_back(it->second);
+            }
+            if (face.size() < 3)
+            {
+                LOG_ERROR("MeshBaker: {}:{}: face with less than 3 vertices", source_path, line_number);
+                return false;
+            }
+            // Fan triangulation, which is exact for the convex polygons OBJ exporters write
+            for (size_t i = 1; i + 1 < face.size(); ++i)
+            {
+                indices.push_back(face[0]);
+                indices.push_back(face[i]);
+                indices.push_back(face[i + 1]);
+            }
+            ++faces_count;
+        }
+
+        if (indices.empty())
+        {
+            LOG_ERROR("MeshBaker: {} has no faces", source_path);
+            return false;
+        }
+        if (vertices.size() > std::numeric_limits<uint32_t>::max())
+        {
+            LOG_ERROR("MeshBaker: {} has too many vertices", source_path);
+            return false;
+        }
+
+        float bounds_min[3] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+        float bounds_max[3] = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+        for (const BakedVertex& vertex : vertices)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                bounds_min[axis] = std::min(bounds_min[axis], vertex.position[axis]);
+                bounds_max[axis] = std::max(bounds_max[axis], vertex.position[axis]);
+            }
+        }
+        const float radius = 0.5f * std::sqrt((bounds_max[0] - bounds_min[0]) * (bounds_max[0] - bounds_min[0]) +
+                                              (bounds_max[1] - bounds_min[1]) * (bounds_max[1] - bounds_min[1]) +
+                                              (bounds_max[2] - bounds_min[2]) * (bounds_max[2] - bounds_min[2]));
+
+        const float acmr_before = compute_acmr(indices.data(), indices.size(), vertices.size());
+        std::vector<std::vector<uint32_t>> lod_indices;
+        std::vector<float> lod_errors;
+        build_lods(vertices, indices, settings, radius, lod_indices, lod_errors);
+
+        // The LODs share one vertex stream, ordered by first use from the coarsest LOD to the finest.
+        // Simplification only removes vertices, so every LOD's vertices are then a prefix of the
+        // stream and paths that transform vertices on the CPU only touch that prefix.
+        std::vector<uint32_t> coarsest_first;
+        for (size_t lod = lod_indices.size(); lod-- > 0;)
+        {
+            std::vector<uint32_t>& lod_range = lod_indices[lod];
+            optimize_vertex_cache(lod_range.data(), lod_range.size(), vertices.size());
+            coarsest_first.insert(coarsest_first.end(), lod_range.begin(), lod_range.end());
+        }
+        vertices.resize(optimize_vertex_fetch(vertices.data(), vertices.size(), sizeof(BakedVertex), coarsest_first.data(), coarsest_first.size()));
+
+        // Stored finest first, as the format expects
+        std::vector<MeshLod> lods;
+        indices.clear();
+        size_t lod_end = coarsest_first.size();
+        for (size_t lod = 0; lod < lod_indices.size(); ++lod)
+        {
+            const size_t lod_size = lod_indices[lod].size();
+            lods.push_back({ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(lod_size), lod_errors[lod] });
+            indices.insert(indices.end(), coarsest_first.begin() + static_cast<std::ptrdiff_t>(lod_end - lod_size),
+                           coarsest_first.begin() + static_cast<std::ptrdiff_t>(lod_end));
+            lod_end -= lod_size;
+        }
+
+        const EIndexType index_type = select_index_type(vertices.size());
+        const size_t index_size = get_index_size(index_type);
+        std::vector<uint8_t> stored_indices(indices.size() * index_size);
+        convert_indices(indices.data(), EIndexType::UInt32, stored_indices.data(), index_type, indices.size());
+
+        const bool compact = settings.vertex_format == EBakedVertexFormat::Compact;
+        const std::vector<uint8_t> stored_vertices = compact ? compact_vertices(vertices) : std::vector<uint8_t>(
+            reinterpret_cast<const uint8_t*>(vertices.data()), reinterpret_cast<const uint8_t*>(vertices.data() + vertices.size()));
+        const ShaderDataType* attributes = compact ? compact_attributes : full_attributes;
+
+        MeshFileHeader header = {};
+        header.magic = MeshFileHeader::magic_value;
+        header.version = MeshFileHeader::current_version;
+        header.vertices_count = static_cast<uint32_t>(vertices.size());
+        header.indices_count = static_cast<uint32_t>(indices.size());
+        header.vertex_stride = static_cast<uint32_t>(compact ? sizeof(CompactVertex) : sizeof(BakedVertex));
+        header.index_size = static_cast<uint32_t>(index_size);
+        header.attributes_count = static_cast<uint32_t>(std::size(full_attributes));
+        for (size_t i = 0; i < header.attributes_count; ++i)
+        {
+            header.attributes[i] = static_cast<uint8_t>(attributes[i]);
+        }
+        std::memcpy(header.bounds_min, bounds_min, sizeof(bounds_min));
+        std::memcpy(header.bounds_max, bounds_max, sizeof(bounds_max));
+        header.lods_count = static_cast<uint32_t>(lods.size());
+        std::copy(lods.begin(), lods.end(), header.lods);
+        header.vertices_offset = align_mesh_file_offset(sizeof(MeshFileHeader));
+        header.vertices_size = stored_vertices.size();
+        header.indices_offset = align_mesh_file_offset(header.vertices_offset + header.vertices_size);
+        header.indices_size = stored_indices.size();
+
+        std::ofstream out(output_path, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            LOG_ERROR("MeshBaker: can't write {}", output_path);
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        write_padding(out, sizeof(header), header.vertices_offset);
+        out.write(reinterpret_cast<const char*>(stored_vertices.data()), static_cast<std::streamsize>(header.vertices_size));
+        write_padding(out, header.vertices_offset + header.vertices_size, header.indices_offset);
+        out.write(reinterpret_cast<const char*>(stored_indices.data()), static_cast<std::streamsize>(header.indices_size));
+        if (!out)
+        {
+            LOG_ERROR("MeshBaker: can't write {}", output_path);
+            return false;
+        }
+
+        if (stats)
+        {
+            stats->source_faces = faces_count;
+            stats->vertices = vertices.size();
+            stats->vertex_stride = header.vertex_stride;
+            stats->indices = indices.size();
+            stats->index_size = index_size;
+            stats->acmr_before = acmr_before;
+            stats->acmr_after = compute_acmr(indices.data(), lods[0].indices_count, vertices.size());
+            stats->lods.clear();
+            for (const MeshLod& lod : lods)
+            {
+                stats->lods.push_back({ lod.indices_count / 3, lod.error });
+            }
+        }
+        return true;
+    }
+}
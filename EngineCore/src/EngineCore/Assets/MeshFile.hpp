@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace GraphicsEngine {
+    // A level of detail: a range of the index stream drawn with the shared vertex stream.
+    // error is the largest geometric deviation from LOD 0, relative to the bounds' radius.
+    struct MeshLod
+    {
+        uint32_t first_index;
+        uint32_t indices_count;
+        float error;
+    };
+
+    // On-disk layout of a baked mesh (.mesh): this header, then the vertex stream and the
+    // index stream, each starting at a multiple of data_alignment. The vertex stream is
+    // interleaved exactly as a BufferLayout built from `attributes` describes it, so both
+    // streams can be handed to the GPU straight from the mapped file. The index stream holds
+    // every LOD back to back, finest first. All values are little endian.
+    struct MeshFileHeader
+    {
+        static constexpr uint32_t magic_value = 0x534D4547; // "GEMS"
+        static constexpr uint32_t current_version = 2;
+        static constexpr uint32_t max_attributes = 8;
+        static constexpr uint32_t max_lods = 8;
+        static constexpr uint64_t data_alignment = 64;
+
+        uint32_t magic;
+        uint32_t version;
+        uint32_t vertices_count;
+        uint32_t indices_count;
+        uint32_t vertex_stride;
+        // Bytes per index: 1, 2 or 4
+        uint32_t index_size;
+        uint32_t attributes_count;
+        // ShaderDataType values, in layout order
+        uint8_t attributes[max_attributes];
+        float bounds_min[3];
+        float bounds_max[3];
+        uint32_t lods_count;
+        uint64_t vertices_offset;
+        uint64_t vertices_size;
+        uint64_t indices_offset;
+        uint64_t indices_size;
+        MeshLod lods[max_lods];
+    };
+    static_assert(std::is_trivially_copyable_v<MeshFileHeader> && sizeof(MeshFileHeader) == 192,
+                  "MeshFileHeader is written to disk as is");
+
+    constexpr uint64_t align_mesh_file_offset(const uint64_t offset)
+    {
+        return (offset + MeshFileHeader::data_alignment - 1) & ~(MeshFileHeader::data_alignment - 1);
+    }
+}
@@ -0,0 +1,226 @@
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace GraphicsEngine {
+    namespace {
+        constexpr size_t cache_size = 32;
+        constexpr size_t max_valence = 32;
+        constexpr uint32_t no_triangle = std::numeric_limits<uint32_t>::max();
+
+        struct VertexScoreTable
+        {
+            // Indexed by cache position + 1, so position -1 (not cached) is entry 0
+            float cache[cache_size + 1];
+            float valence[max_valence + 1];
+
+            VertexScoreTable()
+            {
+                cache[0] = 0.0f;
+                for (size_t position = 0; position < cache_size; ++position)
+                {
+                    // The last triangle's vertices get a fixed score so the next triangle
+                    // doesn't prefer them over the slightly older ones it would evict anyway
+                    cache[position + 1] = position < 3 ? 0.75f
+                        : std::pow(1.0f - static_cast<float>(position - 3) / static_cast<float>(cache_size - 3), 1.5f);
+                }
+                valence[0] = 0.0f;
+                for (size_t remaining = 1; remaining <= max_valence; ++remaining)
+                {
+                    // Boosts vertices with few triangles left, so they are finished instead of left stranded
+                    valence[remaining] = 2.0f / std::sqrt(static_cast<float>(remaining));
+                }
+            }
+        };
+
+        float get_vertex_score(const VertexScoreTable& table, const int32_t cache_position, const uint32_t remaining_triangles)
+        {
+            if (remaining_triangles == 0)
+            {
+                return -1.0f;
+            }
+            return table.cache[cache_position + 1] + table.valence[std::min<size_t>(remaining_triangles, max_valence)];
+        }
+    }
+
+    void optimize_vertex_cache(uint32_t* indices, const size_t indices_count, const size_t vertices_count)
+    {
+        const size_t triangles_count = indices_count / 3;
+        if (triangles_count == 0)
+        {
+            return;
+        }
+        static const VertexScoreTable s_table;
+
+        // Triangles using each vertex, packed per vertex; the first remaining_triangles of a range are the unemitted ones
+        std::vector<uint32_t> remaining_triangles(vertices_count, 0);
+        for (size_t i = 0; i < triangles_count * 3; ++i)
+        {
+            ++remaining_triangles[indices[i]];
+        }
+        std::vector<uint32_t> first_triangle(vertices_count + 1, 0);
+        for (size_t vertex = 0; vertex < vertices_count; ++vertex)
+        {
+            first_triangle[vertex + 1] = first_triangle[vertex] + remaining_triangles[vertex];
+        }
+        std::vector<uint32_t> vertex_triangles(triangles_count * 3);
+        {
+            std::vector<uint32_t> fill(first_triangle.begin(), first_triangle.end() - 1);
+            for (size_t i = 0; i < triangles_count * 3; ++i)
+            {
+                vertex_triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        std::vector<int32_t> cache_position(vertices_count, -1);
+        std::vector<float> vertex_score(vertices_count);
+        for (size_t vertex = 0; vertex < vertices_count; ++vertex)
+        {
+            vertex_score[vertex] = get_vertex_score(s_table, -1, remaining_triangles[vertex]);
+        }
+        std::vector<bool> emitted(triangles_count, false);
+        uint32_t best_triangle = 0;
+        float best_score = -1.0f;
+        for (size_t triangle = 0; triangle < triangles_count; ++triangle)
+        {
+            const uint32_t* corners = indices + triangle * 3;
+            const float score = vertex_score[corners[0]] + vertex_score[corners[1]] + vertex_score[corners[2]];
+            if (score > best_score)
+            {
+                best_score = score;
+                best_triangle = static_cast<uint32_t>(triangle);
+            }
+        }
+
+        std::vector<uint32_t> output(triangles_count * 3);
+        // Room for the 3 vertices pushed in front before the cache is truncated
+        uint32_t cache[cache_size + 3];
+        uint32_t new_cache[cache_size + 3];
+        size_t cache_count = 0;
+        size_t input_cursor = 0;
+        for (size_t emitted_count = 0; emitted_count < triangles_count; ++emitted_count)
+        {
+            if (best_triangle == no_triangle)
+            {
+                // Nothing in the cache has triangles left: continue from the next unemitted one in input order
+                while (emitted[input_cursor])
+                {
+                    ++input_cursor;
+                }
+                best_triangle = static_cast<uint32_t>(input_cursor);
+            }
+
+            const uint32_t corners[3] = { indices[best_triangle * 3], indices[best_triangle * 3 + 1], indices[best_triangle * 3 + 2] };
+            std::memcpy(output.data() + emitted_count * 3, corners, sizeof(corners));
+            emitted[best_triangle] = true;
+
+            size_t new_cache_count = 0;
+            for (const uint32_t vertex : corners)
+            {
+                // Moves the triangle past the vertex's remaining ones
+                uint32_t* triangles = vertex_triangles.data() + first_triangle[vertex];
+                const uint32_t last = --remaining_triangles[vertex];
+                std::swap(*std::find(triangles, triangles + last, best_triangle), triangles[last]);
+
+                if (std::find(new_cache, new_cache + new_cache_count, vertex) == new_cache + new_cache_count)
+                {
+                    new_cache[new_cache_count++] = vertex;
+                }
+            }
+            for (size_t i = 0; i < cache_count; ++i)
+            {
+                const uint32_t vertex = cache[i];
+                if (vertex != corners[0] && vertex != corners[1] && vertex != corners[2])
+                {
+                    new_cache[new_cache_count++] = vertex;
+                }
+            }
+
+            // Rescore everything that was or is in the cache; only their triangles can change score
+            for (size_t i = 0; i < new_cache_count; ++i)
+            {
+                const uint32_t vertex = new_cache[i];
+                cache_position[vertex] = i < cache_size ? static_cast<int32_t>(i) : -1;
+                vertex_score[vertex] = get_vertex_score(s_table, cache_position[vertex], remaining_triangles[vertex]);
+            }
+            best_triangle = no_triangle;
+            best_score = -1.0f;
+            for (size_t i = 0; i < new_cache_count; ++i)
+            {
+                const uint32_t vertex = new_cache[i];
+                const uint32_t* triangles = vertex_triangles.data() + first_triangle[vertex];
+                for (uint32_t t = 0; t < remaining_triangles[vertex]; ++t)
+                {
+                    const uint32_t triangle = triangles[t];
+                    const uint32_t* triangle_corners = indices + triangle * 3;
+                    const float score = vertex_score[triangle_corners[0]] + vertex_score[triangle_corners[1]] + vertex_score[triangle_corners[2]];
+                    if (score > best_score)
+                    {
+                        best_score = score;
+                        best_triangle = triangle;
+                    }
+                }
+            }
+
+            cache_count = std::min(new_cache_count, cache_size);
+            std::memcpy(cache, new_cache, cache_count * sizeof(uint32_t));
+        }
+
+        std::memcpy(indices, output.data(), output.size() * sizeof(uint32_t));
+    }
+
+    size_t optimize_vertex_fetch(void* vertices, const size_t vertices_count, const size_t vertex_size, uint32_t* indices, const size_t indices_count)
+    {
+        constexpr uint32_t unused = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> remap(vertices_count, unused);
+        uint32_t next_vertex = 0;
+        for (size_t i = 0; i < indices_count; ++i)
+        {
+            uint32_t& new_index = remap[indices[i]];
+            if (new_index == unused)
+            {
+                new_index = next_vertex++;
+            }
+            indices[i] = new_index;
+        }
+
+        std::vector<uint8_t> reordered(static_cast<size_t>(next_vertex) * vertex_size);
+        const uint8_t* source = static_cast<const uint8_t*>(vertices);
+        for (size_t vertex = 0; vertex < vertices_count; ++vertex)
+        {
+            if (remap[vertex] != unused)
+            {
+                std::memcpy(reordered.data() + remap[vertex] * vertex_size, source + vertex * vertex_size, vertex_size);
+            }
+        }
+        std::memcpy(vertices, reordered.data(), reordered.size());
+        return next_vertex;
+    }
+
+    float compute_acmr(const uint32_t* indices, const size_t indices_count, const size_t vertices_count, const size_t cache_size)
+    {
+        const size_t triangles_count = indices_count / 3;
+        if (triangles_count == 0 || cache_size == 0)
+        {
+            return 0.0f;
+        }
+
+        // A vertex is cached while fewer than cache_size misses happened since it was last loaded
+        std::vector<size_t> loaded_at(vertices_count, 0);
+        size_t misses = 0;
+        for (size_t i = 0; i < triangles_count * 3; ++i)
+        {
+            const uint32_t vertex = indices[i];
+            if (loaded_at[vertex] == 0 || misses - loaded_at[vertex] >= cache_size)
+            {
+                ++misses;
+                loaded_at[vertex] = misses;
+            }
+        }
+        return static_cast<float>(misses) / static_cast<float>(triangles_count);
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace GraphicsEngine {
+    // Reorders the triangles of an indexed triangle list so consecutive triangles reuse the
+    // vertices still in the GPU's post-transform cache (Forsyth's linear-speed algorithm,
+    // tuned for a 32 entry LRU cache, which also does well on smaller FIFO caches).
+    void optimize_vertex_cache(uint32_t* indices, const size_t indices_count, const size_t vertices_count);
+
+    // Stores the vertices in the order the indices first reference them, so vertex fetch
+    // walks the buffer forwards, and remaps the indices. Unreferenced vertices are dropped;
+    // returns the new vertices count. Run it after optimize_vertex_cache.
+    size_t optimize_vertex_fetch(void* vertices, const size_t vertices_count, const size_t vertex_size, uint32_t* indices, const size_t indices_count);
+
+    // Average cache miss ratio: vertex shader invocations per triangle with a FIFO
+    // post-transform cache of cache_size entries. 3 is the worst case, 0.5 the ideal for a regular grid.
+    float compute_acmr(const uint32_t* indices, const size_t indices_count, const size_t vertices_count, const size_t cache_size = 16);
+}
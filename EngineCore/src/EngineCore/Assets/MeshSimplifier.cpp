@@ -0,0 +1,401 @@
+#include "MeshSimplifier.hpp"
+
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <unordered_set>
+#include <vector>
+
+namespace GraphicsEngine {
+    namespace {
+        // Sum of squared distances to a set of planes, as the upper triangle of a symmetric 4x4
+        // matrix, weighted by the planes' triangle areas so the error can be averaged by weight
+        struct Quadric
+        {
+            double a00 = 0.0, a01 = 0.0, a02 = 0.0, a03 = 0.0;
+            double a11 = 0.0, a12 = 0.0, a13 = 0.0;
+            double a22 = 0.0, a23 = 0.0;
+            double a33 = 0.0;
+            double weight = 0.0;
+
+            void add_plane(const glm::dvec3& normal, const double distance, const double plane_weight)
+            {
+                a00 += plane_weight * normal.x * normal.x;
+                a01 += plane_weight * normal.x * normal.y;
+                a02 += plane_weight * normal.x * normal.z;
+                a03 += plane_weight * normal.x * distance;
+                a11 += plane_weight * normal.y * normal.y;
+                a12 += plane_weight * normal.y * normal.z;
+                a13 += plane_weight * normal.y * distance;
+                a22 += plane_weight * normal.z * normal.z;
+                a23 += plane_weight * normal.z * distance;
+                a33 += plane_weight * distance * distance;
+                weight += plane_weight;
+            }
+
+            Quadric& operator+=(const Quadric& other)
+            {
+                a00 += other.a00; a01 += other.a01; a02 += other.a02; a03 += other.a03;
+                a11 += other.a11; a12 += other.a12; a13 += other.a13;
+                a22 += other.a22; a23 += other.a23;
+                a33 += other.a33;
+                weight += other.weight;
+                return *this;
+            }
+
+            // Mean squared distance of the point to the planes
+            double evaluate(const glm::dvec3& p) const
+            {
+                const double sum = a00 * p.x * p.x + 2.0 * a01 * p.x * p.y + 2.0 * a02 * p.x * p.z + 2.0 * a03 * p.x
+                                 + a11 * p.y * p.y + 2.0 * a12 * p.y * p.z + 2.0 * a13 * p.y
+                                 + a22 * p.z * p.z + 2.0 * a23 * p.z
+                                 + a33;
+                return weight > 0.0 ? std::max(sum, 0.0) / weight : 0.0;
+            }
+        };
+
+        struct Collapse
+        {
+            uint32_t from;
+            uint32_t to;
+            double cost;
+        };
+
+        class Simplifier
+        {
+        public:
+            Simplifier(const float* positions, const size_t positions_stride, const size_t vertices_count, const uint32_t* indices, const size_t indices_count)
+            {
+                m_positions.resize(vertices_count);
+                for (size_t vertex = 0; vertex < vertices_count; ++vertex)
+                {
+                    const float* position = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(positions) + vertex * positions_stride);
+                    // Adding zero turns -0 into +0, so welding compares the bits of equal positions
+                    m_positions[vertex] = glm::vec3(position[0], position[1], position[2]) + 0.0f;
+                }
+                weld_positions();
+
+                m_triangles.reserve(indices_count);
+                for (size_t i = 0; i + 2 < indices_count; i += 3)
+                {
+                    const uint32_t a = indices[i];
+                    const uint32_t b = indices[i + 1];
+                    const uint32_t c = indices[i + 2];
+                    if (m_wedges[a] != m_wedges[b] && m_wedges[b] != m_wedges[c] && m_wedges[a] != m_wedges[c])
+                    {
+                        m_triangles.insert(m_triangles.end(), { a, b, c });
+                    }
+                }
+                m_alive.assign(m_triangles.size() / 3, true);
+                m_alive_count = m_triangles.size() / 3;
+
+                lock_borders();
+                build_quadrics();
+            }
+
+            void simplify(const size_t target_triangles_count, const double max_cost)
+            {
+                std::vector<Collapse> collapses;
+                std::vector<bool> touched(m_positions.size());
+                while (m_alive_count > target_triangles_count)
+                {
+                    // Collapses in one pass don't share vertices, so their costs stay valid within it
+                    collect_collapses(collapses);
+                    std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+                    std::fill(touched.begin(), touched.end(), false);
+
+                    size_t applied = 0;
+                    for (const Collapse& collapse : collapses)
+                    {
+                        if (collapse.cost > max_cost || m_alive_count <= target_triangles_count)
+                        {
+                            break;
+                        }
+                        const uint32_t from = m_wedges[collapse.from];
+                        const uint32_t to = m_wedges[collapse.to];
+                        if (touched[from] || touched[to] || !can_collapse(collapse.from, collapse.to))
+                        {
+                            continue;
+                        }
+                        apply_collapse(collapse.from, collapse.to);
+                        m_max_cost = std::max(m_max_cost, collapse.cost);
+                        touched[from] = true;
+                        touched[to] = true;
+                        ++applied;
+                    }
+                    if (applied == 0)
+                    {
+                        break;
+                    }
+                }
+            }
+
+            size_t write(uint32_t* destination) const
+            {
+                size_t count = 0;
+                for (size_t triangle = 0; triangle < m_alive.size(); ++triangle)
+                {
+                    if (m_alive[triangle])
+                    {
+                        std::memcpy(destination + count, m_triangles.data() + triangle * 3, 3 * sizeof(uint32_t));
+                        count += 3;
+                    }
+                }
+                return count;
+            }
+
+            size_t get_alive_count() const { return m_alive_count; }
+            double get_max_cost() const { return m_max_cost; }
+
+        private:
+            std::vector<glm::vec3> m_positions;
+            // Vertex -> first vertex at the same position; quadrics, locks and adjacency are per wedge
+            std::vector<uint32_t> m_wedges;
+            std::vector<bool> m_locked;
+            std::vector<Quadric> m_quadrics;
+            // Triangles around each wedge, including ones that died since; filtered with m_alive
+            std::vector<std::vector<uint32_t>> m_wedge_triangles;
+            std::vector<uint32_t> m_triangles;
+            std::vector<bool> m_alive;
+            size_t m_alive_count = 0;
+            double m_max_cost = 0.0;
+            mutable std::vector<uint32_t> m_shared_neighbors;
+
+            void weld_positions()
+            {
+                std::vector<uint32_t> order(m_positions.size());
+                std::iota(order.begin(), order.end(), 0u);
+                const auto less = [this](const uint32_t a, const uint32_t b) {
+                    return std::memcmp(&m_positions[a], &m_positions[b], sizeof(glm::vec3)) < 0;
+                };
+                std::sort(order.begin(), order.end(), less);
+
+                m_wedges.resize(m_positions.size());
+                m_locked.assign(m_positions.size(), false);
+                for (size_t begin = 0; begin < order.size();)
+                {
+                    size_t end = begin + 1;
+                    while (end < order.size() && !less(order[begin], order[end]))
+                    {
+                        ++end;
+                    }
+                    const uint32_t wedge = *std::min_element(order.begin() + begin, order.begin() + end);
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        m_wedges[order[i]] = wedge;
+                    }
+                    // Moving one vertex of a seam would tear it open
+                    m_locked[wedge] = end - begin > 1;
+                    begin = end;
+                }
+            }
+
+            // An edge used once is on a border, more than twice or twice in the same direction is non-manifold
+            void lock_borders()
+            {
+                std::unordered_set<uint64_t> edges;
+                std::unordered_set<uint64_t> repeated_edges;
+                edges.reserve(m_triangles.size());
+                const auto key = [](const uint32_t a, const uint32_t b) { return (static_cast<uint64_t>(a) << 32) | b; };
+                for (size_t i = 0; i < m_triangles.size(); i += 3)
+                {
+                    for (size_t corner = 0; corner < 3; ++corner)
+                    {
+                        const uint64_t edge = key(m_wedges[m_triangles[i + corner]], m_wedges[m_triangles[i + (corner + 1) % 3]]);
+                        if (!edges.insert(edge).second)
+                        {
+                            repeated_edges.insert(edge);
+                        }
+                    }
+                }
+                for (const uint64_t edge : edges)
+                {
+                    const uint32_t a = static_cast<uint32_t>(edge >> 32);
+                    const uint32_t b = static_cast<uint32_t>(edge);
+                    if (!edges.contains(key(b, a)) || repeated_edges.contains(edge))
+                    {
+                        m_locked[a] = true;
+                        m_locked[b] = true;
+                    }
+                }
+            }
+
+            void build_quadrics()
+            {
+                m_quadrics.assign(m_positions.size(), Quadric());
+                m_wedge_triangles.assign(m_positions.size(), {});
+                for (size_t triangle = 0; triangle < m_alive.size(); ++triangle)
+                {
+                    const uint32_t* corners = m_triangles.data() + triangle * 3;
+                    const glm::dvec3 p0(m_positions[corners[0]]);
+                    const glm::dvec3 normal = glm::cross(glm::dvec3(m_positions[corners[1]]) - p0, glm::dvec3(m_positions[corners[2]]) - p0);
+                    const double length = glm::length(normal);
+                    Quadric plane;
+                    if (length > 0.0)
+                    {
+                        const glm::dvec3 unit_normal = normal / length;
+                        plane.add_plane(unit_normal, -glm::dot(unit_normal, p0), length * 0.5);
+                    }
+                    for (size_t corner = 0; corner < 3; ++corner)
+                    {
+                        const uint32_t wedge = m_wedges[corners[corner]];
+                        m_quadrics[wedge] += plane;
+                        m_wedge_triangles[wedge].push_back(static_cast<uint32_t>(triangle));
+                    }
+                }
+            }
+
+            void collect_collapses(std::vector<Collapse>& collapses) const
+            {
+                collapses.clear();
+                for (size_t triangle = 0; triangle < m_alive.size(); ++triangle)
+                {
+                    if (!m_alive[triangle])
+                    {
+                        continue;
+                    }
+                    const uint32_t* corners = m_triangles.data() + triangle * 3;
+                    for (size_t corner = 0; corner < 3; ++corner)
+                    {
+                        const uint32_t a = corners[corner];
+                        const uint32_t b = corners[(corner + 1) % 3];
+                        if (!m_locked[m_wedges[a]])
+                        {
+                            collapses.push_back({ a, b, get_cost(a, b) });
+                        }
+                        if (!m_locked[m_wedges[b]])
+                        {
+                            collapses.push_back({ b, a, get_cost(b, a) });
+                        }
+                    }
+                }
+            }
+
+            double get_cost(const uint32_t from, const uint32_t to) const
+            {
+                Quadric quadric = m_quadrics[m_wedges[from]];
+                quadric += m_quadrics[m_wedges[to]];
+                return quadric.evaluate(glm::dvec3(m_positions[to]));
+            }
+
+            // Rejects collapses that fold a triangle over, leave one with zero area or make the surface non-manifold
+            bool can_collapse(const uint32_t from, const uint32_t to) const
+            {
+                const uint32_t from_wedge = m_wedges[from];
+                const uint32_t to_wedge = m_wedges[to];
+                size_t shared_triangles = 0;
+                for (const uint32_t triangle : m_wedge_triangles[from_wedge])
+                {
+                    if (!m_alive[triangle])
+                    {
+                        continue;
+                    }
+                    const uint32_t* corners = m_triangles.data() + triangle * 3;
+                    const bool has_to_wedge = m_wedges[corners[0]] == to_wedge || m_wedges[corners[1]] == to_wedge || m_wedges[corners[2]] == to_wedge;
+                    if (has_to_wedge)
+                    {
+                        // Removed by the collapse, unless it reaches the position through another seam vertex
+                        if (corners[0] != to && corners[1] != to && corners[2] != to)
+                        {
+                            return false;
+                        }
+                        ++shared_triangles;
+                        continue;
+                    }
+
+                    glm::vec3 before[3];
+                    glm::vec3 after[3];
+                    for (size_t corner = 0; corner < 3; ++corner)
+                    {
+                        before[corner] = m_positions[corners[corner]];
+                        after[corner] = corners[corner] == from ? m_positions[to] : before[corner];
+                    }
+                    const glm::vec3 normal_before = glm::cross(before[1] - before[0], before[2] - before[0]);
+                    const glm::vec3 normal_after = glm::cross(after[1] - after[0], after[2] - after[0]);
+                    // Turning further than ~75 degrees either folds the triangle over or stands it on its edge
+                    if (glm::dot(normal_before, normal_after) <= 0.25f * glm::length(normal_before) * glm::length(normal_after))
+                    {
+                        return false;
+                    }
+                }
+
+                // Link condition: the two vertices may only share the neighbors opposite the edge
+                std::vector<uint32_t>& shared_neighbors = m_shared_neighbors;
+                shared_neighbors.clear();
+                for (const uint32_t triangle : m_wedge_triangles[to_wedge])
+                {
+                    if (!m_alive[triangle])
+                    {
+                        continue;
+                    }
+                    const uint32_t* corners = m_triangles.data() + triangle * 3;
+                    for (size_t corner = 0; corner < 3; ++corner)
+                    {
+                        const uint32_t neighbor = m_wedges[corners[corner]];
+                        if (neighbor != to_wedge && neighbor != from_wedge &&
+                            std::find(shared_neighbors.begin(), shared_neighbors.end(), neighbor) == shared_neighbors.end() &&
+                            is_neighbor(from_wedge, neighbor))
+                        {
+                            shared_neighbors.push_back(neighbor);
+                        }
+                    }
+                }
+                return shared_neighbors.size() <= shared_triangles;
+            }
+
+            bool is_neighbor(const uint32_t wedge, const uint32_t other) const
+            {
+                for (const uint32_t triangle : m_wedge_triangles[wedge])
+                {
+                    const uint32_t* corners = m_triangles.data() + triangle * 3;
+                    if (m_alive[triangle] && (m_wedges[corners[0]] == other || m_wedges[corners[1]] == other || m_wedges[corners[2]] == other))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            void apply_collapse(const uint32_t from, const uint32_t to)
+            {
+                const uint32_t from_wedge = m_wedges[from];
+                const uint32_t to_wedge = m_wedges[to];
+                for (const uint32_t triangle : m_wedge_triangles[from_wedge])
+                {
+                    if (!m_alive[triangle])
+                    {
+                        continue;
+                    }
+                    uint32_t* corners = m_triangles.data() + triangle * 3;
+                    if (corners[0] == to || corners[1] == to || corners[2] == to)
+                    {
+                        m_alive[triangle] = false;
+                        --m_alive_count;
+                        continue;
+                    }
+                    std::replace(corners, corners + 3, from, to);
+                    m_wedge_triangles[to_wedge].push_back(triangle);
+                }
+                m_wedge_triangles[from_wedge].clear();
+                m_quadrics[to_wedge] += m_quadrics[from_wedge];
+            }
+        };
+    }
+
+    size_t simplify_mesh(const float* positions, const size_t positions_stride, const size_t vertices_count,
+                         const uint32_t* indices, const size_t indices_count, uint32_t* destination,
+                         const size_t target_indices_count, const float max_error, float* error)
+    {
+        Simplifier simplifier(positions, positions_stride, vertices_count, indices, indices_count);
+        simplifier.simplify(target_indices_count / 3, static_cast<double>(max_error) * max_error);
+        if (error)
+        {
+            *error = static_cast<float>(std::sqrt(simplifier.get_max_cost()));
+        }
+        return simplifier.write(destination);
+    }
+}
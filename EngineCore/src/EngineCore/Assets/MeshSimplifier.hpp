@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace GraphicsEngine {
+    // Reduces an indexed triangle list by collapsing edges in order of their quadric error
+    // (Garland and Heckbert). Vertices only ever move onto other existing vertices, so the
+    // result indexes the same vertex buffer and can be stored as another LOD of it. Vertices
+    // on open borders and on attribute seams (positions shared by several vertices) stay put.
+    // positions_stride is in bytes. Collapses stop once the result has target_indices_count
+    // indices or fewer, or when the cheapest remaining one would move the surface further than
+    // max_error. destination needs room for indices_count; returns the indices written.
+    // error, if not null, receives the largest collapse error: the area-weighted RMS distance from
+    // a moved vertex to the original planes around it, in position units.
+    size_t simplify_mesh(const float* positions, const size_t positions_stride, const size_t vertices_count,
+                         const uint32_t* indices, const size_t indices_count, uint32_t* destination,
+                         const size_t target_indices_count, const float max_error, float* error = nullptr);
+}
@@ -0,0 +1,138 @@
+#define ENGINE_LOG_MODULE ECS
+
+#include "Archetype.hpp"
+#include "EngineCore/Debug.hpp"
+
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+namespace GraphicsEngine {
+    size_t ComponentTypes::register_type(const ComponentInfo& info)
+    {
+        std::lock_guard lock(s_register_mutex);
+        if (s_types_count >= max_component_types)
+        {
+            LOG_CRITICAL("ComponentTypes: more than {} component types", max_component_types);
+            std::abort();
+        }
+        s_infos[s_types_count] = info;
+        return s_types_count++;
+    }
+
+    static size_t align_up(const size_t value, const size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    Archetype::Archetype(const ComponentMask mask, PoolAllocator& chunk_pool)
+        : m_mask(mask), m_chunk_pool(chunk_pool)
+    {
+        size_t row_size = 0;
+        for (size_t id = 0; id < max_component_types; ++id)
+        {
+            if (has_component(id))
+            {
+                row_size += ComponentTypes::get_info(id).size;
+            }
+        }
+        // A tag-only archetype still gets a sensible chunk length
+        m_chunk_capacity = row_size > 0 ? chunk_size / row_size : chunk_size / sizeof(Entity);
+        if (m_chunk_capacity == 0)
+        {
+            LOG_CRITICAL("Archetype: a row of {} bytes does not fit in a {} byte chunk", row_size, chunk_size);
+            std::abort();
+        }
+
+        // Alignment padding between columns may not fit; shrink until it does
+        while (true)
+        {
+            size_t offset = 0;
+            for (size_t id = 0; id < max_component_types; ++id)
+            {
+                if (!has_component(id))
+                {
+                    continue;
+                }
+                const ComponentInfo& info = ComponentTypes::get_info(id);
+                offset = align_up(offset, info.alignment);
+                m_columns[id] = { info.size, offset };
+                offset += info.size * m_chunk_capacity;
+            }
+            if (offset <= chunk_size)
+            {
+                break;
+            }
+            if (m_chunk_capacity == 1)
+            {
+                LOG_CRITICAL("Archetype: a row of {} bytes and its alignment padding do not fit in a {} byte chunk", row_size, chunk_size);
+                std::abort();
+            }
+            --m_chunk_capacity;
+        }
+    }
+
+    Archetype::~Archetype()
+    {
+        for (void* chunk : m_chunks)
+        {
+            m_chunk_pool.free(chunk);
+        }
+    }
+
+    size_t Archetype::push_back(const Entity entity)
+    {
+        const size_t row = m_entities.size();
+        if (row / m_chunk_capacity >= m_chunks.size())
+        {
+            m_chunks.push_back(m_chunk_pool.allocate());
+        }
+        m_entities.push_back(entity);
+        return row;
+    }
+
+    Entity Archetype::swap_remove(const size_t row)
+    {
+        const size_t last_row = m_entities.size() - 1;
+        Entity moved_entity;
+        if (row != last_row)
+        {
+            for (size_t id = 0; id < max_component_types; ++id)
+            {
+                if (has_component(id))
+                {
+                    std::memcpy(get_component(id, row), get_component(id, last_row), m_columns[id].size);
+                }
+            }
+            moved_entity = m_entities[last_row];
+            m_entities[row] = moved_entity;
+        }
+        m_entities.pop_back();
+
+        // Keep one spare chunk so an entity oscillating at a chunk boundary does not reallocate
+        while (m_chunks.size() > get_chunks_count() + 1)
+        {
+            m_chunk_pool.free(m_chunks.back());
+            m_chunks.pop_back();
+        }
+        return moved_entity;
+    }
+
+    void* Archetype::get_component(const size_t component_id, const size_t row)
+    {
+        const Column& column = m_columns[component_id];
+        std::byte* chunk = static_cast<std::byte*>(m_chunks[row / m_chunk_capacity]);
+        return chunk + column.offset + (row % m_chunk_capacity) * column.size;
+    }
+
+    void* Archetype::get_column(const size_t component_id, const size_t chunk)
+    {
+        return static_cast<std::byte*>(m_chunks[chunk]) + m_columns[component_id].offset;
+    }
+
+    size_t Archetype::get_chunk_rows(const size_t chunk) const
+    {
+        const size_t first_row = chunk * m_chunk_capacity;
+        return std::min(m_chunk_capacity, m_entities.size() - first_row);
+    }
+}
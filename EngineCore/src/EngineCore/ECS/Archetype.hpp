@@ -0,0 +1,111 @@
+#pragma once
+
+#include "EngineCore/Memory/PoolAllocator.hpp"
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace GraphicsEngine {
+    struct Entity
+    {
+        static constexpr uint32_t invalid_index = ~0u;
+
+        uint32_t index = invalid_index;
+        uint32_t generation = 0;
+
+        bool is_valid() const { return index != invalid_index; }
+        bool operator==(const Entity&) const = default;
+    };
+
+    static constexpr size_t max_component_types = 64;
+    // Bit i is set when the archetype has the component with id i
+    using ComponentMask = uint64_t;
+
+    struct ComponentInfo
+    {
+        size_t size;
+        size_t alignment;
+    };
+
+    // Assigns every component type a small id on first use, from any thread. Components are
+    // plain data: rows are moved between chunks and archetypes with memcpy.
+    class ComponentTypes
+    {
+    public:
+        template <typename Component>
+        static size_t get_id()
+        {
+            static_assert(std::is_trivially_copyable_v<Component> && std::is_trivially_destructible_v<Component>,
+                          "Components must be trivially copyable and destructible");
+            static_assert(alignof(Component) <= alignof(std::max_align_t), "Component is over-aligned");
+            static const size_t id = register_type({ sizeof(Component), alignof(Component) });
+            return id;
+        }
+
+        template <typename Component>
+        static ComponentMask get_mask() { return ComponentMask(1) << get_id<Component>(); }
+
+        static const ComponentInfo& get_info(const size_t id) { return s_infos[id]; }
+
+    private:
+        static size_t register_type(const ComponentInfo& info);
+
+        // Fixed storage so get_info never reads a vector another thread's registration is reallocating
+        static inline std::array<ComponentInfo, max_component_types> s_infos;
+        static inline size_t s_types_count = 0;
+        static inline std::mutex s_register_mutex;
+    };
+
+    // All entities with exactly the same set of components. Rows live in fixed-size chunks;
+    // inside a chunk every component has its own contiguous array (structure of arrays), so
+    // a query touching two components streams through two arrays and nothing else.
+    // Rows stay dense: removing one moves the last row into its place.
+    class Archetype
+    {
+    public:
+        static constexpr size_t chunk_size = 16 * 1024;
+
+        // Chunks are taken from chunk_pool, whose blocks must be chunk_size bytes
+        Archetype(const ComponentMask mask, PoolAllocator& chunk_pool);
+        ~Archetype();
+        Archetype(const Archetype&) = delete;
+        Archetype& operator=(const Archetype&) = delete;
+
+        // Appends a row with uninitialized components and returns its index
+        size_t push_back(const Entity entity);
+        // Moves the last row into row; returns the entity that moved, or an invalid one if row was the last
+        Entity swap_remove(const size_t row);
+
+        bool has_component(const size_t component_id) const { return (m_mask >> component_id) & 1; }
+        void* get_component(const size_t component_id, const size_t row);
+        void* get_column(const size_t component_id, const size_t chunk);
+
+        ComponentMask get_mask() const { return m_mask; }
+        Entity get_entity(const size_t row) const { return m_entities[row]; }
+        const Entity* get_entities(const size_t chunk) const { return m_entities.data() + chunk * m_chunk_capacity; }
+        size_t get_entities_count() const { return m_entities.size(); }
+        size_t get_chunk_capacity() const { return m_chunk_capacity; }
+        size_t get_chunks_count() const { return (m_entities.size() + m_chunk_capacity - 1) / m_chunk_capacity; }
+        size_t get_chunk_rows(const size_t chunk) const;
+
+    private:
+        struct Column
+        {
+            size_t size;
+            size_t offset;
+        };
+
+        ComponentMask m_mask;
+        // Indexed by component id; only entries for components of this archetype are meaningful
+        std::array<Column, max_component_types> m_columns{};
+        size_t m_chunk_capacity = 0;
+        PoolAllocator& m_chunk_pool;
+        std::vector<void*> m_chunks;
+        std::vector<Entity> m_entities;
+    };
+}
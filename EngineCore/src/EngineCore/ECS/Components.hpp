@@ -0,0 +1,16 @@
+#pragma once
+
+#include "TransformSystem.hpp"
+
+namespace GraphicsEngine {
+    // The entity's node in the scene's TransformSystem
+    struct TransformNode
+    {
+        TransformId id = invalid_transform;
+    };
+
+    // Drawn with the scene's quad mesh at its transform's world matrix
+    struct Renderable
+    {
+    };
+}
@@ -0,0 +1,100 @@
+#define ENGINE_LOG_MODULE ECS
+
+#include "LodSystem.hpp"
+#include "EngineCore/Debug.hpp"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+
+namespace GraphicsEngine {
+    void LodSystem::add(const TransformId id, const AABB& local_bounds)
+    {
+        if (id >= m_entries.size())
+        {
+            m_entries.resize(static_cast<size_t>(id) + 1);
+        }
+
+        Entry& entry = m_entries[id];
+        entry.local_center = (local_bounds.min + local_bounds.max) * 0.5f;
+        entry.local_radius = glm::length(local_bounds.max - local_bounds.min) * 0.5f;
+        entry.registered = true;
+    }
+
+    void LodSystem::remove(const TransformId id)
+    {
+        if (id >= m_entries.size() || !m_entries[id].registered)
+        {
+            LOG_ERROR("LodSystem: removing an unregistered transform {}", id);
+            return;
+        }
+        m_entries[id] = Entry();
+    }
+
+    void LodSystem::set_lod_errors(const std::vector<float>& errors)
+    {
+        m_errors.assign(errors.begin(), errors.begin() + static_cast<std::ptrdiff_t>(std::min(errors.size(), max_lods)));
+        if (m_errors.empty())
+        {
+            m_errors.push_back(0.0f);
+        }
+        // find_lod stops at the first LOD that is too coarse, so errors must not decrease
+        for (size_t lod = 1; lod < m_errors.size(); ++lod)
+        {
+            m_errors[lod] = std::max(m_errors[lod], m_errors[lod - 1]);
+        }
+    }
+
+    uint8_t LodSystem::find_lod(const float pixels_per_error, const float threshold) const
+    {
+        uint8_t lod = 0;
+        while (lod + 1u < m_errors.size() && m_errors[lod + 1] * pixels_per_error <= threshold)
+        {
+            ++lod;
+        }
+        return lod;
+    }
+
+    void LodSystem::select(const TransformSystem& transforms, const glm::mat4& view_projection, const float viewport_height,
+                           const TransformId* ids, const size_t count, uint8_t* lods)
+    {
+        if (m_errors.size() == 1)
+        {
+            std::fill(lods, lods + count, uint8_t(0));
+            return;
+        }
+
+        // Clip-space y per world unit, whatever the view's rotation; dividing by w gives NDC, half the height gives pixels
+        const float pixels_per_unit = glm::length(glm::vec3(view_projection[0][1], view_projection[1][1], view_projection[2][1])) * viewport_height * 0.5f;
+        for (size_t i = 0; i < count; ++i)
+        {
+            Entry& entry = m_entries[ids[i]];
+            const glm::mat4& world = transforms.get_world_matrix(ids[i]);
+            const float w = (view_projection * (world * glm::vec4(entry.local_center, 1.0f))).w;
+            if (w <= 0.0f)
+            {
+                // Behind the camera or around it: the finest LOD
+                entry.lod = 0;
+                lods[i] = 0;
+                continue;
+            }
+
+            const float scale = std::max({ glm::length(glm::vec3(world[0])), glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2])) });
+            const float pixels_per_error = entry.local_radius * scale * pixels_per_unit / w;
+
+            uint8_t lod = std::min<uint8_t>(entry.lod, static_cast<uint8_t>(m_errors.size() - 1));
+            const uint8_t coarser_lod = find_lod(pixels_per_error, m_threshold * (1.0f - m_hysteresis));
+            const uint8_t finer_lod = find_lod(pixels_per_error, m_threshold * (1.0f + m_hysteresis));
+            if (coarser_lod > lod)
+            {
+                lod = coarser_lod;
+            }
+            else if (finer_lod < lod)
+            {
+                lod = finer_lod;
+            }
+            entry.lod = lod;
+            lods[i] = lod;
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "TransformSystem.hpp"
+#include "EngineCore/Rendering/Bounds.hpp"
+
+#include <glm/mat4x4.hpp>
+
+#include <vector>
+#include <cstdint>
+
+namespace GraphicsEngine {
+    // Picks a level of detail per transform from its projected size: the coarsest LOD whose
+    // error, projected to pixels, stays under the threshold. An object only switches once the
+    // other LOD is hysteresis (a fraction of the threshold) past the switching point, so objects
+    // sitting at that distance don't flicker between two LODs. Every transform draws the LOD
+    // chain given to set_lod_errors().
+    class LodSystem
+    {
+    public:
+        static constexpr size_t max_lods = 8;
+
+        LodSystem() = default;
+        LodSystem(const LodSystem&) = delete;
+        LodSystem& operator=(const LodSystem&) = delete;
+
+        void add(const TransformId id, const AABB& local_bounds);
+        void remove(const TransformId id);
+
+        // Finest first, relative to the radius of the local bounds (see MeshLod::error)
+        void set_lod_errors(const std::vector<float>& errors);
+        size_t get_lods_count() const { return m_errors.size(); }
+
+        void set_threshold(const float pixels) { m_threshold = pixels; }
+        float get_threshold() const { return m_threshold; }
+        void set_hysteresis(const float hysteresis) { m_hysteresis = hysteresis; }
+
+        // Writes the LOD of each of the count ids to lods. Distinct ids can be selected on several threads at once
+        void select(const TransformSystem& transforms, const glm::mat4& view_projection, const float viewport_height,
+                    const TransformId* ids, const size_t count, uint8_t* lods);
+
+    private:
+        struct Entry
+        {
+            glm::vec3 local_center = glm::vec3(0.0f);
+            float local_radius = 0.0f;
+            uint8_t lod = 0;
+            bool registered = false;
+        };
+
+        std::vector<Entry> m_entries;
+        std::vector<float> m_errors = { 0.0f };
+        float m_threshold = 1.0f;
+        float m_hysteresis = 0.25f;
+
+        uint8_t find_lod(const float pixels_per_error, const float threshold) const;
+    };
+}
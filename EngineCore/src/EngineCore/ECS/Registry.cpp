@@ -0,0 +1,106 @@
+#define ENGINE_LOG_MODULE ECS
+
+#include "Registry.hpp"
+#include "EngineCore/Debug.hpp"
+
+namespace GraphicsEngine {
+    Registry::Registry()
+        : m_chunk_pool(Archetype::chunk_size, 16)
+    {
+        // Archetype 0 holds entities without components
+        get_or_create_archetype(0);
+    }
+
+    size_t Registry::get_or_create_archetype(const ComponentMask mask)
+    {
+        const auto it = m_archetype_indices.find(mask);
+        if (it != m_archetype_indices.end())
+        {
+            return it->second;
+        }
+
+        m_archetypes.push_back(std::make_unique<Archetype>(mask, m_chunk_pool));
+        m_archetype_indices.emplace(mask, m_archetypes.size() - 1);
+        return m_archetypes.size() - 1;
+    }
+
+    Entity Registry::allocate_entity(const size_t archetype_index)
+    {
+        Entity entity;
+        if (!m_free_indices.empty())
+        {
+            entity.index = m_free_indices.back();
+            m_free_indices.pop_back();
+        }
+        else
+        {
+            entity.index = static_cast<uint32_t>(m_records.size());
+            m_records.emplace_back();
+        }
+
+        EntityRecord& record = m_records[entity.index];
+        entity.generation = record.generation;
+        record.archetype = static_cast<uint32_t>(archetype_index);
+        record.row = m_archetypes[archetype_index]->push_back(entity);
+        record.alive = true;
+        ++m_entities_count;
+        return entity;
+    }
+
+    Entity Registry::create_entity()
+    {
+        return allocate_entity(0);
+    }
+
+    void Registry::destroy_entity(const Entity entity)
+    {
+        if (!is_alive(entity))
+        {
+            LOG_ERROR("Registry: destroying a dead entity {}", entity.index);
+            return;
+        }
+
+        EntityRecord& record = m_records[entity.index];
+        remove_row(record.archetype, record.row);
+        record.alive = false;
+        // Handles to this slot held elsewhere become stale
+        ++record.generation;
+        m_free_indices.push_back(entity.index);
+        --m_entities_count;
+    }
+
+    bool Registry::is_alive(const Entity entity) const
+    {
+        return entity.index < m_records.size() && m_records[entity.index].alive && m_records[entity.index].generation == entity.generation;
+    }
+
+    void Registry::remove_row(const size_t archetype_index, const size_t row)
+    {
+        const Entity moved_entity = m_archetypes[archetype_index]->swap_remove(row);
+        if (moved_entity.is_valid())
+        {
+            m_records[moved_entity.index].row = row;
+        }
+    }
+
+    void Registry::move_entity(const Entity entity, const size_t archetype_index)
+    {
+        EntityRecord& record = m_records[entity.index];
+        Archetype& source = *m_archetypes[record.archetype];
+        Archetype& destination = *m_archetypes[archetype_index];
+
+        const size_t row = destination.push_back(entity);
+        const ComponentMask shared_mask = source.get_mask() & destination.get_mask();
+        for (size_t id = 0; id < max_component_types; ++id)
+        {
+            if ((shared_mask >> id) & 1)
+            {
+                std::memcpy(destination.get_component(id, row), source.get_component(id, record.row), ComponentTypes::get_info(id).size);
+            }
+        }
+
+        remove_row(record.archetype, record.row);
+        record.archetype = static_cast<uint32_t>(archetype_index);
+        record.row = row;
+    }
+}
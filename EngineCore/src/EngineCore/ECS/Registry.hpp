@@ -0,0 +1,158 @@
+#pragma once
+
+#include "Archetype.hpp"
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstring>
+
+namespace GraphicsEngine {
+    // Owns entities and their components, grouped by archetype. Adding or removing a
+    // component moves the entity's row to the matching archetype; every operation on a
+    // single entity is O(1) apart from the first use of a new component combination.
+    // Structural changes (create/destroy/add/remove) must not happen inside each()/each_chunk().
+    class Registry
+    {
+    public:
+        Registry();
+        Registry(const Registry&) = delete;
+        Registry& operator=(const Registry&) = delete;
+
+        Entity create_entity();
+
+        template <typename... Components>
+        Entity create_entity(const Components&... components)
+        {
+            const Entity entity = allocate_entity(get_or_create_archetype((ComponentTypes::get_mask<Components>() | ... | 0)));
+            (write_component(entity, components), ...);
+            return entity;
+        }
+
+        void destroy_entity(const Entity entity);
+        bool is_alive(const Entity entity) const;
+
+        // Replaces the component if the entity already has one
+        template <typename Component>
+        void add_component(const Entity entity, const Component& component)
+        {
+            if (!is_alive(entity))
+            {
+                return;
+            }
+            const ComponentMask mask = m_archetypes[m_records[entity.index].archetype]->get_mask();
+            const ComponentMask component_mask = ComponentTypes::get_mask<Component>();
+            if (!(mask & component_mask))
+            {
+                move_entity(entity, get_or_create_archetype(mask | component_mask));
+            }
+            write_component(entity, component);
+        }
+
+        template <typename Component>
+        void remove_component(const Entity entity)
+        {
+            if (!is_alive(entity))
+            {
+                return;
+            }
+            const ComponentMask mask = m_archetypes[m_records[entity.index].archetype]->get_mask();
+            const ComponentMask component_mask = ComponentTypes::get_mask<Component>();
+            if (mask & component_mask)
+            {
+                move_entity(entity, get_or_create_archetype(mask & ~component_mask));
+            }
+        }
+
+        // nullptr when the entity is dead or lacks the component. The pointer is invalidated by structural changes
+        template <typename Component>
+        Component* get_component(const Entity entity)
+        {
+            if (!is_alive(entity))
+            {
+                return nullptr;
+            }
+            const EntityRecord& record = m_records[entity.index];
+            Archetype& archetype = *m_archetypes[record.archetype];
+            const size_t component_id = ComponentTypes::get_id<Component>();
+            if (!archetype.has_component(component_id))
+            {
+                return nullptr;
+            }
+            return static_cast<Component*>(archetype.get_component(component_id, record.row));
+        }
+
+        template <typename Component>
+        bool has_component(const Entity entity) const
+        {
+            return is_alive(entity) && (m_archetypes[m_records[entity.index].archetype]->get_mask() & ComponentTypes::get_mask<Component>());
+        }
+
+        // Calls function(rows_count, entities, Components*... columns) once per chunk of every
+        // archetype that has all of Components
+        template <typename... Components, typename Function>
+        void each_chunk(Function&& function)
+        {
+            const ComponentMask required_mask = (ComponentTypes::get_mask<Components>() | ... | 0);
+            for (const std::unique_ptr<Archetype>& archetype : m_archetypes)
+            {
+                if ((archetype->get_mask() & required_mask) != required_mask)
+                {
+                    continue;
+                }
+                for (size_t chunk = 0; chunk < archetype->get_chunks_count(); ++chunk)
+                {
+                    function(archetype->get_chunk_rows(chunk), archetype->get_entities(chunk),
+                             static_cast<Components*>(archetype->get_column(ComponentTypes::get_id<Components>(), chunk))...);
+                }
+            }
+        }
+
+        // Calls function(Components&...) for every entity that has all of Components
+        template <typename... Components, typename Function>
+        void each(Function&& function)
+        {
+            each_chunk<Components...>([&function](const size_t rows_count, const Entity*, Components*... columns) {
+                for (size_t row = 0; row < rows_count; ++row)
+                {
+                    function(columns[row]...);
+                }
+            });
+        }
+
+        size_t get_entities_count() const { return m_entities_count; }
+        size_t get_archetypes_count() const { return m_archetypes.size(); }
+        // Chunks of every archetype come from one pool, so chunks freed by one archetype are reused by others
+        const MemoryStats& get_chunk_pool_stats() const { return m_chunk_pool.get_stats(); }
+
+    private:
+        struct EntityRecord
+        {
+            uint32_t generation = 0;
+            uint32_t archetype = 0;
+            size_t row = 0;
+            bool alive = false;
+        };
+
+        size_t get_or_create_archetype(const ComponentMask mask);
+        Entity allocate_entity(const size_t archetype_index);
+        // Moves the entity's row into another archetype, keeping the components both share
+        void move_entity(const Entity entity, const size_t archetype_index);
+        void remove_row(const size_t archetype_index, const size_t row);
+
+        template <typename Component>
+        void write_component(const Entity entity, const Component& component)
+        {
+            const EntityRecord& record = m_records[entity.index];
+            std::memcpy(m_archetypes[record.archetype]->get_component(ComponentTypes::get_id<Component>(), record.row), &component, sizeof(Component));
+        }
+
+        // Declared first so it outlives the archetypes that return chunks to it
+        PoolAllocator m_chunk_pool;
+        std::vector<std::unique_ptr<Archetype>> m_archetypes;
+        std::unordered_map<ComponentMask, size_t> m_archetype_indices;
+        std::vector<EntityRecord> m_records;
+        std::vector<uint32_t> m_free_indices;
+        size_t m_entities_count = 0;
+    };
+}
@@ -0,0 +1,394 @@
+#define ENGINE_LOG_MODULE ECS
+
+#include "TransformSystem.hpp"
+#include "EngineCore/Debug.hpp"
+#include "EngineCore/Memory/ScratchScope.hpp"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define ENGINE_TRANSFORMS_SSE 1
+#include <xmmintrin.h>
+// Non-temporal stores into m_world_matrices need 16-byte aligned columns
+static_assert(__STDCPP_DEFAULT_NEW_ALIGNMENT__ >= 16);
+#endif
+
+#include <algorithm>
+
+namespace GraphicsEngine {
+    namespace {
+#ifdef ENGINE_TRANSFORMS_SSE
+        // Builds the local matrices of lanes [first, first + 4) as position * rotation * scale
+        void compute_local_matrices(const float* position_x, const float* position_y, const float* position_z,
+                                    const float* rotation_x, const float* rotation_y, const float* rotation_z, const float* rotation_w,
+                                    const float* scale_x, const float* scale_y, const float* scale_z,
+                                    glm::mat4* out)
+        {
+            const __m128 x = _mm_loadu_ps(rotation_x);
+            const __m128 y = _mm_loadu_ps(rotation_y);
+            const __m128 z = _mm_loadu_ps(rotation_z);
+            const __m128 w = _mm_loadu_ps(rotation_w);
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 two = _mm_set1_ps(2.0f);
+
+            const __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+            const __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+            const __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+            const __m128 sx = _mm_loadu_ps(scale_x);
+            const __m128 sy = _mm_loadu_ps(scale_y);
+            const __m128 sz = _mm_loadu_ps(scale_z);
+
+            __m128 c0x = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+            __m128 c0y = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+            __m128 c0z = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+            __m128 c0w = _mm_setzero_ps();
+
+            __m128 c1x = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+            __m128 c1y = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+            __m128 c1z = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+            __m128 c1w = _mm_setzero_ps();
+
+            __m128 c2x = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+            __m128 c2y = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+            __m128 c2z = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+            __m128 c2w = _mm_setzero_ps();
+
+            __m128 c3x = _mm_loadu_ps(position_x);
+            __m128 c3y = _mm_loadu_ps(position_y);
+            __m128 c3z = _mm_loadu_ps(position_z);
+            __m128 c3w = one;
+
+            // Lane-major registers -> one column per lane
+            _MM_TRANSPOSE4_PS(c0x, c0y, c0z, c0w);
+            _MM_TRANSPOSE4_PS(c1x, c1y, c1z, c1w);
+            _MM_TRANSPOSE4_PS(c2x, c2y, c2z, c2w);
+            _MM_TRANSPOSE4_PS(c3x, c3y, c3z, c3w);
+
+            const __m128 columns[4][4] = {
+                { c0x, c1x, c2x, c3x },
+                { c0y, c1y, c2y, c3y },
+                { c0z, c1z, c2z, c3z },
+                { c0w, c1w, c2w, c3w },
+            };
+            for (size_t lane = 0; lane < 4; ++lane)
+            {
+                float* matrix = &out[lane][0][0];
+                for (size_t column = 0; column < 4; ++column)
+                {
+                    _mm_storeu_ps(matrix + column * 4, columns[lane][column]);
+                }
+            }
+        }
+
+        // World matrices are written once and read by the renderer much later, so they bypass the cache
+        void store_matrix(const glm::mat4& matrix, glm::mat4& out)
+        {
+            for (size_t column = 0; column < 4; ++column)
+            {
+                _mm_stream_ps(&out[column][0], _mm_loadu_ps(&matrix[column][0]));
+            }
+        }
+
+        void multiply(const glm::mat4& parent, const glm::mat4& local, glm::mat4& out)
+        {
+            const __m128 p0 = _mm_loadu_ps(&parent[0][0]);
+            const __m128 p1 = _mm_loadu_ps(&parent[1][0]);
+            const __m128 p2 = _mm_loadu_ps(&parent[2][0]);
+            const __m128 p3 = _mm_loadu_ps(&parent[3][0]);
+            for (size_t column = 0; column < 4; ++column)
+            {
+                const __m128 l = _mm_loadu_ps(&local[column][0]);
+                __m128 result = _mm_mul_ps(p0, _mm_shuffle_ps(l, l, _MM_SHUFFLE(0, 0, 0, 0)));
+                result = _mm_add_ps(result, _mm_mul_ps(p1, _mm_shuffle_ps(l, l, _MM_SHUFFLE(1, 1, 1, 1))));
+                result = _mm_add_ps(result, _mm_mul_ps(p2, _mm_shuffle_ps(l, l, _MM_SHUFFLE(2, 2, 2, 2))));
+                result = _mm_add_ps(result, _mm_mul_ps(p3, _mm_shuffle_ps(l, l, _MM_SHUFFLE(3, 3, 3, 3))));
+                _mm_stream_ps(&out[column][0], result);
+            }
+        }
+
+        void finish_stores()
+        {
+            _mm_sfence();
+        }
+#else
+        void compute_local_matrices(const float* position_x, const float* position_y, const float* position_z,
+                                    const float* rotation_x, const float* rotation_y, const float* rotation_z, const float* rotation_w,
+                                    const float* scale_x, const float* scale_y, const float* scale_z,
+                                    glm::mat4* out)
+        {
+            for (size_t lane = 0; lane < 4; ++lane)
+            {
+                glm::mat4 matrix = glm::mat4_cast(glm::quat(rotation_w[lane], rotation_x[lane], rotation_y[lane], rotation_z[lane]));
+                matrix[0] *= scale_x[lane];
+                matrix[1] *= scale_y[lane];
+                matrix[2] *= scale_z[lane];
+                matrix[3] = glm::vec4(position_x[lane], position_y[lane], position_z[lane], 1.0f);
+                out[lane] = matrix;
+            }
+        }
+
+        void store_matrix(const glm::mat4& matrix, glm::mat4& out)
+        {
+            out = matrix;
+        }
+
+        void multiply(const glm::mat4& parent, const glm::mat4& local, glm::mat4& out)
+        {
+            out = parent * local;
+        }
+
+        void finish_stores()
+        {
+        }
+#endif
+    }
+
+    void TransformSystem::resize_storage(const size_t count)
+    {
+        const size_t padded_count = (count + lanes_count - 1) / lanes_count * lanes_count;
+        if (padded_count == m_dirty.size())
+        {
+            return;
+        }
+
+        for (std::vector<float>* values : { &m_position_x, &m_position_y, &m_position_z,
+                                            &m_rotation_x, &m_rotation_y, &m_rotation_z, &m_rotation_w,
+                                            &m_scale_x, &m_scale_y, &m_scale_z })
+        {
+            values->resize(padded_count, 0.0f);
+        }
+        m_parents.resize(padded_count, no_parent);
+        m_dirty.resize(padded_count, 0);
+        m_alive.resize(padded_count, 0);
+        m_world_matrices.resize(padded_count, glm::mat4(1.0f));
+        m_ids.resize(padded_count, invalid_transform);
+    }
+
+    TransformId TransformSystem::create(const Transform& local, const TransformId parent)
+    {
+        uint32_t parent_index = no_parent;
+        if (parent != invalid_transform)
+        {
+            if (!is_valid(parent))
+            {
+                LOG_ERROR("TransformSystem: creating a transform under an invalid parent {}", parent);
+                return invalid_transform;
+            }
+            parent_index = m_dense_indices[parent];
+        }
+
+        TransformId id;
+        if (!m_free_ids.empty())
+        {
+            id = m_free_ids.back();
+            m_free_ids.pop_back();
+        }
+        else
+        {
+            id = static_cast<TransformId>(m_dense_indices.size());
+            m_dense_indices.push_back(no_parent);
+        }
+
+        // Appending keeps parents ahead of their children
+        const uint32_t index = static_cast<uint32_t>(m_count++);
+        resize_storage(m_count);
+        m_dense_indices[id] = index;
+        m_ids[index] = id;
+        m_parents[index] = parent_index;
+        m_alive[index] = 1;
+        set_local(id, local);
+        return id;
+    }
+
+    void TransformSystem::destroy(const TransformId id)
+    {
+        if (!is_valid(id))
+        {
+            LOG_ERROR("TransformSystem: destroying an invalid transform {}", id);
+            return;
+        }
+        const uint32_t index = m_dense_indices[id];
+        m_alive[index] = 0;
+        m_dirty[index] = 0;
+        ++m_destroyed_count;
+    }
+
+    bool TransformSystem::is_valid(const TransformId id) const
+    {
+        return id < m_dense_indices.size() && m_dense_indices[id] != no_parent && m_alive[m_dense_indices[id]];
+    }
+
+    Transform TransformSystem::get_local(const TransformId id) const
+    {
+        const uint32_t index = m_dense_indices[id];
+        return { glm::vec3(m_position_x[index], m_position_y[index], m_position_z[index]),
+                 glm::quat(m_rotation_w[index], m_rotation_x[index], m_rotation_y[index], m_rotation_z[index]),
+                 glm::vec3(m_scale_x[index], m_scale_y[index], m_scale_z[index]) };
+    }
+
+    void TransformSystem::set_local(const TransformId id, const Transform& local)
+    {
+        set_position(id, local.position);
+        set_rotation(id, local.rotation);
+        set_scale(id, local.scale);
+    }
+
+    void TransformSystem::set_position(const TransformId id, const glm::vec3& position)
+    {
+        const uint32_t index = m_dense_indices[id];
+        m_position_x[index] = position.x;
+        m_position_y[index] = position.y;
+        m_position_z[index] = position.z;
+        mark_dirty(index);
+    }
+
+    void TransformSystem::set_rotation(const TransformId id, const glm::quat& rotation)
+    {
+        const uint32_t index = m_dense_indices[id];
+        m_rotation_x[index] = rotation.x;
+        m_rotation_y[index] = rotation.y;
+        m_rotation_z[index] = rotation.z;
+        m_rotation_w[index] = rotation.w;
+        mark_dirty(index);
+    }
+
+    void TransformSystem::set_scale(const TransformId id, const glm::vec3& scale)
+    {
+        const uint32_t index = m_dense_indices[id];
+        m_scale_x[index] = scale.x;
+        m_scale_y[index] = scale.y;
+        m_scale_z[index] = scale.z;
+        mark_dirty(index);
+    }
+
+    void TransformSystem::mark_dirty(const uint32_t index)
+    {
+        m_dirty[index] = 1;
+        m_first_dirty = std::min<size_t>(m_first_dirty, index);
+    }
+
+    void TransformSystem::compact()
+    {
+        // Parents precede children, so one forward pass both kills orphaned descendants and remaps parents
+        ScratchScope scratch;
+        uint32_t* remap = scratch.allocate_array<uint32_t>(m_count);
+        std::fill(remap, remap + m_count, no_parent);
+        size_t write = 0;
+        size_t first_moved = m_count;
+        for (size_t read = 0; read < m_count; ++read)
+        {
+            const uint32_t parent = m_parents[read];
+            const bool alive = m_alive[read] && (parent == no_parent || remap[parent] != no_parent);
+            if (!alive)
+            {
+                m_dense_indices[m_ids[read]] = no_parent;
+                m_free_ids.push_back(m_ids[read]);
+                continue;
+            }
+
+            remap[read] = static_cast<uint32_t>(write);
+            if (write != read)
+            {
+                first_moved = std::min(first_moved, write);
+                for (std::vector<float>* values : { &m_position_x, &m_position_y, &m_position_z,
+                                                    &m_rotation_x, &m_rotation_y, &m_rotation_z, &m_rotation_w,
+                                                    &m_scale_x, &m_scale_y, &m_scale_z })
+                {
+                    (*values)[write] = (*values)[read];
+                }
+                m_dirty[write] = m_dirty[read];
+                m_alive[write] = 1;
+                m_world_matrices[write] = m_world_matrices[read];
+                m_ids[write] = m_ids[read];
+            }
+            m_parents[write] = parent == no_parent ? no_parent : remap[parent];
+            m_dense_indices[m_ids[write]] = static_cast<uint32_t>(write);
+            ++write;
+        }
+
+        m_count = write;
+        m_destroyed_count = 0;
+        // Dirty nodes may have moved towards the front
+        m_first_dirty = std::min(m_first_dirty, std::min(m_count, first_moved));
+        resize_storage(m_count);
+        // Clear the padding lanes the shrink may have kept
+        for (size_t index = m_count; index < m_dirty.size(); ++index)
+        {
+            m_dirty[index] = 0;
+            m_alive[index] = 0;
+            m_parents[index] = no_parent;
+        }
+    }
+
+    void TransformSystem::update()
+    {
+        if (m_destroyed_count > 0)
+        {
+            compact();
+        }
+
+        m_updated_count = 0;
+        m_updated_ids.clear();
+        if (m_first_dirty >= m_count)
+        {
+            m_first_dirty = no_parent;
+            return;
+        }
+
+        // Nodes ahead of the first dirty one cannot be affected: their parents come even earlier
+        const size_t first_block = m_first_dirty / lanes_count * lanes_count;
+        m_first_dirty = no_parent;
+
+        const uint32_t* parents = m_parents.data();
+        uint8_t* dirty = m_dirty.data();
+        glm::mat4* world_matrices = m_world_matrices.data();
+
+        for (size_t index = first_block; index < m_count; ++index)
+        {
+            const uint32_t parent = parents[index];
+            dirty[index] |= parent != no_parent && dirty[parent];
+        }
+
+        glm::mat4 local_matrices[lanes_count];
+        size_t updated_count = 0;
+        for (size_t first = first_block; first < m_count; first += lanes_count)
+        {
+            uint32_t block_dirty;
+            std::memcpy(&block_dirty, &dirty[first], sizeof(block_dirty));
+            if (block_dirty == 0)
+            {
+                continue;
+            }
+
+            compute_local_matrices(&m_position_x[first], &m_position_y[first], &m_position_z[first],
+                                   &m_rotation_x[first], &m_rotation_y[first], &m_rotation_z[first], &m_rotation_w[first],
+                                   &m_scale_x[first], &m_scale_y[first], &m_scale_z[first],
+                                   local_matrices);
+
+            // In order: a parent in the same block is finished before its children
+            for (size_t lane = 0; lane < lanes_count; ++lane)
+            {
+                const size_t index = first + lane;
+                if (!dirty[index])
+                {
+                    continue;
+                }
+                const uint32_t parent = parents[index];
+                if (parent == no_parent)
+                {
+                    store_matrix(local_matrices[lane], world_matrices[index]);
+                }
+                else
+                {
+                    multiply(world_matrices[parent], local_matrices[lane], world_matrices[index]);
+                }
+                dirty[index] = 0;
+                m_updated_ids.push_back(m_ids[index]);
+                ++updated_count;
+            }
+        }
+        finish_stores();
+        m_updated_count = updated_count;
+    }
+}
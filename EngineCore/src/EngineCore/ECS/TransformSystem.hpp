@@ -0,0 +1,87 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace GraphicsEngine {
+    using TransformId = uint32_t;
+    static constexpr TransformId invalid_transform = ~0u;
+
+    struct Transform
+    {
+        glm::vec3 position = glm::vec3(0.0f);
+        glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        glm::vec3 scale = glm::vec3(1.0f);
+    };
+
+    // Parent/child hierarchy of transforms. Local transforms are stored as one array per
+    // float (structure of arrays), ordered so that every parent comes before its children.
+    // update() then walks the arrays once: dirtiness flows from parents to children, and
+    // local matrices are built four at a time with SSE. Blocks without dirty nodes are skipped,
+    // so a static scene costs one pass over the dirty flags.
+    class TransformSystem
+    {
+    public:
+        TransformSystem() = default;
+        TransformSystem(const TransformSystem&) = delete;
+        TransformSystem& operator=(const TransformSystem&) = delete;
+
+        TransformId create(const Transform& local, const TransformId parent = invalid_transform);
+        // Also destroys every descendant. Storage is compacted by the next update()
+        void destroy(const TransformId id);
+        bool is_valid(const TransformId id) const;
+
+        Transform get_local(const TransformId id) const;
+        void set_local(const TransformId id, const Transform& local);
+        void set_position(const TransformId id, const glm::vec3& position);
+        void set_rotation(const TransformId id, const glm::quat& rotation);
+        void set_scale(const TransformId id, const glm::vec3& scale);
+
+        // Valid after update()
+        const glm::mat4& get_world_matrix(const TransformId id) const { return m_world_matrices[m_dense_indices[id]]; }
+
+        // Recomputes the world matrices of dirty nodes and their descendants
+        void update();
+
+        size_t get_count() const { return m_count - m_destroyed_count; }
+        // World matrices recomputed by the last update()
+        size_t get_updated_count() const { return m_updated_count; }
+        // Ids whose world matrix changed in the last update(), parents before children
+        const std::vector<TransformId>& get_updated_ids() const { return m_updated_ids; }
+
+    private:
+        static constexpr uint32_t no_parent = ~0u;
+        static constexpr size_t lanes_count = 4;
+
+        void resize_storage(const size_t count);
+        void compact();
+        void mark_dirty(const uint32_t index);
+
+        size_t m_count = 0;
+
+        // Dense storage, padded to a multiple of lanes_count
+        std::vector<float> m_position_x, m_position_y, m_position_z;
+        std::vector<float> m_rotation_x, m_rotation_y, m_rotation_z, m_rotation_w;
+        std::vector<float> m_scale_x, m_scale_y, m_scale_z;
+        std::vector<uint32_t> m_parents;
+        std::vector<uint8_t> m_dirty;
+        std::vector<uint8_t> m_alive;
+        std::vector<glm::mat4> m_world_matrices;
+        std::vector<TransformId> m_ids;
+
+        // TransformId -> dense index
+        std::vector<uint32_t> m_dense_indices;
+        std::vector<TransformId> m_free_ids;
+
+        size_t m_destroyed_count = 0;
+        size_t m_updated_count = 0;
+        std::vector<TransformId> m_updated_ids;
+        // Lowest dense index marked dirty since the last update, no_parent when none
+        size_t m_first_dirty = no_parent;
+    };
+}
@@ -0,0 +1,78 @@
+#define ENGINE_LOG_MODULE ECS
+
+#include "VisibilitySystem.hpp"
+#include "EngineCore/Rendering/Frustum.hpp"
+#include "EngineCore/Debug.hpp"
+
+namespace GraphicsEngine {
+    void VisibilitySystem::add(const TransformId id, const AABB& local_bounds)
+    {
+        if (id >= m_entries.size())
+        {
+            m_entries.resize(static_cast<size_t>(id) + 1);
+        }
+
+        Entry& entry = m_entries[id];
+        if (entry.registered)
+        {
+            entry.local_bounds = local_bounds;
+            return;
+        }
+        entry.local_bounds = local_bounds;
+        entry.registered = true;
+        m_pending_ids.push_back(id);
+    }
+
+    void VisibilitySystem::remove(const TransformId id)
+    {
+        if (id >= m_entries.size() || !m_entries[id].registered)
+        {
+            LOG_ERROR("VisibilitySystem: removing an unregistered transform {}", id);
+            return;
+        }
+
+        Entry& entry = m_entries[id];
+        if (entry.proxy != BoundingVolumeHierarchy::null_node)
+        {
+            m_bvh.destroy_proxy(entry.proxy);
+        }
+        else
+        {
+            std::erase(m_pending_ids, id);
+        }
+        entry = Entry();
+    }
+
+    void VisibilitySystem::update(const TransformSystem& transforms)
+    {
+        m_reinserted_count = 0;
+
+        for (const TransformId id : m_pending_ids)
+        {
+            Entry& entry = m_entries[id];
+            entry.proxy = m_bvh.create_proxy(transform_aabb(entry.local_bounds, transforms.get_world_matrix(id)), id);
+        }
+        m_pending_ids.clear();
+
+        for (const TransformId id : transforms.get_updated_ids())
+        {
+            if (id >= m_entries.size() || m_entries[id].proxy == BoundingVolumeHierarchy::null_node)
+            {
+                continue;
+            }
+            const Entry& entry = m_entries[id];
+            if (m_bvh.move_proxy(entry.proxy, transform_aabb(entry.local_bounds, transforms.get_world_matrix(id))))
+            {
+                ++m_reinserted_count;
+            }
+        }
+    }
+
+    void VisibilitySystem::cull(const glm::mat4& view_projection, std::vector<TransformId>& visible)
+    {
+        visible.clear();
+        m_bvh.query(Frustum(view_projection), visible);
+        m_visible_count = visible.size();
+        m_culled_count = m_bvh.get_proxies_count() - m_visible_count;
+    }
+}
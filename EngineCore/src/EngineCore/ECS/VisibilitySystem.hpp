@@ -0,0 +1,57 @@
+#pragma once
+
+#include "TransformSystem.hpp"
+#include "EngineCore/Rendering/Bounds.hpp"
+#include "EngineCore/Rendering/BoundingVolumeHierarchy.hpp"
+
+#include <glm/mat4x4.hpp>
+
+#include <vector>
+#include <cstdint>
+
+namespace GraphicsEngine {
+    // World-space bounds of renderable transforms, kept in a BVH. update() only touches
+    // the transforms the TransformSystem recomputed, and most of those stay inside their
+    // fat box, so a static or slowly moving scene does not rebuild anything.
+    class VisibilitySystem
+    {
+    public:
+        VisibilitySystem() = default;
+        VisibilitySystem(const VisibilitySystem&) = delete;
+        VisibilitySystem& operator=(const VisibilitySystem&) = delete;
+
+        // The proxy is created by the next update()
+        void add(const TransformId id, const AABB& local_bounds);
+        // Must be called before the transform is destroyed
+        void remove(const TransformId id);
+
+        // Call after TransformSystem::update()
+        void update(const TransformSystem& transforms);
+
+        // Replaces visible with the ids whose bounds intersect the view-projection's frustum
+        void cull(const glm::mat4& view_projection, std::vector<TransformId>& visible);
+
+        size_t get_count() const { return m_bvh.get_proxies_count() + m_pending_ids.size(); }
+        size_t get_visible_count() const { return m_visible_count; }
+        size_t get_culled_count() const { return m_culled_count; }
+        // Proxies re-inserted by the last update()
+        size_t get_reinserted_count() const { return m_reinserted_count; }
+        int get_tree_height() const { return m_bvh.get_height(); }
+
+    private:
+        struct Entry
+        {
+            AABB local_bounds;
+            int32_t proxy = BoundingVolumeHierarchy::null_node;
+            bool registered = false;
+        };
+
+        std::vector<Entry> m_entries;
+        std::vector<TransformId> m_pending_ids;
+        BoundingVolumeHierarchy m_bvh;
+
+        size_t m_visible_count = 0;
+        size_t m_culled_count = 0;
+        size_t m_reinserted_count = 0;
+    };
+}
@@ -0,0 +1,247 @@
+#define ENGINE_LOG_MODULE Jobs
+
+#include "JobSystem.hpp"
+#include "EngineCore/Debug.hpp"
+#include "EngineCore/Profiling/Profiler.hpp"
+
+namespace GraphicsEngine {
+    static thread_local int s_thread_index = -1;
+
+    JobSystem::JobSystem(unsigned int workers_count)
+    {
+        if (workers_count == default_workers_count)
+        {
+            const unsigned int hardware_threads = std::thread::hardware_concurrency();
+            workers_count = hardware_threads > 1 ? hardware_threads - 1 : 0;
+        }
+
+        m_threads.resize(static_cast<size_t>(workers_count) + 1);
+        for (size_t index = 0; index < m_threads.size(); ++index)
+        {
+            m_threads[index] = std::make_unique<ThreadData>();
+            m_threads[index]->jobs = std::make_unique<Job[]>(jobs_ring_size);
+            m_threads[index]->random_state = static_cast<uint32_t>(index) * 2654435761u + 1;
+        }
+
+        s_thread_index = 0;
+        m_workers.reserve(workers_count);
+        for (unsigned int index = 1; index <= workers_count; ++index)
+        {
+            m_workers.emplace_back(&JobSystem::worker_loop, this, index);
+        }
+        LOG_INFO("Job system started with {} worker threads", workers_count);
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            m_stop = true;
+        }
+        m_wake_condition.notify_all();
+        for (std::thread& worker : m_workers)
+        {
+            worker.join();
+        }
+        s_thread_index = -1;
+    }
+
+    int JobSystem::get_thread_index()
+    {
+        return s_thread_index;
+    }
+
+    bool JobSystem::is_outside_job_threads(JobCounter* dependency)
+    {
+        if (s_thread_index >= 0)
+        {
+            return false;
+        }
+
+        LOG_ERROR("JobSystem: job created from a thread outside the job system, running it in place");
+        while (dependency && !dependency->is_done())
+        {
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    Job* JobSystem::allocate_job()
+    {
+        ThreadData& thread = *m_threads[s_thread_index];
+        while (true)
+        {
+            // Slots still in flight are skipped rather than waited for: one of them may be a job
+            // further up this thread's own stack (a job waiting on the jobs it creates)
+            for (size_t attempt = 0; attempt < jobs_ring_size; ++attempt)
+            {
+                Job* job = &thread.jobs[thread.next_job++ % jobs_ring_size];
+                if (job->finished.load(std::memory_order_acquire))
+                {
+                    job->finished.store(false, std::memory_order_relaxed);
+                    job->next = nullptr;
+                    return job;
+                }
+            }
+            // Every slot is in flight: help until one frees up
+            if (!execute_next())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void JobSystem::schedule(Job* job, JobCounter* dependency)
+    {
+        if (job->counter)
+        {
+            job->counter->m_value.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (dependency)
+        {
+            dependency->lock();
+            if (dependency->m_value.load(std::memory_order_relaxed) != 0)
+            {
+                job->next = dependency->m_continuations;
+                dependency->m_continuations = job;
+                dependency->unlock();
+                return;
+            }
+            dependency->unlock();
+        }
+        push(job);
+    }
+
+    void JobSystem::push(Job* job)
+    {
+        // Counted before the push so a thief never takes the count below zero
+        m_queued_count.fetch_add(1, std::memory_order_seq_cst);
+        if (!m_threads[s_thread_index]->queue.push(job))
+        {
+            // Queue full: running in place is always correct, only less parallel
+            m_queued_count.fetch_sub(1, std::memory_order_relaxed);
+            execute(*job);
+            return;
+        }
+
+        // Pairs with the increment of m_sleeping_count in worker_loop: either the worker sees the
+        // queued job, or this thread sees the sleeping worker
+        if (m_sleeping_count.load(std::memory_order_seq_cst) > 0)
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            m_wake_condition.notify_one();
+        }
+    }
+
+    bool JobSystem::execute_next()
+    {
+        ThreadData& thread = *m_threads[s_thread_index];
+        Job* job = thread.queue.pop();
+        if (!job && m_threads.size() > 1)
+        {
+            // xorshift picks where to start looking, so thieves do not all pile onto one victim
+            uint32_t& state = thread.random_state;
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+
+            const size_t threads_count = m_threads.size();
+            const size_t first_victim = state % threads_count;
+            for (size_t i = 0; i < threads_count && !job; ++i)
+            {
+                const size_t victim = (first_victim + i) % threads_count;
+                if (victim != static_cast<size_t>(s_thread_index))
+                {
+                    job = m_threads[victim]->queue.steal();
+                }
+            }
+            if (job)
+            {
+                m_stolen_count.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        if (!job)
+        {
+            return false;
+        }
+        m_queued_count.fetch_sub(1, std::memory_order_relaxed);
+        execute(*job);
+        return true;
+    }
+
+    void JobSystem::execute(Job& job)
+    {
+        job.function(job);
+        m_executed_count.fetch_add(1, std::memory_order_relaxed);
+
+        // The slot may be reused as soon as finished is set
+        JobCounter* counter = job.counter;
+        job.finished.store(true, std::memory_order_release);
+        if (!counter)
+        {
+            return;
+        }
+
+        counter->lock();
+        Job* continuations = nullptr;
+        if (counter->m_value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            continuations = counter->m_continuations;
+            counter->m_continuations = nullptr;
+        }
+        counter->unlock();
+        // The counter may be gone from here on
+
+        while (continuations)
+        {
+            Job* next = continuations->next;
+            push(continuations);
+            continuations = next;
+        }
+    }
+
+    void JobSystem::wait(JobCounter& counter)
+    {
+        while (!counter.is_done())
+        {
+            // Threads outside the job system have no queue to help from
+            if (s_thread_index < 0 || !execute_next())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void JobSystem::worker_loop(const unsigned int index)
+    {
+        s_thread_index = static_cast<int>(index);
+        Profiler::set_thread_name("Worker " + std::to_string(index));
+
+        unsigned int idle_rounds = 0;
+        while (!m_stop.load(std::memory_order_relaxed))
+        {
+            if (execute_next())
+            {
+                idle_rounds = 0;
+                continue;
+            }
+
+            // Spin briefly: jobs tend to come in bursts within a frame
+            if (++idle_rounds < 64)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_sleep_mutex);
+            m_sleeping_count.fetch_add(1, std::memory_order_seq_cst);
+            m_wake_condition.wait(lock, [this]() {
+                return m_stop.load(std::memory_order_relaxed) || m_queued_count.load(std::memory_order_seq_cst) > 0;
+            });
+            m_sleeping_count.fetch_sub(1, std::memory_order_relaxed);
+            idle_rounds = 0;
+        }
+    }
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "WorkStealingQueue.hpp"
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace GraphicsEngine {
+    class JobSystem;
+
+    struct Job
+    {
+        static constexpr size_t payload_size = 88;
+
+        // Runs and destroys the callable stored in payload
+        void (*function)(Job& job) = nullptr;
+        class JobCounter* counter = nullptr;
+        // Next continuation waiting on the same counter
+        Job* next = nullptr;
+        // Cleared while the job is queued or running, so its ring slot is not reused
+        std::atomic<bool> finished = true;
+        alignas(std::max_align_t) std::byte payload[payload_size];
+    };
+
+    // Counts unfinished jobs. A counter must outlive the jobs that signal it and the jobs
+    // that depend on it; JobSystem::wait() returns only once no thread touches it anymore.
+    class JobCounter
+    {
+    public:
+        JobCounter() = default;
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        uint32_t get_value() const { return m_value.load(std::memory_order_acquire); }
+        bool is_done() const { return get_value() == 0 && !m_lock.test(std::memory_order_acquire); }
+
+    private:
+        friend class JobSystem;
+
+        void lock()
+        {
+            while (m_lock.test_and_set(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+        }
+        void unlock() { m_lock.clear(std::memory_order_release); }
+
+        std::atomic<uint32_t> m_value = 0;
+        // Guards the transition to zero and the continuation list
+        std::atomic_flag m_lock;
+        Job* m_continuations = nullptr;
+    };
+
+    // Work-stealing job system. Every thread (workers and the thread that created the system)
+    // owns a deque: it pushes and pops its own jobs, and steals from a random other deque when
+    // its own is empty. Idle workers sleep until a job is pushed. Threads that wait on a counter
+    // execute jobs meanwhile, so waiting inside a job cannot deadlock.
+    // One job system may exist at a time; jobs are queued from its threads, jobs created on other
+    // threads run in place.
+    class JobSystem
+    {
+    public:
+        static constexpr unsigned int default_workers_count = ~0u;
+
+        // default_workers_count starts one worker per hardware thread besides the calling one
+        explicit JobSystem(unsigned int workers_count = default_workers_count);
+        // Outstanding jobs must have been waited for
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        // Queues function(). counter, if given, is incremented now and decremented when function
+        // returns. A job with a dependency is queued only once the dependency reaches zero.
+        template <typename Function>
+        void run(Function&& function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr)
+        {
+            using Callable = std::decay_t<Function>;
+            static_assert(sizeof(Callable) <= Job::payload_size, "job captures too much; capture a pointer instead");
+            static_assert(alignof(Callable) <= alignof(std::max_align_t), "job callable is over-aligned");
+
+            if (is_outside_job_threads(dependency))
+            {
+                function();
+                return;
+            }
+            Job* job = allocate_job();
+            new (job->payload) Callable(std::forward<Function>(function));
+            job->function = [](Job& job) {
+                Callable* callable = std::launder(reinterpret_cast<Callable*>(job.payload));
+                (*callable)();
+                callable->~Callable();
+            };
+            job->counter = counter;
+            schedule(job, dependency);
+        }
+
+        // Calls function(begin, end) over [0, count) split into chunks of at least min_chunk_size
+        // and returns when every chunk is done. The calling thread works on chunks as well.
+        template <typename Function>
+        void parallel_for(const size_t count, Function&& function, const size_t min_chunk_size = 1)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+
+            // A few chunks per thread let stealing even out uneven chunks
+            const size_t target_chunks = static_cast<size_t>(get_threads_count()) * 4;
+            const size_t chunk_size = std::max(std::max<size_t>(min_chunk_size, 1), (count + target_chunks - 1) / target_chunks);
+            if (chunk_size >= count || get_threads_count() == 1)
+            {
+                function(size_t(0), count);
+                return;
+            }
+
+            JobCounter counter;
+            auto* function_pointer = &function;
+            for (size_t begin = chunk_size; begin < count; begin += chunk_size)
+            {
+                const size_t end = std::min(count, begin + chunk_size);
+                run([function_pointer, begin, end]() { (*function_pointer)(begin, end); }, &counter);
+            }
+            // The first chunk runs here while the others are being stolen
+            function(size_t(0), std::min(count, chunk_size));
+            wait(counter);
+        }
+
+        // Executes queued jobs until counter reaches zero
+        void wait(JobCounter& counter);
+
+        unsigned int get_threads_count() const { return static_cast<unsigned int>(m_threads.size()); }
+        // 0 for the thread that created the job system, -1 outside of the job system's threads
+        static int get_thread_index();
+
+        size_t get_executed_count() const { return m_executed_count.load(std::memory_order_relaxed); }
+        size_t get_stolen_count() const { return m_stolen_count.load(std::memory_order_relaxed); }
+
+    private:
+        static constexpr size_t jobs_ring_size = 4096;
+
+        struct alignas(64) ThreadData
+        {
+            WorkStealingQueue queue;
+            std::unique_ptr<Job[]> jobs;
+            size_t next_job = 0;
+            uint32_t random_state = 0;
+        };
+
+        // True on threads outside the job system, which have no queue to push to: the job then runs in
+        // place, once dependency is done
+        bool is_outside_job_threads(JobCounter* dependency);
+        Job* allocate_job();
+        void schedule(Job* job, JobCounter* dependency);
+        void push(Job* job);
+        bool execute_next();
+        void execute(Job& job);
+        void worker_loop(const unsigned int index);
+
+        std::vector<std::unique_ptr<ThreadData>> m_threads;
+        std::vector<std::thread> m_workers;
+
+        // Jobs pushed but not yet taken; idle workers sleep while it is zero
+        std::atomic<size_t> m_queued_count = 0;
+        std::atomic<unsigned int> m_sleeping_count = 0;
+        std::mutex m_sleep_mutex;
+        std::condition_variable m_wake_condition;
+        std::atomic<bool> m_stop = false;
+
+        std::atomic<size_t> m_executed_count = 0;
+        std::atomic<size_t> m_stolen_count = 0;
+    };
+}
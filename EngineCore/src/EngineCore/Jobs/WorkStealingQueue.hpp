@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace GraphicsEngine {
+    struct Job;
+
+    // Fixed-capacity Chase-Lev deque. The owning thread pushes and pops at the bottom (LIFO,
+    // so it keeps working on hot data); other threads steal from the top. Only the steal and
+    // the pop of the last element use a compare-exchange.
+    class WorkStealingQueue
+    {
+    public:
+        static constexpr size_t capacity = 4096;
+
+        // Owner only. Returns false when full
+        bool push(Job* job)
+        {
+            const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+            const int64_t top = m_top.load(std::memory_order_acquire);
+            if (bottom - top >= static_cast<int64_t>(capacity))
+            {
+                return false;
+            }
+            m_jobs[bottom & mask].store(job, std::memory_order_relaxed);
+            // Publishes the job (and its payload) to thieves that read bottom with acquire
+            m_bottom.store(bottom + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Owner only
+        Job* pop()
+        {
+            const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+            m_bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = m_top.load(std::memory_order_relaxed);
+
+            if (top > bottom)
+            {
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            Job* job = m_jobs[bottom & mask].load(std::memory_order_relaxed);
+            if (top == bottom)
+            {
+                // Last element: race the thieves for it
+                if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    job = nullptr;
+                }
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+            return job;
+        }
+
+        // Any thread
+        Job* steal()
+        {
+            int64_t top = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+            if (top >= bottom)
+            {
+                return nullptr;
+            }
+
+            Job* job = m_jobs[top & mask].load(std::memory_order_relaxed);
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return nullptr;
+            }
+            return job;
+        }
+
+        size_t get_size() const
+        {
+            const int64_t size = m_bottom.load(std::memory_order_relaxed) - m_top.load(std::memory_order_relaxed);
+            return size > 0 ? static_cast<size_t>(size) : 0;
+        }
+
+    private:
+        static constexpr int64_t mask = static_cast<int64_t>(capacity) - 1;
+        static_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+
+        // Thieves hammer top, the owner bottom; keep them on separate cache lines
+        alignas(64) std::atomic<int64_t> m_top = 0;
+        alignas(64) std::atomic<int64_t> m_bottom = 0;
+        alignas(64) std::atomic<Job*> m_jobs[capacity] = {};
+    };
+}
@@ -0,0 +1,363 @@
+#include "EngineCore/Log.hpp"
+
+#include <spdlog/spdlog.h>
+#include <spdlog/details/os.h>
+#include <spdlog/sinks/sink.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define ENGINE_LOG_TSC
+#endif
+
+namespace GraphicsEngine {
+    namespace {
+        constexpr size_t queue_mask = Log::queue_capacity - 1;
+        static_assert((Log::queue_capacity & queue_mask) == 0, "Log queue capacity must be a power of two");
+
+        // Bounded multi-producer queue: producers claim a slot with a compare-exchange on the
+        // enqueue position; each slot's sequence tells whether it is free, written or read
+        std::unique_ptr<LogRecord[]> s_records;
+        alignas(64) std::atomic<size_t> s_enqueue_position = 0;
+        alignas(64) std::atomic<size_t> s_dequeue_position = 0;
+        alignas(64) std::atomic<size_t> s_dropped_count = 0;
+
+        std::mutex s_init_mutex;
+        unsigned int s_init_count = 0;
+        std::thread s_thread;
+        std::atomic<bool> s_stop = false;
+        std::atomic<bool> s_sleeping = false;
+        std::mutex s_wake_mutex;
+        std::condition_variable s_wake;
+        // Serializes draining between the logger thread and shutdown()
+        std::mutex s_drain_mutex;
+
+        constexpr const char* module_names[] = { "Core", "Rendering", "ECS", "Jobs", "Memory", "Profiling", "Assets" };
+        static_assert(std::size(module_names) == static_cast<size_t>(ELogModule::Count));
+
+        int64_t now_ns()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(spdlog::log_clock::now().time_since_epoch()).count();
+        }
+
+        // Producers stamp records with the cheapest clock available; the logger thread converts
+        // it to wall time. Reading the time stamp counter is several times faster than the
+        // system clock, which would otherwise dominate the cost of a log call.
+#ifdef ENGINE_LOG_TSC
+        int64_t s_origin_ticks = 0;
+        int64_t s_origin_ns = 0;
+        // Calibration pair taken at the start of each drain()
+        int64_t s_drain_ticks = 0;
+        int64_t s_drain_ns = 0;
+        double s_ticks_per_ns = 0.0;
+
+        int64_t read_timestamp()
+        {
+            return static_cast<int64_t>(__rdtsc());
+        }
+
+        void calibrate_timestamp()
+        {
+            s_drain_ticks = read_timestamp();
+            s_drain_ns = now_ns();
+            // A short interval gives a poor estimate; until then records are at most that old
+            if (s_drain_ns - s_origin_ns >= 1000000)
+            {
+                s_ticks_per_ns = static_cast<double>(s_drain_ticks - s_origin_ticks) / static_cast<double>(s_drain_ns - s_origin_ns);
+            }
+        }
+
+        int64_t timestamp_to_ns(const int64_t ticks)
+        {
+            if (s_ticks_per_ns <= 0.0)
+            {
+                return s_drain_ns;
+            }
+            return s_drain_ns - static_cast<int64_t>(static_cast<double>(s_drain_ticks - ticks) / s_ticks_per_ns);
+        }
+#else
+        int64_t read_timestamp()
+        {
+            return now_ns();
+        }
+
+        void calibrate_timestamp()
+        {
+        }
+
+        int64_t timestamp_to_ns(const int64_t ticks)
+        {
+            return ticks;
+        }
+#endif
+
+        void emit(const ELogModule module, const ELogLevel level, const int64_t time_ns, const size_t thread_id, const fmt::string_view text)
+        {
+            const auto time = spdlog::log_clock::time_point(std::chrono::duration_cast<spdlog::log_clock::duration>(std::chrono::nanoseconds(time_ns)));
+            spdlog::details::log_msg message(time, spdlog::source_loc{}, Log::get_module_name(module),
+                                             static_cast<spdlog::level::level_enum>(level), spdlog::string_view_t(text.data(), text.size()));
+            message.thread_id = thread_id;
+
+            spdlog::logger* logger = spdlog::default_logger_raw();
+            for (const spdlog::sink_ptr& sink : logger->sinks())
+            {
+                if (sink->should_log(message.level))
+                {
+                    sink->log(message);
+                }
+            }
+            if (level >= ELogLevel::Error)
+            {
+                logger->flush();
+            }
+        }
+
+        bool has_pending_record()
+        {
+            const size_t position = s_dequeue_position.load(std::memory_order_relaxed);
+            return s_records[position & queue_mask].sequence.load(std::memory_order_acquire) == position + 1;
+        }
+
+        // Writes every committed record; returns the number written
+        size_t drain()
+        {
+            std::lock_guard lock(s_drain_mutex);
+            calibrate_timestamp();
+            fmt::memory_buffer buffer;
+            size_t position = s_dequeue_position.load(std::memory_order_relaxed);
+            size_t written = 0;
+            for (;;)
+            {
+                LogRecord& record = s_records[position & queue_mask];
+                if (record.sequence.load(std::memory_order_acquire) != position + 1)
+                {
+                    break;
+                }
+
+                fmt::string_view text;
+                if (record.format)
+                {
+                    buffer.clear();
+                    record.format(record, buffer);
+                    text = fmt::string_view(buffer.data(), buffer.size());
+                }
+                else if (record.long_text)
+                {
+                    text = fmt::string_view(record.long_text, record.text_size);
+                }
+                else
+                {
+                    text = fmt::string_view(reinterpret_cast<const char*>(record.payload), record.text_size);
+                }
+                emit(record.module, record.level, timestamp_to_ns(record.timestamp), record.thread_id, text);
+
+                delete[] record.long_text;
+                record.sequence.store(position + Log::queue_capacity, std::memory_order_release);
+                ++position;
+                s_dequeue_position.store(position, std::memory_order_release);
+                ++written;
+            }
+            return written;
+        }
+
+        void report_dropped(size_t& reported_count)
+        {
+            const size_t dropped_count = s_dropped_count.load(std::memory_order_relaxed);
+            if (dropped_count != reported_count)
+            {
+                const std::string text = fmt::format("Log: queue overflow, dropped {} messages", dropped_count - reported_count);
+                emit(ELogModule::Core, ELogLevel::Warn, now_ns(), spdlog::details::os::thread_id(), text);
+                reported_count = dropped_count;
+            }
+        }
+
+        void logger_thread()
+        {
+            size_t reported_count = s_dropped_count.load(std::memory_order_relaxed);
+            while (!s_stop.load(std::memory_order_acquire))
+            {
+                if (drain() > 0)
+                {
+                    continue;
+                }
+                report_dropped(reported_count);
+
+                // Producers only notify when they see this flag, so a missed wake-up costs at
+                // most one timeout instead of a fence on every log call
+                std::unique_lock lock(s_wake_mutex);
+                s_sleeping.store(true, std::memory_order_relaxed);
+                s_wake.wait_for(lock, std::chrono::milliseconds(10), []() {
+                    return s_stop.load(std::memory_order_acquire) || has_pending_record();
+                });
+                s_sleeping.store(false, std::memory_order_relaxed);
+            }
+            drain();
+            report_dropped(reported_count);
+        }
+
+        void wake_logger_thread()
+        {
+            // Only the first producer after the logger went to sleep pays for the wake-up
+            if (s_sleeping.load(std::memory_order_relaxed) && s_sleeping.exchange(false, std::memory_order_relaxed))
+            {
+                s_wake.notify_one();
+            }
+        }
+    }
+
+    void Log::init()
+    {
+        std::lock_guard lock(s_init_mutex);
+        if (s_init_count++ > 0)
+        {
+            return;
+        }
+
+        if (!s_records)
+        {
+            s_records = std::make_unique<LogRecord[]>(queue_capacity);
+            for (size_t i = 0; i < queue_capacity; ++i)
+            {
+                s_records[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+#ifdef ENGINE_LOG_TSC
+        if (s_origin_ns == 0)
+        {
+            s_origin_ticks = read_timestamp();
+            s_origin_ns = now_ns();
+        }
+#endif
+        s_stop.store(false, std::memory_order_relaxed);
+        s_thread = std::thread(logger_thread);
+        s_async.store(true, std::memory_order_release);
+    }
+
+    void Log::shutdown()
+    {
+        std::lock_guard lock(s_init_mutex);
+        if (s_init_count == 0 || --s_init_count > 0)
+        {
+            return;
+        }
+
+        s_async.store(false, std::memory_order_release);
+        {
+            std::lock_guard wake_lock(s_wake_mutex);
+            s_stop.store(true, std::memory_order_release);
+        }
+        s_wake.notify_one();
+        s_thread.join();
+        // Producers that checked s_async just before it was cleared
+        drain();
+        spdlog::default_logger_raw()->flush();
+    }
+
+    void Log::flush()
+    {
+        if (is_async())
+        {
+            const size_t target = s_enqueue_position.load(std::memory_order_acquire);
+            s_wake.notify_one();
+            while (s_dequeue_position.load(std::memory_order_acquire) < target && is_async())
+            {
+                std::this_thread::yield();
+            }
+        }
+        spdlog::default_logger_raw()->flush();
+    }
+
+    void Log::set_level(const ELogLevel level)
+    {
+        for (size_t i = 0; i < static_cast<size_t>(ELogModule::Count); ++i)
+        {
+            set_level(static_cast<ELogModule>(i), level);
+        }
+    }
+
+    const char* Log::get_module_name(const ELogModule module)
+    {
+        return module_names[static_cast<size_t>(module)];
+    }
+
+    size_t Log::get_dropped_count()
+    {
+        return s_dropped_count.load(std::memory_order_relaxed);
+    }
+
+    LogRecord* Log::begin_record(const ELogModule module, const ELogLevel level)
+    {
+        size_t position = s_enqueue_position.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            LogRecord& record = s_records[position & queue_mask];
+            const size_t sequence = record.sequence.load(std::memory_order_acquire);
+            const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0)
+            {
+                if (s_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    record.timestamp = read_timestamp();
+                    record.thread_id = spdlog::details::os::thread_id();
+                    record.format = nullptr;
+                    record.long_text = nullptr;
+                    record.text_size = 0;
+                    record.level = level;
+                    record.module = module;
+                    return &record;
+                }
+            }
+            else if (difference < 0)
+            {
+                s_dropped_count.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            else
+            {
+                position = s_enqueue_position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void Log::commit_record(LogRecord* record)
+    {
+        record->sequence.store(record->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        wake_logger_thread();
+    }
+
+    void Log::write_text(const ELogModule module, const ELogLevel level, const fmt::string_view text)
+    {
+        if (!is_async())
+        {
+            write_sync(module, level, text);
+            return;
+        }
+        LogRecord* record = begin_record(module, level);
+        if (!record)
+        {
+            return;
+        }
+        if (text.size() <= LogRecord::payload_size)
+        {
+            std::memcpy(record->payload, text.data(), text.size());
+        }
+        else
+        {
+            record->long_text = new char[text.size()];
+            std::memcpy(record->long_text, text.data(), text.size());
+        }
+        record->text_size = static_cast<uint32_t>(text.size());
+        commit_record(record);
+    }
+
+    void Log::write_sync(const ELogModule module, const ELogLevel level, const fmt::string_view text)
+    {
+        emit(module, level, now_ns(), spdlog::details::os::thread_id(), text);
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "LinearArena.hpp"
+
+#include <array>
+
+namespace GraphicsEngine {
+    // Memory for data that lives for one frame. The render thread executes frame N while the
+    // main thread records N + 1, so there are two arenas: end_frame() switches to the other one
+    // and resets it, which only happens after RenderThread::submit_frame() has waited for the
+    // frame that used it.
+    class FrameArena
+    {
+    public:
+        explicit FrameArena(const size_t block_size = 1024 * 1024)
+            : m_arenas{ LinearArena(block_size), LinearArena(block_size) }
+        {
+        }
+
+        LinearArena& get() { return m_arenas[m_index]; }
+
+        template <typename T>
+        T* allocate_array(const size_t count) { return get().allocate_array<T>(count); }
+
+        void end_frame()
+        {
+            m_index = 1 - m_index;
+            m_arenas[m_index].reset();
+        }
+
+        // Bytes allocated by the frame being recorded
+        size_t get_bytes_in_use() const { return m_arenas[m_index].get_stats().bytes_in_use; }
+        const MemoryStats& get_stats(const size_t index) const { return m_arenas[index].get_stats(); }
+
+    private:
+        std::array<LinearArena, 2> m_arenas;
+        size_t m_index = 0;
+    };
+}
@@ -0,0 +1,84 @@
+#include "LinearArena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace GraphicsEngine {
+    static size_t align_up(const size_t value, const size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    LinearArena::LinearArena(const size_t block_size)
+        : m_block_size(block_size)
+    {
+    }
+
+    void* LinearArena::allocate(const size_t size, const size_t alignment)
+    {
+        ++m_stats.allocations_count;
+
+        while (m_block < m_blocks.size())
+        {
+            Block& block = m_blocks[m_block];
+            // Align the address, not the offset: blocks only guarantee max_align_t
+            const uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+            const size_t offset = align_up(base + m_offset, alignment) - base;
+            if (offset + size <= block.size)
+            {
+                m_offset = offset + size;
+                update_bytes_in_use();
+                return block.data.get() + offset;
+            }
+
+            // Blocks kept from an earlier rewind are reused before new ones are made
+            m_previous_blocks_bytes += block.size;
+            ++m_block;
+            m_offset = 0;
+        }
+
+        Block block;
+        block.size = std::max(m_block_size, size + alignment);
+        block.data = std::make_unique<std::byte[]>(block.size);
+        m_stats.capacity_bytes += block.size;
+        ++m_stats.heap_allocations_count;
+        m_blocks.push_back(std::move(block));
+
+        const uintptr_t base = reinterpret_cast<uintptr_t>(m_blocks.back().data.get());
+        const size_t offset = align_up(base, alignment) - base;
+        m_offset = offset + size;
+        update_bytes_in_use();
+        return m_blocks.back().data.get() + offset;
+    }
+
+    void LinearArena::rewind(const Marker& marker)
+    {
+        while (m_block > marker.block)
+        {
+            --m_block;
+            m_previous_blocks_bytes -= m_blocks[m_block].size;
+        }
+        m_offset = marker.offset;
+        m_stats.bytes_in_use = m_previous_blocks_bytes + m_offset;
+    }
+
+    void LinearArena::reset()
+    {
+        if (m_blocks.size() > 1)
+        {
+            m_blocks.clear();
+            m_blocks.push_back({ std::make_unique<std::byte[]>(m_stats.capacity_bytes), m_stats.capacity_bytes });
+            ++m_stats.heap_allocations_count;
+        }
+        m_block = 0;
+        m_offset = 0;
+        m_previous_blocks_bytes = 0;
+        m_stats.bytes_in_use = 0;
+    }
+
+    void LinearArena::update_bytes_in_use()
+    {
+        m_stats.bytes_in_use = m_previous_blocks_bytes + m_offset;
+        m_stats.peak_bytes_in_use = std::max(m_stats.peak_bytes_in_use, m_stats.bytes_in_use);
+    }
+}
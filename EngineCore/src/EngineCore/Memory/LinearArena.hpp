@@ -0,0 +1,65 @@
+#pragma once
+
+#include "MemoryStats.hpp"
+
+#include <vector>
+#include <memory>
+#include <type_traits>
+#include <cstddef>
+
+namespace GraphicsEngine {
+    // Bump allocator over a chain of blocks. Individual allocations are never freed: the
+    // arena is rewound as a whole with reset() or back to a marker with rewind(). When a reset
+    // finds that the last cycle spilled into several blocks, they are replaced by a single block
+    // of the combined size, so a steady workload stops touching the heap after its first cycle.
+    // Not thread-safe.
+    class LinearArena
+    {
+    public:
+        struct Marker
+        {
+            size_t block = 0;
+            size_t offset = 0;
+        };
+
+        explicit LinearArena(const size_t block_size = 1024 * 1024);
+        LinearArena(const LinearArena&) = delete;
+        LinearArena& operator=(const LinearArena&) = delete;
+        LinearArena(LinearArena&&) noexcept = default;
+        LinearArena& operator=(LinearArena&&) noexcept = default;
+
+        void* allocate(const size_t size, const size_t alignment = alignof(std::max_align_t));
+
+        // Uninitialized storage for count objects; destructors are never run
+        template <typename T>
+        T* allocate_array(const size_t count)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "arena memory is released without running destructors");
+            return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        Marker get_marker() const { return { m_block, m_offset }; }
+        // Releases everything allocated after the marker was taken
+        void rewind(const Marker& marker);
+        void reset();
+
+        const MemoryStats& get_stats() const { return m_stats; }
+
+    private:
+        struct Block
+        {
+            std::unique_ptr<std::byte[]> data;
+            size_t size = 0;
+        };
+
+        void update_bytes_in_use();
+
+        size_t m_block_size;
+        std::vector<Block> m_blocks;
+        size_t m_block = 0;
+        size_t m_offset = 0;
+        // Sum of the sizes of the blocks before m_block
+        size_t m_previous_blocks_bytes = 0;
+        MemoryStats m_stats;
+    };
+}
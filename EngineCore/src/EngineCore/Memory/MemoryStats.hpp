@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+namespace GraphicsEngine {
+    struct MemoryStats
+    {
+        // Since construction
+        size_t allocations_count = 0;
+        // Allocations that needed memory from the heap (new blocks, pool growth)
+        size_t heap_allocations_count = 0;
+        size_t bytes_in_use = 0;
+        size_t peak_bytes_in_use = 0;
+        // Memory currently reserved from the heap
+        size_t capacity_bytes = 0;
+    };
+}
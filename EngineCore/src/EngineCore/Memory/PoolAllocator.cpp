@@ -0,0 +1,63 @@
+#include "PoolAllocator.hpp"
+
+#include <algorithm>
+
+namespace GraphicsEngine {
+    PoolAllocator::PoolAllocator(const size_t block_size, const size_t blocks_per_page, const size_t alignment)
+        : m_alignment(std::max(alignment, alignof(FreeBlock)))
+    {
+        // Every block must hold the free-list link and keep the next block aligned
+        m_block_size = std::max(block_size, sizeof(FreeBlock));
+        m_block_size = (m_block_size + m_alignment - 1) / m_alignment * m_alignment;
+        m_blocks_per_page = std::max<size_t>(blocks_per_page, 1);
+    }
+
+    void PoolAllocator::add_page()
+    {
+        const size_t page_size = m_block_size * m_blocks_per_page + m_alignment;
+        m_pages.push_back(std::make_unique<std::byte[]>(page_size));
+        m_stats.capacity_bytes += page_size;
+        ++m_stats.heap_allocations_count;
+
+        void* data = m_pages.back().get();
+        size_t space = page_size;
+        std::byte* first = static_cast<std::byte*>(std::align(m_alignment, m_block_size * m_blocks_per_page, data, space));
+
+        // Linked in reverse so blocks are handed out in address order
+        for (size_t i = m_blocks_per_page; i-- > 0;)
+        {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(first + i * m_block_size);
+            block->next = m_free_list;
+            m_free_list = block;
+        }
+    }
+
+    void* PoolAllocator::allocate()
+    {
+        if (!m_free_list)
+        {
+            add_page();
+        }
+
+        FreeBlock* block = m_free_list;
+        m_free_list = block->next;
+
+        ++m_stats.allocations_count;
+        m_stats.bytes_in_use += m_block_size;
+        m_stats.peak_bytes_in_use = std::max(m_stats.peak_bytes_in_use, m_stats.bytes_in_use);
+        return block;
+    }
+
+    void PoolAllocator::free(void* block)
+    {
+        if (!block)
+        {
+            return;
+        }
+
+        FreeBlock* free_block = static_cast<FreeBlock*>(block);
+        free_block->next = m_free_list;
+        m_free_list = free_block;
+        m_stats.bytes_in_use -= m_block_size;
+    }
+}
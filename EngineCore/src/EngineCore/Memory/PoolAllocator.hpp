@@ -0,0 +1,75 @@
+#pragma once
+
+#include "MemoryStats.hpp"
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <new>
+#include <cstddef>
+
+namespace GraphicsEngine {
+    // Fixed-size blocks handed out from pages of blocks_per_page. Freed blocks go on an
+    // intrusive free list and are reused most-recently-freed first, so allocation and release
+    // are a few pointer moves. Pages are only returned to the heap when the pool is destroyed.
+    // Not thread-safe.
+    class PoolAllocator
+    {
+    public:
+        PoolAllocator(const size_t block_size, const size_t blocks_per_page, const size_t alignment = alignof(std::max_align_t));
+        PoolAllocator(const PoolAllocator&) = delete;
+        PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+        void* allocate();
+        void free(void* block);
+
+        size_t get_block_size() const { return m_block_size; }
+        const MemoryStats& get_stats() const { return m_stats; }
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        void add_page();
+
+        size_t m_block_size;
+        size_t m_blocks_per_page;
+        size_t m_alignment;
+        std::vector<std::unique_ptr<std::byte[]>> m_pages;
+        FreeBlock* m_free_list = nullptr;
+        MemoryStats m_stats;
+    };
+
+    // Typed front end of a PoolAllocator for small engine objects
+    template <typename T>
+    class ObjectPool
+    {
+    public:
+        explicit ObjectPool(const size_t objects_per_page = 256)
+            : m_pool(sizeof(T), objects_per_page, alignof(T))
+        {
+        }
+
+        template <typename... Args>
+        T* create(Args&&... args)
+        {
+            return new (m_pool.allocate()) T(std::forward<Args>(args)...);
+        }
+
+        void destroy(T* object)
+        {
+            if (object)
+            {
+                object->~T();
+                m_pool.free(object);
+            }
+        }
+
+        const MemoryStats& get_stats() const { return m_pool.get_stats(); }
+
+    private:
+        PoolAllocator m_pool;
+    };
+}
@@ -0,0 +1,10 @@
+#include "ScratchScope.hpp"
+
+namespace GraphicsEngine {
+    LinearArena& ScratchScope::get_thread_arena()
+    {
+        // Created on a thread's first scope; grows in 256KiB blocks if a scope needs more
+        static thread_local LinearArena arena(256 * 1024);
+        return arena;
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "LinearArena.hpp"
+
+namespace GraphicsEngine {
+    // Temporary allocations from the calling thread's scratch stack. Everything allocated
+    // through a scope is released when it ends; scopes nest like the calls that open them.
+    //
+    //     ScratchScope scratch;
+    //     uint32_t* remap = scratch.allocate_array<uint32_t>(count);
+    class ScratchScope
+    {
+    public:
+        ScratchScope()
+            : m_arena(get_thread_arena()), m_marker(m_arena.get_marker())
+        {
+        }
+        ~ScratchScope() { m_arena.rewind(m_marker); }
+
+        ScratchScope(const ScratchScope&) = delete;
+        ScratchScope& operator=(const ScratchScope&) = delete;
+
+        void* allocate(const size_t size, const size_t alignment = alignof(std::max_align_t)) { return m_arena.allocate(size, alignment); }
+
+        template <typename T>
+        T* allocate_array(const size_t count) { return m_arena.allocate_array<T>(count); }
+
+        // Statistics of the calling thread's stack
+        static const MemoryStats& get_thread_stats() { return get_thread_arena().get_stats(); }
+
+    private:
+        static LinearArena& get_thread_arena();
+
+        LinearArena& m_arena;
+        LinearArena::Marker m_marker;
+    };
+}
@@ -0,0 +1,255 @@
+#define ENGINE_LOG_MODULE Profiling
+
+#include "Profiler.hpp"
+#include "EngineCore/Debug.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+
+namespace GraphicsEngine {
+    namespace {
+        struct ThreadBuffer
+        {
+            std::mutex mutex;
+            // Closed zones waiting for end_frame()
+            std::vector<ProfileZone> zones;
+            std::string name;
+            uint32_t index = 0;
+
+            // Only touched by the owning thread
+            ProfileZone open_zones[Profiler::max_depth];
+            uint32_t depth = 0;
+        };
+
+        struct ProfilerState
+        {
+#ifdef ENGINE_PROFILING
+            std::atomic<bool> enabled = true;
+#else
+            std::atomic<bool> enabled = false;
+#endif
+            const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+            std::mutex threads_mutex;
+            std::vector<std::unique_ptr<ThreadBuffer>> threads;
+
+            std::mutex gpu_mutex;
+            std::vector<ProfileZone> gpu_zones;
+
+            std::array<Profiler::FrameRecord, Profiler::history_frames> frames;
+            size_t frames_count = 0;
+            int64_t frame_start_ns = 0;
+        };
+
+        ProfilerState& get_state()
+        {
+            static ProfilerState state;
+            return state;
+        }
+
+        ThreadBuffer& get_thread_buffer()
+        {
+            static thread_local ThreadBuffer* buffer = nullptr;
+            if (!buffer)
+            {
+                ProfilerState& state = get_state();
+                std::lock_guard<std::mutex> lock(state.threads_mutex);
+                state.threads.push_back(std::make_unique<ThreadBuffer>());
+                buffer = state.threads.back().get();
+                buffer->index = static_cast<uint32_t>(state.threads.size() - 1);
+                buffer->name = "Thread " + std::to_string(buffer->index);
+            }
+            return *buffer;
+        }
+
+        void write_json_string(std::ostream& out, const std::string& value)
+        {
+            out << '"';
+            for (const char c : value)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    out << '\\';
+                }
+                out << c;
+            }
+            out << '"';
+        }
+    }
+
+    int64_t Profiler::now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - get_state().epoch).count();
+    }
+
+    void Profiler::set_enabled(const bool enabled)
+    {
+        get_state().enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool Profiler::is_enabled()
+    {
+        return get_state().enabled.load(std::memory_order_relaxed);
+    }
+
+    void Profiler::set_thread_name(const std::string& name)
+    {
+        ThreadBuffer& buffer = get_thread_buffer();
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        buffer.name = name;
+    }
+
+    std::string Profiler::get_thread_name(const uint32_t thread)
+    {
+        if (thread == gpu_thread)
+        {
+            return "GPU";
+        }
+
+        ProfilerState& state = get_state();
+        std::lock_guard<std::mutex> lock(state.threads_mutex);
+        if (thread >= state.threads.size())
+        {
+            return {};
+        }
+        std::lock_guard<std::mutex> buffer_lock(state.threads[thread]->mutex);
+        return state.threads[thread]->name;
+    }
+
+    bool Profiler::begin_zone(const char* name)
+    {
+        if (!is_enabled())
+        {
+            return false;
+        }
+
+        ThreadBuffer& buffer = get_thread_buffer();
+        if (buffer.depth >= max_depth)
+        {
+            return false;
+        }
+        buffer.open_zones[buffer.depth] = { name, now_ns(), 0, buffer.index, buffer.depth };
+        ++buffer.depth;
+        return true;
+    }
+
+    void Profiler::end_zone()
+    {
+        const int64_t end_ns = now_ns();
+        ThreadBuffer& buffer = get_thread_buffer();
+        ProfileZone& zone = buffer.open_zones[--buffer.depth];
+        zone.end_ns = end_ns;
+
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        buffer.zones.push_back(zone);
+    }
+
+    void Profiler::add_gpu_zone(const char* name, const int64_t start_ns, const int64_t end_ns, const uint32_t depth)
+    {
+        ProfilerState& state = get_state();
+        std::lock_guard<std::mutex> lock(state.gpu_mutex);
+        state.gpu_zones.push_back({ name, start_ns, end_ns, gpu_thread, depth });
+    }
+
+    void Profiler::end_frame()
+    {
+        ProfilerState& state = get_state();
+        FrameRecord& frame = state.frames[state.frames_count % history_frames];
+        // The vector keeps its capacity, so a warmed-up history does not allocate
+        frame.zones.clear();
+        frame.start_ns = state.frame_start_ns;
+        frame.end_ns = now_ns();
+        state.frame_start_ns = frame.end_ns;
+
+        {
+            std::lock_guard<std::mutex> lock(state.threads_mutex);
+            for (const std::unique_ptr<ThreadBuffer>& buffer : state.threads)
+            {
+                std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+                frame.zones.insert(frame.zones.end(), buffer->zones.begin(), buffer->zones.end());
+                buffer->zones.clear();
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(state.gpu_mutex);
+            frame.zones.insert(frame.zones.end(), state.gpu_zones.begin(), state.gpu_zones.end());
+            state.gpu_zones.clear();
+        }
+        ++state.frames_count;
+    }
+
+    const Profiler::FrameRecord* Profiler::get_frame(const size_t frames_ago)
+    {
+        const ProfilerState& state = get_state();
+        if (frames_ago >= get_frames_count())
+        {
+            return nullptr;
+        }
+        return &state.frames[(state.frames_count - 1 - frames_ago) % history_frames];
+    }
+
+    size_t Profiler::get_frames_count()
+    {
+        return std::min(get_state().frames_count, history_frames);
+    }
+
+    bool Profiler::write_chrome_trace(const std::string& path)
+    {
+        std::ofstream out(path);
+        if (!out)
+        {
+            LOG_ERROR("Profiler: cannot write trace to {}", path);
+            return false;
+        }
+
+        ProfilerState& state = get_state();
+        // GPU zones get their own track id after the CPU threads
+        size_t threads_count = 0;
+        {
+            std::lock_guard<std::mutex> lock(state.threads_mutex);
+            threads_count = state.threads.size();
+        }
+        const size_t gpu_track = threads_count;
+
+        out << std::fixed << std::setprecision(3);
+        out << "{\"traceEvents\":[\n";
+        bool first = true;
+        auto write_separator = [&out, &first]() {
+            out << (first ? "" : ",\n");
+            first = false;
+        };
+
+        for (size_t thread = 0; thread <= threads_count; ++thread)
+        {
+            write_separator();
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread << ",\"args\":{\"name\":";
+            write_json_string(out, thread == gpu_track ? std::string("GPU") : get_thread_name(static_cast<uint32_t>(thread)));
+            out << "}}";
+        }
+
+        for (size_t frames_ago = get_frames_count(); frames_ago-- > 0;)
+        {
+            const FrameRecord& frame = *get_frame(frames_ago);
+            for (const ProfileZone& zone : frame.zones)
+            {
+                write_separator();
+                const size_t track = zone.thread == gpu_thread ? gpu_track : zone.thread;
+                // Chrome trace times are in microseconds
+                out << "{\"name\":";
+                write_json_string(out, zone.name);
+                out << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << track
+                    << ",\"ts\":" << static_cast<double>(zone.start_ns) / 1000.0
+                    << ",\"dur\":" << static_cast<double>(zone.end_ns - zone.start_ns) / 1000.0 << "}";
+            }
+        }
+        out << "\n]}\n";
+        LOG_INFO("Profiler: wrote {} frames to {}", get_frames_count(), path);
+        return true;
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace GraphicsEngine {
+    struct ProfileZone
+    {
+        // Must point to static storage (a string literal)
+        const char* name;
+        int64_t start_ns;
+        int64_t end_ns;
+        uint32_t thread;
+        uint32_t depth;
+    };
+
+    // Collects timed zones from every thread. Zones are buffered per thread and gathered
+    // by end_frame(), which the main loop calls once per iteration; the last history_frames
+    // frames are kept for the overlay and for Chrome trace export. GPU zones are measured by
+    // GpuProfiler_OpenGL a few frames late and added with their times already converted to
+    // the CPU clock, so they land in whichever frame is being gathered when they arrive.
+    class Profiler
+    {
+    public:
+        static constexpr uint32_t gpu_thread = ~0u;
+        static constexpr size_t history_frames = 240;
+        static constexpr uint32_t max_depth = 32;
+
+        struct FrameRecord
+        {
+            int64_t start_ns = 0;
+            int64_t end_ns = 0;
+            std::vector<ProfileZone> zones;
+        };
+
+        // Nanoseconds on the clock zones are measured with
+        static int64_t now_ns();
+
+        static void set_enabled(const bool enabled);
+        static bool is_enabled();
+        // Names the calling thread in the overlay and in traces
+        static void set_thread_name(const std::string& name);
+        static std::string get_thread_name(const uint32_t thread);
+
+        // Returns false when the zone was not opened (profiling disabled or nested too deep)
+        static bool begin_zone(const char* name);
+        static void end_zone();
+        static void add_gpu_zone(const char* name, const int64_t start_ns, const int64_t end_ns, const uint32_t depth);
+
+        static void end_frame();
+
+        // 0 is the last completed frame
+        static const FrameRecord* get_frame(const size_t frames_ago);
+        static size_t get_frames_count();
+
+        // Writes every frame in the history as Chrome trace JSON (chrome://tracing, Perfetto)
+        static bool write_chrome_trace(const std::string& path);
+    };
+
+    class ProfileScope
+    {
+    public:
+        explicit ProfileScope(const char* name)
+            : m_active(Profiler::begin_zone(name))
+        {
+        }
+        ~ProfileScope()
+        {
+            if (m_active)
+            {
+                Profiler::end_zone();
+            }
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        bool m_active;
+    };
+}
+
+#define ENGINE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define ENGINE_PROFILE_CONCAT(a, b) ENGINE_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef ENGINE_PROFILING
+// Times the rest of the enclosing block; name must be a string literal
+#define PROFILE_SCOPE(name) ::GraphicsEngine::ProfileScope ENGINE_PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name)
+#endif
@@ -0,0 +1,148 @@
+#include "ProfilerOverlay.hpp"
+#include "Profiler.hpp"
+
+#include <imgui/imgui.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+namespace GraphicsEngine {
+    static ImU32 get_zone_color(const char* name)
+    {
+        // Stable per name so a zone keeps its color from frame to frame
+        const size_t hash = std::hash<std::string_view>()(name);
+        const float hue = static_cast<float>(hash % 360) / 360.0f;
+        float r, g, b;
+        ImGui::ColorConvertHSVtoRGB(hue, 0.5f, 0.8f, r, g, b);
+        return ImGui::GetColorU32(ImVec4(r, g, b, 1.0f));
+    }
+
+    static void draw_lane(const Profiler::FrameRecord& frame, const uint32_t thread, const int64_t origin_ns, const double ns_per_pixel)
+    {
+        const float row_height = ImGui::GetTextLineHeight() + 2.0f;
+        uint32_t depths_count = 0;
+        for (const ProfileZone& zone : frame.zones)
+        {
+            if (zone.thread == thread)
+            {
+                depths_count = std::max(depths_count, zone.depth + 1);
+            }
+        }
+
+        ImGui::TextUnformatted(Profiler::get_thread_name(thread).c_str());
+        const ImVec2 lane_origin = ImGui::GetCursorScreenPos();
+        const float lane_width = ImGui::GetContentRegionAvail().x;
+        ImGui::Dummy(ImVec2(lane_width, row_height * static_cast<float>(depths_count)));
+
+        ImDrawList* draw_list = ImGui::GetWindowDrawList();
+        const ImVec2 mouse = ImGui::GetIO().MousePos;
+        for (const ProfileZone& zone : frame.zones)
+        {
+            if (zone.thread != thread)
+            {
+                continue;
+            }
+
+            const float x0 = lane_origin.x + static_cast<float>(static_cast<double>(zone.start_ns - origin_ns) / ns_per_pixel);
+            const float x1 = std::max(x0 + 1.0f, lane_origin.x + static_cast<float>(static_cast<double>(zone.end_ns - origin_ns) / ns_per_pixel));
+            const float y0 = lane_origin.y + row_height * static_cast<float>(zone.depth);
+            const ImVec2 min(std::max(x0, lane_origin.x), y0);
+            const ImVec2 max(std::min(x1, lane_origin.x + lane_width), y0 + row_height - 1.0f);
+            if (max.x <= min.x)
+            {
+                continue;
+            }
+
+            draw_list->AddRectFilled(min, max, get_zone_color(zone.name));
+            const float text_width = ImGui::CalcTextSize(zone.name).x;
+            if (text_width < max.x - min.x - 4.0f)
+            {
+                draw_list->AddText(ImVec2(min.x + 2.0f, min.y), IM_COL32(0, 0, 0, 255), zone.name);
+            }
+            if (mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y)
+            {
+                ImGui::SetTooltip("%s: %.3f ms", zone.name, static_cast<double>(zone.end_ns - zone.start_ns) / 1.0e6);
+            }
+        }
+    }
+
+    void draw_profiler_overlay()
+    {
+        ImGui::SetNextWindowSize(ImVec2(600, 320), ImGuiCond_FirstUseEver);
+        ImGui::Begin("Profiler");
+
+        bool enabled = Profiler::is_enabled();
+        if (ImGui::Checkbox("enabled", &enabled))
+        {
+            Profiler::set_enabled(enabled);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("export chrome trace"))
+        {
+            Profiler::write_chrome_trace("profile_trace.json");
+        }
+
+        // Oldest first, as the plots draw left to right
+        std::array<float, Profiler::history_frames> cpu_times{};
+        std::array<float, Profiler::history_frames> gpu_times{};
+        const size_t frames_count = Profiler::get_frames_count();
+        float cpu_max = 0.0f;
+        float cpu_total = 0.0f;
+        for (size_t i = 0; i < frames_count; ++i)
+        {
+            const Profiler::FrameRecord& frame = *Profiler::get_frame(frames_count - 1 - i);
+            cpu_times[i] = static_cast<float>(static_cast<double>(frame.end_ns - frame.start_ns) / 1.0e6);
+            for (const ProfileZone& zone : frame.zones)
+            {
+                if (zone.thread == Profiler::gpu_thread && zone.depth == 0)
+                {
+                    gpu_times[i] += static_cast<float>(static_cast<double>(zone.end_ns - zone.start_ns) / 1.0e6);
+                }
+            }
+            cpu_max = std::max(cpu_max, cpu_times[i]);
+            cpu_total += cpu_times[i];
+        }
+
+        const int plotted_count = static_cast<int>(frames_count);
+        ImGui::Text("frame: %.2f ms avg, %.2f ms max", frames_count > 0 ? cpu_total / static_cast<float>(frames_count) : 0.0f, cpu_max);
+        ImGui::PlotLines("cpu ms", cpu_times.data(), plotted_count, 0, nullptr, 0.0f, cpu_max * 1.1f, ImVec2(0, 50));
+        ImGui::PlotLines("gpu ms", gpu_times.data(), plotted_count, 0, nullptr, 0.0f, cpu_max * 1.1f, ImVec2(0, 50));
+
+        const Profiler::FrameRecord* frame = Profiler::get_frame(0);
+        if (frame && frame->end_ns > frame->start_ns)
+        {
+            const double ns_per_pixel = static_cast<double>(frame->end_ns - frame->start_ns) / std::max(1.0f, ImGui::GetContentRegionAvail().x);
+
+            std::array<uint32_t, 64> threads{};
+            size_t threads_count = 0;
+            int64_t gpu_origin_ns = INT64_MAX;
+            for (const ProfileZone& zone : frame->zones)
+            {
+                if (zone.thread == Profiler::gpu_thread)
+                {
+                    gpu_origin_ns = std::min(gpu_origin_ns, zone.start_ns);
+                }
+                else if (threads_count < threads.size() && std::find(threads.begin(), threads.begin() + threads_count, zone.thread) == threads.begin() + threads_count)
+                {
+                    threads[threads_count++] = zone.thread;
+                }
+            }
+            std::sort(threads.begin(), threads.begin() + threads_count);
+
+            for (size_t i = 0; i < threads_count; ++i)
+            {
+                draw_lane(*frame, threads[i], frame->start_ns, ns_per_pixel);
+            }
+            // GPU results arrive a few frames late; the lane starts at the oldest GPU zone gathered this frame
+            if (gpu_origin_ns != INT64_MAX)
+            {
+                draw_lane(*frame, Profiler::gpu_thread, gpu_origin_ns, ns_per_pixel);
+            }
+        }
+
+        ImGui::End();
+    }
+}
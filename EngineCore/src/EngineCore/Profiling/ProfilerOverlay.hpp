@@ -0,0 +1,7 @@
+#pragma once
+
+namespace GraphicsEngine {
+    // ImGui window with the frame time history and a flame graph of the last frame, one lane
+    // per thread plus one for the GPU. Call between ImGui::NewFrame() and ImGui::Render().
+    void draw_profiler_overlay();
+}
@@ -0,0 +1,296 @@
+#define ENGINE_LOG_MODULE Rendering
+
+#include "BoundingVolumeHierarchy.hpp"
+#include "Frustum.hpp"
+#include "EngineCore/Debug.hpp"
+#include "EngineCore/Memory/ScratchScope.hpp"
+
+#include <algorithm>
+
+namespace GraphicsEngine {
+    // Fat boxes grow by this fraction of their size on each side
+    static constexpr float s_aabb_margin_ratio = 0.1f;
+
+    int32_t BoundingVolumeHierarchy::allocate_node()
+    {
+        if (m_free_list == null_node)
+        {
+            m_nodes.emplace_back();
+            return static_cast<int32_t>(m_nodes.size() - 1);
+        }
+        const int32_t node = m_free_list;
+        m_free_list = m_nodes[node].parent;
+        m_nodes[node] = Node();
+        return node;
+    }
+
+    void BoundingVolumeHierarchy::free_node(const int32_t node)
+    {
+        m_nodes[node].parent = m_free_list;
+        m_nodes[node].height = -1;
+        m_free_list = node;
+    }
+
+    int32_t BoundingVolumeHierarchy::create_proxy(const AABB& aabb, const uint32_t user_data)
+    {
+        const int32_t proxy = allocate_node();
+        const glm::vec3 margin = (aabb.max - aabb.min) * s_aabb_margin_ratio;
+        m_nodes[proxy].aabb = { aabb.min - margin, aabb.max + margin };
+        m_nodes[proxy].user_data = user_data;
+        m_nodes[proxy].height = 0;
+        insert_leaf(proxy);
+        ++m_proxies_count;
+        return proxy;
+    }
+
+    void BoundingVolumeHierarchy::destroy_proxy(const int32_t proxy)
+    {
+        if (proxy < 0 || proxy >= static_cast<int32_t>(m_nodes.size()) || !m_nodes[proxy].is_leaf() || m_nodes[proxy].height != 0)
+        {
+            LOG_ERROR("BoundingVolumeHierarchy: destroying an invalid proxy {}", proxy);
+            return;
+        }
+        remove_leaf(proxy);
+        free_node(proxy);
+        --m_proxies_count;
+    }
+
+    bool BoundingVolumeHierarchy::move_proxy(const int32_t proxy, const AABB& aabb)
+    {
+        if (m_nodes[proxy].aabb.contains(aabb))
+        {
+            return false;
+        }
+
+        remove_leaf(proxy);
+        const glm::vec3 margin = (aabb.max - aabb.min) * s_aabb_margin_ratio;
+        m_nodes[proxy].aabb = { aabb.min - margin, aabb.max + margin };
+        insert_leaf(proxy);
+        return true;
+    }
+
+    void BoundingVolumeHierarchy::insert_leaf(const int32_t leaf)
+    {
+        if (m_root == null_node)
+        {
+            m_root = leaf;
+            m_nodes[leaf].parent = null_node;
+            return;
+        }
+
+        // Walk down to the sibling that grows the tree's total surface area the least
+        const AABB leaf_aabb = m_nodes[leaf].aabb;
+        int32_t index = m_root;
+        while (!m_nodes[index].is_leaf())
+        {
+            const Node& node = m_nodes[index];
+            const float area = node.aabb.get_surface_area();
+            const float combined_area = AABB::merge(node.aabb, leaf_aabb).get_surface_area();
+
+            // Cost of making a new parent for this node and the leaf, and the minimum cost of pushing the leaf further down
+            const float cost = 2.0f * combined_area;
+            const float inheritance_cost = 2.0f * (combined_area - area);
+
+            auto descend_cost = [&](const int32_t child) {
+                const AABB merged = AABB::merge(leaf_aabb, m_nodes[child].aabb);
+                if (m_nodes[child].is_leaf())
+                {
+                    return merged.get_surface_area() + inheritance_cost;
+                }
+                return merged.get_surface_area() - m_nodes[child].aabb.get_surface_area() + inheritance_cost;
+            };
+            const float cost1 = descend_cost(node.child1);
+            const float cost2 = descend_cost(node.child2);
+
+            if (cost < cost1 && cost < cost2)
+            {
+                break;
+            }
+            index = cost1 < cost2 ? node.child1 : node.child2;
+        }
+
+        const int32_t sibling = index;
+        const int32_t old_parent = m_nodes[sibling].parent;
+        const int32_t new_parent = allocate_node();
+        m_nodes[new_parent].parent = old_parent;
+        m_nodes[new_parent].aabb = AABB::merge(leaf_aabb, m_nodes[sibling].aabb);
+        m_nodes[new_parent].height = m_nodes[sibling].height + 1;
+        m_nodes[new_parent].child1 = sibling;
+        m_nodes[new_parent].child2 = leaf;
+        m_nodes[sibling].parent = new_parent;
+        m_nodes[leaf].parent = new_parent;
+
+        if (old_parent == null_node)
+        {
+            m_root = new_parent;
+        }
+        else if (m_nodes[old_parent].child1 == sibling)
+        {
+            m_nodes[old_parent].child1 = new_parent;
+        }
+        else
+        {
+            m_nodes[old_parent].child2 = new_parent;
+        }
+
+        // Refit and rebalance the ancestors
+        index = m_nodes[leaf].parent;
+        while (index != null_node)
+        {
+            index = balance(index);
+            Node& node = m_nodes[index];
+            node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+            node.aabb = AABB::merge(m_nodes[node.child1].aabb, m_nodes[node.child2].aabb);
+            index = node.parent;
+        }
+    }
+
+    void BoundingVolumeHierarchy::remove_leaf(const int32_t leaf)
+    {
+        if (leaf == m_root)
+        {
+            m_root = null_node;
+            return;
+        }
+
+        const int32_t parent = m_nodes[leaf].parent;
+        const int32_t grand_parent = m_nodes[parent].parent;
+        const int32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+        if (grand_parent == null_node)
+        {
+            m_root = sibling;
+            m_nodes[sibling].parent = null_node;
+            free_node(parent);
+            return;
+        }
+
+        if (m_nodes[grand_parent].child1 == parent)
+        {
+            m_nodes[grand_parent].child1 = sibling;
+        }
+        else
+        {
+            m_nodes[grand_parent].child2 = sibling;
+        }
+        m_nodes[sibling].parent = grand_parent;
+        free_node(parent);
+
+        int32_t index = grand_parent;
+        while (index != null_node)
+        {
+            index = balance(index);
+            Node& node = m_nodes[index];
+            node.aabb = AABB::merge(m_nodes[node.child1].aabb, m_nodes[node.child2].aabb);
+            node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+            index = node.parent;
+        }
+    }
+
+    // Rotates a grandchild up when one subtree of a is more than one level taller; returns the subtree's new root
+    int32_t BoundingVolumeHierarchy::balance(const int32_t a)
+    {
+        Node& node_a = m_nodes[a];
+        if (node_a.is_leaf() || node_a.height < 2)
+        {
+            return a;
+        }
+
+        const int32_t b = node_a.child1;
+        const int32_t c = node_a.child2;
+        const int32_t height_difference = m_nodes[c].height - m_nodes[b].height;
+        if (height_difference >= -1 && height_difference <= 1)
+        {
+            return a;
+        }
+
+        // The taller child moves up into a's place; a takes the better of its grandchildren
+        const int32_t up = height_difference > 1 ? c : b;
+        const int32_t stay = height_difference > 1 ? b : c;
+        Node& node_up = m_nodes[up];
+        const int32_t f = node_up.child1;
+        const int32_t g = node_up.child2;
+
+        node_up.child1 = a;
+        node_up.parent = node_a.parent;
+        node_a.parent = up;
+
+        if (node_up.parent == null_node)
+        {
+            m_root = up;
+        }
+        else if (m_nodes[node_up.parent].child1 == a)
+        {
+            m_nodes[node_up.parent].child1 = up;
+        }
+        else
+        {
+            m_nodes[node_up.parent].child2 = up;
+        }
+
+        const bool keep_f = m_nodes[f].height > m_nodes[g].height;
+        const int32_t kept = keep_f ? f : g;
+        const int32_t moved = keep_f ? g : f;
+
+        node_up.child2 = kept;
+        if (up == c)
+        {
+            node_a.child2 = moved;
+        }
+        else
+        {
+            node_a.child1 = moved;
+        }
+        m_nodes[moved].parent = a;
+
+        node_a.aabb = AABB::merge(m_nodes[stay].aabb, m_nodes[moved].aabb);
+        node_a.height = 1 + std::max(m_nodes[stay].height, m_nodes[moved].height);
+        node_up.aabb = AABB::merge(node_a.aabb, m_nodes[kept].aabb);
+        node_up.height = 1 + std::max(node_a.height, m_nodes[kept].height);
+        return up;
+    }
+
+    void BoundingVolumeHierarchy::query(const Frustum& frustum, std::vector<uint32_t>& out) const
+    {
+        if (m_root == null_node)
+        {
+            return;
+        }
+
+        // Nodes below one that is fully inside are collected without further plane tests
+        struct StackEntry
+        {
+            int32_t node;
+            bool inside;
+        };
+        // Each pop pushes at most two children, so the stack never holds more than height + 1 entries
+        ScratchScope scratch;
+        StackEntry* stack = scratch.allocate_array<StackEntry>(static_cast<size_t>(get_height()) + 1);
+        size_t stack_size = 0;
+        stack[stack_size++] = { m_root, false };
+        while (stack_size > 0)
+        {
+            const StackEntry entry = stack[--stack_size];
+            const Node& node = m_nodes[entry.node];
+
+            bool inside = entry.inside;
+            if (!inside)
+            {
+                const Frustum::ETestResult result = frustum.test_aabb(node.aabb);
+                if (result == Frustum::ETestResult::Outside)
+                {
+                    continue;
+                }
+                inside = result == Frustum::ETestResult::Inside;
+            }
+
+            if (node.is_leaf())
+            {
+                out.push_back(node.user_data);
+                continue;
+            }
+            stack[stack_size++] = { node.child1, inside };
+            stack[stack_size++] = { node.child2, inside };
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Bounds.hpp"
+
+#include <vector>
+#include <cstdint>
+
+namespace GraphicsEngine {
+    class Frustum;
+
+    // Dynamic AABB tree. Each proxy is stored with a fattened box, so small movements
+    // only compare two boxes; a proxy is re-inserted when it leaves its fat box.
+    // Insertion picks the sibling with the smallest surface area cost and the tree is kept
+    // balanced with rotations on the way back up.
+    class BoundingVolumeHierarchy
+    {
+    public:
+        static constexpr int32_t null_node = -1;
+
+        BoundingVolumeHierarchy() = default;
+        BoundingVolumeHierarchy(const BoundingVolumeHierarchy&) = delete;
+        BoundingVolumeHierarchy& operator=(const BoundingVolumeHierarchy&) = delete;
+
+        int32_t create_proxy(const AABB& aabb, const uint32_t user_data);
+        void destroy_proxy(const int32_t proxy);
+        // Returns true when the proxy had to be re-inserted
+        bool move_proxy(const int32_t proxy, const AABB& aabb);
+
+        // Appends the user data of every proxy whose fat box is not outside the frustum
+        void query(const Frustum& frustum, std::vector<uint32_t>& out) const;
+
+        uint32_t get_user_data(const int32_t proxy) const { return m_nodes[proxy].user_data; }
+        size_t get_proxies_count() const { return m_proxies_count; }
+        int get_height() const { return m_root == null_node ? 0 : m_nodes[m_root].height; }
+
+    private:
+        struct Node
+        {
+            AABB aabb;
+            int32_t parent = null_node;
+            int32_t child1 = null_node;
+            int32_t child2 = null_node;
+            // Leaves have height 0; free nodes -1
+            int32_t height = -1;
+            uint32_t user_data = 0;
+
+            bool is_leaf() const { return child1 == null_node; }
+        };
+
+        int32_t allocate_node();
+        void free_node(const int32_t node);
+        void insert_leaf(const int32_t leaf);
+        void remove_leaf(const int32_t leaf);
+        int32_t balance(const int32_t node);
+
+        std::vector<Node> m_nodes;
+        int32_t m_root = null_node;
+        int32_t m_free_list = null_node;
+        size_t m_proxies_count = 0;
+    };
+}
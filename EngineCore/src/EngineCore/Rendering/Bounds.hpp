@@ -0,0 +1,39 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/common.hpp>
+
+namespace GraphicsEngine {
+    struct AABB
+    {
+        glm::vec3 min = glm::vec3(0.0f);
+        glm::vec3 max = glm::vec3(0.0f);
+
+        glm::vec3 get_center() const { return (min + max) * 0.5f; }
+        glm::vec3 get_extents() const { return (max - min) * 0.5f; }
+        float get_surface_area() const
+        {
+            const glm::vec3 size = max - min;
+            return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+        bool contains(const AABB& other) const
+        {
+            return glm::all(glm::lessThanEqual(min, other.min)) && glm::all(glm::greaterThanEqual(max, other.max));
+        }
+
+        static AABB merge(const AABB& a, const AABB& b) { return { glm::min(a.min, b.min), glm::max(a.max, b.max) }; }
+        static AABB from_center_extents(const glm::vec3& center, const glm::vec3& extents) { return { center - extents, center + extents }; }
+    };
+
+    // Smallest axis-aligned box around the transformed box
+    inline AABB transform_aabb(const AABB& aabb, const glm::mat4& matrix)
+    {
+        const glm::vec3 center = glm::vec3(matrix * glm::vec4(aabb.get_center(), 1.0f));
+        const glm::vec3 extents = aabb.get_extents();
+        const glm::vec3 world_extents = glm::abs(glm::vec3(matrix[0])) * extents.x
+                                      + glm::abs(glm::vec3(matrix[1])) * extents.y
+                                      + glm::abs(glm::vec3(matrix[2])) * extents.z;
+        return AABB::from_center_extents(center, world_extents);
+    }
+}
@@ -0,0 +1,114 @@
+#include "Frustum.hpp"
+
+#include <glm/geometric.hpp>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define ENGINE_FRUSTUM_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace GraphicsEngine {
+    Frustum::Frustum(const glm::mat4& view_projection)
+    {
+        // Gribb/Hartmann: each clip-space bound is a row of the matrix plus or minus the w row
+        const glm::vec4 row_x(view_projection[0][0], view_projection[1][0], view_projection[2][0], view_projection[3][0]);
+        const glm::vec4 row_y(view_projection[0][1], view_projection[1][1], view_projection[2][1], view_projection[3][1]);
+        const glm::vec4 row_z(view_projection[0][2], view_projection[1][2], view_projection[2][2], view_projection[3][2]);
+        const glm::vec4 row_w(view_projection[0][3], view_projection[1][3], view_projection[2][3], view_projection[3][3]);
+
+        const glm::vec4 planes[6] = {
+            row_w + row_x, row_w - row_x,
+            row_w + row_y, row_w - row_y,
+            row_w + row_z, row_w - row_z
+        };
+        for (int i = 0; i < planes_count; ++i)
+        {
+            glm::vec4 plane(0.0f, 0.0f, 0.0f, 1e30f);
+            if (i < 6)
+            {
+                const float length = glm::length(glm::vec3(planes[i]));
+                plane = length > 0.0f ? planes[i] / length : glm::vec4(0.0f, 0.0f, 0.0f, 1e30f);
+            }
+            m_normal_x[i] = plane.x;
+            m_normal_y[i] = plane.y;
+            m_normal_z[i] = plane.z;
+            m_distance[i] = plane.w;
+        }
+    }
+
+#ifdef ENGINE_FRUSTUM_SSE
+    namespace {
+        // Bit i of outside_mask is set when the volume is fully behind plane i; of crossing_mask when it straddles it
+        void test_planes(const float* normal_x, const float* normal_y, const float* normal_z, const float* distance,
+                         const glm::vec3& center, const glm::vec3& extents, const float radius,
+                         int& outside_mask, int& crossing_mask)
+        {
+            const __m128 sign_mask = _mm_set1_ps(-0.0f);
+            const __m128 center_x = _mm_set1_ps(center.x), center_y = _mm_set1_ps(center.y), center_z = _mm_set1_ps(center.z);
+            const __m128 extents_x = _mm_set1_ps(extents.x), extents_y = _mm_set1_ps(extents.y), extents_z = _mm_set1_ps(extents.z);
+            const __m128 sphere_radius = _mm_set1_ps(radius);
+
+            outside_mask = 0;
+            crossing_mask = 0;
+            for (int first = 0; first < 8; first += 4)
+            {
+                const __m128 nx = _mm_load_ps(normal_x + first);
+                const __m128 ny = _mm_load_ps(normal_y + first);
+                const __m128 nz = _mm_load_ps(normal_z + first);
+                const __m128 d = _mm_load_ps(distance + first);
+
+                const __m128 signed_distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, center_x), _mm_mul_ps(ny, center_y)),
+                                                          _mm_add_ps(_mm_mul_ps(nz, center_z), d));
+                // Projected radius of the box onto the plane normal, plus the sphere radius
+                const __m128 projected_radius = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(_mm_andnot_ps(sign_mask, nx), extents_x), _mm_mul_ps(_mm_andnot_ps(sign_mask, ny), extents_y)),
+                    _mm_add_ps(_mm_mul_ps(_mm_andnot_ps(sign_mask, nz), extents_z), sphere_radius));
+
+                outside_mask |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(signed_distance, projected_radius), _mm_setzero_ps())) << first;
+                crossing_mask |= _mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(signed_distance, projected_radius), _mm_setzero_ps())) << first;
+            }
+        }
+    }
+#else
+    namespace {
+        void test_planes(const float* normal_x, const float* normal_y, const float* normal_z, const float* distance,
+                         const glm::vec3& center, const glm::vec3& extents, const float radius,
+                         int& outside_mask, int& crossing_mask)
+        {
+            outside_mask = 0;
+            crossing_mask = 0;
+            for (int i = 0; i < 8; ++i)
+            {
+                const float signed_distance = normal_x[i] * center.x + normal_y[i] * center.y + normal_z[i] * center.z + distance[i];
+                const float projected_radius = std::abs(normal_x[i]) * extents.x + std::abs(normal_y[i]) * extents.y
+                                             + std::abs(normal_z[i]) * extents.z + radius;
+                outside_mask |= (signed_distance + projected_radius < 0.0f) << i;
+                crossing_mask |= (signed_distance - projected_radius < 0.0f) << i;
+            }
+        }
+    }
+#endif
+
+    Frustum::ETestResult Frustum::test_aabb(const AABB& aabb) const
+    {
+        int outside_mask, crossing_mask;
+        test_planes(m_normal_x, m_normal_y, m_normal_z, m_distance, aabb.get_center(), aabb.get_extents(), 0.0f, outside_mask, crossing_mask);
+        if (outside_mask)
+        {
+            return ETestResult::Outside;
+        }
+        return crossing_mask ? ETestResult::Intersecting : ETestResult::Inside;
+    }
+
+    Frustum::ETestResult Frustum::test_sphere(const glm::vec3& center, const float radius) const
+    {
+        int outside_mask, crossing_mask;
+        test_planes(m_normal_x, m_normal_y, m_normal_z, m_distance, center, glm::vec3(0.0f), radius, outside_mask, crossing_mask);
+        if (outside_mask)
+        {
+            return ETestResult::Outside;
+        }
+        return crossing_mask ? ETestResult::Intersecting : ETestResult::Inside;
+    }
+}
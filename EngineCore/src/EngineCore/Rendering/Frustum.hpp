@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Bounds.hpp"
+
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+
+namespace GraphicsEngine {
+    // The six planes of a view-projection matrix, normals pointing inwards. Planes are kept
+    // as one array per coefficient (padded to eight with planes everything passes) so one
+    // volume is tested against four planes per SSE instruction.
+    class Frustum
+    {
+    public:
+        enum class ETestResult
+        {
+            Outside,
+            Intersecting,
+            Inside
+        };
+
+        explicit Frustum(const glm::mat4& view_projection);
+
+        ETestResult test_aabb(const AABB& aabb) const;
+        ETestResult test_sphere(const glm::vec3& center, const float radius) const;
+
+    private:
+        static constexpr int planes_count = 8;
+
+        alignas(16) float m_normal_x[planes_count];
+        alignas(16) float m_normal_y[planes_count];
+        alignas(16) float m_normal_z[planes_count];
+        alignas(16) float m_distance[planes_count];
+    };
+}
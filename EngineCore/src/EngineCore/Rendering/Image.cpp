@@ -0,0 +1,98 @@
+#include "Image.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace GraphicsEngine {
+    namespace {
+        float srgb_to_linear(const float value)
+        {
+            return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+        }
+
+        float linear_to_srgb(const float value)
+        {
+            return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+        }
+
+        const std::array<float, 256>& get_srgb_to_linear_table()
+        {
+            static const std::array<float, 256> table = []() {
+                std::array<float, 256> values{};
+                for (size_t i = 0; i < values.size(); ++i)
+                {
+                    values[i] = srgb_to_linear(static_cast<float>(i) / 255.0f);
+                }
+                return values;
+            }();
+            return table;
+        }
+
+        uint8_t to_unorm8(const float value)
+        {
+            return static_cast<uint8_t>(std::lround(std::fmin(std::fmax(value, 0.0f), 1.0f) * 255.0f));
+        }
+    }
+
+    bool Image::is_opaque() const
+    {
+        for (size_t i = 3; i < pixels.size(); i += 4)
+        {
+            if (pixels[i] != 255)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Image downsample_image(const Image& image, const bool srgb)
+    {
+        Image result(image.width > 1 ? image.width / 2 : 1, image.height > 1 ? image.height / 2 : 1);
+        const std::array<float, 256>& to_linear = get_srgb_to_linear_table();
+        for (uint32_t y = 0; y < result.height; ++y)
+        {
+            const uint32_t y0 = std::min(y * 2, image.height - 1);
+            const uint32_t y1 = std::min(y * 2 + 1, image.height - 1);
+            for (uint32_t x = 0; x < result.width; ++x)
+            {
+                const uint32_t x0 = std::min(x * 2, image.width - 1);
+                const uint32_t x1 = std::min(x * 2 + 1, image.width - 1);
+                const uint8_t* samples[4] = { image.get_pixel(x0, y0), image.get_pixel(x1, y0), image.get_pixel(x0, y1), image.get_pixel(x1, y1) };
+                uint8_t* pixel = result.get_pixel(x, y);
+                for (int channel = 0; channel < 4; ++channel)
+                {
+                    if (srgb && channel < 3)
+                    {
+                        float sum = 0.0f;
+                        for (const uint8_t* sample : samples)
+                        {
+                            sum += to_linear[sample[channel]];
+                        }
+                        pixel[channel] = to_unorm8(linear_to_srgb(sum * 0.25f));
+                    }
+                    else
+                    {
+                        unsigned int sum = 2;
+                        for (const uint8_t* sample : samples)
+                        {
+                            sum += sample[channel];
+                        }
+                        pixel[channel] = static_cast<uint8_t>(sum / 4);
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    void blit_image(const Image& source, Image& destination, const uint32_t x, const uint32_t y)
+    {
+        for (uint32_t row = 0; row < source.height; ++row)
+        {
+            std::memcpy(destination.get_pixel(x, y + row), source.get_pixel(0, row), static_cast<size_t>(source.width) * 4);
+        }
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace GraphicsEngine {
+    // 8-bit RGBA image in CPU memory, tightly packed rows from the first texture row on
+    struct Image
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<uint8_t> pixels;
+
+        Image() = default;
+        Image(const uint32_t image_width, const uint32_t image_height)
+            : width(image_width)
+            , height(image_height)
+            , pixels(static_cast<size_t>(image_width) * image_height * 4, 0)
+        {
+        }
+
+        uint8_t* get_pixel(const uint32_t x, const uint32_t y) { return pixels.data() + (static_cast<size_t>(y) * width + x) * 4; }
+        const uint8_t* get_pixel(const uint32_t x, const uint32_t y) const { return pixels.data() + (static_cast<size_t>(y) * width + x) * 4; }
+        bool is_empty() const { return pixels.empty(); }
+        bool is_opaque() const;
+    };
+
+    // Next mip level: a 2x2 box filter, halving each side down to 1. With srgb the color
+    // channels are averaged in linear space so mips don't darken; alpha is always linear.
+    Image downsample_image(const Image& image, const bool srgb);
+    // Copies source into destination at (x, y); the rectangle must fit
+    void blit_image(const Image& source, Image& destination, const uint32_t x, const uint32_t y);
+}
@@ -0,0 +1,98 @@
+#define ENGINE_LOG_MODULE Rendering
+
+#include "OffsetAllocator.hpp"
+#include "EngineCore/Debug.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace GraphicsEngine {
+    OffsetAllocator::OffsetAllocator(const size_t capacity)
+    {
+        reset(capacity);
+    }
+
+    void OffsetAllocator::reset(const size_t capacity)
+    {
+        m_free_ranges.clear();
+        m_capacity = capacity;
+        m_used_size = 0;
+        if (capacity > 0)
+        {
+            m_free_ranges.emplace(0, capacity);
+        }
+    }
+
+    OffsetAllocator::Allocation OffsetAllocator::allocate(const size_t size)
+    {
+        if (size == 0)
+        {
+            return {};
+        }
+
+        for (auto it = m_free_ranges.begin(); it != m_free_ranges.end(); ++it)
+        {
+            if (it->second < size)
+            {
+                continue;
+            }
+
+            const Allocation allocation{ it->first, size };
+            const size_t remaining_size = it->second - size;
+            m_free_ranges.erase(it);
+            if (remaining_size > 0)
+            {
+                m_free_ranges.emplace(allocation.offset + size, remaining_size);
+            }
+            m_used_size += size;
+            return allocation;
+        }
+        return {};
+    }
+
+    void OffsetAllocator::free(const Allocation& allocation)
+    {
+        if (!allocation.is_valid())
+        {
+            return;
+        }
+        if (allocation.offset + allocation.size > m_capacity)
+        {
+            LOG_ERROR("OffsetAllocator: freeing range [{}, {}) outside of capacity {}", allocation.offset, allocation.offset + allocation.size, m_capacity);
+            return;
+        }
+
+        size_t offset = allocation.offset;
+        size_t size = allocation.size;
+
+        auto next = m_free_ranges.lower_bound(offset);
+        if (next != m_free_ranges.end() && offset + size == next->first)
+        {
+            size += next->second;
+            next = m_free_ranges.erase(next);
+        }
+        if (next != m_free_ranges.begin())
+        {
+            auto previous = std::prev(next);
+            if (previous->first + previous->second == offset)
+            {
+                offset = previous->first;
+                size += previous->second;
+                m_free_ranges.erase(previous);
+            }
+        }
+
+        m_free_ranges.emplace(offset, size);
+        m_used_size -= allocation.size;
+    }
+
+    size_t OffsetAllocator::get_largest_free_range() const
+    {
+        size_t largest = 0;
+        for (const auto& [offset, size] : m_free_ranges)
+        {
+            largest = std::max(largest, size);
+        }
+        return largest;
+    }
+}
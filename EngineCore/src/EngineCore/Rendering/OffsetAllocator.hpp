@@ -0,0 +1,43 @@
+#pragma once
+
+#include <map>
+#include <cstddef>
+
+namespace GraphicsEngine {
+    // Hands out ranges of a fixed-size address space, e.g. vertices inside one large GPU
+    // buffer. Free ranges are kept sorted by offset and merged with their neighbours when
+    // a range is freed, so fragmentation only remains between live allocations.
+    class OffsetAllocator
+    {
+    public:
+        struct Allocation
+        {
+            static constexpr size_t invalid_offset = ~size_t(0);
+
+            size_t offset = invalid_offset;
+            size_t size = 0;
+
+            bool is_valid() const { return offset != invalid_offset; }
+        };
+
+        explicit OffsetAllocator(const size_t capacity = 0);
+
+        // First fit; returns an invalid allocation when no free range is large enough
+        Allocation allocate(const size_t size);
+        void free(const Allocation& allocation);
+        // Forgets every allocation
+        void reset(const size_t capacity);
+
+        size_t get_capacity() const { return m_capacity; }
+        size_t get_used_size() const { return m_used_size; }
+        size_t get_free_size() const { return m_capacity - m_used_size; }
+        size_t get_largest_free_range() const;
+        size_t get_free_ranges_count() const { return m_free_ranges.size(); }
+
+    private:
+        // offset -> size
+        std::map<size_t, size_t> m_free_ranges;
+        size_t m_capacity = 0;
+        size_t m_used_size = 0;
+    };
+}
@@ -0,0 +1,232 @@
+#define ENGINE_LOG_MODULE Rendering
+
+#include "BatchRenderer.hpp"
+#include "ShaderProgram.hpp"
+#include "Renderer_OpenGL.hpp"
+#include "StateCache_OpenGL.hpp"
+#include "EngineCore/Debug.hpp"
+
+#include <algorithm>
+
+namespace GraphicsEngine {
+    static const BufferLayout s_batch_layout{
+        ShaderDataType::Float3,
+        ShaderDataType::Float4,
+        ShaderDataType::Float2,
+        ShaderDataType::Int
+    };
+
+    static const glm::vec4 s_quad_positions[4] = {
+        { -0.5f, -0.5f, 0.0f, 1.0f },
+        {  0.5f, -0.5f, 0.0f, 1.0f },
+        {  0.5f,  0.5f, 0.0f, 1.0f },
+        { -0.5f,  0.5f, 0.0f, 1.0f }
+    };
+
+    static const glm::vec2 s_quad_tex_coords[4] = {
+        { 0.0f, 0.0f },
+        { 1.0f, 0.0f },
+        { 1.0f, 1.0f },
+        { 0.0f, 1.0f }
+    };
+
+    static const uint32_t s_quad_indices[6] = { 0, 1, 2, 2, 3, 0 };
+
+    namespace {
+        // Returns one past the largest source index, so the caller can check them without reading them twice
+        template <typename TDestination, typename TSource>
+        size_t offset_indices(TDestination* destination, const TSource* source, const size_t count, const uint32_t base_vertex)
+        {
+            size_t referenced_vertices_count = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                destination[i] = static_cast<TDestination>(base_vertex + source[i]);
+                referenced_vertices_count = std::max(referenced_vertices_count, static_cast<size_t>(source[i]) + 1);
+            }
+            return referenced_vertices_count;
+        }
+
+        template <typename TDestination>
+        size_t offset_indices(TDestination* destination, const void* source, const EIndexType source_type, const size_t count, const uint32_t base_vertex)
+        {
+            switch (source_type)
+            {
+                case EIndexType::UInt8:  return offset_indices(destination, static_cast<const uint8_t*>(source), count, base_vertex);
+                case EIndexType::UInt16: return offset_indices(destination, static_cast<const uint16_t*>(source), count, base_vertex);
+                case EIndexType::UInt32: return offset_indices(destination, static_cast<const uint32_t*>(source), count, base_vertex);
+            }
+            return 0;
+        }
+    }
+
+    BatchRenderer::BatchRenderer(const size_t max_vertices, const size_t max_indices)
+        : m_max_vertices(max_vertices)
+        , m_max_indices(max_indices)
+        , m_vertex_buffer(nullptr, max_vertices * sizeof(StreamVertex), s_batch_layout, VertexBuffer::EUsage::PersistentStream)
+        , m_index_buffer(nullptr, max_indices, max_vertices <= 65536 ? EIndexType::UInt16 : EIndexType::UInt32, VertexBuffer::EUsage::PersistentStream)
+    {
+        m_vertex_array.add_vertex_buffer(m_vertex_buffer);
+        m_vertex_array.set_index_buffer(m_index_buffer);
+        VertexArray::unbind();
+    }
+
+    void BatchRenderer::begin(const ShaderProgram& shader_program)
+    {
+        m_shader_program = &shader_program;
+        m_texture_id = 0;
+        m_batches_count = 0;
+        m_submitted_count = 0;
+    }
+
+    void BatchRenderer::end()
+    {
+        flush();
+    }
+
+    void BatchRenderer::set_shader(const ShaderProgram& shader_program)
+    {
+        if (m_shader_program != &shader_program)
+        {
+            flush();
+            m_shader_program = &shader_program;
+        }
+    }
+
+    void BatchRenderer::set_texture(const unsigned int texture_id)
+    {
+        if (m_texture_id != texture_id)
+        {
+            flush();
+            m_texture_id = texture_id;
+        }
+    }
+
+    size_t BatchRenderer::get_fence_waits_count() const
+    {
+        return m_vertex_buffer.get_stream().get_fence_waits_count() + m_index_buffer.get_stream().get_fence_waits_count();
+    }
+
+    void BatchRenderer::draw_quad(const glm::mat4& transform, const glm::vec4& color)
+    {
+        if (m_vertices_count + 4 > m_max_vertices || m_indices_count + 6 > m_max_indices)
+        {
+            flush();
+        }
+        if (!m_vertices)
+        {
+            map_regions();
+        }
+
+        const unsigned int base_vertex = static_cast<unsigned int>(m_vertices_count);
+        for (size_t i = 0; i < 4; ++i)
+        {
+            m_vertices[m_vertices_count++] = { glm::vec3(transform * s_quad_positions[i]), color, s_quad_tex_coords[i], 0 };
+        }
+
+        write_indices(s_quad_indices, EIndexType::UInt32, 6, base_vertex);
+
+        ++m_submitted_count;
+    }
+
+    void BatchRenderer::draw_mesh(const BatchVertex* vertices, const size_t vertices_count,
+                                  const void* indices, const size_t indices_count,
+                                  const glm::mat4& transform, const EIndexType index_type, const int32_t atlas_region)
+    {
+        if (vertices_count > m_max_vertices || indices_count > m_max_indices)
+        {
+            LOG_ERROR("BatchRenderer: mesh with {} vertices and {} indices does not fit into the batch", vertices_count, indices_count);
+            return;
+        }
+
+        if (m_vertices_count + vertices_count > m_max_vertices || m_indices_count + indices_count > m_max_indices)
+        {
+            flush();
+        }
+        if (!m_vertices)
+        {
+            map_regions();
+        }
+
+        const unsigned int base_vertex = static_cast<unsigned int>(m_vertices_count);
+        for (size_t i = 0; i < vertices_count; ++i)
+        {
+            const BatchVertex& vertex = vertices[i];
+            m_vertices[m_vertices_count++] = { glm::vec3(transform * glm::vec4(vertex.position, 1.0f)), vertex.color, vertex.tex_coord, atlas_region };
+        }
+        // An index past the mesh's vertices would read another mesh's vertices in the batch, or unwritten ones
+        const size_t referenced_vertices_count = write_indices(indices, index_type, indices_count, base_vertex);
+        if (referenced_vertices_count > vertices_count)
+        {
+            LOG_ERROR("BatchRenderer: mesh index {} is past its {} vertices", referenced_vertices_count - 1, vertices_count);
+            m_vertices_count = base_vertex;
+            m_indices_count -= indices_count;
+            return;
+        }
+
+        ++m_submitted_count;
+    }
+
+    size_t BatchRenderer::write_indices(const void* indices, const EIndexType index_type, const size_t indices_count, const uint32_t base_vertex)
+    {
+        size_t referenced_vertices_count = 0;
+        if (m_index_buffer.get_type() == EIndexType::UInt16)
+        {
+            referenced_vertices_count = offset_indices(static_cast<uint16_t*>(m_indices) + m_indices_count, indices, index_type, indices_count, base_vertex);
+        }
+        else
+        {
+            referenced_vertices_count = offset_indices(static_cast<uint32_t*>(m_indices) + m_indices_count, indices, index_type, indices_count, base_vertex);
+        }
+        m_indices_count += indices_count;
+        return referenced_vertices_count;
+    }
+
+    void BatchRenderer::map_regions()
+    {
+        m_vertices = static_cast<StreamVertex*>(m_vertex_buffer.get_stream().map_next_region());
+        m_indices = m_index_buffer.get_stream().map_next_region();
+        m_vertices_count = 0;
+        m_indices_count = 0;
+    }
+
+    void BatchRenderer::flush()
+    {
+        if (m_indices_count == 0)
+        {
+            return;
+        }
+        if (!m_shader_program)
+        {
+            LOG_ERROR("BatchRenderer: flush without a shader program");
+            m_vertices_count = 0;
+            m_indices_count = 0;
+            return;
+        }
+
+        m_shader_program->bind();
+        if (m_texture_id)
+        {
+            StateCache_OpenGL::bind_texture_unit(0, m_texture_id);
+        }
+
+        StreamBuffer& vertex_stream = m_vertex_buffer.get_stream();
+        StreamBuffer& index_stream = m_index_buffer.get_stream();
+
+        m_vertex_array.bind();
+        vertex_stream.commit(m_vertices_count * sizeof(StreamVertex));
+        index_stream.commit(m_indices_count * m_index_buffer.get_index_size());
+
+        Renderer_OpenGL::draw(m_vertex_array, m_indices_count,
+                              index_stream.get_region_offset() / m_index_buffer.get_index_size(),
+                              static_cast<int>(vertex_stream.get_region_offset() / sizeof(StreamVertex)));
+        ++m_batches_count;
+
+        vertex_stream.fence();
+        index_stream.fence();
+
+        m_vertices = nullptr;
+        m_indices = nullptr;
+        m_vertices_count = 0;
+        m_indices_count = 0;
+    }
+}
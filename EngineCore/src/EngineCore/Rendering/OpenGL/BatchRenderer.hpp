@@ -0,0 +1,82 @@
+#pragma once
+
+#include "VertexBuffer.hpp"
+#include "IndexBuffer.hpp"
+#include "VertexArray.hpp"
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+namespace GraphicsEngine {
+    class ShaderProgram;
+
+    struct BatchVertex
+    {
+        glm::vec3 position;
+        glm::vec4 color;
+        glm::vec2 tex_coord;
+    };
+
+    // Collects quads and small meshes into shared vertex/index streams (transformed on submission)
+    // and draws them with as few draw calls as possible. A flush happens only when the
+    // streams are full or the shader/texture changes. Vertices are written straight into
+    // persistently mapped StreamBuffer regions. Indices are 16-bit unless max_vertices needs more.
+    class BatchRenderer
+    {
+    public:
+        BatchRenderer(const size_t max_vertices = 40000, const size_t max_indices = 60000);
+        BatchRenderer(const BatchRenderer&) = delete;
+        BatchRenderer& operator=(const BatchRenderer&) = delete;
+
+        void begin(const ShaderProgram& shader_program);
+        void end();
+
+        void set_shader(const ShaderProgram& shader_program);
+        void set_texture(const unsigned int texture_id);
+
+        void draw_quad(const glm::mat4& transform, const glm::vec4& color);
+        // Indices are relative to vertices; a mesh with an index of vertices_count or more is skipped with an error.
+        // atlas_region reaches the shader as an int attribute at location 3 on every vertex of the mesh
+        void draw_mesh(const BatchVertex* vertices, const size_t vertices_count,
+                       const void* indices, const size_t indices_count,
+                       const glm::mat4& transform, const EIndexType index_type = EIndexType::UInt32, const int32_t atlas_region = 0);
+
+        size_t get_batches_count() const { return m_batches_count; }
+        size_t get_submitted_count() const { return m_submitted_count; }
+        size_t get_fence_waits_count() const;
+
+    private:
+        // A BatchVertex as written to the stream, with the atlas region of the draw it belongs to
+        struct StreamVertex
+        {
+            glm::vec3 position;
+            glm::vec4 color;
+            glm::vec2 tex_coord;
+            int32_t atlas_region;
+        };
+
+        void map_regions();
+        void flush();
+        // Returns one past the largest of the indices written
+        size_t write_indices(const void* indices, const EIndexType index_type, const size_t indices_count, const uint32_t base_vertex);
+
+        size_t m_max_vertices;
+        size_t m_max_indices;
+        StreamVertex* m_vertices = nullptr;
+        void* m_indices = nullptr;
+        size_t m_vertices_count = 0;
+        size_t m_indices_count = 0;
+
+        VertexBuffer m_vertex_buffer;
+        IndexBuffer m_index_buffer;
+        VertexArray m_vertex_array;
+
+        const ShaderProgram* m_shader_program = nullptr;
+        unsigned int m_texture_id = 0;
+
+        size_t m_batches_count = 0;
+        size_t m_submitted_count = 0;
+    };
+}
@@ -0,0 +1,143 @@
+#define ENGINE_LOG_MODULE Rendering
+
+#include "GpuProfiler_OpenGL.hpp"
+#include "EngineCore/Profiling/Profiler.hpp"
+#include "EngineCore/Debug.hpp"
+
+#include <glad/glad.h>
+
+namespace GraphicsEngine {
+    GpuProfiler_OpenGL::GpuProfiler_OpenGL()
+    {
+        for (Frame& frame : m_frames)
+        {
+            glGenQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+            frame.zones.reserve(max_zones_per_frame);
+        }
+        calibrate();
+    }
+
+    GpuProfiler_OpenGL::~GpuProfiler_OpenGL()
+    {
+        for (Frame& frame : m_frames)
+        {
+            glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+        }
+    }
+
+    void GpuProfiler_OpenGL::calibrate()
+    {
+        // Reading GL_TIMESTAMP does not wait for queued commands, only for the driver to answer
+        GLint64 gl_time = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gl_time);
+        m_clock_offset_ns = Profiler::now_ns() - static_cast<int64_t>(gl_time);
+    }
+
+    void GpuProfiler_OpenGL::collect(Frame& frame)
+    {
+        frame.pending = false;
+        if (frame.zones.empty())
+        {
+            return;
+        }
+
+        // Queries complete in order, and the frame zone's end is written last
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(frame.queries[frame.zones.front().end_query], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available != GL_TRUE)
+        {
+            ++m_dropped_frames_count;
+            return;
+        }
+
+        for (const Zone& zone : frame.zones)
+        {
+            GLuint64 begin = 0;
+            GLuint64 end = 0;
+            glGetQueryObjectui64v(frame.queries[zone.begin_query], GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(frame.queries[zone.end_query], GL_QUERY_RESULT, &end);
+            Profiler::add_gpu_zone(zone.name, static_cast<int64_t>(begin) + m_clock_offset_ns,
+                                   static_cast<int64_t>(end) + m_clock_offset_ns, zone.depth);
+            if (zone.depth == 0)
+            {
+                m_last_frame_time_ms = static_cast<double>(end - begin) / 1.0e6;
+            }
+        }
+    }
+
+    void GpuProfiler_OpenGL::begin_frame()
+    {
+        m_frame_index = (m_frame_index + 1) % frames_in_flight;
+        Frame& frame = m_frames[m_frame_index];
+        if (frame.pending)
+        {
+            collect(frame);
+        }
+        // The two clocks drift apart slowly; re-measuring every frame keeps zones aligned
+        calibrate();
+
+        frame.zones.clear();
+        frame.queries_used = 0;
+        m_depth = 0;
+        m_refused_depth = 0;
+        m_in_frame = Profiler::is_enabled();
+        if (!m_in_frame)
+        {
+            return;
+        }
+        begin_zone("GPU frame");
+    }
+
+    void GpuProfiler_OpenGL::end_frame()
+    {
+        if (!m_in_frame)
+        {
+            return;
+        }
+        m_refused_depth = 0;
+        while (m_depth > 0)
+        {
+            end_zone();
+        }
+        m_frames[m_frame_index].pending = true;
+        m_in_frame = false;
+    }
+
+    void GpuProfiler_OpenGL::begin_zone(const char* name)
+    {
+        Frame& frame = m_frames[m_frame_index];
+        if (!m_in_frame)
+        {
+            return;
+        }
+        if (m_refused_depth > 0 || frame.queries_used + 2 > frame.queries.size() || m_depth >= m_open_zones.size())
+        {
+            ++m_refused_depth;
+            return;
+        }
+
+        const uint32_t begin_query = static_cast<uint32_t>(frame.queries_used++);
+        const uint32_t end_query = static_cast<uint32_t>(frame.queries_used++);
+        glQueryCounter(frame.queries[begin_query], GL_TIMESTAMP);
+        m_open_zones[m_depth] = static_cast<uint32_t>(frame.zones.size());
+        frame.zones.push_back({ name, m_depth, begin_query, end_query });
+        ++m_depth;
+    }
+
+    void GpuProfiler_OpenGL::end_zone()
+    {
+        if (!m_in_frame || m_depth == 0)
+        {
+            return;
+        }
+        if (m_refused_depth > 0)
+        {
+            --m_refused_depth;
+            return;
+        }
+
+        Frame& frame = m_frames[m_frame_index];
+        const Zone& zone = frame.zones[m_open_zones[--m_depth]];
+        glQueryCounter(frame.queries[zone.end_query], GL_TIMESTAMP);
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "EngineCore/Profiling/Profiler.hpp"
+
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace GraphicsEngine {
+    // GPU zones measured with GL_TIMESTAMP queries. Each frame writes into its own set of
+    // queries and the set is read back frames_in_flight frames later, by which time the GPU
+    // has normally passed it; a set that is still not available is dropped instead of waited
+    // for, so the profiler never stalls the pipeline. Results are converted to the CPU clock
+    // and handed to Profiler. Timestamps rather than GL_TIME_ELAPSED so zones can nest.
+    // All calls must come from the thread that owns the GL context.
+    class GpuProfiler_OpenGL
+    {
+    public:
+        static constexpr size_t frames_in_flight = 4;
+        static constexpr size_t max_zones_per_frame = 64;
+
+        GpuProfiler_OpenGL();
+        ~GpuProfiler_OpenGL();
+
+        GpuProfiler_OpenGL(const GpuProfiler_OpenGL&) = delete;
+        GpuProfiler_OpenGL& operator=(const GpuProfiler_OpenGL&) = delete;
+
+        // Reads back the oldest frame's queries and opens a "GPU frame" zone. Does nothing
+        // while Profiler is disabled
+        void begin_frame();
+        void end_frame();
+
+        void begin_zone(const char* name);
+        void end_zone();
+
+        // Frames whose results were not ready in time
+        size_t get_dropped_frames_count() const { return m_dropped_frames_count; }
+        double get_last_frame_time_ms() const { return m_last_frame_time_ms; }
+
+    private:
+        struct Zone
+        {
+            const char* name;
+            uint32_t depth;
+            uint32_t begin_query;
+            uint32_t end_query;
+        };
+
+        struct Frame
+        {
+            std::array<unsigned int, max_zones_per_frame * 2> queries{};
+            std::vector<Zone> zones;
+            size_t queries_used = 0;
+            bool pending = false;
+        };
+
+        void collect(Frame& frame);
+        void calibrate();
+
+        std::array<Frame, frames_in_flight> m_frames;
+        size_t m_frame_index = 0;
+        bool m_in_frame = false;
+        // Indices into the current frame's zones of the zones still open
+        std::array<uint32_t, max_zones_per_frame> m_open_zones{};
+        uint32_t m_depth = 0;
+        // Zones refused by begin_zone(), so their end_zone() is ignored too
+        uint32_t m_refused_depth = 0;
+
+        // CPU clock minus GL clock, in nanoseconds
+        int64_t m_clock_offset_ns = 0;
+        size_t m_dropped_frames_count = 0;
+        double m_last_frame_time_ms = 0.0;
+    };
+
+    class GpuProfileScope
+    {
+    public:
+        GpuProfileScope(GpuProfiler_OpenGL& profiler, const char* name)
+            : m_profiler(profiler)
+        {
+            m_profiler.begin_zone(name);
+        }
+        ~GpuProfileScope() { m_profiler.end_zone(); }
+
+        GpuProfileScope(const GpuProfileScope&) = delete;
+        GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+    private:
+        GpuProfiler_OpenGL& m_profiler;
+    };
+}
+
+#ifdef ENGINE_PROFILING
+// Times the GPU work issued in the rest of the enclosing block
+#define GPU_PROFILE_SCOPE(profiler, name) ::GraphicsEngine::GpuProfileScope ENGINE_PROFILE_CONCAT(gpu_profile_scope_, __LINE__)(profiler, name)
+#else
+#define GPU_PROFILE_SCOPE(profiler, name)
+#endif
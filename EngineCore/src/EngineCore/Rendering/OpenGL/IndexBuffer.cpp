@@ -1,6 +1,13 @@
+#define ENGINE_LOG_MODULE Rendering
+
 #include "IndexBuffer.hpp"
 #include "EngineCore/Debug.hpp"
+#include "EngineCore/Rendering/RenderStats.hpp"
+#include "StateCache_OpenGL.hpp"
+#include "Renderer_OpenGL.hpp"
 #include <glad/glad.h>
+#include <algorithm>
+#include <cstring>
 
 namespace GraphicsEngine {
     constexpr GLenum usage_to_GLenum(const VertexBuffer::EUsage usage)
@@ -9,26 +16,140 @@ namespace GraphicsEngine {
         {
             case VertexBuffer::EUsage::Static:  return GL_STATIC_DRAW;
             case VertexBuffer::EUsage::Dynamic: return GL_DYNAMIC_DRAW;
-            case VertexBuffer::EUsage::Stream:  return GL_STREAM_DRAW;
+            case VertexBuffer::EUsage::Stream:
+            case VertexBuffer::EUsage::PersistentStream: return GL_STREAM_DRAW;
         }
         LOG_ERROR("Unknown VertexBuffer usage");
         return GL_STREAM_DRAW;
     }
-    IndexBuffer::IndexBuffer(const void* data, const size_t count, const VertexBuffer::EUsage usage)
+    constexpr unsigned int usage_to_storage_flags(const VertexBuffer::EUsage usage)
+    {
+        return usage == VertexBuffer::EUsage::Static ? 0 : GL_DYNAMIC_STORAGE_BIT;
+    }
+    namespace {
+        template <typename TSource, typename TDestination>
+        void copy_indices(const void* source, void* destination, const size_t count)
+        {
+            const TSource* source_indices = static_cast<const TSource*>(source);
+            TDestination* destination_indices = static_cast<TDestination*>(destination);
+            for (size_t i = 0; i < count; ++i)
+            {
+                destination_indices[i] = static_cast<TDestination>(source_indices[i]);
+            }
+        }
+
+        template <typename TSource>
+        void copy_indices_to(const void* source, void* destination, const EIndexType destination_type, const size_t count)
+        {
+            switch (destination_type)
+            {
+                case EIndexType::UInt8:  copy_indices<TSource, uint8_t>(source, destination, count); return;
+                case EIndexType::UInt16: copy_indices<TSource, uint16_t>(source, destination, count); return;
+                case EIndexType::UInt32: copy_indices<TSource, uint32_t>(source, destination, count); return;
+            }
+        }
+
+        template <typename TIndex>
+        size_t get_referenced_vertices_count(const void* indices, const size_t count)
+        {
+            const TIndex* typed_indices = static_cast<const TIndex*>(indices);
+            size_t vertices_count = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                vertices_count = std::max(vertices_count, static_cast<size_t>(typed_indices[i]) + 1);
+            }
+            return vertices_count;
+        }
+    }
+
+    void convert_indices(const void* source, const EIndexType source_type, void* destination, const EIndexType destination_type, const size_t count)
+    {
+        if (source_type == destination_type)
+        {
+            std::memcpy(destination, source, count * get_index_size(source_type));
+            return;
+        }
+        switch (source_type)
+        {
+            case EIndexType::UInt8:  copy_indices_to<uint8_t>(source, destination, destination_type, count); return;
+            case EIndexType::UInt16: copy_indices_to<uint16_t>(source, destination, destination_type, count); return;
+            case EIndexType::UInt32: copy_indices_to<uint32_t>(source, destination, destination_type, count); return;
+        }
+    }
+
+    size_t get_referenced_vertices_count(const void* indices, const EIndexType type, const size_t count)
+    {
+        switch (type)
+        {
+            case EIndexType::UInt8:  return get_referenced_vertices_count<uint8_t>(indices, count);
+            case EIndexType::UInt16: return get_referenced_vertices_count<uint16_t>(indices, count);
+            case EIndexType::UInt32: return get_referenced_vertices_count<uint32_t>(indices, count);
+        }
+        return 0;
+    }
+
+    unsigned int get_gl_index_type(const EIndexType type)
+    {
+        switch (type)
+        {
+            case EIndexType::UInt8:  return GL_UNSIGNED_BYTE;
+            case EIndexType::UInt16: return GL_UNSIGNED_SHORT;
+            case EIndexType::UInt32: return GL_UNSIGNED_INT;
+        }
+        LOG_ERROR("Unknown EIndexType");
+        return GL_UNSIGNED_INT;
+    }
+
+    IndexBuffer::IndexBuffer(const void* data, const size_t count, const EIndexType type, const VertexBuffer::EUsage usage)
         : m_count(count)
+        , m_type(type)
+        , m_usage(usage)
     {
-        glGenBuffers(1, &m_id);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(GLuint), data, usage_to_GLenum(usage));
+        const bool direct_state_access = Renderer_OpenGL::has_direct_state_access();
+        if (direct_state_access)
+        {
+            glCreateBuffers(1, &m_id);
+        }
+        else
+        {
+            glGenBuffers(1, &m_id);
+            StateCache_OpenGL::bind_buffer(GL_ELEMENT_ARRAY_BUFFER, m_id);
+        }
+        if (usage == VertexBuffer::EUsage::PersistentStream)
+        {
+            m_stream.allocate(GL_ELEMENT_ARRAY_BUFFER, m_id, count * get_index_size());
+            if (data)
+            {
+                update_buffer(data, count);
+            }
+            return;
+        }
+
+        if (direct_state_access)
+        {
+            glNamedBufferStorage(m_id, static_cast<GLsizeiptr>(count * get_index_size()), data, usage_to_storage_flags(usage));
+        }
+        else
+        {
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * get_index_size(), data, usage_to_GLenum(usage));
+        }
+        if (data)
+        {
+            RenderStats::upload_bytes += count * get_index_size();
+        }
     }
     IndexBuffer::~IndexBuffer()
     {
+        StateCache_OpenGL::on_buffer_deleted(m_id);
         glDeleteBuffers(1, &m_id);
     }
     IndexBuffer& IndexBuffer::operator=(IndexBuffer&& index_buffer) noexcept
     {
         m_id = index_buffer.m_id;
         m_count = index_buffer.m_count;
+        m_type = index_buffer.m_type;
+        m_usage = index_buffer.m_usage;
+        m_stream = std::move(index_buffer.m_stream);
         index_buffer.m_id = 0;
         index_buffer.m_count = 0;
         return *this;
@@ -36,16 +157,40 @@ namespace GraphicsEngine {
     IndexBuffer::IndexBuffer(IndexBuffer&& index_buffer) noexcept
         : m_id(index_buffer.m_id)
         , m_count(index_buffer.m_count)
+        , m_type(index_buffer.m_type)
+        , m_usage(index_buffer.m_usage)
+        , m_stream(std::move(index_buffer.m_stream))
     {
         index_buffer.m_id = 0;
         index_buffer.m_count = 0;
     }
     void IndexBuffer::bind() const
     {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id);
+        StateCache_OpenGL::bind_buffer(GL_ELEMENT_ARRAY_BUFFER, m_id);
     }
     void IndexBuffer::unbind()
     {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        StateCache_OpenGL::bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+    void IndexBuffer::update_buffer(const void* data, const size_t count, const size_t offset)
+    {
+        if (m_usage == VertexBuffer::EUsage::PersistentStream)
+        {
+            // Writes into the next region; readers must use m_stream.get_region_offset()
+            std::memcpy(m_stream.map_next_region(), data, count * get_index_size());
+            m_stream.commit(count * get_index_size());
+            return;
+        }
+        if (Renderer_OpenGL::has_direct_state_access())
+        {
+            glNamedBufferSubData(m_id, static_cast<GLintptr>(offset * get_index_size()), static_cast<GLsizeiptr>(count * get_index_size()), data);
+        }
+        else
+        {
+            // The element array binding belongs to the bound VAO, so upload through a target that does not
+            StateCache_OpenGL::bind_buffer(GL_COPY_WRITE_BUFFER, m_id);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(offset * get_index_size()), count * get_index_size(), data);
+        }
+        RenderStats::upload_bytes += count * get_index_size();
     }
 }
\ No newline at end of file
@@ -2,9 +2,45 @@
 #include "VertexBuffer.hpp"
 
 namespace GraphicsEngine {
+    enum class EIndexType : uint8_t
+    {
+        UInt8,
+        UInt16,
+        UInt32
+    };
+
+    constexpr size_t get_index_size(const EIndexType type)
+    {
+        switch (type)
+        {
+            case EIndexType::UInt8:  return 1;
+            case EIndexType::UInt16: return 2;
+            case EIndexType::UInt32: return 4;
+        }
+        return 4;
+    }
+
+    // Narrowest type whose indices address vertices_count vertices
+    constexpr EIndexType select_index_type(const size_t vertices_count)
+    {
+        if (vertices_count <= 256)
+        {
+            return EIndexType::UInt8;
+        }
+        return vertices_count <= 65536 ? EIndexType::UInt16 : EIndexType::UInt32;
+    }
+
+    // Copies count indices, widening or narrowing them; narrowing assumes every index fits
+    void convert_indices(const void* source, const EIndexType source_type, void* destination, const EIndexType destination_type, const size_t count);
+    // One past the largest of count indices: how many vertices from the first they can reference
+    size_t get_referenced_vertices_count(const void* indices, const EIndexType type, const size_t count);
+    unsigned int get_gl_index_type(const EIndexType type);
+
     class IndexBuffer {
     public:
-        IndexBuffer(const void* data, const size_t count, const VertexBuffer::EUsage usage = VertexBuffer::EUsage::Static);
+        // data holds count indices of type
+        IndexBuffer(const void* data, const size_t count, const EIndexType type = EIndexType::UInt32,
+                    const VertexBuffer::EUsage usage = VertexBuffer::EUsage::Static);
         ~IndexBuffer();
         IndexBuffer(const IndexBuffer&) = delete;
         IndexBuffer& operator=(const IndexBuffer&) = delete;
@@ -12,9 +48,22 @@ namespace GraphicsEngine {
         IndexBuffer(IndexBuffer&& index_buffer) noexcept;
         void bind() const;
         static void unbind();
+
+        // data holds indices of the buffer's type; offset is in indices and ignored for PersistentStream buffers, which always write a whole new region
+        void update_buffer(const void* data, const size_t count, const size_t offset = 0);
+
+        unsigned int get_id() const { return m_id; }
         size_t get_count() const { return m_count; }
+        EIndexType get_type() const { return m_type; }
+        size_t get_index_size() const { return GraphicsEngine::get_index_size(m_type); }
+        StreamBuffer& get_stream() { return m_stream; }
+        const StreamBuffer& get_stream() const { return m_stream; }
+        VertexBuffer::EUsage get_usage() const { return m_usage; }
     private:
         unsigned int m_id = 0;
         size_t m_count;
+        EIndexType m_type;
+        VertexBuffer::EUsage m_usage;
+        StreamBuffer m_stream;
     };
 }
\ No newline at end of file
@@ -0,0 +1,251 @@
+#define ENGINE_LOG_MODULE Rendering
+
+#include "MeshPool.hpp"
+#include "ShaderProgram.hpp"
+#include "Renderer_OpenGL.hpp"
+#include "StateCache_OpenGL.hpp"
+#include "EngineCore/Rendering/RenderStats.hpp"
+#include "EngineCore/Debug.hpp"
+#include "EngineCore/Memory/ScratchScope.hpp"
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstring>
+
+namespace GraphicsEngine {
+    MeshPool::MeshPool(BufferLayout layout, const size_t max_vertices, const size_t max_indices, const size_t max_draws)
+        : m_vertex_size(layout.get_stride())
+        , m_max_draws(max_draws)
+        , m_vertex_buffer(nullptr, max_vertices * layout.get_stride(), std::move(layout), VertexBuffer::EUsage::Dynamic)
+        , m_index_buffer(nullptr, max_indices, select_index_type(max_vertices), VertexBuffer::EUsage::Dynamic)
+        , m_vertex_allocator(max_vertices)
+        , m_index_allocator(max_indices)
+    {
+        glGenBuffers(1, &m_indirect_buffer_id);
+        StateCache_OpenGL::bind_buffer(GL_DRAW_INDIRECT_BUFFER, m_indirect_buffer_id);
+        m_indirect_stream.allocate(GL_DRAW_INDIRECT_BUFFER, m_indirect_buffer_id, max_draws * sizeof(DrawElementsIndirectCommand));
+
+        create_vertex_array();
+    }
+
+    MeshPool::~MeshPool()
+    {
+        m_indirect_stream = StreamBuffer();
+        StateCache_OpenGL::on_buffer_deleted(m_indirect_buffer_id);
+        glDeleteBuffers(1, &m_indirect_buffer_id);
+    }
+
+    void MeshPool::create_vertex_array()
+    {
+        m_vertex_array = std::make_unique<VertexArray>();
+        m_vertex_array->add_vertex_buffer(m_vertex_buffer);
+        if (m_instance_buffer)
+        {
+            m_vertex_array->add_vertex_buffer(*m_instance_buffer);
+        }
+        m_vertex_array->set_index_buffer(m_index_buffer);
+        VertexArray::unbind();
+    }
+
+    void MeshPool::attach_instance_buffer(const VertexBuffer* instance_buffer)
+    {
+        if (m_instance_buffer && instance_buffer)
+        {
+            m_vertex_array->set_vertex_buffer(1, *instance_buffer);
+            VertexArray::unbind();
+            m_instance_buffer = instance_buffer;
+            return;
+        }
+        m_instance_buffer = instance_buffer;
+        create_vertex_array();
+    }
+
+    MeshHandle MeshPool::add_mesh(const void* vertices, const size_t vertices_count, const void* indices, const size_t indices_count,
+                                  const EIndexType index_type)
+    {
+        const OffsetAllocator::Allocation vertices_allocation = m_vertex_allocator.allocate(vertices_count);
+        if (!vertices_allocation.is_valid())
+        {
+            LOG_ERROR("MeshPool: no free range for {} vertices ({} free)", vertices_count, m_vertex_allocator.get_free_size());
+            return {};
+        }
+        const OffsetAllocator::Allocation indices_allocation = m_index_allocator.allocate(indices_count);
+        if (!indices_allocation.is_valid())
+        {
+            LOG_ERROR("MeshPool: no free range for {} indices ({} free)", indices_count, m_index_allocator.get_free_size());
+            m_vertex_allocator.free(vertices_allocation);
+            return {};
+        }
+
+        m_vertex_buffer.update_buffer(vertices, vertices_count * m_vertex_size, vertices_allocation.offset * m_vertex_size);
+        if (index_type == m_index_buffer.get_type())
+        {
+            m_index_buffer.update_buffer(indices, indices_count, indices_allocation.offset);
+        }
+        else
+        {
+            ScratchScope scratch;
+            void* converted = scratch.allocate(indices_count * m_index_buffer.get_index_size());
+            convert_indices(indices, index_type, converted, m_index_buffer.get_type(), indices_count);
+            m_index_buffer.update_buffer(converted, indices_count, indices_allocation.offset);
+        }
+
+        MeshHandle handle;
+        if (!m_free_mesh_slots.empty())
+        {
+            handle.index = m_free_mesh_slots.back();
+            m_free_mesh_slots.pop_back();
+        }
+        else
+        {
+            handle.index = static_cast<unsigned int>(m_meshes.size());
+            m_meshes.emplace_back();
+        }
+        m_meshes[handle.index] = { vertices_allocation, indices_allocation };
+        return handle;
+    }
+
+    void MeshPool::remove_mesh(const MeshHandle handle)
+    {
+        if (!is_live(handle))
+        {
+            LOG_ERROR("MeshPool: removing an invalid mesh handle");
+            return;
+        }
+
+        Mesh& mesh = m_meshes[handle.index];
+        m_vertex_allocator.free(mesh.vertices);
+        m_index_allocator.free(mesh.indices);
+        mesh = {};
+        m_free_mesh_slots.push_back(handle.index);
+    }
+
+    bool MeshPool::is_live(const MeshHandle handle) const
+    {
+        return handle.is_valid() && handle.index < m_meshes.size() && m_meshes[handle.index].vertices.is_valid();
+    }
+
+    void MeshPool::compact()
+    {
+        std::vector<unsigned int> live_meshes;
+        for (unsigned int i = 0; i < m_meshes.size(); ++i)
+        {
+            if (m_meshes[i].vertices.is_valid())
+            {
+                live_meshes.push_back(i);
+            }
+        }
+
+        // Packed in the current vertex order, so ranges only ever move towards the start
+        std::sort(live_meshes.begin(), live_meshes.end(), [this](const unsigned int a, const unsigned int b) {
+            return m_meshes[a].vertices.offset < m_meshes[b].vertices.offset;
+        });
+
+        const size_t used_vertices_bytes = m_vertex_allocator.get_used_size() * m_vertex_size;
+        const size_t index_size = m_index_buffer.get_index_size();
+        const size_t used_indices_bytes = m_index_allocator.get_used_size() * index_size;
+
+        // glCopyBufferSubData rejects overlapping ranges within one buffer, so pack into a scratch buffer and copy back
+        unsigned int scratch_buffer_id = 0;
+        glGenBuffers(1, &scratch_buffer_id);
+        StateCache_OpenGL::bind_buffer(GL_COPY_WRITE_BUFFER, scratch_buffer_id);
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(used_vertices_bytes + used_indices_bytes), nullptr, GL_STREAM_COPY);
+
+        m_vertex_allocator.reset(m_vertex_allocator.get_capacity());
+        m_index_allocator.reset(m_index_allocator.get_capacity());
+
+        StateCache_OpenGL::bind_buffer(GL_COPY_READ_BUFFER, m_vertex_buffer.get_id());
+        for (const unsigned int mesh_index : live_meshes)
+        {
+            Mesh& mesh = m_meshes[mesh_index];
+            const OffsetAllocator::Allocation packed = m_vertex_allocator.allocate(mesh.vertices.size);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(mesh.vertices.offset * m_vertex_size),
+                                static_cast<GLintptr>(packed.offset * m_vertex_size), static_cast<GLsizeiptr>(mesh.vertices.size * m_vertex_size));
+            mesh.vertices = packed;
+        }
+
+        StateCache_OpenGL::bind_buffer(GL_COPY_READ_BUFFER, m_index_buffer.get_id());
+        for (const unsigned int mesh_index : live_meshes)
+        {
+            Mesh& mesh = m_meshes[mesh_index];
+            const OffsetAllocator::Allocation packed = m_index_allocator.allocate(mesh.indices.size);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(mesh.indices.offset * index_size),
+                                static_cast<GLintptr>(used_vertices_bytes + packed.offset * index_size),
+                                static_cast<GLsizeiptr>(mesh.indices.size * index_size));
+            mesh.indices = packed;
+        }
+
+        StateCache_OpenGL::bind_buffer(GL_COPY_READ_BUFFER, scratch_buffer_id);
+        StateCache_OpenGL::bind_buffer(GL_COPY_WRITE_BUFFER, m_vertex_buffer.get_id());
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(used_vertices_bytes));
+        StateCache_OpenGL::bind_buffer(GL_COPY_WRITE_BUFFER, m_index_buffer.get_id());
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(used_vertices_bytes), 0,
+                            static_cast<GLsizeiptr>(used_indices_bytes));
+
+        StateCache_OpenGL::on_buffer_deleted(scratch_buffer_id);
+        glDeleteBuffers(1, &scratch_buffer_id);
+    }
+
+    void MeshPool::begin()
+    {
+        m_commands.clear();
+        m_draws_count = 0;
+    }
+
+    void MeshPool::add_draw(const MeshHandle handle, const unsigned int instances_count, const unsigned int base_instance)
+    {
+        if (!is_live(handle))
+        {
+            LOG_ERROR("MeshPool: drawing an invalid mesh handle");
+            return;
+        }
+        const Mesh& mesh = m_meshes[handle.index];
+        m_commands.push_back({ static_cast<uint32_t>(mesh.indices.size), instances_count, static_cast<uint32_t>(mesh.indices.offset),
+                               static_cast<int32_t>(mesh.vertices.offset), base_instance });
+    }
+
+    void MeshPool::add_draw(const MeshHandle handle, const size_t first_index, const size_t indices_count, const unsigned int instances_count,
+                            const unsigned int base_instance)
+    {
+        if (!is_live(handle))
+        {
+            LOG_ERROR("MeshPool: drawing an invalid mesh handle");
+            return;
+        }
+        const Mesh& mesh = m_meshes[handle.index];
+        if (first_index > mesh.indices.size || indices_count > mesh.indices.size - first_index)
+        {
+            LOG_ERROR("MeshPool: indices {} to {} are outside the mesh's {}", first_index, first_index + indices_count, mesh.indices.size);
+            return;
+        }
+        m_commands.push_back({ static_cast<uint32_t>(indices_count), instances_count, static_cast<uint32_t>(mesh.indices.offset + first_index),
+                               static_cast<int32_t>(mesh.vertices.offset), base_instance });
+    }
+
+    void MeshPool::end(const ShaderProgram& shader_program)
+    {
+        if (m_commands.empty())
+        {
+            return;
+        }
+
+        shader_program.bind();
+        StateCache_OpenGL::bind_buffer(GL_DRAW_INDIRECT_BUFFER, m_indirect_buffer_id);
+        for (size_t first = 0; first < m_commands.size(); first += m_max_draws)
+        {
+            const size_t commands_count = std::min(m_max_draws, m_commands.size() - first);
+            const size_t commands_size = commands_count * sizeof(DrawElementsIndirectCommand);
+
+            std::memcpy(m_indirect_stream.map_next_region(), m_commands.data() + first, commands_size);
+            m_indirect_stream.commit(commands_size);
+            Renderer_OpenGL::multi_draw_indirect(*m_vertex_array, m_indirect_stream.get_region_offset(), commands_count);
+            for (size_t i = first; i < first + commands_count; ++i)
+            {
+                RenderStats::triangles += static_cast<size_t>(m_commands[i].count / 3) * m_commands[i].instance_count;
+            }
+            m_indirect_stream.fence();
+        }
+        m_draws_count += m_commands.size();
+        m_commands.clear();
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "VertexBuffer.hpp"
+#include "IndexBuffer.hpp"
+#include "VertexArray.hpp"
+#include "StreamBuffer.hpp"
+#include "EngineCore/Rendering/OffsetAllocator.hpp"
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+namespace GraphicsEngine {
+    class ShaderProgram;
+
+    struct MeshHandle
+    {
+        static constexpr unsigned int invalid_index = ~0u;
+
+        unsigned int index = invalid_index;
+
+        bool is_valid() const { return index != invalid_index; }
+    };
+
+    // Stores many meshes that share one vertex layout in a single vertex buffer and a
+    // single index buffer, so they all draw from one VAO. Ranges are sub-allocated with
+    // OffsetAllocator. A frame's draws are collected into an indirect command buffer
+    // and issued with one glMultiDrawElementsIndirect per max_draws commands. Indices use
+    // the narrowest type that addresses max_vertices.
+    class MeshPool
+    {
+    public:
+        MeshPool(BufferLayout layout, const size_t max_vertices, const size_t max_indices, const size_t max_draws = 65536);
+        ~MeshPool();
+        MeshPool(const MeshPool&) = delete;
+        MeshPool& operator=(const MeshPool&) = delete;
+
+        // Indices are relative to the mesh's own vertices and are converted to the pool's index type.
+        // Returns an invalid handle when the pool is full
+        MeshHandle add_mesh(const void* vertices, const size_t vertices_count, const void* indices, const size_t indices_count,
+                            const EIndexType index_type = EIndexType::UInt32);
+        void remove_mesh(const MeshHandle handle);
+        // Moves every live mesh to the front of the buffers; handles stay valid
+        void compact();
+
+        // Per-instance attributes follow the pool's vertex attributes; pass nullptr to detach
+        void attach_instance_buffer(const VertexBuffer* instance_buffer);
+
+        void begin();
+        void add_draw(const MeshHandle handle, const unsigned int instances_count = 1, const unsigned int base_instance = 0);
+        // Draws indices_count of the mesh's indices from first_index on, e.g. one of its LODs
+        void add_draw(const MeshHandle handle, const size_t first_index, const size_t indices_count, const unsigned int instances_count,
+                      const unsigned int base_instance);
+        void end(const ShaderProgram& shader_program);
+
+        size_t get_meshes_count() const { return m_meshes.size() - m_free_mesh_slots.size(); }
+        size_t get_draws_count() const { return m_draws_count; }
+        const OffsetAllocator& get_vertex_allocator() const { return m_vertex_allocator; }
+        const OffsetAllocator& get_index_allocator() const { return m_index_allocator; }
+        EIndexType get_index_type() const { return m_index_buffer.get_type(); }
+
+    private:
+        struct Mesh
+        {
+            OffsetAllocator::Allocation vertices;
+            OffsetAllocator::Allocation indices;
+        };
+
+        // Matches the layout glMultiDrawElementsIndirect reads
+        struct DrawElementsIndirectCommand
+        {
+            uint32_t count;
+            uint32_t instance_count;
+            uint32_t first_index;
+            int32_t base_vertex;
+            uint32_t base_instance;
+        };
+
+        void create_vertex_array();
+        // Whether handle refers to a mesh that has not been removed
+        bool is_live(const MeshHandle handle) const;
+
+        size_t m_vertex_size;
+        size_t m_max_draws;
+        VertexBuffer m_vertex_buffer;
+        IndexBuffer m_index_buffer;
+        std::unique_ptr<VertexArray> m_vertex_array;
+        const VertexBuffer* m_instance_buffer = nullptr;
+
+        OffsetAllocator m_vertex_allocator;
+        OffsetAllocator m_index_allocator;
+        std::vector<Mesh> m_meshes;
+        std::vector<unsigned int> m_free_mesh_slots;
+
+        unsigned int m_indirect_buffer_id = 0;
+        StreamBuffer m_indirect_stream;
+        std::vector<DrawElementsIndirectCommand> m_commands;
+        size_t m_draws_count = 0;
+    };
+}
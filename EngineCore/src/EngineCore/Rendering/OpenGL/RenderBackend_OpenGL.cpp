@@ -0,0 +1,61 @@
+#define ENGINE_LOG_MODULE Rendering
+
+#include "RenderBackend_OpenGL.hpp"
+#include "Renderer_OpenGL.hpp"
+#include "EngineCore/Debug.hpp"
+
+#include <algorithm>
+
+namespace GraphicsEngine {
+    RenderBackend_OpenGL::RenderBackend_OpenGL(BatchRenderer& batch_renderer, UniformBuffer& frame_uniform_buffer, const UniformHandle view_projection_handle)
+        : m_batch_renderer(batch_renderer)
+        , m_frame_uniform_buffer(frame_uniform_buffer)
+        , m_view_projection_handle(view_projection_handle)
+    {
+    }
+
+    void RenderBackend_OpenGL::set_viewport(const unsigned int width, const unsigned int height)
+    {
+        Renderer_OpenGL::set_viewport(width, height);
+    }
+
+    void RenderBackend_OpenGL::clear(const glm::vec4& color)
+    {
+        Renderer_OpenGL::set_clear_color(color.r, color.g, color.b, color.a);
+        Renderer_OpenGL::clear();
+    }
+
+    void RenderBackend_OpenGL::draw(const glm::mat4& view_projection, const MeshView& mesh, std::span<const MeshDraw> draws)
+    {
+        if (!m_program || !mesh.layout || mesh.layout->get_stride() != sizeof(BatchVertex))
+        {
+            LOG_ERROR("RenderBackend_OpenGL: needs a program and meshes in BatchVertex's layout");
+            return;
+        }
+
+        m_frame_uniform_buffer.setMatrix4(m_view_projection_handle, view_projection);
+        m_frame_uniform_buffer.upload();
+        m_frame_uniform_buffer.bind(0);
+
+        const BatchVertex* vertices = static_cast<const BatchVertex*>(mesh.vertices);
+        const size_t index_size = get_index_size(mesh.index_type);
+        m_batch_renderer.begin(*m_program);
+        for (const MeshDraw& draw : draws)
+        {
+            if (draw.model_matrices.empty())
+            {
+                continue;
+            }
+            // Baked meshes store each LOD's vertices as a prefix of the vertex stream, so coarser LODs transform fewer
+            const void* indices = static_cast<const uint8_t*>(mesh.indices) + draw.first_index * index_size;
+            const size_t vertices_count = std::min(mesh.vertices_count, get_referenced_vertices_count(indices, mesh.index_type, draw.indices_count));
+            for (size_t instance = 0; instance < draw.model_matrices.size(); ++instance)
+            {
+                const int32_t atlas_region = draw.atlas_regions.empty() ? 0 : draw.atlas_regions[instance];
+                m_batch_renderer.draw_mesh(vertices, vertices_count, indices, draw.indices_count, draw.model_matrices[instance], mesh.index_type,
+                                           atlas_region);
+            }
+        }
+        m_batch_renderer.end();
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "EngineCore/Rendering/RenderBackend.hpp"
+#include "BatchRenderer.hpp"
+#include "UniformBuffer.hpp"
+
+namespace GraphicsEngine {
+    class ShaderProgram;
+
+    // Draws meshes by batching them on the CPU (see BatchRenderer), so they must be in
+    // BatchVertex's layout. The view projection matrix goes into the FrameData block of the
+    // program set with set_program() through frame_uniform_buffer, bound at binding 0.
+    class RenderBackend_OpenGL final : public RenderBackend
+    {
+    public:
+        RenderBackend_OpenGL(BatchRenderer& batch_renderer, UniformBuffer& frame_uniform_buffer, const UniformHandle view_projection_handle);
+
+        void set_program(const ShaderProgram* program) { m_program = program; }
+
+        void set_viewport(const unsigned int width, const unsigned int height) override;
+        void clear(const glm::vec4& color) override;
+        void draw(const glm::mat4& view_projection, const MeshView& mesh, std::span<const MeshDraw> draws) override;
+
+        size_t get_batches_count() const { return m_batch_renderer.get_batches_count(); }
+
+    private:
+        BatchRenderer& m_batch_renderer;
+        UniformBuffer& m_frame_uniform_buffer;
+        UniformHandle m_view_projection_handle;
+        const ShaderProgram* m_program = nullptr;
+    };
+}
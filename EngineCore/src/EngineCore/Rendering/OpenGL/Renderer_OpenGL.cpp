@@ -0,0 +1,123 @@
+#define ENGINE_LOG_MODULE Rendering
+
+#include "Renderer_OpenGL.hpp"
+#include "VertexArray.hpp"
+#include "StateCache_OpenGL.hpp"
+#include "EngineCore/Rendering/RenderStats.hpp"
+#include "EngineCore/Debug.hpp"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+namespace GraphicsEngine {
+    namespace {
+        bool s_direct_state_access_allowed = true;
+        bool s_direct_state_access = false;
+    }
+
+    bool Renderer_OpenGL::init(GLFWwindow* window, StateCache_OpenGL& state_cache)
+    {
+        glfwMakeContextCurrent(window);
+        StateCache_OpenGL::make_current(&state_cache);
+
+        if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+        {
+            LOG_CRITICAL("Failed to initialize GLAD");
+            return false;
+        }
+        s_direct_state_access = s_direct_state_access_allowed && GLAD_GL_VERSION_4_5;
+
+        LOG_INFO("OpenGL context initialized:");
+        LOG_INFO("  Vendor: {}", get_vendor_str());
+        LOG_INFO("  Renderer: {}", get_renderer_str());
+        LOG_INFO("  Version: {}", get_version_str());
+        LOG_INFO("  Direct state access: {}", s_direct_state_access ? "yes" : "no");
+
+        return true;
+    }
+
+    void Renderer_OpenGL::set_direct_state_access_allowed(const bool allowed)
+    {
+        s_direct_state_access_allowed = allowed;
+    }
+
+    bool Renderer_OpenGL::has_direct_state_access()
+    {
+        return s_direct_state_access;
+    }
+
+    void Renderer_OpenGL::draw(const VertexArray& vertex_array)
+    {
+        draw(vertex_array, vertex_array.get_indices_count());
+    }
+
+    void Renderer_OpenGL::draw(const VertexArray& vertex_array, const size_t indices_count, const size_t first_index, const int base_vertex)
+    {
+        const EIndexType index_type = vertex_array.get_index_type();
+        vertex_array.bind();
+        glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(indices_count), get_gl_index_type(index_type),
+                                 reinterpret_cast<const void*>(first_index * get_index_size(index_type)), base_vertex);
+        ++RenderStats::draw_calls;
+        RenderStats::triangles += indices_count / 3;
+    }
+
+    void Renderer_OpenGL::draw_instanced(const VertexArray& vertex_array, const size_t indices_count, const size_t instances_count,
+                                         const size_t first_index, const int base_vertex, const unsigned int base_instance)
+    {
+        const EIndexType index_type = vertex_array.get_index_type();
+        vertex_array.bind();
+        glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, static_cast<GLsizei>(indices_count), get_gl_index_type(index_type),
+                                                      reinterpret_cast<const void*>(first_index * get_index_size(index_type)),
+                                                      static_cast<GLsizei>(instances_count), base_vertex, base_instance);
+        ++RenderStats::draw_calls;
+        RenderStats::triangles += indices_count / 3 * instances_count;
+    }
+
+    void Renderer_OpenGL::multi_draw_indirect(const VertexArray& vertex_array, const size_t indirect_offset, const size_t draws_count)
+    {
+        vertex_array.bind();
+        glMultiDrawElementsIndirect(GL_TRIANGLES, get_gl_index_type(vertex_array.get_index_type()), reinterpret_cast<const void*>(indirect_offset),
+                                    static_cast<GLsizei>(draws_count), 0);
+        ++RenderStats::draw_calls;
+    }
+
+    void Renderer_OpenGL::set_clear_color(const float r, const float g, const float b, const float a)
+    {
+        glClearColor(r, g, b, a);
+    }
+
+    void Renderer_OpenGL::clear()
+    {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+
+    void Renderer_OpenGL::enable_depth_testing()
+    {
+        StateCache_OpenGL::enable(GL_DEPTH_TEST);
+    }
+
+    void Renderer_OpenGL::disable_depth_testing()
+    {
+        StateCache_OpenGL::disable(GL_DEPTH_TEST);
+    }
+
+    void Renderer_OpenGL::set_viewport(const unsigned int width, const unsigned int height, const unsigned int left_offset, const unsigned int bottom_offset)
+    {
+        glViewport(left_offset, bottom_offset, width, height);
+    }
+
+    const char* Renderer_OpenGL::get_vendor_str()
+    {
+        return reinterpret_cast<const char*>(glGetString(GL_VENDOR));
+    }
+
+    const char* Renderer_OpenGL::get_renderer_str()
+    {
+        return reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    }
+
+    const char* Renderer_OpenGL::get_version_str()
+    {
+        return reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+
+struct GLFWwindow;
+
+namespace GraphicsEngine {
+    class VertexArray;
+    class StateCache_OpenGL;
+
+    class Renderer_OpenGL
+    {
+    public:
+        // Makes window's context and state_cache, which the caller keeps for the context's lifetime, current on this thread
+        static bool init(GLFWwindow* window, StateCache_OpenGL& state_cache);
+
+        // GL 4.5 direct state access: buffers and vertex arrays are created and edited by name
+        // instead of being bound first. Disallowing it before init() forces the bind-to-edit path
+        static void set_direct_state_access_allowed(const bool allowed);
+        static bool has_direct_state_access();
+
+        static void draw(const VertexArray& vertex_array);
+        static void draw(const VertexArray& vertex_array, const size_t indices_count, const size_t first_index = 0, const int base_vertex = 0);
+        // base_instance offsets the per-instance attributes, e.g. into the current StreamBuffer region
+        static void draw_instanced(const VertexArray& vertex_array, const size_t indices_count, const size_t instances_count,
+                                   const size_t first_index = 0, const int base_vertex = 0, const unsigned int base_instance = 0);
+        // Reads draws_count DrawElementsIndirectCommand from the bound GL_DRAW_INDIRECT_BUFFER at indirect_offset
+        static void multi_draw_indirect(const VertexArray& vertex_array, const size_t indirect_offset, const size_t draws_count);
+        static void set_clear_color(const float r, const float g, const float b, const float a);
+        static void clear();
+        static void enable_depth_testing();
+        static void disable_depth_testing();
+        static void set_viewport(const unsigned int width, const unsigned int height, const unsigned int left_offset = 0, const unsigned int bottom_offset = 0);
+
+        static const char* get_vendor_str();
+        static const char* get_renderer_str();
+        static const char* get_version_str();
+    };
+}
@@ -1,7 +1,12 @@
+#define ENGINE_LOG_MODULE Rendering
+
 #include "ShaderProgram.hpp"
+#include "ShaderProgramCache.hpp"
+#include "StateCache_OpenGL.hpp"
 #include "EngineCore/Debug.hpp"
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
+#include <cstring>
 
 namespace GraphicsEngine
 {
@@ -22,10 +27,106 @@ namespace GraphicsEngine
         return true;
     }
 
-    ShaderProgram::ShaderProgram(const char* vertex_shader_src, const char* fragment_shader_src)
+    std::string apply_defines(const char* source, const std::vector<std::string>& defines)
+    {
+        std::string result(source);
+        if (defines.empty())
+        {
+            return result;
+        }
+
+        std::string define_lines;
+        for (const std::string& define : defines)
+        {
+            define_lines += "#define " + define + "\n";
+        }
+
+        // #version must stay the first directive
+        size_t insert_position = 0;
+        if (result.compare(0, 8, "#version") == 0)
+        {
+            const size_t line_end = result.find('\n');
+            if (line_end == std::string::npos)
+            {
+                result += '\n';
+                insert_position = result.size();
+            }
+            else
+            {
+                insert_position = line_end + 1;
+            }
+        }
+        result.insert(insert_position, define_lines);
+        return result;
+    }
+
+    size_t uniform_type_size(const GLenum type)
+    {
+        switch (type)
+        {
+            case GL_FLOAT:
+            case GL_INT:
+            case GL_UNSIGNED_INT:
+            case GL_BOOL:
+                return 4;
+            case GL_FLOAT_VEC2:
+            case GL_INT_VEC2:
+            case GL_UNSIGNED_INT_VEC2:
+            case GL_BOOL_VEC2:
+                return 8;
+            case GL_FLOAT_VEC3:
+            case GL_INT_VEC3:
+            case GL_UNSIGNED_INT_VEC3:
+            case GL_BOOL_VEC3:
+                return 12;
+            case GL_FLOAT_VEC4:
+            case GL_INT_VEC4:
+            case GL_UNSIGNED_INT_VEC4:
+            case GL_BOOL_VEC4:
+            case GL_FLOAT_MAT2:
+                return 16;
+            case GL_FLOAT_MAT3:
+                return 36;
+            case GL_FLOAT_MAT4:
+                return 64;
+        }
+        // Samplers and images are set as a single int
+        return 4;
+    }
+
+    std::string get_resource_name(const GLuint program_id, const GLenum interface, const GLuint index, const GLint name_length)
     {
+        std::string name(static_cast<size_t>(name_length), '\0');
+        glGetProgramResourceName(program_id, interface, index, name_length, nullptr, name.data());
+        name.resize(std::strlen(name.c_str()));
+
+        // Arrays are reported as "name[0]"
+        const size_t bracket = name.find('[');
+        if (bracket != std::string::npos)
+        {
+            name.resize(bracket);
+        }
+        return name;
+    }
+
+    ShaderProgram::ShaderProgram(const char* vertex_shader_src, const char* fragment_shader_src, const std::vector<std::string>& defines)
+    {
+        const std::string vertex_source = apply_defines(vertex_shader_src, defines);
+        const std::string fragment_source = apply_defines(fragment_shader_src, defines);
+
+        std::string cache_key;
+        if (ShaderProgramCache::is_enabled())
+        {
+            cache_key = ShaderProgramCache::make_key({ vertex_source, fragment_source }, defines);
+            if (load_binary(cache_key))
+            {
+                reflect();
+                return;
+            }
+        }
+
         GLuint vertex_shader_id = 0;
-        if (!create_shader(vertex_shader_src, GL_VERTEX_SHADER, vertex_shader_id))
+        if (!create_shader(vertex_source.c_str(), GL_VERTEX_SHADER, vertex_shader_id))
         {
             LOG_CRITICAL("VERTEX SHADER: compile-time error!");
             glDeleteShader(vertex_shader_id);
@@ -34,7 +135,7 @@ namespace GraphicsEngine
 
         GLuint fragment_shader_id = 0;
 
-        if (!create_shader(fragment_shader_src, GL_FRAGMENT_SHADER, fragment_shader_id))
+        if (!create_shader(fragment_source.c_str(), GL_FRAGMENT_SHADER, fragment_shader_id))
         {
             LOG_CRITICAL("FRAGMENT SHADER: compile-time error!");
             glDeleteShader(vertex_shader_id);
@@ -45,6 +146,10 @@ namespace GraphicsEngine
         m_id = glCreateProgram();
         glAttachShader(m_id, vertex_shader_id);
         glAttachShader(m_id, fragment_shader_id);
+        if (!cache_key.empty())
+        {
+            glProgramParameteri(m_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
         glLinkProgram(m_id);
 
         GLint success;
@@ -69,39 +174,267 @@ namespace GraphicsEngine
         glDetachShader(m_id, fragment_shader_id);
         glDeleteShader(vertex_shader_id);
         glDeleteShader(fragment_shader_id);
+
+        if (!cache_key.empty())
+        {
+            store_binary(cache_key);
+        }
+        reflect();
+    }
+
+    bool ShaderProgram::load_binary(const std::string& cache_key)
+    {
+        unsigned int binary_format = 0;
+        std::vector<uint8_t> binary;
+        if (!ShaderProgramCache::load(cache_key, binary_format, binary))
+        {
+            return false;
+        }
+
+        m_id = glCreateProgram();
+        glProgramBinary(m_id, binary_format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+        GLint success;
+        glGetProgramiv(m_id, GL_LINK_STATUS, &success);
+        if (success == GL_FALSE)
+        {
+            // Usually a driver update; the entry is rebuilt from source
+            LOG_WARN("SHADER PROGRAM: cached binary {} was rejected, recompiling", cache_key);
+            glDeleteProgram(m_id);
+            m_id = 0;
+            ShaderProgramCache::remove(cache_key);
+            return false;
+        }
+
+        m_isCompiled = true;
+        return true;
+    }
+
+    void ShaderProgram::store_binary(const std::string& cache_key) const
+    {
+        GLint binary_length = 0;
+        glGetProgramiv(m_id, GL_PROGRAM_BINARY_LENGTH, &binary_length);
+        if (binary_length <= 0)
+        {
+            return;
+        }
+
+        std::vector<uint8_t> binary(static_cast<size_t>(binary_length));
+        GLenum binary_format = 0;
+        glGetProgramBinary(m_id, binary_length, nullptr, &binary_format, binary.data());
+        ShaderProgramCache::store(cache_key, binary_format, binary);
+    }
+
+    void ShaderProgram::reflect()
+    {
+        m_uniforms.clear();
+        m_uniform_value_offsets.clear();
+        m_uniform_indices.clear();
+        m_uniform_blocks.clear();
+
+        GLint blocks_count = 0;
+        glGetProgramInterfaceiv(m_id, GL_UNIFORM_BLOCK, GL_ACTIVE_RESOURCES, &blocks_count);
+        for (GLint block_index = 0; block_index < blocks_count; ++block_index)
+        {
+            const GLenum properties[] = { GL_NAME_LENGTH, GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE };
+            GLint values[3] = {};
+            glGetProgramResourceiv(m_id, GL_UNIFORM_BLOCK, block_index, 3, properties, 3, nullptr, values);
+
+            UniformBlockInfo block;
+            block.name = get_resource_name(m_id, GL_UNIFORM_BLOCK, block_index, values[0]);
+            block.index = static_cast<unsigned int>(block_index);
+            block.binding = values[1];
+            block.data_size = static_cast<size_t>(values[2]);
+            m_uniform_blocks.push_back(std::move(block));
+        }
+
+        GLint uniforms_count = 0;
+        glGetProgramInterfaceiv(m_id, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniforms_count);
+        size_t values_size = 0;
+        for (GLint uniform_index = 0; uniform_index < uniforms_count; ++uniform_index)
+        {
+            const GLenum properties[] = { GL_NAME_LENGTH, GL_TYPE, GL_LOCATION, GL_ARRAY_SIZE, GL_BLOCK_INDEX, GL_OFFSET };
+            GLint values[6] = {};
+            glGetProgramResourceiv(m_id, GL_UNIFORM, uniform_index, 6, properties, 6, nullptr, values);
+
+            UniformInfo uniform;
+            uniform.name = get_resource_name(m_id, GL_UNIFORM, uniform_index, values[0]);
+            uniform.type = static_cast<unsigned int>(values[1]);
+            uniform.location = values[2];
+            uniform.array_size = values[3];
+            uniform.offset = values[5];
+            uniform.size = uniform_type_size(uniform.type);
+
+            if (values[4] >= 0)
+            {
+                m_uniform_blocks[values[4]].members.push_back(std::move(uniform));
+                continue;
+            }
+
+            m_uniform_indices.emplace(uniform.name, static_cast<int>(m_uniforms.size()));
+            m_uniform_value_offsets.push_back(values_size);
+            values_size += uniform.size;
+            m_uniforms.push_back(std::move(uniform));
+        }
+
+        // Initializers and layout(binding) give uniforms values other than zero, so nothing is known until set once
+        m_uniform_values.assign(values_size, 0);
+        m_uniform_values_known.assign(m_uniforms.size(), false);
     }
 
     ShaderProgram::~ShaderProgram()
     {
+        StateCache_OpenGL::on_program_deleted(m_id);
         glDeleteProgram(m_id);
     }
 
     void ShaderProgram::bind() const
     {
-        glUseProgram(m_id);
+        StateCache_OpenGL::use_program(m_id);
     }
 
     void ShaderProgram::unbind()
     {
-        glUseProgram(0);
+        StateCache_OpenGL::use_program(0);
+    }
+
+    UniformHandle ShaderProgram::get_uniform_handle(const char* name) const
+    {
+        const auto it = m_uniform_indices.find(name);
+        if (it == m_uniform_indices.end())
+        {
+            return {};
+        }
+        return { it->second };
+    }
+
+    const UniformBlockInfo* ShaderProgram::get_uniform_block(const char* name) const
+    {
+        for (const UniformBlockInfo& block : m_uniform_blocks)
+        {
+            if (block.name == name)
+            {
+                return &block;
+            }
+        }
+        return nullptr;
+    }
+
+    void ShaderProgram::set_uniform_block_binding(const char* name, const unsigned int binding)
+    {
+        for (UniformBlockInfo& block : m_uniform_blocks)
+        {
+            if (block.name == name && block.binding != static_cast<int>(binding))
+            {
+                glUniformBlockBinding(m_id, block.index, binding);
+                block.binding = static_cast<int>(binding);
+            }
+        }
+    }
+
+    bool ShaderProgram::update_cached_value(const UniformHandle handle, const void* value, const size_t size)
+    {
+        if (!handle.is_valid())
+        {
+            return false;
+        }
+        const UniformInfo& uniform = m_uniforms[handle.index];
+        if (size > uniform.size)
+        {
+            return false;
+        }
+        // Arrays are not cached: the slot holds one element, which the other elements' values could not be compared with
+        if (uniform.array_size > 1)
+        {
+            return true;
+        }
+        uint8_t* cached_value = m_uniform_values.data() + m_uniform_value_offsets[handle.index];
+        if (m_uniform_values_known[handle.index] && std::memcmp(cached_value, value, size) == 0)
+        {
+            return false;
+        }
+        std::memcpy(cached_value, value, size);
+        m_uniform_values_known[handle.index] = true;
+        return true;
+    }
+
+    void ShaderProgram::setInt(const UniformHandle handle, const int value)
+    {
+        if (update_cached_value(handle, &value, sizeof(value)))
+        {
+            glProgramUniform1i(m_id, m_uniforms[handle.index].location, value);
+        }
+    }
+
+    void ShaderProgram::setFloat(const UniformHandle handle, const float value)
+    {
+        if (update_cached_value(handle, &value, sizeof(value)))
+        {
+            glProgramUniform1f(m_id, m_uniforms[handle.index].location, value);
+        }
+    }
+
+    void ShaderProgram::setVec2(const UniformHandle handle, const glm::vec2& value)
+    {
+        if (update_cached_value(handle, glm::value_ptr(value), sizeof(value)))
+        {
+            glProgramUniform2fv(m_id, m_uniforms[handle.index].location, 1, glm::value_ptr(value));
+        }
+    }
+
+    void ShaderProgram::setVec3(const UniformHandle handle, const glm::vec3& value)
+    {
+        if (update_cached_value(handle, glm::value_ptr(value), sizeof(value)))
+        {
+            glProgramUniform3fv(m_id, m_uniforms[handle.index].location, 1, glm::value_ptr(value));
+        }
+    }
+
+    void ShaderProgram::setVec4(const UniformHandle handle, const glm::vec4& value)
+    {
+        if (update_cached_value(handle, glm::value_ptr(value), sizeof(value)))
+        {
+            glProgramUniform4fv(m_id, m_uniforms[handle.index].location, 1, glm::value_ptr(value));
+        }
+    }
+
+    void ShaderProgram::setMatrix4(const UniformHandle handle, const glm::mat4& matrix)
+    {
+        if (update_cached_value(handle, glm::value_ptr(matrix), sizeof(matrix)))
+        {
+            glProgramUniformMatrix4fv(m_id, m_uniforms[handle.index].location, 1, GL_FALSE, glm::value_ptr(matrix));
+        }
     }
 
-    void ShaderProgram::setMatrix4(const char *name, const glm::mat4 &matrix) const
+    void ShaderProgram::setMatrix4(const char *name, const glm::mat4 &matrix)
     {
-        glUniformMatrix4fv(glGetUniformLocation(m_id, name), 1, GL_FALSE, glm::value_ptr(matrix));
+        setMatrix4(get_uniform_handle(name), matrix);
     }
 
     ShaderProgram& ShaderProgram::operator=(ShaderProgram&& shaderProgram)
     {
+        StateCache_OpenGL::on_program_deleted(m_id);
         glDeleteProgram(m_id);
         m_id = shaderProgram.m_id;
         m_isCompiled = shaderProgram.m_isCompiled;
+        m_uniforms = std::move(shaderProgram.m_uniforms);
+        m_uniform_value_offsets = std::move(shaderProgram.m_uniform_value_offsets);
+        m_uniform_values = std::move(shaderProgram.m_uniform_values);
+        m_uniform_values_known = std::move(shaderProgram.m_uniform_values_known);
+        m_uniform_indices = std::move(shaderProgram.m_uniform_indices);
+        m_uniform_blocks = std::move(shaderProgram.m_uniform_blocks);
         shaderProgram.m_id = 0;
         shaderProgram.m_isCompiled = false;
         return *this;
     }
     
     ShaderProgram::ShaderProgram(ShaderProgram&& shaderProgram)
+        : m_uniforms(std::move(shaderProgram.m_uniforms))
+        , m_uniform_value_offsets(std::move(shaderProgram.m_uniform_value_offsets))
+        , m_uniform_values(std::move(shaderProgram.m_uniform_values))
+        , m_uniform_values_known(std::move(shaderProgram.m_uniform_values_known))
+        , m_uniform_indices(std::move(shaderProgram.m_uniform_indices))
+        , m_uniform_blocks(std::move(shaderProgram.m_uniform_blocks))
     {
         m_id = shaderProgram.m_id;
         m_isCompiled = shaderProgram.m_isCompiled;
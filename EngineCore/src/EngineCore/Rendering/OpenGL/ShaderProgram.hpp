@@ -1,12 +1,47 @@
 #pragma once
 
 #include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
 
 namespace GraphicsEngine {
+    // Index into a reflection table (ShaderProgram uniforms or UniformBuffer members)
+    struct UniformHandle
+    {
+        int index = -1;
+        bool is_valid() const { return index >= 0; }
+    };
+
+    struct UniformInfo
+    {
+        std::string name;
+        unsigned int type = 0;
+        int location = -1;
+        int array_size = 1;
+        int offset = -1;
+        size_t size = 0;
+    };
+
+    struct UniformBlockInfo
+    {
+        std::string name;
+        unsigned int index = 0;
+        int binding = 0;
+        size_t data_size = 0;
+        std::vector<UniformInfo> members;
+    };
+
     class ShaderProgram
     {
     public:
-        ShaderProgram(const char* vertex_shader_src, const char* fragment_shader_src);
+        // Each define is inserted after the #version line as "#define <define>", e.g. "USE_TEXTURE 1".
+        // Linked programs are restored from ShaderProgramCache when it is enabled.
+        ShaderProgram(const char* vertex_shader_src, const char* fragment_shader_src, const std::vector<std::string>& defines = {});
         ShaderProgram(ShaderProgram&&);
         ShaderProgram& operator=(ShaderProgram&&);
         ~ShaderProgram();
@@ -16,9 +51,36 @@ namespace GraphicsEngine {
         void bind() const;
         static void unbind();
         bool isCompiled() const { return m_isCompiled; }
-        void setMatrix4(const char* name, const glm::mat4& matrix) const ;
+
+        UniformHandle get_uniform_handle(const char* name) const;
+        const UniformInfo& get_uniform_info(const UniformHandle handle) const { return m_uniforms[handle.index]; }
+        const std::vector<UniformBlockInfo>& get_uniform_blocks() const { return m_uniform_blocks; }
+        const UniformBlockInfo* get_uniform_block(const char* name) const;
+        void set_uniform_block_binding(const char* name, const unsigned int binding);
+
+        // Setters skip the GL call when the value equals the last one set for this program (arrays are always set)
+        void setInt(const UniformHandle handle, const int value);
+        void setFloat(const UniformHandle handle, const float value);
+        void setVec2(const UniformHandle handle, const glm::vec2& value);
+        void setVec3(const UniformHandle handle, const glm::vec3& value);
+        void setVec4(const UniformHandle handle, const glm::vec4& value);
+        void setMatrix4(const UniformHandle handle, const glm::mat4& matrix);
+        void setMatrix4(const char* name, const glm::mat4& matrix);
     private:
+        bool load_binary(const std::string& cache_key);
+        void store_binary(const std::string& cache_key) const;
+        void reflect();
+        bool update_cached_value(const UniformHandle handle, const void* value, const size_t size);
+
         bool m_isCompiled = false;
         unsigned int m_id = 0;
+
+        std::vector<UniformInfo> m_uniforms;
+        std::vector<size_t> m_uniform_value_offsets;
+        std::vector<uint8_t> m_uniform_values;
+        // Whether m_uniform_values holds the uniform's value, known once it was set through this program
+        std::vector<bool> m_uniform_values_known;
+        std::unordered_map<std::string, int> m_uniform_indices;
+        std::vector<UniformBlockInfo> m_uniform_blocks;
     };
-}
\ No newline at end of file
+}
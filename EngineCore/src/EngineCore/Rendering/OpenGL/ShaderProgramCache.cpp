@@ -0,0 +1,172 @@
+#define ENGINE_LOG_MODULE Rendering
+
+#include "ShaderProgramCache.hpp"
+#include "Renderer_OpenGL.hpp"
+#include "EngineCore/Debug.hpp"
+
+#include <glad/glad.h>
+#include <filesystem>
+#include <fstream>
+#include <cstdio>
+
+namespace GraphicsEngine {
+    static std::string s_directory;
+
+    static constexpr uint32_t s_file_magic = 0x42505347; // "GSPB"
+    static constexpr uint32_t s_file_version = 1;
+
+    struct CacheFileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t binary_format;
+        uint32_t reserved;
+        uint64_t binary_size;
+    };
+
+    constexpr uint64_t fnv1a_hash(const char* data, const size_t size, uint64_t hash = 0xcbf29ce484222325ull)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= static_cast<uint8_t>(data[i]);
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    uint64_t hash_string(const std::string& value, const uint64_t hash)
+    {
+        // Hash the terminator too, so {"ab", "c"} and {"a", "bc"} differ
+        return fnv1a_hash(value.c_str(), value.size() + 1, hash);
+    }
+
+    const char* gl_string_or_empty(const char* value)
+    {
+        return value ? value : "";
+    }
+
+    void ShaderProgramCache::set_directory(std::string directory)
+    {
+        s_directory = std::move(directory);
+        if (s_directory.empty())
+        {
+            return;
+        }
+
+        std::error_code error;
+        std::filesystem::create_directories(s_directory, error);
+        if (error)
+        {
+            LOG_ERROR("ShaderProgramCache: can't create directory {}: {}", s_directory, error.message());
+            s_directory.clear();
+        }
+    }
+
+    bool ShaderProgramCache::is_enabled()
+    {
+        if (s_directory.empty())
+        {
+            return false;
+        }
+        GLint formats_count = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats_count);
+        return formats_count > 0;
+    }
+
+    std::string ShaderProgramCache::make_key(const std::vector<std::string>& sources, const std::vector<std::string>& defines)
+    {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        hash = hash_string(gl_string_or_empty(Renderer_OpenGL::get_vendor_str()), hash);
+        hash = hash_string(gl_string_or_empty(Renderer_OpenGL::get_renderer_str()), hash);
+        hash = hash_string(gl_string_or_empty(Renderer_OpenGL::get_version_str()), hash);
+        for (const std::string& source : sources)
+        {
+            hash = hash_string(source, hash);
+        }
+        for (const std::string& define : defines)
+        {
+            hash = hash_string(define, hash);
+        }
+
+        char key[17];
+        std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash));
+        return key;
+    }
+
+    std::string ShaderProgramCache::get_entry_path(const std::string& key)
+    {
+        return (std::filesystem::path(s_directory) / (key + ".bin")).string();
+    }
+
+    bool ShaderProgramCache::load(const std::string& key, unsigned int& binary_format, std::vector<uint8_t>& binary)
+    {
+        const std::string path = get_entry_path(key);
+        std::error_code error;
+        const uintmax_t file_size = std::filesystem::file_size(path, error);
+        if (error)
+        {
+            return false;
+        }
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+
+        CacheFileHeader header{};
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!file || header.magic != s_file_magic || header.version != s_file_version)
+        {
+            LOG_WARN("ShaderProgramCache: entry {} has an invalid header", key);
+            return false;
+        }
+
+        // Checked before allocating, so a corrupt size can't ask for gigabytes
+        if (header.binary_size != file_size - sizeof(header))
+        {
+            LOG_WARN("ShaderProgramCache: entry {} is truncated or corrupt", key);
+            return false;
+        }
+        binary.resize(static_cast<size_t>(header.binary_size));
+        file.read(reinterpret_cast<char*>(binary.data()), static_cast<std::streamsize>(binary.size()));
+        if (!file)
+        {
+            LOG_WARN("ShaderProgramCache: entry {} can't be read", key);
+            return false;
+        }
+
+        binary_format = header.binary_format;
+        return true;
+    }
+
+    void ShaderProgramCache::store(const std::string& key, const unsigned int binary_format, const std::vector<uint8_t>& binary)
+    {
+        // Write to a temporary file first so a crash never leaves a truncated entry behind
+        const std::string path = get_entry_path(key);
+        const std::string temporary_path = path + ".tmp";
+        {
+            std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+            const CacheFileHeader header{ s_file_magic, s_file_version, binary_format, 0, binary.size() };
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(binary.data()), static_cast<std::streamsize>(binary.size()));
+            if (!file)
+            {
+                LOG_ERROR("ShaderProgramCache: can't write entry {}", key);
+                return;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary_path, path, error);
+        if (error)
+        {
+            LOG_ERROR("ShaderProgramCache: can't write entry {}: {}", key, error.message());
+        }
+    }
+
+    void ShaderProgramCache::remove(const std::string& key)
+    {
+        std::error_code error;
+        std::filesystem::remove(get_entry_path(key), error);
+    }
+}
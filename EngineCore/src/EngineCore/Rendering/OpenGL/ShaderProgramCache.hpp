@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace GraphicsEngine {
+    // On-disk cache of linked program binaries (glGetProgramBinary/glProgramBinary).
+    // Entries are keyed on the shader sources, defines and the driver strings, so a
+    // driver update invalidates them. Disabled until a directory is set.
+    class ShaderProgramCache
+    {
+    public:
+        static void set_directory(std::string directory);
+        static bool is_enabled();
+
+        static std::string make_key(const std::vector<std::string>& sources, const std::vector<std::string>& defines);
+
+        static bool load(const std::string& key, unsigned int& binary_format, std::vector<uint8_t>& binary);
+        static void store(const std::string& key, const unsigned int binary_format, const std::vector<uint8_t>& binary);
+        static void remove(const std::string& key);
+
+    private:
+        static std::string get_entry_path(const std::string& key);
+    };
+}
@@ -0,0 +1,278 @@
+#include "StateCache_OpenGL.hpp"
+#include "EngineCore/Rendering/RenderStats.hpp"
+
+#include <glad/glad.h>
+
+#include <cassert>
+
+namespace GraphicsEngine {
+    constexpr int buffer_target_index(const GLenum target)
+    {
+        switch (target)
+        {
+            case GL_ARRAY_BUFFER:         return 0;
+            case GL_ELEMENT_ARRAY_BUFFER: return 1;
+            case GL_UNIFORM_BUFFER:       return 2;
+            case GL_DRAW_INDIRECT_BUFFER: return 3;
+            case GL_PIXEL_UNPACK_BUFFER:  return 4;
+            case GL_COPY_READ_BUFFER:     return 5;
+            case GL_COPY_WRITE_BUFFER:    return 6;
+        }
+        return -1;
+    }
+
+    constexpr int capability_index(const GLenum capability)
+    {
+        switch (capability)
+        {
+            case GL_BLEND:              return 0;
+            case GL_DEPTH_TEST:         return 1;
+            case GL_CULL_FACE:          return 2;
+            case GL_SCISSOR_TEST:       return 3;
+            case GL_STENCIL_TEST:       return 4;
+            case GL_PRIMITIVE_RESTART:  return 5;
+            case GL_FRAMEBUFFER_SRGB:   return 6;
+            case GL_MULTISAMPLE:        return 7;
+        }
+        return -1;
+    }
+
+    template <typename T>
+    bool update_cached(T& cached_value, const T value)
+    {
+        if (cached_value == value)
+        {
+            ++RenderStats::state_changes_skipped;
+            return false;
+        }
+        cached_value = value;
+        ++RenderStats::state_changes_issued;
+        return true;
+    }
+
+    StateCache_OpenGL::StateCache_OpenGL()
+    {
+        forget_bindings();
+    }
+
+    void StateCache_OpenGL::make_current(StateCache_OpenGL* cache)
+    {
+        s_current = cache;
+    }
+
+    StateCache_OpenGL& StateCache_OpenGL::current()
+    {
+        assert(s_current && "StateCache_OpenGL: no cache is current on this thread");
+        return *s_current;
+    }
+
+    void StateCache_OpenGL::forget_bindings()
+    {
+        m_buffers.fill(unknown);
+        m_uniform_buffer_bases.fill(unknown);
+        m_storage_buffer_bases.fill(unknown);
+        m_texture_units.fill(unknown);
+        m_capabilities.fill(unknown);
+        m_vertex_array = unknown;
+        m_program = unknown;
+    }
+
+    void StateCache_OpenGL::invalidate()
+    {
+        current().forget_bindings();
+    }
+
+    void StateCache_OpenGL::bind_buffer(const unsigned int target, const unsigned int buffer_id)
+    {
+        StateCache_OpenGL& cache = current();
+        const int index = buffer_target_index(target);
+        if (index < 0)
+        {
+            ++RenderStats::state_changes_issued;
+            glBindBuffer(target, buffer_id);
+            return;
+        }
+        if (update_cached(cache.m_buffers[index], buffer_id))
+        {
+            glBindBuffer(target, buffer_id);
+        }
+    }
+
+    void StateCache_OpenGL::bind_buffer_base(const unsigned int target, const unsigned int index, const unsigned int buffer_id)
+    {
+        StateCache_OpenGL& cache = current();
+        std::array<unsigned int, buffer_bases_count>* bases = nullptr;
+        if (target == GL_UNIFORM_BUFFER)
+        {
+            bases = &cache.m_uniform_buffer_bases;
+        }
+        else if (target == GL_SHADER_STORAGE_BUFFER)
+        {
+            bases = &cache.m_storage_buffer_bases;
+        }
+
+        if (!bases || index >= buffer_bases_count)
+        {
+            ++RenderStats::state_changes_issued;
+            glBindBufferBase(target, index, buffer_id);
+            return;
+        }
+        if (update_cached((*bases)[index], buffer_id))
+        {
+            glBindBufferBase(target, index, buffer_id);
+            // glBindBufferBase also changes the generic binding point
+            const int target_index = buffer_target_index(target);
+            if (target_index >= 0)
+            {
+                cache.m_buffers[target_index] = buffer_id;
+            }
+        }
+    }
+
+    void StateCache_OpenGL::bind_vertex_array(const unsigned int vertex_array_id)
+    {
+        StateCache_OpenGL& cache = current();
+        if (update_cached(cache.m_vertex_array, vertex_array_id))
+        {
+            glBindVertexArray(vertex_array_id);
+            // The element buffer binding is part of the vertex array state
+            cache.m_buffers[buffer_target_index(GL_ELEMENT_ARRAY_BUFFER)] = unknown;
+        }
+    }
+
+    void StateCache_OpenGL::use_program(const unsigned int program_id)
+    {
+        StateCache_OpenGL& cache = current();
+        if (update_cached(cache.m_program, program_id))
+        {
+            glUseProgram(program_id);
+        }
+    }
+
+    void StateCache_OpenGL::bind_texture_unit(const unsigned int unit, const unsigned int texture_id)
+    {
+        StateCache_OpenGL& cache = current();
+        if (unit >= texture_units_count)
+        {
+            ++RenderStats::state_changes_issued;
+            glBindTextureUnit(unit, texture_id);
+            return;
+        }
+        if (update_cached(cache.m_texture_units[unit], texture_id))
+        {
+            glBindTextureUnit(unit, texture_id);
+        }
+    }
+
+    void StateCache_OpenGL::bind_texture(const unsigned int target, const unsigned int texture_id)
+    {
+        StateCache_OpenGL& cache = current();
+        // The engine never changes the active texture unit, so this binds to unit 0
+        if (update_cached(cache.m_texture_units[0], texture_id))
+        {
+            glBindTexture(target, texture_id);
+        }
+    }
+
+    void StateCache_OpenGL::set_capability(const unsigned int capability, const bool enabled)
+    {
+        StateCache_OpenGL& cache = current();
+        const int index = capability_index(capability);
+        if (index >= 0 && !update_cached(cache.m_capabilities[index], static_cast<unsigned int>(enabled)))
+        {
+            return;
+        }
+        if (index < 0)
+        {
+            ++RenderStats::state_changes_issued;
+        }
+
+        if (enabled)
+        {
+            glEnable(capability);
+        }
+        else
+        {
+            glDisable(capability);
+        }
+    }
+
+    void StateCache_OpenGL::enable(const unsigned int capability)
+    {
+        set_capability(capability, true);
+    }
+
+    void StateCache_OpenGL::disable(const unsigned int capability)
+    {
+        set_capability(capability, false);
+    }
+
+    void StateCache_OpenGL::on_buffer_deleted(const unsigned int buffer_id)
+    {
+        StateCache_OpenGL& cache = current();
+        // Deleting a bound object reverts its bindings to zero
+        for (unsigned int& binding : cache.m_buffers)
+        {
+            if (binding == buffer_id)
+            {
+                binding = 0;
+            }
+        }
+        for (unsigned int& binding : cache.m_uniform_buffer_bases)
+        {
+            if (binding == buffer_id)
+            {
+                binding = 0;
+            }
+        }
+        for (unsigned int& binding : cache.m_storage_buffer_bases)
+        {
+            if (binding == buffer_id)
+            {
+                binding = 0;
+            }
+        }
+    }
+
+    void StateCache_OpenGL::on_vertex_array_deleted(const unsigned int vertex_array_id)
+    {
+        StateCache_OpenGL& cache = current();
+        if (cache.m_vertex_array == vertex_array_id)
+        {
+            cache.m_vertex_array = 0;
+            cache.m_buffers[buffer_target_index(GL_ELEMENT_ARRAY_BUFFER)] = unknown;
+        }
+    }
+
+    void StateCache_OpenGL::on_element_buffer_set(const unsigned int vertex_array_id, const unsigned int buffer_id)
+    {
+        StateCache_OpenGL& cache = current();
+        if (cache.m_vertex_array == vertex_array_id)
+        {
+            cache.m_buffers[buffer_target_index(GL_ELEMENT_ARRAY_BUFFER)] = buffer_id;
+        }
+    }
+
+    void StateCache_OpenGL::on_program_deleted(const unsigned int program_id)
+    {
+        StateCache_OpenGL& cache = current();
+        // A bound program stays in use until something else is bound, so the cache
+        // must not skip the next glUseProgram
+        if (cache.m_program == program_id)
+        {
+            cache.m_program = unknown;
+        }
+    }
+
+    void StateCache_OpenGL::on_texture_deleted(const unsigned int texture_id)
+    {
+        StateCache_OpenGL& cache = current();
+        for (unsigned int& binding : cache.m_texture_units)
+        {
+            if (binding == texture_id)
+            {
+                binding = 0;
+            }
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace GraphicsEngine {
+    // Shadow copy of the binding state of one OpenGL context. Every wrapper in
+    // Rendering/OpenGL binds through the static functions below, so binds, program switches
+    // and capability toggles that would not change anything never reach the driver.
+    // Each context owns a cache, and like the context it is current per thread: whoever makes
+    // a context current on a thread makes its cache current there too with make_current().
+    // Call invalidate() after code outside the wrappers (e.g. ImGui) touches GL state.
+    class StateCache_OpenGL
+    {
+    public:
+        StateCache_OpenGL();
+
+        StateCache_OpenGL(const StateCache_OpenGL&) = delete;
+        StateCache_OpenGL& operator=(const StateCache_OpenGL&) = delete;
+
+        // nullptr when the calling thread releases its context
+        static void make_current(StateCache_OpenGL* cache);
+
+        static void invalidate();
+
+        static void bind_buffer(const unsigned int target, const unsigned int buffer_id);
+        static void bind_buffer_base(const unsigned int target, const unsigned int index, const unsigned int buffer_id);
+        static void bind_vertex_array(const unsigned int vertex_array_id);
+        static void use_program(const unsigned int program_id);
+        static void bind_texture_unit(const unsigned int unit, const unsigned int texture_id);
+        // Binds to target on unit 0 to edit the texture; needed before a new texture has a target
+        static void bind_texture(const unsigned int target, const unsigned int texture_id);
+        static void enable(const unsigned int capability);
+        static void disable(const unsigned int capability);
+
+        static void on_buffer_deleted(const unsigned int buffer_id);
+        static void on_vertex_array_deleted(const unsigned int vertex_array_id);
+        // After glVertexArrayElementBuffer, which changes the element buffer binding if the vertex array is bound
+        static void on_element_buffer_set(const unsigned int vertex_array_id, const unsigned int buffer_id);
+        static void on_program_deleted(const unsigned int program_id);
+        static void on_texture_deleted(const unsigned int texture_id);
+
+    private:
+        static constexpr unsigned int unknown = ~0u;
+        static constexpr size_t buffer_targets_count = 7;
+        static constexpr size_t buffer_bases_count = 16;
+        static constexpr size_t texture_units_count = 32;
+        static constexpr size_t capabilities_count = 8;
+
+        // Binding through the wrappers without a current cache means no context is current either
+        static StateCache_OpenGL& current();
+        static void set_capability(const unsigned int capability, const bool enabled);
+
+        void forget_bindings();
+
+        static inline thread_local StateCache_OpenGL* s_current = nullptr;
+
+        std::array<unsigned int, buffer_targets_count> m_buffers = {};
+        std::array<unsigned int, buffer_bases_count> m_uniform_buffer_bases = {};
+        std::array<unsigned int, buffer_bases_count> m_storage_buffer_bases = {};
+        std::array<unsigned int, texture_units_count> m_texture_units = {};
+        std::array<unsigned int, capabilities_count> m_capabilities = {};
+        unsigned int m_vertex_array = unknown;
+        unsigned int m_program = unknown;
+    };
+}
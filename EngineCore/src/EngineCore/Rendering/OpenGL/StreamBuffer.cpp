@@ -0,0 +1,137 @@
+#define ENGINE_LOG_MODULE Rendering
+
+#include "StreamBuffer.hpp"
+#include "EngineCore/Debug.hpp"
+#include "EngineCore/Rendering/RenderStats.hpp"
+
+#include "StateCache_OpenGL.hpp"
+#include "Renderer_OpenGL.hpp"
+#include <glad/glad.h>
+
+namespace GraphicsEngine {
+    StreamBuffer::~StreamBuffer()
+    {
+        release();
+    }
+
+    StreamBuffer& StreamBuffer::operator=(StreamBuffer&& stream_buffer) noexcept
+    {
+        release();
+        m_target = stream_buffer.m_target;
+        m_buffer_id = stream_buffer.m_buffer_id;
+        m_region_size = stream_buffer.m_region_size;
+        m_region_index = stream_buffer.m_region_index;
+        m_mapped_data = stream_buffer.m_mapped_data;
+        m_staging_data = std::move(stream_buffer.m_staging_data);
+        m_fences = stream_buffer.m_fences;
+        m_fence_waits_count = stream_buffer.m_fence_waits_count;
+        stream_buffer.m_buffer_id = 0;
+        stream_buffer.m_mapped_data = nullptr;
+        stream_buffer.m_fences.fill(nullptr);
+        return *this;
+    }
+
+    StreamBuffer::StreamBuffer(StreamBuffer&& stream_buffer) noexcept
+    {
+        *this = std::move(stream_buffer);
+    }
+
+    void StreamBuffer::allocate(const unsigned int target, const unsigned int buffer_id, const size_t region_size)
+    {
+        release();
+        m_target = target;
+        m_buffer_id = buffer_id;
+        m_region_size = region_size;
+        m_region_index = regions_count - 1;
+
+        const GLsizeiptr buffer_size = static_cast<GLsizeiptr>(region_size * regions_count);
+        const GLbitfield map_flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        if (Renderer_OpenGL::has_direct_state_access())
+        {
+            glNamedBufferStorage(buffer_id, buffer_size, nullptr, map_flags | GL_DYNAMIC_STORAGE_BIT);
+            m_mapped_data = static_cast<uint8_t*>(glMapNamedBufferRange(buffer_id, 0, buffer_size, map_flags));
+        }
+        else if (glBufferStorage)
+        {
+            glBufferStorage(target, buffer_size, nullptr, map_flags | GL_DYNAMIC_STORAGE_BIT);
+            m_mapped_data = static_cast<uint8_t*>(glMapBufferRange(target, 0, buffer_size, map_flags));
+        }
+
+        if (!m_mapped_data)
+        {
+            LOG_WARN("StreamBuffer: persistent mapping is unavailable, falling back to glBufferSubData");
+            if (!glBufferStorage)
+            {
+                glBufferData(target, buffer_size, nullptr, GL_STREAM_DRAW);
+            }
+            m_staging_data.resize(region_size);
+        }
+    }
+
+    void* StreamBuffer::map_next_region()
+    {
+        m_region_index = (m_region_index + 1) % regions_count;
+
+        GLsync& fence = m_fences[m_region_index];
+        if (fence)
+        {
+            GLenum result = glClientWaitSync(fence, 0, 0);
+            if (result == GL_TIMEOUT_EXPIRED)
+            {
+                ++m_fence_waits_count;
+                ++RenderStats::fence_waits;
+                do
+                {
+                    result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+                } while (result == GL_TIMEOUT_EXPIRED);
+            }
+            if (result == GL_WAIT_FAILED)
+            {
+                LOG_ERROR("StreamBuffer: glClientWaitSync failed");
+            }
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+
+        return m_mapped_data ? m_mapped_data + get_region_offset() : m_staging_data.data();
+    }
+
+    void StreamBuffer::commit(const size_t size)
+    {
+        if (!m_mapped_data && Renderer_OpenGL::has_direct_state_access())
+        {
+            glNamedBufferSubData(m_buffer_id, static_cast<GLintptr>(get_region_offset()), static_cast<GLsizeiptr>(size), m_staging_data.data());
+        }
+        else if (!m_mapped_data)
+        {
+            StateCache_OpenGL::bind_buffer(m_target, m_buffer_id);
+            glBufferSubData(m_target, static_cast<GLintptr>(get_region_offset()), static_cast<GLsizeiptr>(size), m_staging_data.data());
+        }
+        RenderStats::upload_bytes += size;
+    }
+
+    void StreamBuffer::fence()
+    {
+        GLsync& fence = m_fences[m_region_index];
+        if (fence)
+        {
+            glDeleteSync(fence);
+        }
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    void StreamBuffer::release()
+    {
+        for (GLsync& fence : m_fences)
+        {
+            if (fence)
+            {
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+        // The mapping itself is released together with the buffer object
+        m_mapped_data = nullptr;
+        m_staging_data.clear();
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Same declaration as glad's, so fences are stored with their type without including GL here
+typedef struct __GLsync* GLsync;
+
+namespace GraphicsEngine {
+    // Ring of regions inside one immutable, persistently mapped buffer (glBufferStorage).
+    // The CPU writes the next region while the GPU still reads the previous ones; each
+    // region is guarded by a fence placed after the draw that consumed it.
+    // Without GL 4.4 it falls back to a CPU staging copy uploaded with glBufferSubData.
+    class StreamBuffer
+    {
+    public:
+        static constexpr size_t regions_count = 3;
+
+        StreamBuffer() = default;
+        ~StreamBuffer();
+        StreamBuffer(const StreamBuffer&) = delete;
+        StreamBuffer& operator=(const StreamBuffer&) = delete;
+        StreamBuffer& operator=(StreamBuffer&& stream_buffer) noexcept;
+        StreamBuffer(StreamBuffer&& stream_buffer) noexcept;
+
+        // Allocates regions_count * region_size bytes for buffer_id, which must be bound to target
+        // unless Renderer_OpenGL::has_direct_state_access(), in which case it only has to exist
+        void allocate(const unsigned int target, const unsigned int buffer_id, const size_t region_size);
+
+        // Advances to the next region, waiting for the GPU if it is still in use
+        void* map_next_region();
+        // Makes the first size bytes written into the current region visible to the GPU
+        void commit(const size_t size);
+        // Must be called after the last draw that reads the current region
+        void fence();
+
+        bool is_persistent() const { return m_mapped_data != nullptr; }
+        size_t get_region_size() const { return m_region_size; }
+        size_t get_region_offset() const { return m_region_index * m_region_size; }
+        size_t get_fence_waits_count() const { return m_fence_waits_count; }
+
+    private:
+        void release();
+
+        unsigned int m_target = 0;
+        unsigned int m_buffer_id = 0;
+        size_t m_region_size = 0;
+        size_t m_region_index = regions_count - 1;
+        uint8_t* m_mapped_data = nullptr;
+        std::vector<uint8_t> m_staging_data;
+        std::array<GLsync, regions_count> m_fences{};
+        size_t m_fence_waits_count = 0;
+    };
+}
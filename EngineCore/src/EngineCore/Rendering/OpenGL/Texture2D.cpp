@@ -0,0 +1,111 @@
+#define ENGINE_LOG_MODULE Rendering
+
+#include "Texture2D.hpp"
+#include "TextureFormat_OpenGL.hpp"
+#include "StateCache_OpenGL.hpp"
+#include "EngineCore/Debug.hpp"
+
+#include <glad/glad.h>
+#include <algorithm>
+
+namespace GraphicsEngine {
+    Texture2D::Texture2D(const TextureDesc& desc)
+        : m_desc(desc)
+    {
+        const uint32_t max_levels = get_mip_levels_count(m_desc.width, m_desc.height);
+        m_desc.mip_levels = m_desc.mip_levels == 0 ? max_levels : std::min(m_desc.mip_levels, max_levels);
+        m_desc.layers = 1;
+
+        glGenTextures(1, &m_id);
+        StateCache_OpenGL::bind_texture(GL_TEXTURE_2D, m_id);
+        glTexStorage2D(GL_TEXTURE_2D, static_cast<GLsizei>(m_desc.mip_levels), get_gl_internal_format(m_desc.format),
+                       static_cast<GLsizei>(m_desc.width), static_cast<GLsizei>(m_desc.height));
+        apply_texture_sampling(GL_TEXTURE_2D, m_desc.filter, m_desc.wrap, m_desc.mip_levels);
+    }
+
+    Texture2D::~Texture2D()
+    {
+        StateCache_OpenGL::on_texture_deleted(m_id);
+        glDeleteTextures(1, &m_id);
+    }
+
+    Texture2D& Texture2D::operator=(Texture2D&& texture) noexcept
+    {
+        StateCache_OpenGL::on_texture_deleted(m_id);
+        glDeleteTextures(1, &m_id);
+        m_id = texture.m_id;
+        m_desc = texture.m_desc;
+        texture.m_id = 0;
+        return *this;
+    }
+
+    Texture2D::Texture2D(Texture2D&& texture) noexcept
+        : m_id(texture.m_id)
+        , m_desc(texture.m_desc)
+    {
+        texture.m_id = 0;
+    }
+
+    std::unique_ptr<Texture2D> Texture2D::create(const Image& image, const TextureImportSettings& settings)
+    {
+        TextureDesc desc;
+        desc.width = image.width;
+        desc.height = image.height;
+        desc.format = select_texture_format(image.is_opaque(), settings);
+        desc.mip_levels = settings.mip_generation == EMipGeneration::None ? 1 : settings.mip_levels;
+        desc.filter = settings.filter;
+        desc.wrap = settings.wrap;
+        auto texture = std::make_unique<Texture2D>(desc);
+
+        // Compressed storage can't be rendered to, so its mips always come from the CPU
+        const bool gpu_mips = settings.mip_generation == EMipGeneration::Gpu && !is_compressed_format(desc.format);
+        const uint32_t cpu_levels = gpu_mips ? 1 : texture->get_mip_levels();
+        encode_texture_levels(image, desc.format, cpu_levels, settings.srgb, [&texture](const uint32_t level, const void* data, const size_t size) {
+            texture->set_level(level, data, size);
+        });
+        if (gpu_mips)
+        {
+            texture->generate_mipmaps();
+        }
+        return texture;
+    }
+
+    void Texture2D::set_level(const uint32_t level, const void* data, const size_t size)
+    {
+        const uint32_t width = get_mip_size(m_desc.width, level);
+        const uint32_t height = get_mip_size(m_desc.height, level);
+        if (level >= m_desc.mip_levels || size != get_image_size(m_desc.format, width, height))
+        {
+            LOG_ERROR("Texture2D: invalid upload of {} bytes to level {} of a {}x{} {} texture", size, level, m_desc.width, m_desc.height, get_format_name(m_desc.format));
+            return;
+        }
+        StateCache_OpenGL::bind_texture(GL_TEXTURE_2D, m_id);
+        upload_texture_level(GL_TEXTURE_2D, m_desc.format, level, 0, width, height, data, size);
+    }
+
+    void Texture2D::generate_mipmaps()
+    {
+        if (is_compressed_format(m_desc.format))
+        {
+            LOG_ERROR("Texture2D: can't generate mipmaps of a {} texture on the GPU", get_format_name(m_desc.format));
+            return;
+        }
+        StateCache_OpenGL::bind_texture(GL_TEXTURE_2D, m_id);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    void Texture2D::bind(const unsigned int unit) const
+    {
+        StateCache_OpenGL::bind_texture_unit(unit, m_id);
+    }
+
+    size_t Texture2D::get_memory_size() const
+    {
+        size_t size = 0;
+        for (uint32_t level = 0; level < m_desc.mip_levels; ++level)
+        {
+            size += get_image_size(m_desc.format, get_mip_size(m_desc.width, level), get_mip_size(m_desc.height, level));
+        }
+        return size;
+    }
+}
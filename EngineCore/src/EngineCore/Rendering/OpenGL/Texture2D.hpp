@@ -0,0 +1,44 @@
+#pragma once
+
+#include "EngineCore/Rendering/Image.hpp"
+#include "EngineCore/Rendering/TextureFormat.hpp"
+
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+namespace GraphicsEngine {
+    // Immutable 2D texture (glTexStorage2D): size, format and mip count are fixed when it is
+    // created, so the driver never has to re-validate or reallocate it on later uploads.
+    class Texture2D
+    {
+    public:
+        explicit Texture2D(const TextureDesc& desc);
+        ~Texture2D();
+        Texture2D(const Texture2D&) = delete;
+        Texture2D& operator=(const Texture2D&) = delete;
+        Texture2D& operator=(Texture2D&& texture) noexcept;
+        Texture2D(Texture2D&& texture) noexcept;
+
+        // Imports an RGBA8 image, compressed and with mips as settings ask for
+        static std::unique_ptr<Texture2D> create(const Image& image, const TextureImportSettings& settings);
+
+        // Replaces a whole mip level: tightly packed pixels, or blocks as compress_image writes them
+        void set_level(const uint32_t level, const void* data, const size_t size);
+        // Fills the levels below 0 from level 0 on the GPU; uncompressed formats only
+        void generate_mipmaps();
+        void bind(const unsigned int unit) const;
+
+        unsigned int get_id() const { return m_id; }
+        uint32_t get_width() const { return m_desc.width; }
+        uint32_t get_height() const { return m_desc.height; }
+        uint32_t get_mip_levels() const { return m_desc.mip_levels; }
+        ETextureFormat get_format() const { return m_desc.format; }
+        // GPU memory of every mip level
+        size_t get_memory_size() const;
+
+    private:
+        unsigned int m_id = 0;
+        TextureDesc m_desc;
+    };
+}
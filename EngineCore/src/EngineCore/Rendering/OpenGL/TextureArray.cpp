@@ -0,0 +1,131 @@
+#define ENGINE_LOG_MODULE Rendering
+
+#include "TextureArray.hpp"
+#include "TextureFormat_OpenGL.hpp"
+#include "StateCache_OpenGL.hpp"
+#include "EngineCore/Debug.hpp"
+
+#include <glad/glad.h>
+#include <algorithm>
+
+namespace GraphicsEngine {
+    TextureArray::TextureArray(const TextureDesc& desc)
+        : m_desc(desc)
+    {
+        const uint32_t max_levels = get_mip_levels_count(m_desc.width, m_desc.height);
+        m_desc.mip_levels = m_desc.mip_levels == 0 ? max_levels : std::min(m_desc.mip_levels, max_levels);
+        m_desc.layers = std::max(m_desc.layers, 1u);
+
+        glGenTextures(1, &m_id);
+        StateCache_OpenGL::bind_texture(GL_TEXTURE_2D_ARRAY, m_id);
+        glTexStorage3D(GL_TEXTURE_2D_ARRAY, static_cast<GLsizei>(m_desc.mip_levels), get_gl_internal_format(m_desc.format),
+                       static_cast<GLsizei>(m_desc.width), static_cast<GLsizei>(m_desc.height), static_cast<GLsizei>(m_desc.layers));
+        apply_texture_sampling(GL_TEXTURE_2D_ARRAY, m_desc.filter, m_desc.wrap, m_desc.mip_levels);
+    }
+
+    TextureArray::~TextureArray()
+    {
+        StateCache_OpenGL::on_texture_deleted(m_id);
+        glDeleteTextures(1, &m_id);
+    }
+
+    TextureArray& TextureArray::operator=(TextureArray&& texture) noexcept
+    {
+        StateCache_OpenGL::on_texture_deleted(m_id);
+        glDeleteTextures(1, &m_id);
+        m_id = texture.m_id;
+        m_desc = texture.m_desc;
+        texture.m_id = 0;
+        return *this;
+    }
+
+    TextureArray::TextureArray(TextureArray&& texture) noexcept
+        : m_id(texture.m_id)
+        , m_desc(texture.m_desc)
+    {
+        texture.m_id = 0;
+    }
+
+    std::unique_ptr<TextureArray> TextureArray::create(const std::vector<Image>& layers, const TextureImportSettings& settings)
+    {
+        if (layers.empty())
+        {
+            LOG_ERROR("TextureArray: no layers to import");
+            return nullptr;
+        }
+        TextureDesc desc;
+        desc.width = layers[0].width;
+        desc.height = layers[0].height;
+        desc.layers = static_cast<uint32_t>(layers.size());
+        bool opaque = true;
+        for (size_t i = 0; i < layers.size(); ++i)
+        {
+            if (layers[i].width != desc.width || layers[i].height != desc.height)
+            {
+                LOG_ERROR("TextureArray: layer {} is {}x{}, expected {}x{}", i, layers[i].width, layers[i].height, desc.width, desc.height);
+                return nullptr;
+            }
+            opaque = opaque && layers[i].is_opaque();
+        }
+        desc.format = select_texture_format(opaque, settings);
+        desc.mip_levels = settings.mip_generation == EMipGeneration::None ? 1 : settings.mip_levels;
+        desc.filter = settings.filter;
+        desc.wrap = settings.wrap;
+        auto texture = std::make_unique<TextureArray>(desc);
+
+        // Compressed storage can't be rendered to, so its mips always come from the CPU
+        const bool gpu_mips = settings.mip_generation == EMipGeneration::Gpu && !is_compressed_format(desc.format);
+        const uint32_t cpu_levels = gpu_mips ? 1 : texture->get_mip_levels();
+        for (uint32_t layer = 0; layer < desc.layers; ++layer)
+        {
+            encode_texture_levels(layers[layer], desc.format, cpu_levels, settings.srgb, [&texture, layer](const uint32_t level, const void* data, const size_t size) {
+                texture->set_level(layer, level, data, size);
+            });
+        }
+        if (gpu_mips)
+        {
+            texture->generate_mipmaps();
+        }
+        return texture;
+    }
+
+    void TextureArray::set_level(const uint32_t layer, const uint32_t level, const void* data, const size_t size)
+    {
+        const uint32_t width = get_mip_size(m_desc.width, level);
+        const uint32_t height = get_mip_size(m_desc.height, level);
+        if (layer >= m_desc.layers || level >= m_desc.mip_levels || size != get_image_size(m_desc.format, width, height))
+        {
+            LOG_ERROR("TextureArray: invalid upload of {} bytes to layer {} level {} of a {}x{}x{} {} texture",
+                      size, layer, level, m_desc.width, m_desc.height, m_desc.layers, get_format_name(m_desc.format));
+            return;
+        }
+        StateCache_OpenGL::bind_texture(GL_TEXTURE_2D_ARRAY, m_id);
+        upload_texture_level(GL_TEXTURE_2D_ARRAY, m_desc.format, level, layer, width, height, data, size);
+    }
+
+    void TextureArray::generate_mipmaps()
+    {
+        if (is_compressed_format(m_desc.format))
+        {
+            LOG_ERROR("TextureArray: can't generate mipmaps of a {} texture on the GPU", get_format_name(m_desc.format));
+            return;
+        }
+        StateCache_OpenGL::bind_texture(GL_TEXTURE_2D_ARRAY, m_id);
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    }
+
+    void TextureArray::bind(const unsigned int unit) const
+    {
+        StateCache_OpenGL::bind_texture_unit(unit, m_id);
+    }
+
+    size_t TextureArray::get_memory_size() const
+    {
+        size_t size = 0;
+        for (uint32_t level = 0; level < m_desc.mip_levels; ++level)
+        {
+            size += get_image_size(m_desc.format, get_mip_size(m_desc.width, level), get_mip_size(m_desc.height, level));
+        }
+        return size * m_desc.layers;
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "EngineCore/Rendering/Image.hpp"
+#include "EngineCore/Rendering/TextureFormat.hpp"
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace GraphicsEngine {
+    // Immutable 2D array texture (glTexStorage3D): layers of the same size and format behind one
+    // binding, sampled with a sampler2DArray and a layer index, e.g. the pages of a TextureAtlas.
+    class TextureArray
+    {
+    public:
+        explicit TextureArray(const TextureDesc& desc);
+        ~TextureArray();
+        TextureArray(const TextureArray&) = delete;
+        TextureArray& operator=(const TextureArray&) = delete;
+        TextureArray& operator=(TextureArray&& texture) noexcept;
+        TextureArray(TextureArray&& texture) noexcept;
+
+        // Imports RGBA8 images of the same size as layers. The format is chosen once for all
+        // layers: BC3 if any layer has transparent pixels
+        static std::unique_ptr<TextureArray> create(const std::vector<Image>& layers, const TextureImportSettings& settings);
+
+        // Replaces a mip level of one layer: tightly packed pixels, or blocks as compress_image writes them
+        void set_level(const uint32_t layer, const uint32_t level, const void* data, const size_t size);
+        // Fills the levels below 0 of every layer on the GPU; uncompressed formats only
+        void generate_mipmaps();
+        void bind(const unsigned int unit) const;
+
+        unsigned int get_id() const { return m_id; }
+        uint32_t get_width() const { return m_desc.width; }
+        uint32_t get_height() const { return m_desc.height; }
+        uint32_t get_layers() const { return m_desc.layers; }
+        uint32_t get_mip_levels() const { return m_desc.mip_levels; }
+        ETextureFormat get_format() const { return m_desc.format; }
+        // GPU memory of every layer and mip level
+        size_t get_memory_size() const;
+
+    private:
+        unsigned int m_id = 0;
+        TextureDesc m_desc;
+    };
+}
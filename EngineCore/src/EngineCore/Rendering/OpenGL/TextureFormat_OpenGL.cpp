@@ -0,0 +1,227 @@
+#define ENGINE_LOG_MODULE Rendering
+
+#include "TextureFormat_OpenGL.hpp"
+#include "EngineCore/Debug.hpp"
+#include "EngineCore/Rendering/RenderStats.hpp"
+#include "EngineCore/Rendering/TextureCompression.hpp"
+
+#include <glad/glad.h>
+#include <array>
+#include <cstring>
+
+namespace GraphicsEngine {
+    namespace {
+        // GL_EXT_texture_compression_s3tc and GL_EXT_texture_sRGB, which glad was not generated with
+        constexpr GLenum gl_compressed_rgba_s3tc_dxt1 = 0x83F1;
+        constexpr GLenum gl_compressed_rgba_s3tc_dxt5 = 0x83F3;
+        constexpr GLenum gl_compressed_srgb_alpha_s3tc_dxt1 = 0x8C4D;
+        constexpr GLenum gl_compressed_srgb_alpha_s3tc_dxt5 = 0x8C4F;
+
+        constexpr size_t formats_count = static_cast<size_t>(ETextureFormat::BC7_SRGB) + 1;
+
+        bool has_extension(const char* name)
+        {
+            GLint extensions_count = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &extensions_count);
+            for (GLint i = 0; i < extensions_count; ++i)
+            {
+                const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+                if (extension && std::strcmp(extension, name) == 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool query_format_support(const ETextureFormat format)
+        {
+            if (format == ETextureFormat::BC1 || format == ETextureFormat::BC3)
+            {
+                if (!has_extension("GL_EXT_texture_compression_s3tc"))
+                {
+                    return false;
+                }
+            }
+            else if (format == ETextureFormat::BC1_SRGB || format == ETextureFormat::BC3_SRGB)
+            {
+                if (!has_extension("GL_EXT_texture_compression_s3tc") ||
+                    !(has_extension("GL_EXT_texture_sRGB") || has_extension("GL_EXT_texture_compression_s3tc_srgb")))
+                {
+                    return false;
+                }
+            }
+            if (!glGetInternalformativ)
+            {
+                // Everything else is core in GL 4.2
+                return true;
+            }
+            GLint supported = GL_FALSE;
+            glGetInternalformativ(GL_TEXTURE_2D, get_gl_internal_format(format), GL_INTERNALFORMAT_SUPPORTED, 1, &supported);
+            return supported == GL_TRUE;
+        }
+
+        GLenum get_gl_pixel_format(const ETextureFormat format)
+        {
+            switch (format)
+            {
+                case ETextureFormat::R8:  return GL_RED;
+                case ETextureFormat::RG8: return GL_RG;
+                default:                  return GL_RGBA;
+            }
+        }
+    }
+
+    unsigned int get_gl_internal_format(const ETextureFormat format)
+    {
+        switch (format)
+        {
+            case ETextureFormat::R8:       return GL_R8;
+            case ETextureFormat::RG8:      return GL_RG8;
+            case ETextureFormat::RGBA8:    return GL_RGBA8;
+            case ETextureFormat::SRGBA8:   return GL_SRGB8_ALPHA8;
+            case ETextureFormat::BC1:      return gl_compressed_rgba_s3tc_dxt1;
+            case ETextureFormat::BC1_SRGB: return gl_compressed_srgb_alpha_s3tc_dxt1;
+            case ETextureFormat::BC3:      return gl_compressed_rgba_s3tc_dxt5;
+            case ETextureFormat::BC3_SRGB: return gl_compressed_srgb_alpha_s3tc_dxt5;
+            case ETextureFormat::BC4:      return GL_COMPRESSED_RED_RGTC1;
+            case ETextureFormat::BC5:      return GL_COMPRESSED_RG_RGTC2;
+            case ETextureFormat::BC7:      return GL_COMPRESSED_RGBA_BPTC_UNORM;
+            case ETextureFormat::BC7_SRGB: return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+        }
+        LOG_ERROR("get_gl_internal_format: unknown ETextureFormat!");
+        return GL_RGBA8;
+    }
+
+    bool is_texture_format_supported(const ETextureFormat format)
+    {
+        // -1 until queried
+        static std::array<int8_t, formats_count> s_supported = []() {
+            std::array<int8_t, formats_count> values{};
+            values.fill(-1);
+            return values;
+        }();
+        int8_t& supported = s_supported[static_cast<size_t>(format)];
+        if (supported < 0)
+        {
+            supported = query_format_support(format) ? 1 : 0;
+        }
+        return supported == 1;
+    }
+
+    ETextureFormat select_texture_format(const bool opaque, const TextureImportSettings& settings)
+    {
+        const ETextureFormat uncompressed = settings.srgb ? ETextureFormat::SRGBA8 : ETextureFormat::RGBA8;
+        if (!settings.compress)
+        {
+            return uncompressed;
+        }
+        ETextureFormat compressed = opaque ? ETextureFormat::BC1 : ETextureFormat::BC3;
+        if (settings.srgb)
+        {
+            compressed = compressed == ETextureFormat::BC1 ? ETextureFormat::BC1_SRGB : ETextureFormat::BC3_SRGB;
+        }
+        return is_texture_format_supported(compressed) ? compressed : uncompressed;
+    }
+
+    void apply_texture_sampling(const unsigned int target, const ETextureFilter filter, const ETextureWrap wrap, const uint32_t mip_levels)
+    {
+        GLint min_filter = GL_NEAREST;
+        GLint mag_filter = GL_NEAREST;
+        switch (filter)
+        {
+            case ETextureFilter::Nearest:
+                min_filter = mip_levels > 1 ? GL_NEAREST_MIPMAP_NEAREST : GL_NEAREST;
+                break;
+            case ETextureFilter::Linear:
+                min_filter = mip_levels > 1 ? GL_LINEAR_MIPMAP_NEAREST : GL_LINEAR;
+                mag_filter = GL_LINEAR;
+                break;
+            case ETextureFilter::Trilinear:
+                min_filter = mip_levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR;
+                mag_filter = GL_LINEAR;
+                break;
+        }
+        const GLint gl_wrap = wrap == ETextureWrap::Repeat ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+        glTexParameteri(target, GL_TEXTURE_MIN_FILTER, min_filter);
+        glTexParameteri(target, GL_TEXTURE_MAG_FILTER, mag_filter);
+        glTexParameteri(target, GL_TEXTURE_WRAP_S, gl_wrap);
+        glTexParameteri(target, GL_TEXTURE_WRAP_T, gl_wrap);
+    }
+
+    void upload_texture_level(const unsigned int target, const ETextureFormat format, const uint32_t level, const uint32_t layer,
+                              const uint32_t width, const uint32_t height, const void* data, const size_t size)
+    {
+        const GLsizei gl_width = static_cast<GLsizei>(width);
+        const GLsizei gl_height = static_cast<GLsizei>(height);
+        const GLint gl_level = static_cast<GLint>(level);
+        if (is_compressed_format(format))
+        {
+            const GLenum internal_format = get_gl_internal_format(format);
+            if (target == GL_TEXTURE_2D_ARRAY)
+            {
+                glCompressedTexSubImage3D(target, gl_level, 0, 0, static_cast<GLint>(layer), gl_width, gl_height, 1, internal_format, static_cast<GLsizei>(size), data);
+            }
+            else
+            {
+                glCompressedTexSubImage2D(target, gl_level, 0, 0, gl_width, gl_height, internal_format, static_cast<GLsizei>(size), data);
+            }
+        }
+        else
+        {
+            // Rows of R8 and RG8 images are not 4-byte aligned
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            const GLenum pixel_format = get_gl_pixel_format(format);
+            if (target == GL_TEXTURE_2D_ARRAY)
+            {
+                glTexSubImage3D(target, gl_level, 0, 0, static_cast<GLint>(layer), gl_width, gl_height, 1, pixel_format, GL_UNSIGNED_BYTE, data);
+            }
+            else
+            {
+                glTexSubImage2D(target, gl_level, 0, 0, gl_width, gl_height, pixel_format, GL_UNSIGNED_BYTE, data);
+            }
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        }
+        RenderStats::upload_bytes += size;
+    }
+
+    void encode_texture_levels(const Image& image, const ETextureFormat format, const uint32_t levels_count, const bool srgb,
+                               const std::function<void(uint32_t, const void*, size_t)>& upload)
+    {
+        std::vector<uint8_t> data;
+        Image mip;
+        for (uint32_t level = 0; level < levels_count; ++level)
+        {
+            if (level > 0)
+            {
+                mip = downsample_image(level == 1 ? image : mip, srgb);
+            }
+            const Image& source = level == 0 ? image : mip;
+
+            if (is_compressed_format(format))
+            {
+                if (!compress_image(source, format, data))
+                {
+                    LOG_ERROR("encode_texture_levels: can't encode {} textures", get_format_name(format));
+                    return;
+                }
+                upload(level, data.data(), data.size());
+            }
+            else if (format == ETextureFormat::R8 || format == ETextureFormat::RG8)
+            {
+                const size_t channels = get_format_block_size(format);
+                const size_t pixels_count = static_cast<size_t>(source.width) * source.height;
+                data.resize(pixels_count * channels);
+                for (size_t i = 0; i < pixels_count; ++i)
+                {
+                    std::memcpy(data.data() + i * channels, source.pixels.data() + i * 4, channels);
+                }
+                upload(level, data.data(), data.size());
+            }
+            else
+            {
+                upload(level, source.pixels.data(), source.pixels.size());
+            }
+        }
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "EngineCore/Rendering/Image.hpp"
+#include "EngineCore/Rendering/TextureFormat.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace GraphicsEngine {
+    unsigned int get_gl_internal_format(const ETextureFormat format);
+    // Whether textures of this format can be allocated. BC1-BC3 also need
+    // GL_EXT_texture_compression_s3tc (and GL_EXT_texture_sRGB for the sRGB variants).
+    // Cached after the first query, so only call it with the context current.
+    bool is_texture_format_supported(const ETextureFormat format);
+    // Storage format for RGBA8 images imported with settings; opaque when no pixel has alpha below 255
+    ETextureFormat select_texture_format(const bool opaque, const TextureImportSettings& settings);
+
+    // Sets filtering and wrapping on the texture bound to target
+    void apply_texture_sampling(const unsigned int target, const ETextureFilter filter, const ETextureWrap wrap, const uint32_t mip_levels);
+    // Uploads one mip level (one layer for array textures) to the texture bound to target
+    void upload_texture_level(const unsigned int target, const ETextureFormat format, const uint32_t level, const uint32_t layer,
+                              const uint32_t width, const uint32_t height, const void* data, const size_t size);
+
+    // Encodes image and the mip levels computed from it on the CPU in format, calling
+    // upload(level, data, size) for each of the first levels_count levels
+    void encode_texture_levels(const Image& image, const ETextureFormat format, const uint32_t levels_count, const bool srgb,
+                               const std::function<void(uint32_t, const void*, size_t)>& upload);
+}
@@ -0,0 +1,140 @@
+#define ENGINE_LOG_MODULE Rendering
+
+#include "UniformBuffer.hpp"
+#include "EngineCore/Debug.hpp"
+#include "EngineCore/Rendering/RenderStats.hpp"
+
+#include "StateCache_OpenGL.hpp"
+#include <glad/glad.h>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace GraphicsEngine {
+    UniformBuffer::UniformBuffer(const UniformBlockInfo& block_info)
+        : m_members(block_info.members)
+        , m_data(block_info.data_size, 0)
+    {
+        glGenBuffers(1, &m_id);
+        StateCache_OpenGL::bind_buffer(GL_UNIFORM_BUFFER, m_id);
+        glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(m_data.size()), m_data.data(), GL_DYNAMIC_DRAW);
+        RenderStats::upload_bytes += m_data.size();
+    }
+
+    UniformBuffer::~UniformBuffer()
+    {
+        StateCache_OpenGL::on_buffer_deleted(m_id);
+        glDeleteBuffers(1, &m_id);
+    }
+
+    UniformBuffer& UniformBuffer::operator=(UniformBuffer&& uniform_buffer) noexcept
+    {
+        StateCache_OpenGL::on_buffer_deleted(m_id);
+        glDeleteBuffers(1, &m_id);
+        m_id = uniform_buffer.m_id;
+        m_members = std::move(uniform_buffer.m_members);
+        m_data = std::move(uniform_buffer.m_data);
+        m_dirty_begin = uniform_buffer.m_dirty_begin;
+        m_dirty_end = uniform_buffer.m_dirty_end;
+        uniform_buffer.m_id = 0;
+        return *this;
+    }
+
+    UniformBuffer::UniformBuffer(UniformBuffer&& uniform_buffer) noexcept
+        : m_id(uniform_buffer.m_id)
+        , m_members(std::move(uniform_buffer.m_members))
+        , m_data(std::move(uniform_buffer.m_data))
+        , m_dirty_begin(uniform_buffer.m_dirty_begin)
+        , m_dirty_end(uniform_buffer.m_dirty_end)
+    {
+        uniform_buffer.m_id = 0;
+    }
+
+    UniformHandle UniformBuffer::get_member_handle(const char* name) const
+    {
+        for (size_t i = 0; i < m_members.size(); ++i)
+        {
+            if (m_members[i].name == name)
+            {
+                return { static_cast<int>(i) };
+            }
+        }
+        LOG_ERROR("UniformBuffer: unknown member {}", name);
+        return {};
+    }
+
+    void UniformBuffer::set_data(const size_t offset, const void* data, const size_t size)
+    {
+        if (offset + size > m_data.size())
+        {
+            LOG_ERROR("UniformBuffer: write of {} bytes at offset {} is out of range", size, offset);
+            return;
+        }
+        if (std::memcmp(m_data.data() + offset, data, size) == 0)
+        {
+            return;
+        }
+
+        std::memcpy(m_data.data() + offset, data, size);
+        if (is_dirty())
+        {
+            m_dirty_begin = std::min(m_dirty_begin, offset);
+            m_dirty_end = std::max(m_dirty_end, offset + size);
+        }
+        else
+        {
+            m_dirty_begin = offset;
+            m_dirty_end = offset + size;
+        }
+    }
+
+    void UniformBuffer::set_member(const UniformHandle handle, const void* data, const size_t size)
+    {
+        if (!handle.is_valid())
+        {
+            return;
+        }
+        set_data(static_cast<size_t>(m_members[handle.index].offset), data, size);
+    }
+
+    void UniformBuffer::setInt(const UniformHandle handle, const int value)
+    {
+        set_member(handle, &value, sizeof(value));
+    }
+
+    void UniformBuffer::setFloat(const UniformHandle handle, const float value)
+    {
+        set_member(handle, &value, sizeof(value));
+    }
+
+    void UniformBuffer::setVec4(const UniformHandle handle, const glm::vec4& value)
+    {
+        set_member(handle, glm::value_ptr(value), sizeof(value));
+    }
+
+    void UniformBuffer::setMatrix4(const UniformHandle handle, const glm::mat4& matrix)
+    {
+        // std140 stores a column-major mat4 as four vec4 columns, same as glm
+        set_member(handle, glm::value_ptr(matrix), sizeof(matrix));
+    }
+
+    void UniformBuffer::upload()
+    {
+        if (!is_dirty())
+        {
+            return;
+        }
+
+        StateCache_OpenGL::bind_buffer(GL_UNIFORM_BUFFER, m_id);
+        glBufferSubData(GL_UNIFORM_BUFFER, static_cast<GLintptr>(m_dirty_begin), static_cast<GLsizeiptr>(m_dirty_end - m_dirty_begin), m_data.data() + m_dirty_begin);
+        RenderStats::upload_bytes += m_dirty_end - m_dirty_begin;
+
+        m_dirty_begin = 0;
+        m_dirty_end = 0;
+    }
+
+    void UniformBuffer::bind(const unsigned int binding) const
+    {
+        StateCache_OpenGL::bind_buffer_base(GL_UNIFORM_BUFFER, binding, m_id);
+    }
+}
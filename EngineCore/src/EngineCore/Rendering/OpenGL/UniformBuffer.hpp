@@ -0,0 +1,46 @@
+#pragma once
+
+#include "ShaderProgram.hpp"
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+#include <vector>
+#include <cstdint>
+
+namespace GraphicsEngine {
+    // GPU copy of a std140 uniform block with a CPU shadow copy. Setters only mark
+    // the changed byte range dirty; upload() sends that range and nothing else.
+    class UniformBuffer
+    {
+    public:
+        UniformBuffer(const UniformBlockInfo& block_info);
+        ~UniformBuffer();
+        UniformBuffer(const UniformBuffer&) = delete;
+        UniformBuffer& operator=(const UniformBuffer&) = delete;
+        UniformBuffer& operator=(UniformBuffer&& uniform_buffer) noexcept;
+        UniformBuffer(UniformBuffer&& uniform_buffer) noexcept;
+
+        UniformHandle get_member_handle(const char* name) const;
+
+        void set_data(const size_t offset, const void* data, const size_t size);
+        void setInt(const UniformHandle handle, const int value);
+        void setFloat(const UniformHandle handle, const float value);
+        void setVec4(const UniformHandle handle, const glm::vec4& value);
+        void setMatrix4(const UniformHandle handle, const glm::mat4& matrix);
+
+        void upload();
+        void bind(const unsigned int binding) const;
+
+        bool is_dirty() const { return m_dirty_begin < m_dirty_end; }
+        size_t get_size() const { return m_data.size(); }
+
+    private:
+        void set_member(const UniformHandle handle, const void* data, const size_t size);
+
+        unsigned int m_id = 0;
+        std::vector<UniformInfo> m_members;
+        std::vector<uint8_t> m_data;
+        size_t m_dirty_begin = 0;
+        size_t m_dirty_end = 0;
+    };
+}
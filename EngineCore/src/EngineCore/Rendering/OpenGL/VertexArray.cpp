@@ -1,64 +1,162 @@
+#define ENGINE_LOG_MODULE Rendering
+
 #include "VertexArray.hpp"
 #include "EngineCore/Debug.hpp"
+#include "StateCache_OpenGL.hpp"
+#include "Renderer_OpenGL.hpp"
 #include <glad/glad.h>
 
 namespace GraphicsEngine {
     
     VertexArray::VertexArray()
     {
-        glGenVertexArrays(1, &m_id);
+        if (Renderer_OpenGL::has_direct_state_access())
+        {
+            glCreateVertexArrays(1, &m_id);
+        }
+        else
+        {
+            glGenVertexArrays(1, &m_id);
+        }
     }
     VertexArray::~VertexArray()
     {
+        StateCache_OpenGL::on_vertex_array_deleted(m_id);
         glDeleteVertexArrays(1, &m_id);
     }
     VertexArray& VertexArray::operator=(VertexArray&& vertex_array) noexcept
     {
         m_id = vertex_array.m_id;
-        m_elements_count = vertex_array.m_id;
+        m_elements_count = vertex_array.m_elements_count;
+        m_bindings_first_attribute = std::move(vertex_array.m_bindings_first_attribute);
+        m_indices_count = vertex_array.m_indices_count;
+        m_index_type = vertex_array.m_index_type;
         vertex_array.m_id = 0;
         vertex_array.m_elements_count = 0;
+        vertex_array.m_indices_count = 0;
         return *this;
     }
     VertexArray::VertexArray(VertexArray&& vertex_array) noexcept
         : m_id(vertex_array.m_id)
         , m_elements_count(vertex_array.m_elements_count)
+        , m_bindings_first_attribute(std::move(vertex_array.m_bindings_first_attribute))
+        , m_indices_count(vertex_array.m_indices_count)
+        , m_index_type(vertex_array.m_index_type)
     {
         vertex_array.m_id = 0;
         vertex_array.m_elements_count = 0;
+        vertex_array.m_indices_count = 0;
     }
     void VertexArray::bind() const
     {
-        glBindVertexArray(m_id);
+        StateCache_OpenGL::bind_vertex_array(m_id);
     }
     void VertexArray::unbind()
     {
-        glBindVertexArray(0);
+        StateCache_OpenGL::bind_vertex_array(0);
     }
     void VertexArray::add_vertex_buffer(const VertexBuffer& vertex_buffer)
     {
-        bind();
-        vertex_buffer.bind();
+        const unsigned int binding = static_cast<unsigned int>(m_bindings_first_attribute.size());
+        m_bindings_first_attribute.push_back(m_elements_count);
+        set_attributes(vertex_buffer, m_elements_count, binding);
+        for (const BufferElement& element : vertex_buffer.get_layout().get_elements())
+        {
+            m_elements_count += static_cast<unsigned int>(element.locations_count);
+        }
+    }
+
+    void VertexArray::set_vertex_buffer(const size_t binding, const VertexBuffer& vertex_buffer)
+    {
+        if (binding >= m_bindings_first_attribute.size())
+        {
+            LOG_ERROR("VertexArray: no vertex buffer binding {}", binding);
+            return;
+        }
+        if (Renderer_OpenGL::has_direct_state_access())
+        {
+            // The attribute formats stay, only the buffer behind the binding changes
+            glVertexArrayVertexBuffer(m_id, static_cast<GLuint>(binding), vertex_buffer.get_id(), 0,
+                                      static_cast<GLsizei>(vertex_buffer.get_layout().get_stride()));
+            return;
+        }
+        // Attribute pointers capture the buffer bound when they are specified, so specify them again
+        set_attributes(vertex_buffer, m_bindings_first_attribute[binding], static_cast<unsigned int>(binding));
+    }
+
+    void VertexArray::set_attributes(const VertexBuffer& vertex_buffer, const unsigned int first_attribute, const unsigned int binding)
+    {
+        const BufferLayout& layout = vertex_buffer.get_layout();
+        const bool direct_state_access = Renderer_OpenGL::has_direct_state_access();
+        if (direct_state_access)
+        {
+            glVertexArrayVertexBuffer(m_id, binding, vertex_buffer.get_id(), 0, static_cast<GLsizei>(layout.get_stride()));
+            glVertexArrayBindingDivisor(m_id, binding, layout.get_instance_divisor());
+        }
+        else
+        {
+            bind();
+            vertex_buffer.bind();
+        }
 
-        for (const BufferElement& current_element : vertex_buffer.get_layout().get_elements())
+        unsigned int attribute = first_attribute;
+        for (const BufferElement& current_element : layout.get_elements())
         {
-            glEnableVertexAttribArray(m_elements_count);
-            glVertexAttribPointer(
-                m_elements_count,
-                static_cast<GLint>(current_element.components_count),
-                current_element.component_type,
-                GL_FALSE,
-                static_cast<GLsizei>(vertex_buffer.get_layout().get_stride()),
-                reinterpret_cast<const void*>(current_element.offset)
-            );
-            ++m_elements_count;
+            const size_t location_size = current_element.size / current_element.locations_count;
+            for (size_t location = 0; location < current_element.locations_count; ++location, ++attribute)
+            {
+                const size_t offset = current_element.offset + location * location_size;
+                const GLint components_count = static_cast<GLint>(current_element.components_count);
+                const GLboolean normalized = current_element.normalized ? GL_TRUE : GL_FALSE;
+                if (direct_state_access)
+                {
+                    glEnableVertexArrayAttrib(m_id, attribute);
+                    if (is_integer_shader_data_type(current_element.type))
+                    {
+                        glVertexArrayAttribIFormat(m_id, attribute, components_count, current_element.component_type, static_cast<GLuint>(offset));
+                    }
+                    else
+                    {
+                        glVertexArrayAttribFormat(m_id, attribute, components_count, current_element.component_type, normalized,
+                                                  static_cast<GLuint>(offset));
+                    }
+                    glVertexArrayAttribBinding(m_id, attribute, binding);
+                    continue;
+                }
+
+                const void* pointer = reinterpret_cast<const void*>(offset);
+                glEnableVertexAttribArray(attribute);
+                if (is_integer_shader_data_type(current_element.type))
+                {
+                    glVertexAttribIPointer(attribute, components_count, current_element.component_type,
+                                           static_cast<GLsizei>(layout.get_stride()), pointer);
+                }
+                else
+                {
+                    glVertexAttribPointer(attribute, components_count, current_element.component_type, normalized,
+                                          static_cast<GLsizei>(layout.get_stride()), pointer);
+                }
+                if (layout.get_instance_divisor() != 0)
+                {
+                    glVertexAttribDivisor(attribute, layout.get_instance_divisor());
+                }
+            }
         }
     }
 
     void VertexArray::set_index_buffer(const IndexBuffer& index_buffer)
     {
-        bind();
-        index_buffer.bind();
+        if (Renderer_OpenGL::has_direct_state_access())
+        {
+            glVertexArrayElementBuffer(m_id, index_buffer.get_id());
+            StateCache_OpenGL::on_element_buffer_set(m_id, index_buffer.get_id());
+        }
+        else
+        {
+            bind();
+            index_buffer.bind();
+        }
         m_indices_count = index_buffer.get_count();
+        m_index_type = index_buffer.get_type();
     }
-}
\ No newline at end of file
+}
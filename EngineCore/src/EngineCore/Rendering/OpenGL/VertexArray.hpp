@@ -2,7 +2,12 @@
 #include "VertexBuffer.hpp"
 #include "IndexBuffer.hpp"
 
+#include <vector>
+
 namespace GraphicsEngine {
+    // Each add_vertex_buffer() call describes one vertex buffer binding. A VAO describes a vertex
+    // format rather than particular buffers: set_vertex_buffer() and set_index_buffer() re-point
+    // it at other buffers of the same format instead of building a new VAO
     class VertexArray {
     public:
         VertexArray();
@@ -12,13 +17,21 @@ namespace GraphicsEngine {
         VertexArray& operator=(VertexArray&& vertex_buffer) noexcept;
         VertexArray(VertexArray&& vertex_buffer) noexcept;
         void add_vertex_buffer(const VertexBuffer& vertex_buffer);
+        // vertex_buffer must have the layout of the buffer that was added for binding
+        void set_vertex_buffer(const size_t binding, const VertexBuffer& vertex_buffer);
         void set_index_buffer(const IndexBuffer& index_buffer);
         void bind() const;
         static void unbind();
         size_t get_indices_count() const { return m_indices_count; }
+        EIndexType get_index_type() const { return m_index_type; }
+        size_t get_bindings_count() const { return m_bindings_first_attribute.size(); }
     private:
+        void set_attributes(const VertexBuffer& vertex_buffer, const unsigned int first_attribute, const unsigned int binding);
+
         unsigned int m_id = 0;
         unsigned int m_elements_count = 0;
+        std::vector<unsigned int> m_bindings_first_attribute;
         size_t m_indices_count = 0;
+        EIndexType m_index_type = EIndexType::UInt32;
     };
-}
\ No newline at end of file
+}
@@ -1,7 +1,13 @@
+#define ENGINE_LOG_MODULE Rendering
+
 #include "VertexBuffer.hpp"
 #include "EngineCore/Debug.hpp"
+#include "EngineCore/Rendering/RenderStats.hpp"
+#include "StateCache_OpenGL.hpp"
+#include "Renderer_OpenGL.hpp"
 #include <glad/glad.h>
 #include <memory>
+#include <cstring>
 
 namespace GraphicsEngine
 {
@@ -14,18 +20,40 @@ namespace GraphicsEngine
                 return 1;
             case ShaderDataType::Float2:
             case ShaderDataType::Int2:
+            case ShaderDataType::Half2:
+            case ShaderDataType::Short2Norm:
                 return 2;
             case ShaderDataType::Float3:
             case ShaderDataType::Int3:
                 return 3;
             case ShaderDataType::Float4:
             case ShaderDataType::Int4:
+            case ShaderDataType::Mat4:
+            case ShaderDataType::Half4:
+            case ShaderDataType::UByte4Norm:
+            case ShaderDataType::Short4Norm:
+            case ShaderDataType::Int2_10_10_10_Rev:
                 return 4;
+            case ShaderDataType::Mat3:
+                return 3;
         }
         LOG_ERROR("shader_data_type_to_component_type: unknown ShaderDataType!");
         return 0;
     }
 
+    constexpr unsigned int shader_data_type_to_locations_count(const ShaderDataType type)
+    {
+        switch (type)
+        {
+            case ShaderDataType::Mat3:
+                return 3;
+            case ShaderDataType::Mat4:
+                return 4;
+            default:
+                return 1;
+        }
+    }
+
     constexpr size_t shader_data_type_size(const ShaderDataType type)
     {
         switch (type)
@@ -34,12 +62,24 @@ namespace GraphicsEngine
             case ShaderDataType::Float2:
             case ShaderDataType::Float3:
             case ShaderDataType::Float4:
-                return sizeof(GLfloat) * shader_data_type_to_components_count(type);
+            case ShaderDataType::Mat3:
+            case ShaderDataType::Mat4:
+                return sizeof(GLfloat) * shader_data_type_to_components_count(type) * shader_data_type_to_locations_count(type);
             case ShaderDataType::Int:
             case ShaderDataType::Int2:
             case ShaderDataType::Int3:
             case ShaderDataType::Int4:
                 return sizeof(GLint) * shader_data_type_to_components_count(type);
+            case ShaderDataType::Half2:
+            case ShaderDataType::Half4:
+                return sizeof(GLhalf) * shader_data_type_to_components_count(type);
+            case ShaderDataType::UByte4Norm:
+                return sizeof(GLubyte) * 4;
+            case ShaderDataType::Short2Norm:
+            case ShaderDataType::Short4Norm:
+                return sizeof(GLshort) * shader_data_type_to_components_count(type);
+            case ShaderDataType::Int2_10_10_10_Rev:
+                return sizeof(GLuint);
         }
         LOG_ERROR("shader_data_type_size: unknown ShaderDataType!");
         return 0;
@@ -54,12 +94,19 @@ namespace GraphicsEngine
         case VertexBuffer::EUsage::Dynamic:
             return GL_DYNAMIC_DRAW;
         case VertexBuffer::EUsage::Stream:
+        case VertexBuffer::EUsage::PersistentStream:
             return GL_STREAM_DRAW;
         }
         LOG_ERROR("Unknown VertexBuffer usage");
         return GL_STREAM_DRAW;
     }
 
+    constexpr unsigned int usage_to_storage_flags(const VertexBuffer::EUsage usage)
+    {
+        // Static buffers are only written at creation or by GPU copies, which immutable storage allows
+        return usage == VertexBuffer::EUsage::Static ? 0 : GL_DYNAMIC_STORAGE_BIT;
+    }
+
     constexpr unsigned int shader_data_type_to_component_type(const ShaderDataType type)
     {
         switch (type)
@@ -68,21 +115,49 @@ namespace GraphicsEngine
             case ShaderDataType::Float2:
             case ShaderDataType::Float3:
             case ShaderDataType::Float4:
+            case ShaderDataType::Mat3:
+            case ShaderDataType::Mat4:
                 return GL_FLOAT;
             case ShaderDataType::Int:
             case ShaderDataType::Int2:
             case ShaderDataType::Int3:
             case ShaderDataType::Int4:
                 return GL_INT;
+            case ShaderDataType::Half2:
+            case ShaderDataType::Half4:
+                return GL_HALF_FLOAT;
+            case ShaderDataType::UByte4Norm:
+                return GL_UNSIGNED_BYTE;
+            case ShaderDataType::Short2Norm:
+            case ShaderDataType::Short4Norm:
+                return GL_SHORT;
+            case ShaderDataType::Int2_10_10_10_Rev:
+                return GL_INT_2_10_10_10_REV;
         }
         LOG_ERROR("shader_data_type_to_component_type: unknown ShaderDataType!");
         return GL_FLOAT;
     }
 
+    constexpr bool shader_data_type_is_normalized(const ShaderDataType type)
+    {
+        switch (type)
+        {
+            case ShaderDataType::UByte4Norm:
+            case ShaderDataType::Short2Norm:
+            case ShaderDataType::Short4Norm:
+            case ShaderDataType::Int2_10_10_10_Rev:
+                return true;
+            default:
+                return false;
+        }
+    }
+
     BufferElement::BufferElement(const ShaderDataType _type)
         : type(_type)
         , component_type(shader_data_type_to_component_type(_type))
         , components_count(shader_data_type_to_components_count(_type))
+        , locations_count(shader_data_type_to_locations_count(_type))
+        , normalized(shader_data_type_is_normalized(_type))
         , size(shader_data_type_size(_type))
         , offset(0)
     {
@@ -90,38 +165,88 @@ namespace GraphicsEngine
 
     VertexBuffer::VertexBuffer(const void* data, const size_t size, BufferLayout buffer_layout, const EUsage usage)
         : m_buffer_layout(std::move(buffer_layout))
+        , m_usage(usage)
     {
-        glGenBuffers(1, &m_id);
-        glBindBuffer(GL_ARRAY_BUFFER, m_id);
-        glBufferData(GL_ARRAY_BUFFER, size, data, usage_to_GLenum(usage));
+        const bool direct_state_access = Renderer_OpenGL::has_direct_state_access();
+        if (direct_state_access)
+        {
+            glCreateBuffers(1, &m_id);
+        }
+        else
+        {
+            glGenBuffers(1, &m_id);
+            StateCache_OpenGL::bind_buffer(GL_ARRAY_BUFFER, m_id);
+        }
+        if (usage == EUsage::PersistentStream)
+        {
+            m_stream.allocate(GL_ARRAY_BUFFER, m_id, size);
+            if (data)
+            {
+                update_buffer(data, size);
+            }
+            return;
+        }
+
+        if (direct_state_access)
+        {
+            glNamedBufferStorage(m_id, static_cast<GLsizeiptr>(size), data, usage_to_storage_flags(usage));
+        }
+        else
+        {
+            glBufferData(GL_ARRAY_BUFFER, size, data, usage_to_GLenum(usage));
+        }
+        if (data)
+        {
+            RenderStats::upload_bytes += size;
+        }
     }
     VertexBuffer::~VertexBuffer()
     {
+        StateCache_OpenGL::on_buffer_deleted(m_id);
         glDeleteBuffers(1, &m_id);
     }
     VertexBuffer &VertexBuffer::operator=(VertexBuffer &&vertex_buffer) noexcept
     {
         m_id = vertex_buffer.m_id;
+        m_usage = vertex_buffer.m_usage;
+        m_stream = std::move(vertex_buffer.m_stream);
         vertex_buffer.m_id = 0;
         return *this;
     }
     VertexBuffer::VertexBuffer(VertexBuffer &&vertex_buffer) noexcept
         : m_id(vertex_buffer.m_id)
         , m_buffer_layout(std::move(vertex_buffer.m_buffer_layout))
+        , m_usage(vertex_buffer.m_usage)
+        , m_stream(std::move(vertex_buffer.m_stream))
     {
         vertex_buffer.m_id = 0;
     }
     void VertexBuffer::bind() const
     {
-        glBindBuffer(GL_ARRAY_BUFFER, m_id);
+        StateCache_OpenGL::bind_buffer(GL_ARRAY_BUFFER, m_id);
     }
     void VertexBuffer::unbind()
     {
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        StateCache_OpenGL::bind_buffer(GL_ARRAY_BUFFER, 0);
     }
-    void VertexBuffer::update_buffer(const void *data, const size_t size)
+    void VertexBuffer::update_buffer(const void *data, const size_t size, const size_t offset)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, m_id);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+        if (m_usage == EUsage::PersistentStream)
+        {
+            // Writes into the next region; readers must use m_stream.get_region_offset()
+            std::memcpy(m_stream.map_next_region(), data, size);
+            m_stream.commit(size);
+            return;
+        }
+        if (Renderer_OpenGL::has_direct_state_access())
+        {
+            glNamedBufferSubData(m_id, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+        }
+        else
+        {
+            StateCache_OpenGL::bind_buffer(GL_ARRAY_BUFFER, m_id);
+            glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset), size, data);
+        }
+        RenderStats::upload_bytes += size;
     }
 }
\ No newline at end of file
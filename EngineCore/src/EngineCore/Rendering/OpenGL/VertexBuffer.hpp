@@ -1,7 +1,10 @@
 #pragma once
 
+#include "StreamBuffer.hpp"
+
 #include <vector>
 #include <cstdint>
+#include <cstddef>
 
 namespace GraphicsEngine {
     enum class ShaderDataType
@@ -14,13 +17,35 @@ namespace GraphicsEngine {
         Int2,
         Int3,
         Int4,
+        // Matrices occupy one attribute location per column
+        Mat3,
+        Mat4,
+        // Compressed types, read as floats by the shader. Norm types map their integer range
+        // to [0, 1] (unsigned) or [-1, 1] (signed). Baked meshes store these values, so new
+        // types are only ever appended.
+        Half2,
+        Half4,
+        UByte4Norm,
+        Short2Norm,
+        Short4Norm,
+        // xyz in 10 bits and w in 2 bits, signed normalized, packed into one 32-bit word
+        Int2_10_10_10_Rev,
     };
 
+    // Integer types reach the shader as ints instead of being converted to floats
+    constexpr bool is_integer_shader_data_type(const ShaderDataType type)
+    {
+        return type == ShaderDataType::Int || type == ShaderDataType::Int2 || type == ShaderDataType::Int3 || type == ShaderDataType::Int4;
+    }
+
     struct BufferElement
     {
         ShaderDataType type;
         uint32_t component_type;
+        // Components per attribute location
         size_t components_count;
+        size_t locations_count;
+        bool normalized;
         size_t size;
         size_t offset;
         BufferElement(const ShaderDataType type);
@@ -29,8 +54,15 @@ namespace GraphicsEngine {
     class BufferLayout
     {
     public:
-        BufferLayout(std::initializer_list<BufferElement> elements)
+        // A non-zero instance_divisor makes the attributes advance once per instance_divisor
+        // instances instead of once per vertex
+        BufferLayout(std::initializer_list<BufferElement> elements, const unsigned int instance_divisor = 0)
+            : BufferLayout(std::vector<BufferElement>(elements), instance_divisor)
+        {
+        }
+        BufferLayout(std::vector<BufferElement> elements, const unsigned int instance_divisor = 0)
             : m_elements(std::move(elements))
+            , m_instance_divisor(instance_divisor)
         {
             size_t offset = 0;
             m_stride = 0;
@@ -43,9 +75,11 @@ namespace GraphicsEngine {
         }
         const std::vector<BufferElement>& get_elements() const { return m_elements; }
         size_t get_stride() const { return m_stride; }
+        unsigned int get_instance_divisor() const { return m_instance_divisor; }
     private:
         std::vector<BufferElement> m_elements;
         size_t m_stride = 0;
+        unsigned int m_instance_divisor = 0;
     };
 
     class VertexBuffer {
@@ -54,7 +88,9 @@ namespace GraphicsEngine {
         {
             Static,
             Dynamic,
-            Stream
+            Stream,
+            // size is the size of one region of a persistently mapped StreamBuffer
+            PersistentStream
         };
         VertexBuffer(const void* data, const size_t size, BufferLayout buffer_layout, const EUsage usage = VertexBuffer::EUsage::Static);
         ~VertexBuffer();
@@ -65,11 +101,18 @@ namespace GraphicsEngine {
         void bind() const;
         static void unbind();
 
-        void update_buffer(const void* data, const size_t size);
+        // offset is in bytes and ignored for PersistentStream buffers, which always write a whole new region
+        void update_buffer(const void* data, const size_t size, const size_t offset = 0);
 
+        unsigned int get_id() const { return m_id; }
         const BufferLayout& get_layout() const { return m_buffer_layout; }
+        StreamBuffer& get_stream() { return m_stream; }
+        const StreamBuffer& get_stream() const { return m_stream; }
+        EUsage get_usage() const { return m_usage; }
     private:
         unsigned int m_id = 0;
         BufferLayout m_buffer_layout;
+        EUsage m_usage;
+        StreamBuffer m_stream;
     };
 }
\ No newline at end of file
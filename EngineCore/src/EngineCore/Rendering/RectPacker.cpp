@@ -0,0 +1,114 @@
+#include "RectPacker.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace GraphicsEngine {
+    RectPacker::RectPacker(const uint32_t width, const uint32_t height)
+        : m_width(width)
+        , m_height(height)
+    {
+        reset();
+    }
+
+    void RectPacker::reset()
+    {
+        m_skyline.clear();
+        m_skyline.push_back({ 0, 0, m_width });
+        m_used_area = 0;
+    }
+
+    bool RectPacker::fit(const size_t index, const uint32_t width, const uint32_t height, uint32_t& y) const
+    {
+        const uint32_t x = m_skyline[index].x;
+        if (x + width > m_width)
+        {
+            return false;
+        }
+        y = 0;
+        uint32_t remaining_width = width;
+        for (size_t i = index; remaining_width > 0; ++i)
+        {
+            y = std::max(y, m_skyline[i].y);
+            if (y + height > m_height)
+            {
+                return false;
+            }
+            remaining_width -= std::min(remaining_width, m_skyline[i].width);
+        }
+        return true;
+    }
+
+    bool RectPacker::pack(const uint32_t width, const uint32_t height, uint32_t& x, uint32_t& y)
+    {
+        if (width == 0 || height == 0)
+        {
+            return false;
+        }
+
+        size_t best_index = m_skyline.size();
+        uint32_t best_top = std::numeric_limits<uint32_t>::max();
+        uint32_t best_width = std::numeric_limits<uint32_t>::max();
+        uint32_t best_y = 0;
+        for (size_t i = 0; i < m_skyline.size(); ++i)
+        {
+            uint32_t fit_y = 0;
+            if (!fit(i, width, height, fit_y))
+            {
+                continue;
+            }
+            // Ties go to the narrower segment, which leaves wider gaps for later rectangles
+            const uint32_t top = fit_y + height;
+            if (top < best_top || (top == best_top && m_skyline[i].width < best_width))
+            {
+                best_index = i;
+                best_top = top;
+                best_width = m_skyline[i].width;
+                best_y = fit_y;
+            }
+        }
+        if (best_index == m_skyline.size())
+        {
+            return false;
+        }
+
+        x = m_skyline[best_index].x;
+        y = best_y;
+        m_skyline.insert(m_skyline.begin() + static_cast<std::ptrdiff_t>(best_index), { x, best_top, width });
+
+        // Segments now under the rectangle shrink or disappear
+        for (size_t i = best_index + 1; i < m_skyline.size();)
+        {
+            Segment& segment = m_skyline[i];
+            const uint32_t covered_end = x + width;
+            if (segment.x >= covered_end)
+            {
+                break;
+            }
+            const uint32_t overlap = std::min(covered_end - segment.x, segment.width);
+            segment.x += overlap;
+            segment.width -= overlap;
+            if (segment.width == 0)
+            {
+                m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(i));
+                continue;
+            }
+            break;
+        }
+
+        // Neighbours at the same height merge into one segment
+        for (size_t i = 0; i + 1 < m_skyline.size();)
+        {
+            if (m_skyline[i].y == m_skyline[i + 1].y)
+            {
+                m_skyline[i].width += m_skyline[i + 1].width;
+                m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+                continue;
+            }
+            ++i;
+        }
+
+        m_used_area += static_cast<size_t>(width) * height;
+        return true;
+    }
+}
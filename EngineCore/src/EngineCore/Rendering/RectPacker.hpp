@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace GraphicsEngine {
+    // Packs rectangles into a fixed-size bin with the skyline bottom-left heuristic: the bin's
+    // used area is tracked as a list of horizontal segments, and each rectangle goes where its
+    // top edge ends up lowest. Sorting rectangles by decreasing height before packing gives the
+    // best results. Space below a segment is never reused, which costs little for atlases.
+    class RectPacker
+    {
+    public:
+        RectPacker(const uint32_t width, const uint32_t height);
+
+        // Returns false when the rectangle does not fit anywhere
+        bool pack(const uint32_t width, const uint32_t height, uint32_t& x, uint32_t& y);
+        void reset();
+
+        uint32_t get_width() const { return m_width; }
+        uint32_t get_height() const { return m_height; }
+        // Packed area / bin area
+        float get_occupancy() const { return static_cast<float>(m_used_area) / (static_cast<float>(m_width) * static_cast<float>(m_height)); }
+
+    private:
+        struct Segment
+        {
+            uint32_t x;
+            uint32_t y;
+            uint32_t width;
+        };
+
+        // Lowest y at which a rectangle of the given width can sit on the skyline from segment index on
+        bool fit(const size_t index, const uint32_t width, const uint32_t height, uint32_t& y) const;
+
+        uint32_t m_width;
+        uint32_t m_height;
+        size_t m_used_area = 0;
+        std::vector<Segment> m_skyline;
+    };
+}
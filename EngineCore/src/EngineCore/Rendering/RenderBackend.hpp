@@ -0,0 +1,52 @@
+#pragma once
+
+#include "EngineCore/Rendering/OpenGL/VertexBuffer.hpp"
+#include "EngineCore/Rendering/OpenGL/IndexBuffer.hpp"
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+#include <span>
+#include <cstddef>
+
+namespace GraphicsEngine {
+    enum class ERenderBackend
+    {
+        OpenGL,
+        // Rasterized on the CPU into memory (see Renderer_Software); headless windows only
+        Software
+    };
+
+    // A mesh in CPU memory, in the layout and index type its VertexBuffer and IndexBuffer use
+    struct MeshView
+    {
+        const void* vertices = nullptr;
+        size_t vertices_count = 0;
+        const BufferLayout* layout = nullptr;
+        const void* indices = nullptr;
+        size_t indices_count = 0;
+        EIndexType index_type = EIndexType::UInt32;
+    };
+
+    // indices_count indices from first_index, drawn once per model matrix
+    struct MeshDraw
+    {
+        size_t first_index = 0;
+        size_t indices_count = 0;
+        std::span<const glm::mat4> model_matrices;
+        // Texture atlas region of each instance, parallel to model_matrices; empty draws every instance with region 0
+        std::span<const int32_t> atlas_regions;
+    };
+
+    // What drawing the scene needs from a renderer. The first element of a mesh's layout is
+    // its position and the second, if there is one, its color, as in the scene's shaders.
+    class RenderBackend
+    {
+    public:
+        virtual ~RenderBackend() = default;
+
+        virtual void set_viewport(const unsigned int width, const unsigned int height) = 0;
+        virtual void clear(const glm::vec4& color) = 0;
+        virtual void draw(const glm::mat4& view_projection, const MeshView& mesh, std::span<const MeshDraw> draws) = 0;
+    };
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <type_traits>
+#include <new>
+
+namespace GraphicsEngine {
+    // Linear buffer of recorded render commands. A command is any callable; it is copied
+    // into the buffer next to a pointer to its invoker, so recording does not allocate once
+    // the buffer has grown to the frame's size. Commands must be trivially copyable and
+    // destructible (capture values and pointers, not containers).
+    class RenderCommandList
+    {
+    public:
+        RenderCommandList() = default;
+        RenderCommandList(const RenderCommandList&) = delete;
+        RenderCommandList& operator=(const RenderCommandList&) = delete;
+
+        template <typename Command>
+        void submit(Command&& command)
+        {
+            using CommandType = std::decay_t<Command>;
+            static_assert(std::is_trivially_copyable_v<CommandType> && std::is_trivially_destructible_v<CommandType>,
+                          "Render commands must be trivially copyable and destructible");
+            static_assert(alignof(CommandType) <= alignof(std::max_align_t), "Render command is over-aligned");
+
+            const size_t blocks_count = 1 + (sizeof(CommandType) + sizeof(Block) - 1) / sizeof(Block);
+            const size_t offset = m_blocks.size();
+            m_blocks.resize(offset + blocks_count);
+
+            CommandHeader* header = reinterpret_cast<CommandHeader*>(&m_blocks[offset]);
+            header->execute = [](void* data) { (*static_cast<CommandType*>(data))(); };
+            header->blocks_count = blocks_count;
+            new (&m_blocks[offset + 1]) CommandType(std::forward<Command>(command));
+            ++m_commands_count;
+        }
+
+        void execute()
+        {
+            for (size_t offset = 0; offset < m_blocks.size();)
+            {
+                CommandHeader* header = reinterpret_cast<CommandHeader*>(&m_blocks[offset]);
+                header->execute(&m_blocks[offset + 1]);
+                offset += header->blocks_count;
+            }
+        }
+
+        void clear()
+        {
+            m_blocks.clear();
+            m_commands_count = 0;
+        }
+
+        bool empty() const { return m_blocks.empty(); }
+        size_t get_commands_count() const { return m_commands_count; }
+
+    private:
+        using Block = std::max_align_t;
+
+        struct CommandHeader
+        {
+            void (*execute)(void*);
+            size_t blocks_count;
+        };
+        static_assert(sizeof(CommandHeader) <= sizeof(Block));
+
+        std::vector<Block> m_blocks;
+        size_t m_commands_count = 0;
+    };
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace GraphicsEngine {
+    // Counters for the current frame, taken and zeroed by Application after each frame.
+    // Atomic because the render thread updates them while the main thread reads them.
+    struct RenderStats
+    {
+        static inline std::atomic<size_t> draw_calls = 0;
+        static inline std::atomic<size_t> triangles = 0;
+        static inline std::atomic<size_t> upload_bytes = 0;
+        static inline std::atomic<size_t> fence_waits = 0;
+        static inline std::atomic<size_t> state_changes_issued = 0;
+        static inline std::atomic<size_t> state_changes_skipped = 0;
+
+        static void reset()
+        {
+            draw_calls = 0;
+            triangles = 0;
+            upload_bytes = 0;
+            fence_waits = 0;
+            state_changes_issued = 0;
+            state_changes_skipped = 0;
+        }
+    };
+}
@@ -0,0 +1,111 @@
+#define ENGINE_LOG_MODULE Rendering
+
+#include "RenderThread.hpp"
+#include "OpenGL/StateCache_OpenGL.hpp"
+#include "EngineCore/Debug.hpp"
+#include "EngineCore/Profiling/Profiler.hpp"
+
+#include <GLFW/glfw3.h>
+
+namespace GraphicsEngine {
+    RenderThread::RenderThread(GLFWwindow* window, StateCache_OpenGL* state_cache, const bool multithreaded)
+        : m_window(window)
+        , m_state_cache(state_cache)
+        , m_multithreaded(multithreaded)
+    {
+        if (!m_multithreaded)
+        {
+            return;
+        }
+
+        glfwMakeContextCurrent(nullptr);
+        StateCache_OpenGL::make_current(nullptr);
+        m_thread = std::thread(&RenderThread::thread_main, this);
+    }
+
+    RenderThread::~RenderThread()
+    {
+        if (!m_multithreaded)
+        {
+            return;
+        }
+
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [this] { return !m_frame_pending; });
+            m_exit = true;
+        }
+        m_condition.notify_all();
+        m_thread.join();
+
+        glfwMakeContextCurrent(m_window);
+        StateCache_OpenGL::make_current(m_state_cache);
+    }
+
+    void RenderThread::submit_frame()
+    {
+        if (!m_multithreaded)
+        {
+            PROFILE_SCOPE("execute commands");
+            m_command_lists[m_record_index].execute();
+            m_command_lists[m_record_index].clear();
+            return;
+        }
+
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [this] { return !m_frame_pending; });
+            m_execute_index = m_record_index;
+            m_record_index = 1 - m_record_index;
+            m_frame_pending = true;
+        }
+        m_condition.notify_all();
+    }
+
+    void RenderThread::flush()
+    {
+        if (!m_multithreaded)
+        {
+            return;
+        }
+
+        std::unique_lock lock(m_mutex);
+        m_condition.wait(lock, [this] { return !m_frame_pending; });
+    }
+
+    void RenderThread::thread_main()
+    {
+        glfwMakeContextCurrent(m_window);
+        StateCache_OpenGL::make_current(m_state_cache);
+        Profiler::set_thread_name("Render");
+
+        while (true)
+        {
+            size_t execute_index = 0;
+            {
+                std::unique_lock lock(m_mutex);
+                m_condition.wait(lock, [this] { return m_frame_pending || m_exit; });
+                if (m_exit)
+                {
+                    break;
+                }
+                execute_index = m_execute_index;
+            }
+
+            {
+                PROFILE_SCOPE("execute commands");
+                m_command_lists[execute_index].execute();
+                m_command_lists[execute_index].clear();
+            }
+
+            {
+                std::lock_guard lock(m_mutex);
+                m_frame_pending = false;
+            }
+            m_condition.notify_all();
+        }
+
+        glfwMakeContextCurrent(nullptr);
+        StateCache_OpenGL::make_current(nullptr);
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "RenderCommandList.hpp"
+
+#include <array>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+struct GLFWwindow;
+
+namespace GraphicsEngine {
+    class StateCache_OpenGL;
+
+    // Owns the window's GL context and executes the command lists recorded by the main
+    // thread. Lists are double-buffered: while the render thread submits frame N, the main
+    // thread records frame N + 1. In single-threaded mode submit_frame() executes the list
+    // in place, which keeps the same code path for debugging.
+    // The context and its state cache are current on the calling thread again once the
+    // RenderThread is destroyed.
+    class RenderThread
+    {
+    public:
+        // state_cache is made current wherever the context is; nullptr for windows without a GL context
+        RenderThread(GLFWwindow* window, StateCache_OpenGL* state_cache, const bool multithreaded);
+        ~RenderThread();
+
+        RenderThread(const RenderThread&) = delete;
+        RenderThread& operator=(const RenderThread&) = delete;
+
+        RenderCommandList& get_command_list() { return m_command_lists[m_record_index]; }
+
+        // Hands the recorded list over; blocks while the previous frame is still executing
+        void submit_frame();
+        // Blocks until every submitted frame has executed
+        void flush();
+
+        bool is_multithreaded() const { return m_multithreaded; }
+
+    private:
+        void thread_main();
+
+        GLFWwindow* m_window = nullptr;
+        StateCache_OpenGL* m_state_cache = nullptr;
+        bool m_multithreaded = false;
+
+        std::array<RenderCommandList, 2> m_command_lists;
+        size_t m_record_index = 0;
+        size_t m_execute_index = 0;
+
+        std::thread m_thread;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        bool m_frame_pending = false;
+        bool m_exit = false;
+    };
+}
@@ -0,0 +1,823 @@
+#define ENGINE_LOG_MODULE Rendering
+
+#include "Renderer_Software.hpp"
+#include "EngineCore/Rendering/RenderStats.hpp"
+#include "EngineCore/Rendering/VertexQuantization.hpp"
+#include "EngineCore/Jobs/JobSystem.hpp"
+#include "EngineCore/Profiling/Profiler.hpp"
+#include "EngineCore/Debug.hpp"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+// The AVX2 rasterizer is compiled for its own function only and picked at runtime, so the
+// rest of the engine keeps running on CPUs without it
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ENGINE_RASTERIZER_AVX2 1
+#define ENGINE_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(__AVX2__)
+#define ENGINE_RASTERIZER_AVX2 1
+#define ENGINE_TARGET_AVX2
+#include <immintrin.h>
+#endif
+
+namespace GraphicsEngine {
+    namespace {
+        using Triangle = Renderer_Software::Triangle;
+
+        constexpr int32_t subpixels = 16;
+        // Clipping lets triangles reach this many pixels past each side of the viewport, which keeps
+        // positions within 2^17 subpixels and edge functions over a tile within 32 bits
+        constexpr float guard_band = 4096.0f;
+        constexpr size_t chunk_triangles = 2048;
+        constexpr size_t max_pass_chunks = 64;
+        constexpr size_t planes_count = 6;
+
+        struct ClipVertex
+        {
+            glm::vec4 position;
+            glm::vec4 color;
+        };
+
+        // Inside is dot(plane, position) >= 0. Triangles outside one frustum plane are dropped; the
+        // others are only clipped against the guard band's planes (and near and far) they cross
+        struct ClipSpace
+        {
+            glm::vec4 frustum_planes[planes_count];
+            glm::vec4 guard_planes[planes_count];
+            float width;
+            float height;
+        };
+
+        struct TileTarget
+        {
+            uint32_t* color;
+            float* depth;
+            size_t stride;
+            int32_t min_x;
+            int32_t min_y;
+            int32_t max_x;
+            int32_t max_y;
+            bool depth_test;
+        };
+
+        // Edge function values for the first pixel of a rectangle, 8-aligned span_x, and per pixel steps
+        struct EdgeSetup
+        {
+            int32_t start[3];
+            int32_t step_x[3];
+            int32_t step_y[3];
+            int32_t span_x;
+            int32_t min_x;
+            int32_t min_y;
+            int32_t max_x;
+            int32_t max_y;
+        };
+
+        bool cpu_supports_avx2()
+        {
+#if defined(ENGINE_RASTERIZER_AVX2) && (defined(__GNUC__) || defined(__clang__))
+            return __builtin_cpu_supports("avx2");
+#elif defined(ENGINE_RASTERIZER_AVX2)
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        glm::vec4 decode_element(const BufferElement& element, const uint8_t* data)
+        {
+            glm::vec4 value(0.0f, 0.0f, 0.0f, 1.0f);
+            const size_t components_count = std::min<size_t>(element.components_count, 4);
+            switch (element.type)
+            {
+                case ShaderDataType::Float:
+                case ShaderDataType::Float2:
+                case ShaderDataType::Float3:
+                case ShaderDataType::Float4:
+                    std::memcpy(&value[0], data, components_count * sizeof(float));
+                    break;
+                case ShaderDataType::Int:
+                case ShaderDataType::Int2:
+                case ShaderDataType::Int3:
+                case ShaderDataType::Int4:
+                    for (size_t i = 0; i < components_count; ++i)
+                    {
+                        int32_t component;
+                        std::memcpy(&component, data + i * sizeof(component), sizeof(component));
+                        value[static_cast<glm::length_t>(i)] = static_cast<float>(component);
+                    }
+                    break;
+                case ShaderDataType::Half2:
+                case ShaderDataType::Half4:
+                    for (size_t i = 0; i < components_count; ++i)
+                    {
+                        uint16_t component;
+                        std::memcpy(&component, data + i * sizeof(component), sizeof(component));
+                        value[static_cast<glm::length_t>(i)] = half_to_float(component);
+                    }
+                    break;
+                case ShaderDataType::UByte4Norm:
+                    for (size_t i = 0; i < 4; ++i)
+                    {
+                        value[static_cast<glm::length_t>(i)] = unorm8_to_float(data[i]);
+                    }
+                    break;
+                case ShaderDataType::Short2Norm:
+                case ShaderDataType::Short4Norm:
+                    for (size_t i = 0; i < components_count; ++i)
+                    {
+                        int16_t component;
+                        std::memcpy(&component, data + i * sizeof(component), sizeof(component));
+                        value[static_cast<glm::length_t>(i)] = snorm16_to_float(component);
+                    }
+                    break;
+                case ShaderDataType::Int2_10_10_10_Rev:
+                {
+                    uint32_t packed;
+                    std::memcpy(&packed, data, sizeof(packed));
+                    unpack_snorm_2_10_10_10_rev(packed, &value[0]);
+                    break;
+                }
+                case ShaderDataType::Mat3:
+                case ShaderDataType::Mat4:
+                    break;
+            }
+            return value;
+        }
+
+        uint32_t fetch_index(const void* indices, const EIndexType type, const size_t i)
+        {
+            switch (type)
+            {
+                case EIndexType::UInt8:  return static_cast<const uint8_t*>(indices)[i];
+                case EIndexType::UInt16: return static_cast<const uint16_t*>(indices)[i];
+                case EIndexType::UInt32: return static_cast<const uint32_t*>(indices)[i];
+            }
+            return 0;
+        }
+
+        // Both rasterizers round like this: to nearest even, after clamping to [0, 1]
+        uint32_t pack_channel(const float value)
+        {
+            const float clamped = value > 0.0f ? value : 0.0f;
+            return static_cast<uint32_t>(std::nearbyint((clamped < 1.0f ? clamped : 1.0f) * 255.0f));
+        }
+
+        uint32_t pack_color(const glm::vec4& color)
+        {
+            return pack_channel(color.r) | pack_channel(color.g) << 8 | pack_channel(color.b) << 16 | pack_channel(color.a) << 24;
+        }
+
+        uint32_t get_outcode(const glm::vec4& position, const glm::vec4 (&planes)[planes_count])
+        {
+            uint32_t outcode = 0;
+            for (size_t i = 0; i < planes_count; ++i)
+            {
+                if (glm::dot(planes[i], position) < 0.0f)
+                {
+                    outcode |= 1u << i;
+                }
+            }
+            return outcode;
+        }
+
+        // Sutherland-Hodgman against one plane; returns the vertices written to destination
+        size_t clip_polygon(const ClipVertex* source, const size_t count, ClipVertex* destination, const glm::vec4& plane)
+        {
+            size_t written = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const ClipVertex& a = source[i];
+                const ClipVertex& b = source[(i + 1) % count];
+                const float distance_a = glm::dot(plane, a.position);
+                const float distance_b = glm::dot(plane, b.position);
+                if (distance_a >= 0.0f)
+                {
+                    destination[written++] = a;
+                }
+                if ((distance_a >= 0.0f) != (distance_b >= 0.0f))
+                {
+                    const float t = distance_a / (distance_a - distance_b);
+                    destination[written++] = { a.position + (b.position - a.position) * t, a.color + (b.color - a.color) * t };
+                }
+            }
+            return written;
+        }
+
+        void emit_triangle(const ClipVertex& vertex0, const ClipVertex& vertex1, const ClipVertex& vertex2, const ClipSpace& clip,
+                           std::vector<Triangle>& triangles)
+        {
+            const ClipVertex* vertices[3] = { &vertex0, &vertex1, &vertex2 };
+            int32_t x[3];
+            int32_t y[3];
+            float depth[3];
+            float inverse_w[3];
+            glm::vec4 color[3];
+            for (size_t i = 0; i < 3; ++i)
+            {
+                const glm::vec4& position = vertices[i]->position;
+                if (!(position.w > 0.0f))
+                {
+                    return;
+                }
+                inverse_w[i] = 1.0f / position.w;
+                const float screen_x = (position.x * inverse_w[i] * 0.5f + 0.5f) * clip.width;
+                const float screen_y = (0.5f - position.y * inverse_w[i] * 0.5f) * clip.height;
+                x[i] = static_cast<int32_t>(std::nearbyint(screen_x * static_cast<float>(subpixels)));
+                y[i] = static_cast<int32_t>(std::nearbyint(screen_y * static_cast<float>(subpixels)));
+                depth[i] = position.z * inverse_w[i] * 0.5f + 0.5f;
+                color[i] = vertices[i]->color * inverse_w[i];
+            }
+
+            int64_t area = static_cast<int64_t>(x[1] - x[0]) * (y[2] - y[0]) - static_cast<int64_t>(y[1] - y[0]) * (x[2] - x[0]);
+            if (area == 0)
+            {
+                return;
+            }
+            // Nothing is culled by facing: triangles are flipped so that inside means all edge functions >= 0
+            if (area < 0)
+            {
+                std::swap(x[1], x[2]);
+                std::swap(y[1], y[2]);
+                std::swap(depth[1], depth[2]);
+                std::swap(inverse_w[1], inverse_w[2]);
+                std::swap(color[1], color[2]);
+                area = -area;
+            }
+
+            // Pixels whose centers (16 * x + 8) lie within the bounds
+            Triangle triangle;
+            const int32_t half_pixel = subpixels / 2;
+            triangle.min_x = std::max<int32_t>(0, (std::min({ x[0], x[1], x[2] }) - half_pixel + subpixels - 1) >> 4);
+            triangle.min_y = std::max<int32_t>(0, (std::min({ y[0], y[1], y[2] }) - half_pixel + subpixels - 1) >> 4);
+            triangle.max_x = std::min<int32_t>(static_cast<int32_t>(clip.width), ((std::max({ x[0], x[1], x[2] }) - half_pixel) >> 4) + 1);
+            triangle.max_y = std::min<int32_t>(static_cast<int32_t>(clip.height), ((std::max({ y[0], y[1], y[2] }) - half_pixel) >> 4) + 1);
+            if (triangle.min_x >= triangle.max_x || triangle.min_y >= triangle.max_y)
+            {
+                return;
+            }
+
+            for (size_t i = 0; i < 3; ++i)
+            {
+                triangle.x[i] = x[i];
+                triangle.y[i] = y[i];
+            }
+            // Weight of vertex 1 is its edge function (opposite edge 2 -> 0) over the area; a pixel step moves 16 subpixels
+            const double pixel_area = static_cast<double>(area) / subpixels;
+            triangle.origin_x = static_cast<float>(x[0]) / subpixels;
+            triangle.origin_y = static_cast<float>(y[0]) / subpixels;
+            triangle.weight1_dx = static_cast<float>((y[2] - y[0]) / pixel_area);
+            triangle.weight1_dy = static_cast<float>((x[0] - x[2]) / pixel_area);
+            triangle.weight2_dx = static_cast<float>((y[0] - y[1]) / pixel_area);
+            triangle.weight2_dy = static_cast<float>((x[1] - x[0]) / pixel_area);
+            triangle.depth[0] = depth[0];
+            triangle.depth[1] = depth[1] - depth[0];
+            triangle.depth[2] = depth[2] - depth[0];
+            triangle.inverse_w[0] = inverse_w[0];
+            triangle.inverse_w[1] = inverse_w[1] - inverse_w[0];
+            triangle.inverse_w[2] = inverse_w[2] - inverse_w[0];
+            triangle.color[0] = color[0];
+            triangle.color[1] = color[1] - color[0];
+            triangle.color[2] = color[2] - color[0];
+            triangles.push_back(triangle);
+        }
+
+        void setup_triangle(const ClipVertex (&vertices)[3], const ClipSpace& clip, std::vector<Triangle>& triangles)
+        {
+            if ((get_outcode(vertices[0].position, clip.frustum_planes) & get_outcode(vertices[1].position, clip.frustum_planes)
+                 & get_outcode(vertices[2].position, clip.frustum_planes)) != 0)
+            {
+                return;
+            }
+            const uint32_t crossed = get_outcode(vertices[0].position, clip.guard_planes) | get_outcode(vertices[1].position, clip.guard_planes)
+                                   | get_outcode(vertices[2].position, clip.guard_planes);
+            if (crossed == 0)
+            {
+                emit_triangle(vertices[0], vertices[1], vertices[2], clip, triangles);
+                return;
+            }
+
+            // Each plane adds at most one vertex
+            ClipVertex polygons[2][3 + planes_count];
+            std::copy(std::begin(vertices), std::end(vertices), polygons[0]);
+            size_t count = 3;
+            size_t current = 0;
+            for (size_t plane = 0; plane < planes_count && count >= 3; ++plane)
+            {
+                if (crossed & (1u << plane))
+                {
+                    count = clip_polygon(polygons[current], count, polygons[1 - current], clip.guard_planes[plane]);
+                    current = 1 - current;
+                }
+            }
+            for (size_t i = 1; i + 1 < count; ++i)
+            {
+                emit_triangle(polygons[current][0], polygons[current][i], polygons[current][i + 1], clip, triangles);
+            }
+        }
+
+        // Top-left rule: pixel centers exactly on an edge belong to the triangle only on its top and left edges
+        // (y points down), so triangles sharing an edge never both cover a pixel
+        bool is_top_left(const int32_t a, const int32_t b)
+        {
+            return a > 0 || (a == 0 && b > 0);
+        }
+
+        // Clips the triangle's bounds to the tile. Edges that cover the whole rectangle get zero steps so
+        // they never fail, which also keeps the remaining values within 32 bits; false if an edge covers none of it
+        bool setup_edges(const Triangle& triangle, const TileTarget& target, EdgeSetup& edges)
+        {
+            edges.min_x = std::max(triangle.min_x, target.min_x);
+            edges.min_y = std::max(triangle.min_y, target.min_y);
+            edges.max_x = std::min(triangle.max_x, target.max_x);
+            edges.max_y = std::min(triangle.max_y, target.max_y);
+            if (edges.min_x >= edges.max_x || edges.min_y >= edges.max_y)
+            {
+                return false;
+            }
+            edges.span_x = edges.min_x & ~7;
+
+            for (size_t i = 0; i < 3; ++i)
+            {
+                const size_t from = (i + 1) % 3;
+                const size_t to = (i + 2) % 3;
+                const int32_t a = triangle.y[from] - triangle.y[to];
+                const int32_t b = triangle.x[to] - triangle.x[from];
+                const int64_t c = static_cast<int64_t>(triangle.x[from]) * triangle.y[to] - static_cast<int64_t>(triangle.y[from]) * triangle.x[to]
+                                + (is_top_left(a, b) ? 0 : -1);
+                auto evaluate = [a, b, c](const int32_t x, const int32_t y) {
+                    return static_cast<int64_t>(a) * (x * subpixels + subpixels / 2) + static_cast<int64_t>(b) * (y * subpixels + subpixels / 2) + c;
+                };
+                const int64_t corners[4] = { evaluate(edges.min_x, edges.min_y), evaluate(edges.max_x - 1, edges.min_y),
+                                             evaluate(edges.min_x, edges.max_y - 1), evaluate(edges.max_x - 1, edges.max_y - 1) };
+                if (*std::max_element(corners, corners + 4) < 0)
+                {
+                    return false;
+                }
+                if (*std::min_element(corners, corners + 4) >= 0)
+                {
+                    edges.start[i] = 0;
+                    edges.step_x[i] = 0;
+                    edges.step_y[i] = 0;
+                    continue;
+                }
+                edges.start[i] = static_cast<int32_t>(evaluate(edges.span_x, edges.min_y));
+                edges.step_x[i] = a * subpixels;
+                edges.step_y[i] = b * subpixels;
+            }
+            return true;
+        }
+
+        void rasterize_scalar(const Triangle& triangle, const TileTarget& target)
+        {
+            EdgeSetup edges;
+            if (!setup_edges(triangle, target, edges))
+            {
+                return;
+            }
+
+            int32_t row[3] = { edges.start[0], edges.start[1], edges.start[2] };
+            for (int32_t y = edges.min_y; y < edges.max_y; ++y)
+            {
+                const float dy = (static_cast<float>(y) + 0.5f) - triangle.origin_y;
+                uint32_t* color_row = target.color + static_cast<size_t>(y) * target.stride;
+                float* depth_row = target.depth + static_cast<size_t>(y) * target.stride;
+                for (int32_t x = edges.min_x; x < edges.max_x; ++x)
+                {
+                    const int32_t offset = x - edges.span_x;
+                    const int32_t e0 = row[0] + offset * edges.step_x[0];
+                    const int32_t e1 = row[1] + offset * edges.step_x[1];
+                    const int32_t e2 = row[2] + offset * edges.step_x[2];
+                    if ((e0 | e1 | e2) < 0)
+                    {
+                        continue;
+                    }
+
+                    const float dx = (static_cast<float>(x) + 0.5f) - triangle.origin_x;
+                    const float weight1 = triangle.weight1_dx * dx + triangle.weight1_dy * dy;
+                    const float weight2 = triangle.weight2_dx * dx + triangle.weight2_dy * dy;
+                    const float depth = (triangle.depth[0] + weight1 * triangle.depth[1]) + weight2 * triangle.depth[2];
+                    if (target.depth_test && !(depth < depth_row[x]))
+                    {
+                        continue;
+                    }
+                    const float inverse_w = (triangle.inverse_w[0] + weight1 * triangle.inverse_w[1]) + weight2 * triangle.inverse_w[2];
+                    const float w = 1.0f / inverse_w;
+                    glm::vec4 color;
+                    for (glm::length_t channel = 0; channel < 4; ++channel)
+                    {
+                        color[channel] = ((triangle.color[0][channel] + weight1 * triangle.color[1][channel]) + weight2 * triangle.color[2][channel]) * w;
+                    }
+                    color_row[x] = pack_color(color);
+                    if (target.depth_test)
+                    {
+                        depth_row[x] = depth;
+                    }
+                }
+                row[0] += edges.step_y[0];
+                row[1] += edges.step_y[1];
+                row[2] += edges.step_y[2];
+            }
+        }
+
+#ifdef ENGINE_RASTERIZER_AVX2
+        ENGINE_TARGET_AVX2 __m256i pack_channels_avx2(const __m256 value)
+        {
+            const __m256 clamped = _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+            return _mm256_cvtps_epi32(_mm256_mul_ps(clamped, _mm256_set1_ps(255.0f)));
+        }
+
+        ENGINE_TARGET_AVX2 __m256 interpolate_avx2(const float value, const float difference1, const float difference2, const __m256 weight1, const __m256 weight2)
+        {
+            return _mm256_add_ps(_mm256_add_ps(_mm256_set1_ps(value), _mm256_mul_ps(weight1, _mm256_set1_ps(difference1))),
+                                 _mm256_mul_ps(weight2, _mm256_set1_ps(difference2)));
+        }
+
+        // rasterize_scalar on 8 pixels of a row at once, with the same arithmetic
+        ENGINE_TARGET_AVX2 void rasterize_avx2(const Triangle& triangle, const TileTarget& target)
+        {
+            EdgeSetup edges;
+            if (!setup_edges(triangle, target, edges))
+            {
+                return;
+            }
+
+            const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            __m256i row[3];
+            __m256i step_span[3];
+            __m256i step_row[3];
+            for (size_t i = 0; i < 3; ++i)
+            {
+                row[i] = _mm256_add_epi32(_mm256_set1_epi32(edges.start[i]), _mm256_mullo_epi32(lanes, _mm256_set1_epi32(edges.step_x[i])));
+                step_span[i] = _mm256_set1_epi32(edges.step_x[i] * 8);
+                step_row[i] = _mm256_set1_epi32(edges.step_y[i]);
+            }
+            const __m256i min_x = _mm256_set1_epi32(edges.min_x - 1);
+            const __m256i max_x = _mm256_set1_epi32(edges.max_x);
+            const __m256 half = _mm256_set1_ps(0.5f);
+            const __m256 origin_x = _mm256_set1_ps(triangle.origin_x);
+
+            for (int32_t y = edges.min_y; y < edges.max_y; ++y)
+            {
+                const __m256 dy = _mm256_set1_ps((static_cast<float>(y) + 0.5f) - triangle.origin_y);
+                const __m256 weight1_y = _mm256_mul_ps(_mm256_set1_ps(triangle.weight1_dy), dy);
+                const __m256 weight2_y = _mm256_mul_ps(_mm256_set1_ps(triangle.weight2_dy), dy);
+                uint32_t* color_row = target.color + static_cast<size_t>(y) * target.stride;
+                float* depth_row = target.depth + static_cast<size_t>(y) * target.stride;
+                __m256i e0 = row[0];
+                __m256i e1 = row[1];
+                __m256i e2 = row[2];
+                for (int32_t x = edges.span_x; x < edges.max_x; x += 8)
+                {
+                    const __m256i lane_x = _mm256_add_epi32(_mm256_set1_epi32(x), lanes);
+                    const __m256i inside = _mm256_cmpgt_epi32(_mm256_or_si256(e0, _mm256_or_si256(e1, e2)), _mm256_set1_epi32(-1));
+                    const __m256i in_bounds = _mm256_and_si256(_mm256_cmpgt_epi32(lane_x, min_x), _mm256_cmpgt_epi32(max_x, lane_x));
+                    __m256i mask = _mm256_and_si256(inside, in_bounds);
+                    e0 = _mm256_add_epi32(e0, step_span[0]);
+                    e1 = _mm256_add_epi32(e1, step_span[1]);
+                    e2 = _mm256_add_epi32(e2, step_span[2]);
+                    if (_mm256_testz_si256(mask, mask))
+                    {
+                        continue;
+                    }
+
+                    const __m256 dx = _mm256_sub_ps(_mm256_add_ps(_mm256_cvtepi32_ps(lane_x), half), origin_x);
+                    const __m256 weight1 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(triangle.weight1_dx), dx), weight1_y);
+                    const __m256 weight2 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(triangle.weight2_dx), dx), weight2_y);
+                    const __m256 depth = interpolate_avx2(triangle.depth[0], triangle.depth[1], triangle.depth[2], weight1, weight2);
+                    if (target.depth_test)
+                    {
+                        const __m256 passed = _mm256_cmp_ps(depth, _mm256_loadu_ps(depth_row + x), _CMP_LT_OQ);
+                        mask = _mm256_and_si256(mask, _mm256_castps_si256(passed));
+                        if (_mm256_testz_si256(mask, mask))
+                        {
+                            continue;
+                        }
+                    }
+                    const __m256 inverse_w = interpolate_avx2(triangle.inverse_w[0], triangle.inverse_w[1], triangle.inverse_w[2], weight1, weight2);
+                    const __m256 w = _mm256_div_ps(_mm256_set1_ps(1.0f), inverse_w);
+                    __m256i packed = _mm256_setzero_si256();
+                    for (int channel = 0; channel < 4; ++channel)
+                    {
+                        const __m256 value = _mm256_mul_ps(interpolate_avx2(triangle.color[0][channel], triangle.color[1][channel],
+                                                                            triangle.color[2][channel], weight1, weight2), w);
+                        packed = _mm256_or_si256(packed, _mm256_sllv_epi32(pack_channels_avx2(value), _mm256_set1_epi32(channel * 8)));
+                    }
+                    _mm256_maskstore_epi32(reinterpret_cast<int*>(color_row + x), mask, packed);
+                    if (target.depth_test)
+                    {
+                        _mm256_maskstore_ps(depth_row + x, mask, depth);
+                    }
+                }
+                row[0] = _mm256_add_epi32(row[0], step_row[0]);
+                row[1] = _mm256_add_epi32(row[1], step_row[1]);
+                row[2] = _mm256_add_epi32(row[2], step_row[2]);
+            }
+        }
+#endif
+    }
+
+    Image SoftwareFramebuffer::to_image() const
+    {
+        Image image(m_width, m_height);
+        for (unsigned int y = 0; y < m_height; ++y)
+        {
+            for (unsigned int x = 0; x < m_width; ++x)
+            {
+                const uint32_t pixel = get_pixel(x, y);
+                uint8_t* destination = image.get_pixel(x, y);
+                destination[0] = static_cast<uint8_t>(pixel);
+                destination[1] = static_cast<uint8_t>(pixel >> 8);
+                destination[2] = static_cast<uint8_t>(pixel >> 16);
+                destination[3] = static_cast<uint8_t>(pixel >> 24);
+            }
+        }
+        return image;
+    }
+
+    Renderer_Software::Renderer_Software(const unsigned int width, const unsigned int height)
+        : m_simd(cpu_supports_avx2())
+    {
+        set_viewport(width, height);
+        LOG_INFO("Software renderer: {}x{}, {}", m_framebuffer.m_width, m_framebuffer.m_height, m_simd ? "AVX2" : "scalar");
+    }
+
+    void Renderer_Software::set_simd(const bool enabled)
+    {
+        m_simd = enabled && cpu_supports_avx2();
+    }
+
+    void Renderer_Software::set_viewport(const unsigned int width, const unsigned int height)
+    {
+        if (width > max_size || height > max_size)
+        {
+            LOG_ERROR("Renderer_Software: {}x{} is larger than {}x{}, clamping", width, height, max_size, max_size);
+        }
+        m_framebuffer.m_width = std::clamp(width, 1u, max_size);
+        m_framebuffer.m_height = std::clamp(height, 1u, max_size);
+        m_tiles_x = (m_framebuffer.m_width + tile_size - 1) / tile_size;
+        m_tiles_y = (m_framebuffer.m_height + tile_size - 1) / tile_size;
+        m_framebuffer.m_stride = static_cast<size_t>(m_tiles_x) * tile_size;
+        const size_t pixels_count = m_framebuffer.m_stride * m_tiles_y * tile_size;
+        m_framebuffer.m_color.assign(pixels_count, 0);
+        m_framebuffer.m_depth.assign(pixels_count, 1.0f);
+    }
+
+    void Renderer_Software::clear(const glm::vec4& color)
+    {
+        PROFILE_SCOPE("Renderer_Software::clear");
+        std::fill(m_framebuffer.m_color.begin(), m_framebuffer.m_color.end(), pack_color(color));
+        std::fill(m_framebuffer.m_depth.begin(), m_framebuffer.m_depth.end(), 1.0f);
+    }
+
+    void Renderer_Software::draw(const glm::mat4& view_projection, const MeshView& mesh, std::span<const MeshDraw> draws)
+    {
+        PROFILE_SCOPE("Renderer_Software::draw");
+        if (!mesh.vertices || !mesh.indices || !mesh.layout || mesh.layout->get_elements().empty())
+        {
+            LOG_ERROR("Renderer_Software: the mesh needs vertices, indices and a layout");
+            return;
+        }
+        m_instances.clear();
+        for (const MeshDraw& draw : draws)
+        {
+            if (draw.first_index + draw.indices_count > mesh.indices_count)
+            {
+                LOG_ERROR("Renderer_Software: indices {} to {} are outside the mesh's {}", draw.first_index, draw.first_index + draw.indices_count,
+                          mesh.indices_count);
+                continue;
+            }
+            if (draw.model_matrices.empty())
+            {
+                continue;
+            }
+            for (const glm::mat4& model_matrix : draw.model_matrices)
+            {
+                m_instances.push_back({ view_projection * model_matrix, draw.first_index, draw.indices_count / 3 });
+            }
+            ++RenderStats::draw_calls;
+            RenderStats::triangles += draw.indices_count / 3 * draw.model_matrices.size();
+        }
+        if (m_instances.empty())
+        {
+            return;
+        }
+        if (mesh.vertices != m_decoded_vertices || mesh.vertices_count != m_decoded_vertices_count || mesh.layout != m_decoded_layout)
+        {
+            decode_vertices(mesh);
+            m_decoded_vertices = mesh.vertices;
+            m_decoded_vertices_count = mesh.vertices_count;
+            m_decoded_layout = mesh.layout;
+        }
+
+        // Passes of at most max_pass_chunks chunks bound the memory binned triangles take
+        m_chunks.clear();
+        Chunk chunk = { 0, 0, 0 };
+        for (size_t instance = 0; instance < m_instances.size(); ++instance)
+        {
+            const size_t triangles_count = m_instances[instance].triangles_count;
+            for (size_t triangle = 0; triangle < triangles_count;)
+            {
+                if (chunk.triangles_count == 0)
+                {
+                    chunk = { instance, triangle, 0 };
+                }
+                const size_t taken = std::min(chunk_triangles - chunk.triangles_count, triangles_count - triangle);
+                chunk.triangles_count += taken;
+                triangle += taken;
+                if (chunk.triangles_count == chunk_triangles)
+                {
+                    m_chunks.push_back(chunk);
+                    chunk.triangles_count = 0;
+                    if (m_chunks.size() == max_pass_chunks)
+                    {
+                        run_pass(mesh);
+                        m_chunks.clear();
+                    }
+                }
+            }
+        }
+        if (chunk.triangles_count > 0)
+        {
+            m_chunks.push_back(chunk);
+        }
+        if (!m_chunks.empty())
+        {
+            run_pass(mesh);
+        }
+    }
+
+    void Renderer_Software::decode_vertices(const MeshView& mesh)
+    {
+        PROFILE_SCOPE("decode vertices");
+        const std::vector<BufferElement>& elements = mesh.layout->get_elements();
+        const size_t stride = mesh.layout->get_stride();
+        const uint8_t* vertices = static_cast<const uint8_t*>(mesh.vertices);
+        m_positions.resize(mesh.vertices_count);
+        m_colors.resize(mesh.vertices_count);
+        auto decode = [&](const size_t begin, const size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const uint8_t* vertex = vertices + i * stride;
+                m_positions[i] = glm::vec3(decode_element(elements[0], vertex + elements[0].offset));
+                m_colors[i] = elements.size() > 1 ? decode_element(elements[1], vertex + elements[1].offset) : glm::vec4(1.0f);
+            }
+        };
+        if (m_job_system)
+        {
+            m_job_system->parallel_for(mesh.vertices_count, decode, 4096);
+        }
+        else
+        {
+            decode(0, mesh.vertices_count);
+        }
+    }
+
+    void Renderer_Software::run_pass(const MeshView& mesh)
+    {
+        if (m_chunk_bins.size() < m_chunks.size())
+        {
+            m_chunk_bins.resize(m_chunks.size());
+        }
+
+        auto setup = [this, &mesh](const size_t begin, const size_t end) {
+            PROFILE_SCOPE("software setup chunk");
+            for (size_t i = begin; i < end; ++i)
+            {
+                setup_chunk(mesh, m_chunks[i], m_chunk_bins[i]);
+            }
+        };
+        const size_t tiles_count = static_cast<size_t>(m_tiles_x) * m_tiles_y;
+        const size_t chunks_count = m_chunks.size();
+        auto rasterize = [this, chunks_count](const size_t begin, const size_t end) {
+            PROFILE_SCOPE("software rasterize tiles");
+            for (size_t tile = begin; tile < end; ++tile)
+            {
+                rasterize_tile(tile, chunks_count);
+            }
+        };
+        if (m_job_system)
+        {
+            m_job_system->parallel_for(chunks_count, setup, 1);
+            m_job_system->parallel_for(tiles_count, rasterize, 1);
+        }
+        else
+        {
+            setup(0, chunks_count);
+            rasterize(0, tiles_count);
+        }
+    }
+
+    void Renderer_Software::setup_chunk(const MeshView& mesh, const Chunk& chunk, ChunkBins& bins) const
+    {
+        const float width = static_cast<float>(m_framebuffer.m_width);
+        const float height = static_cast<float>(m_framebuffer.m_height);
+        const float guard_x = 1.0f + 2.0f * guard_band / width;
+        const float guard_y = 1.0f + 2.0f * guard_band / height;
+        const ClipSpace clip = {
+            { { 1, 0, 0, 1 }, { -1, 0, 0, 1 }, { 0, 1, 0, 1 }, { 0, -1, 0, 1 }, { 0, 0, 1, 1 }, { 0, 0, -1, 1 } },
+            { { 1, 0, 0, guard_x }, { -1, 0, 0, guard_x }, { 0, 1, 0, guard_y }, { 0, -1, 0, guard_y }, { 0, 0, 1, 1 }, { 0, 0, -1, 1 } },
+            width,
+            height
+        };
+
+        bins.triangles.clear();
+        size_t instance = chunk.instance;
+        size_t triangle = chunk.first_triangle;
+        for (size_t remaining = chunk.triangles_count; remaining > 0;)
+        {
+            const Instance& current = m_instances[instance];
+            if (triangle >= current.triangles_count)
+            {
+                ++instance;
+                triangle = 0;
+                continue;
+            }
+
+            ClipVertex vertices[3];
+            bool valid = true;
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                const uint32_t index = fetch_index(mesh.indices, mesh.index_type, current.first_index + triangle * 3 + corner);
+                if (index >= mesh.vertices_count)
+                {
+                    valid = false;
+                    break;
+                }
+                vertices[corner] = { current.model_view_projection * glm::vec4(m_positions[index], 1.0f), m_colors[index] };
+            }
+            if (valid)
+            {
+                setup_triangle(vertices, clip, bins.triangles);
+            }
+            ++triangle;
+            --remaining;
+        }
+
+        // Counting sort of the triangles into the tiles their bounds overlap, keeping their order
+        const size_t tiles_count = static_cast<size_t>(m_tiles_x) * m_tiles_y;
+        bins.tile_offsets.assign(tiles_count + 1, 0);
+        for (const Triangle& binned : bins.triangles)
+        {
+            for (int32_t tile_y = binned.min_y / tile_size; tile_y <= (binned.max_y - 1) / static_cast<int32_t>(tile_size); ++tile_y)
+            {
+                for (int32_t tile_x = binned.min_x / tile_size; tile_x <= (binned.max_x - 1) / static_cast<int32_t>(tile_size); ++tile_x)
+                {
+                    ++bins.tile_offsets[static_cast<size_t>(tile_y) * m_tiles_x + tile_x + 1];
+                }
+            }
+        }
+        for (size_t tile = 0; tile < tiles_count; ++tile)
+        {
+            bins.tile_offsets[tile + 1] += bins.tile_offsets[tile];
+        }
+        bins.tile_triangles.resize(bins.tile_offsets[tiles_count]);
+        bins.tile_cursors.assign(bins.tile_offsets.begin(), bins.tile_offsets.end() - 1);
+        for (uint32_t i = 0; i < bins.triangles.size(); ++i)
+        {
+            const Triangle& binned = bins.triangles[i];
+            for (int32_t tile_y = binned.min_y / tile_size; tile_y <= (binned.max_y - 1) / static_cast<int32_t>(tile_size); ++tile_y)
+            {
+                for (int32_t tile_x = binned.min_x / tile_size; tile_x <= (binned.max_x - 1) / static_cast<int32_t>(tile_size); ++tile_x)
+                {
+                    bins.tile_triangles[bins.tile_cursors[static_cast<size_t>(tile_y) * m_tiles_x + tile_x]++] = i;
+                }
+            }
+        }
+    }
+
+    void Renderer_Software::rasterize_tile(const size_t tile, const size_t chunks_count)
+    {
+        const int32_t tile_x = static_cast<int32_t>(tile % m_tiles_x) * tile_size;
+        const int32_t tile_y = static_cast<int32_t>(tile / m_tiles_x) * tile_size;
+        const TileTarget target = {
+            m_framebuffer.m_color.data(),
+            m_framebuffer.m_depth.data(),
+            m_framebuffer.m_stride,
+            tile_x,
+            tile_y,
+            std::min<int32_t>(tile_x + tile_size, static_cast<int32_t>(m_framebuffer.m_width)),
+            std::min<int32_t>(tile_y + tile_size, static_cast<int32_t>(m_framebuffer.m_height)),
+            m_depth_test
+        };
+#ifdef ENGINE_RASTERIZER_AVX2
+        void (*const rasterize)(const Triangle&, const TileTarget&) = m_simd ? rasterize_avx2 : rasterize_scalar;
+#else
+        void (*const rasterize)(const Triangle&, const TileTarget&) = rasterize_scalar;
+#endif
+        for (size_t chunk = 0; chunk < chunks_count; ++chunk)
+        {
+            const ChunkBins& bins = m_chunk_bins[chunk];
+            for (uint32_t i = bins.tile_offsets[tile]; i < bins.tile_offsets[tile + 1]; ++i)
+            {
+                rasterize(bins.triangles[bins.tile_triangles[i]], target);
+            }
+        }
+    }
+}
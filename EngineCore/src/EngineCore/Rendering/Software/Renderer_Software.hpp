@@ -0,0 +1,139 @@
+#pragma once
+
+#include "EngineCore/Rendering/RenderBackend.hpp"
+#include "EngineCore/Rendering/Image.hpp"
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace GraphicsEngine {
+    class JobSystem;
+
+    // Color and depth rendered by Renderer_Software, top row first. Rows are padded to whole tiles.
+    class SoftwareFramebuffer
+    {
+    public:
+        unsigned int get_width() const { return m_width; }
+        unsigned int get_height() const { return m_height; }
+        // RGBA8 with red in the lowest byte
+        uint32_t get_pixel(const unsigned int x, const unsigned int y) const { return m_color[static_cast<size_t>(y) * m_stride + x]; }
+        // Window-space depth in [0, 1], 1 where nothing was drawn
+        float get_depth(const unsigned int x, const unsigned int y) const { return m_depth[static_cast<size_t>(y) * m_stride + x]; }
+        Image to_image() const;
+
+    private:
+        friend class Renderer_Software;
+
+        unsigned int m_width = 0;
+        unsigned int m_height = 0;
+        size_t m_stride = 0;
+        std::vector<uint32_t> m_color;
+        std::vector<float> m_depth;
+    };
+
+    // Rasterizes on the CPU, for machines without a GPU and for deterministic images.
+    // Triangles are set up and binned into 64x64 pixel tiles in chunks, then every tile is
+    // rasterized on its own, so both stages spread over the job system's threads without
+    // sharing pixels. Tiles draw the triangles in submission order, so the image does not
+    // depend on the threads count. Coverage uses exact fixed-point edge functions with 4
+    // subpixel bits and a top-left fill rule; 8 pixels are tested and shaded at once with AVX2
+    // where the CPU supports it, and the scalar path computes the same image bit for bit.
+    // Colors are interpolated perspective-correctly and depth is tested with less-than.
+    class Renderer_Software final : public RenderBackend
+    {
+    public:
+        static constexpr unsigned int tile_size = 64;
+        static constexpr unsigned int max_size = 4096;
+
+        Renderer_Software(const unsigned int width, const unsigned int height);
+
+        // Setup and rasterization run on this job system's threads; nullptr runs them serially
+        void set_job_system(JobSystem* job_system) { m_job_system = job_system; }
+        void set_depth_test(const bool enabled) { m_depth_test = enabled; }
+        // Disabling SIMD uses the scalar path even where AVX2 is available
+        void set_simd(const bool enabled);
+        bool is_simd_enabled() const { return m_simd; }
+        // Vertices are decoded again only when a mesh's vertices pointer, count or layout changes,
+        // so call this after changing a mesh's vertices in place
+        void invalidate_vertices() { m_decoded_vertices = nullptr; }
+
+        void set_viewport(const unsigned int width, const unsigned int height) override;
+        void clear(const glm::vec4& color) override;
+        void draw(const glm::mat4& view_projection, const MeshView& mesh, std::span<const MeshDraw> draws) override;
+
+        const SoftwareFramebuffer& get_framebuffer() const { return m_framebuffer; }
+
+        // Triangles in screen space: 28.4 fixed-point positions and attribute planes
+        struct Triangle
+        {
+            int32_t x[3];
+            int32_t y[3];
+            // Pixels whose centers may be covered, clamped to the viewport; max is exclusive
+            int32_t min_x;
+            int32_t min_y;
+            int32_t max_x;
+            int32_t max_y;
+            // Barycentric weights of vertices 1 and 2 change by these per pixel, from 0 at vertex 0
+            float origin_x;
+            float origin_y;
+            float weight1_dx;
+            float weight1_dy;
+            float weight2_dx;
+            float weight2_dy;
+            // Value at vertex 0 and differences to vertices 1 and 2: depth, 1 / w and color / w
+            float depth[3];
+            float inverse_w[3];
+            glm::vec4 color[3];
+        };
+
+    private:
+        struct Instance
+        {
+            glm::mat4 model_view_projection;
+            size_t first_index;
+            size_t triangles_count;
+        };
+
+        // A run of consecutive triangles over consecutive instances, set up and binned by one job
+        struct Chunk
+        {
+            size_t instance;
+            size_t first_triangle;
+            size_t triangles_count;
+        };
+
+        struct ChunkBins
+        {
+            std::vector<Triangle> triangles;
+            // The triangles overlapping tile t are tile_triangles[tile_offsets[t]] up to tile_triangles[tile_offsets[t + 1]]
+            std::vector<uint32_t> tile_offsets;
+            std::vector<uint32_t> tile_triangles;
+            std::vector<uint32_t> tile_cursors;
+        };
+
+        void decode_vertices(const MeshView& mesh);
+        void run_pass(const MeshView& mesh);
+        void setup_chunk(const MeshView& mesh, const Chunk& chunk, ChunkBins& bins) const;
+        void rasterize_tile(const size_t tile, const size_t chunks_count);
+
+        SoftwareFramebuffer m_framebuffer;
+        unsigned int m_tiles_x = 0;
+        unsigned int m_tiles_y = 0;
+        JobSystem* m_job_system = nullptr;
+        bool m_depth_test = true;
+        bool m_simd = false;
+
+        const void* m_decoded_vertices = nullptr;
+        size_t m_decoded_vertices_count = 0;
+        const BufferLayout* m_decoded_layout = nullptr;
+        std::vector<glm::vec3> m_positions;
+        std::vector<glm::vec4> m_colors;
+        std::vector<Instance> m_instances;
+        std::vector<Chunk> m_chunks;
+        std::vector<ChunkBins> m_chunk_bins;
+    };
+}
@@ -0,0 +1,224 @@
+#define ENGINE_LOG_MODULE Rendering
+
+#include "EngineCore/SoftwareRendererCheck.hpp"
+#include "Renderer_Software.hpp"
+#include "EngineCore/Jobs/JobSystem.hpp"
+#include "EngineCore/Debug.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <bit>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace GraphicsEngine {
+    namespace {
+        struct CheckVertex
+        {
+            glm::vec3 position;
+            glm::vec4 color;
+        };
+
+        const BufferLayout check_layout = {
+            ShaderDataType::Float3,
+            ShaderDataType::Float4
+        };
+
+        uint64_t hash_framebuffer(const SoftwareFramebuffer& framebuffer)
+        {
+            uint64_t hash = 14695981039346656037ull;
+            auto add = [&hash](const uint32_t value) {
+                for (unsigned int shift = 0; shift < 32; shift += 8)
+                {
+                    hash = (hash ^ ((value >> shift) & 0xFF)) * 1099511628211ull;
+                }
+            };
+            for (unsigned int y = 0; y < framebuffer.get_height(); ++y)
+            {
+                for (unsigned int x = 0; x < framebuffer.get_width(); ++x)
+                {
+                    add(framebuffer.get_pixel(x, y));
+                    add(std::bit_cast<uint32_t>(framebuffer.get_depth(x, y)));
+                }
+            }
+            return hash;
+        }
+
+        // Grid points past the viewport's edges, so clipped triangles cover the border pixels
+        size_t count_coverage_errors(const bool simd, const bool snap_to_pixel_centers, std::mt19937& random)
+        {
+            constexpr unsigned int width = 97;
+            constexpr unsigned int height = 75;
+            constexpr uint32_t cells = 9;
+            std::uniform_real_distribution<float> jitter(-0.08f, 0.08f);
+            std::vector<CheckVertex> vertices;
+            for (uint32_t row = 0; row <= cells; ++row)
+            {
+                for (uint32_t column = 0; column <= cells; ++column)
+                {
+                    float x = -1.3f + 2.6f * static_cast<float>(column) / cells;
+                    float y = -1.3f + 2.6f * static_cast<float>(row) / cells;
+                    if (snap_to_pixel_centers)
+                    {
+                        x = (std::round((x * 0.5f + 0.5f) * width - 0.5f) + 0.5f) / width * 2.0f - 1.0f;
+                        y = (std::round((y * 0.5f + 0.5f) * height - 0.5f) + 0.5f) / height * 2.0f - 1.0f;
+                    }
+                    else if (row > 0 && row < cells && column > 0 && column < cells)
+                    {
+                        x += jitter(random);
+                        y += jitter(random);
+                    }
+                    vertices.push_back({ glm::vec3(x, y, 0.0f), glm::vec4(1.0f) });
+                }
+            }
+            // Alternating diagonals, so edges run both ways
+            std::vector<uint32_t> indices;
+            for (uint32_t row = 0; row < cells; ++row)
+            {
+                for (uint32_t column = 0; column < cells; ++column)
+                {
+                    const uint32_t corner = row * (cells + 1) + column;
+                    const uint32_t right = corner + 1;
+                    const uint32_t up = corner + cells + 1;
+                    const uint32_t up_right = up + 1;
+                    if ((row + column) % 2 == 0)
+                    {
+                        indices.insert(indices.end(), { corner, right, up, right, up_right, up });
+                    }
+                    else
+                    {
+                        indices.insert(indices.end(), { corner, right, up_right, corner, up_right, up });
+                    }
+                }
+            }
+
+            Renderer_Software renderer(width, height);
+            renderer.set_simd(simd);
+            renderer.set_depth_test(false);
+            const MeshView mesh = { vertices.data(), vertices.size(), &check_layout, indices.data(), indices.size(), EIndexType::UInt32 };
+            const glm::mat4 model_matrix(1.0f);
+            std::vector<unsigned int> coverage(static_cast<size_t>(width) * height, 0);
+            for (size_t first_index = 0; first_index < indices.size(); first_index += 3)
+            {
+                const MeshDraw draw = { first_index, 3, { &model_matrix, 1 } };
+                renderer.clear(glm::vec4(0.0f));
+                renderer.draw(glm::mat4(1.0f), mesh, { &draw, 1 });
+                for (unsigned int y = 0; y < height; ++y)
+                {
+                    for (unsigned int x = 0; x < width; ++x)
+                    {
+                        coverage[static_cast<size_t>(y) * width + x] += renderer.get_framebuffer().get_pixel(x, y) != 0;
+                    }
+                }
+            }
+
+            size_t errors = 0;
+            for (const unsigned int count : coverage)
+            {
+                errors += count != 1;
+            }
+            return errors;
+        }
+
+        // Enough instances of random triangles for several setup passes; mostly small ones, and a
+        // few large ones that cross the near plane and the viewport's edges
+        struct CheckScene
+        {
+            std::vector<CheckVertex> vertices;
+            std::vector<uint16_t> indices;
+            std::vector<glm::mat4> model_matrices;
+            glm::mat4 view_projection;
+        };
+
+        CheckScene create_check_scene(std::mt19937& random)
+        {
+            CheckScene scene;
+            std::uniform_real_distribution<float> coordinate(-3.0f, 3.0f);
+            std::uniform_real_distribution<float> offset(-0.2f, 0.2f);
+            std::uniform_real_distribution<float> channel(0.0f, 1.0f);
+            for (uint16_t triangle = 0; triangle < 1000; ++triangle)
+            {
+                const glm::vec3 center(coordinate(random), coordinate(random), coordinate(random));
+                const float size = triangle % 50 == 0 ? 10.0f : 1.0f;
+                for (uint16_t corner = 0; corner < 3; ++corner)
+                {
+                    scene.vertices.push_back({ center + size * glm::vec3(offset(random), offset(random), offset(random)),
+                                               glm::vec4(channel(random), channel(random), channel(random), 1.0f) });
+                    scene.indices.push_back(static_cast<uint16_t>(triangle * 3 + corner));
+                }
+            }
+            for (size_t i = 0; i < 150; ++i)
+            {
+                scene.model_matrices.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(coordinate(random), coordinate(random), coordinate(random))));
+            }
+            scene.view_projection = glm::perspective(1.2f, 4.0f / 3.0f, 0.5f, 30.0f) *
+                                    glm::lookAt(glm::vec3(0.0f, 0.0f, 4.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            return scene;
+        }
+
+        // The size isn't a multiple of the tile size, so partial tiles are covered too
+        uint64_t render_check_scene(const CheckScene& scene, const bool simd, JobSystem* job_system)
+        {
+            Renderer_Software renderer(333, 250);
+            renderer.set_simd(simd);
+            renderer.set_job_system(job_system);
+            renderer.clear(glm::vec4(0.1f, 0.2f, 0.3f, 1.0f));
+            const MeshView mesh = { scene.vertices.data(), scene.vertices.size(), &check_layout, scene.indices.data(), scene.indices.size(), EIndexType::UInt16 };
+            const MeshDraw draw = { 0, scene.indices.size(), scene.model_matrices };
+            renderer.draw(scene.view_projection, mesh, { &draw, 1 });
+            return hash_framebuffer(renderer.get_framebuffer());
+        }
+    }
+
+    bool check_software_renderer(SoftwareRendererCheckStats* stats)
+    {
+        SoftwareRendererCheckStats result;
+        std::mt19937 random(7);
+        {
+            Renderer_Software renderer(1, 1);
+            renderer.set_simd(true);
+            result.simd_available = renderer.is_simd_enabled();
+        }
+
+        for (const bool simd : { false, true })
+        {
+            for (const bool snap_to_pixel_centers : { false, true })
+            {
+                const size_t errors = count_coverage_errors(simd, snap_to_pixel_centers, random);
+                if (errors > 0)
+                {
+                    LOG_ERROR("Software renderer check: {} pixels of the {} grid are not covered exactly once with SIMD {}", errors,
+                              snap_to_pixel_centers ? "snapped" : "jittered", simd ? "on" : "off");
+                }
+                result.coverage_errors += errors;
+            }
+        }
+
+        const CheckScene scene = create_check_scene(random);
+        result.reference_hash = render_check_scene(scene, false, nullptr);
+        for (const unsigned int workers_count : { 0u, 1u, 3u, 7u })
+        {
+            // Serially without a job system, then with this many worker threads
+            std::unique_ptr<JobSystem> job_system = workers_count > 0 ? std::make_unique<JobSystem>(workers_count) : nullptr;
+            for (const bool simd : { false, true })
+            {
+                const uint64_t hash = render_check_scene(scene, simd, job_system.get());
+                ++result.configurations;
+                if (hash != result.reference_hash)
+                {
+                    LOG_ERROR("Software renderer check: the image with SIMD {} and {} workers hashes to {:016x} instead of {:016x}", simd ? "on" : "off",
+                              workers_count, hash, result.reference_hash);
+                    ++result.mismatches;
+                }
+            }
+        }
+
+        if (stats)
+        {
+            *stats = result;
+        }
+        return result.coverage_errors == 0 && result.mismatches == 0;
+    }
+}
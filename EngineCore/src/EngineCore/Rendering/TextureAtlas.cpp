@@ -0,0 +1,135 @@
+#define ENGINE_LOG_MODULE Rendering
+
+#include "TextureAtlas.hpp"
+#include "RectPacker.hpp"
+#include "EngineCore/Debug.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+namespace GraphicsEngine {
+    namespace {
+        uint32_t align_to_block(const uint32_t value)
+        {
+            return (value + 3) & ~3u;
+        }
+    }
+
+    TextureAtlas::TextureAtlas(const uint32_t page_size, const uint32_t padding)
+        : m_page_size(align_to_block(page_size))
+        , m_padding(align_to_block(padding))
+    {
+    }
+
+    uint32_t TextureAtlas::add_image(Image image)
+    {
+        m_images.push_back(std::move(image));
+        m_regions.emplace_back();
+        return static_cast<uint32_t>(m_images.size() - 1);
+    }
+
+    bool TextureAtlas::build()
+    {
+        m_pages.clear();
+        m_packed_area = 0;
+
+        std::vector<uint32_t> order(m_images.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [this](const uint32_t a, const uint32_t b) {
+            return m_images[a].height > m_images[b].height;
+        });
+
+        // Opaque atlases keep their unused space opaque too, so they compress to BC1
+        const bool opaque = std::all_of(m_images.begin(), m_images.end(), [](const Image& image) { return image.is_opaque(); });
+        std::vector<RectPacker> packers;
+        const float page_size = static_cast<float>(m_page_size);
+        for (const uint32_t index : order)
+        {
+            const Image& image = m_images[index];
+            const uint32_t slot_width = align_to_block(image.width) + 2 * m_padding;
+            const uint32_t slot_height = align_to_block(image.height) + 2 * m_padding;
+            if (image.is_empty() || slot_width > m_page_size || slot_height > m_page_size)
+            {
+                LOG_ERROR("TextureAtlas: a {}x{} image does not fit on a {} page with {} pixels of padding", image.width, image.height, m_page_size, m_padding);
+                m_pages.clear();
+                return false;
+            }
+
+            uint32_t x = 0;
+            uint32_t y = 0;
+            size_t page = 0;
+            while (page < packers.size() && !packers[page].pack(slot_width, slot_height, x, y))
+            {
+                ++page;
+            }
+            if (page == packers.size())
+            {
+                packers.emplace_back(m_page_size, m_page_size);
+                m_pages.emplace_back(m_page_size, m_page_size);
+                if (opaque)
+                {
+                    for (size_t i = 3; i < m_pages.back().pixels.size(); i += 4)
+                    {
+                        m_pages.back().pixels[i] = 255;
+                    }
+                }
+                packers.back().pack(slot_width, slot_height, x, y);
+            }
+
+            AtlasRegion& region = m_regions[index];
+            region.page = static_cast<uint32_t>(page);
+            region.x = x + m_padding;
+            region.y = y + m_padding;
+            region.width = image.width;
+            region.height = image.height;
+            region.uv_rect = glm::vec4(static_cast<float>(region.x) / page_size, static_cast<float>(region.y) / page_size,
+                                       static_cast<float>(region.width) / page_size, static_cast<float>(region.height) / page_size);
+            write_padded(image, m_pages[page], region.x, region.y);
+            m_packed_area += static_cast<size_t>(image.width) * image.height;
+        }
+        return true;
+    }
+
+    void TextureAtlas::write_padded(const Image& image, Image& page, const uint32_t x, const uint32_t y) const
+    {
+        const int64_t padding = m_padding;
+        for (int64_t row = -padding; row < static_cast<int64_t>(image.height) + padding; ++row)
+        {
+            const uint32_t source_row = static_cast<uint32_t>(std::clamp<int64_t>(row, 0, image.height - 1));
+            uint8_t* destination = page.get_pixel(x - m_padding, static_cast<uint32_t>(y + row));
+            for (int64_t column = -padding; column < static_cast<int64_t>(image.width) + padding; ++column, destination += 4)
+            {
+                const uint32_t source_column = static_cast<uint32_t>(std::clamp<int64_t>(column, 0, image.width - 1));
+                std::memcpy(destination, image.get_pixel(source_column, source_row), 4);
+            }
+        }
+    }
+
+    uint32_t TextureAtlas::get_max_mip_levels() const
+    {
+        uint32_t levels = 1;
+        for (uint32_t padding = m_padding; padding > 1; padding >>= 1)
+        {
+            ++levels;
+        }
+        return levels;
+    }
+
+    float TextureAtlas::get_occupancy() const
+    {
+        if (m_pages.empty())
+        {
+            return 0.0f;
+        }
+        return static_cast<float>(m_packed_area) / (static_cast<float>(m_page_size) * static_cast<float>(m_page_size) * static_cast<float>(m_pages.size()));
+    }
+
+    void TextureAtlas::release_images()
+    {
+        m_images.clear();
+        m_images.shrink_to_fit();
+        m_pages.clear();
+        m_pages.shrink_to_fit();
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Image.hpp"
+
+#include <glm/vec4.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace GraphicsEngine {
+    struct AtlasRegion
+    {
+        // Texture coordinate offset (xy) and scale (zw): atlas_uv = uv_rect.xy + uv * uv_rect.zw
+        glm::vec4 uv_rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+        // Page, i.e. the array layer when the pages are uploaded as a TextureArray
+        uint32_t page = 0;
+        uint32_t x = 0;
+        uint32_t y = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    // Packs many small images into a few square pages so they share one texture binding.
+    // Each image is surrounded by padding filled with its edge pixels, so filtering and the
+    // first mip levels don't bleed neighbours in, and starts on a 4-pixel boundary so BCn
+    // blocks never straddle two images.
+    class TextureAtlas
+    {
+    public:
+        // Both are rounded up to multiples of 4
+        explicit TextureAtlas(const uint32_t page_size = 1024, const uint32_t padding = 4);
+
+        // Returns the image's region index
+        uint32_t add_image(Image image);
+        // Packs every image added so far into new pages, tallest first, opening pages as needed.
+        // Fails if an image does not fit on an empty page with its padding
+        bool build();
+
+        const std::vector<Image>& get_pages() const { return m_pages; }
+        const std::vector<AtlasRegion>& get_regions() const { return m_regions; }
+        const AtlasRegion& get_region(const uint32_t index) const { return m_regions[index]; }
+        uint32_t get_page_size() const { return m_page_size; }
+        // Mip levels that sample padding only, never a neighbouring image
+        uint32_t get_max_mip_levels() const;
+        // Packed area / page area over all pages
+        float get_occupancy() const;
+        // Drops the images and pages once the pages are uploaded; regions stay valid
+        void release_images();
+
+    private:
+        // Copies image to (x, y) and repeats its edge pixels into the padding around it
+        void write_padded(const Image& image, Image& page, const uint32_t x, const uint32_t y) const;
+
+        uint32_t m_page_size;
+        uint32_t m_padding;
+        std::vector<Image> m_images;
+        std::vector<AtlasRegion> m_regions;
+        std::vector<Image> m_pages;
+        size_t m_packed_area = 0;
+    };
+}
@@ -0,0 +1,268 @@
+#include "TextureCompression.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace GraphicsEngine {
+    namespace {
+        // Edge blocks of images whose size is not a multiple of 4 repeat the last row and column
+        void read_block(const Image& image, const uint32_t block_x, const uint32_t block_y, uint8_t pixels[16][4])
+        {
+            for (uint32_t y = 0; y < 4; ++y)
+            {
+                for (uint32_t x = 0; x < 4; ++x)
+                {
+                    const uint8_t* pixel = image.get_pixel(std::min(block_x * 4 + x, image.width - 1), std::min(block_y * 4 + y, image.height - 1));
+                    std::memcpy(pixels[y * 4 + x], pixel, 4);
+                }
+            }
+        }
+
+        uint16_t to_rgb565(const float color[3])
+        {
+            const auto quantize = [](const float value, const float max_value) {
+                return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 255.0f) * max_value / 255.0f));
+            };
+            return static_cast<uint16_t>((quantize(color[0], 31.0f) << 11) | (quantize(color[1], 63.0f) << 5) | quantize(color[2], 31.0f));
+        }
+
+        void from_rgb565(const uint16_t value, float color[3])
+        {
+            const unsigned int r = (value >> 11) & 31;
+            const unsigned int g = (value >> 5) & 63;
+            const unsigned int b = value & 31;
+            color[0] = static_cast<float>((r << 3) | (r >> 2));
+            color[1] = static_cast<float>((g << 2) | (g >> 4));
+            color[2] = static_cast<float>((b << 3) | (b >> 2));
+        }
+
+        void write_u16(uint8_t* out, const uint16_t value)
+        {
+            out[0] = static_cast<uint8_t>(value);
+            out[1] = static_cast<uint8_t>(value >> 8);
+        }
+
+        // BC1 color block. With punch_through, pixels with alpha below 128 become transparent
+        // (3-color mode); otherwise the block always uses 4 colors, as BC3 requires.
+        void encode_color_block(const uint8_t pixels[16][4], const bool punch_through, uint8_t* out)
+        {
+            bool transparent[16] = {};
+            bool has_transparent = false;
+            float mean[3] = {};
+            int opaque_count = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                transparent[i] = punch_through && pixels[i][3] < 128;
+                has_transparent |= transparent[i];
+                if (!transparent[i])
+                {
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        mean[c] += pixels[i][c];
+                    }
+                    ++opaque_count;
+                }
+            }
+            if (opaque_count == 0)
+            {
+                // c0 <= c1 selects 3-color mode, where index 3 is transparent black
+                write_u16(out, 0);
+                write_u16(out + 2, 0);
+                std::memset(out + 4, 0xFF, 4);
+                return;
+            }
+            for (float& value : mean)
+            {
+                value /= static_cast<float>(opaque_count);
+            }
+
+            float covariance[6] = {};
+            for (int i = 0; i < 16; ++i)
+            {
+                if (transparent[i])
+                {
+                    continue;
+                }
+                const float d[3] = { pixels[i][0] - mean[0], pixels[i][1] - mean[1], pixels[i][2] - mean[2] };
+                covariance[0] += d[0] * d[0];
+                covariance[1] += d[0] * d[1];
+                covariance[2] += d[0] * d[2];
+                covariance[3] += d[1] * d[1];
+                covariance[4] += d[1] * d[2];
+                covariance[5] += d[2] * d[2];
+            }
+            // Power iteration for the principal axis
+            float axis[3] = { 1.0f, 1.0f, 1.0f };
+            for (int iteration = 0; iteration < 4; ++iteration)
+            {
+                const float next[3] = {
+                    covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+                    covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+                    covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2]
+                };
+                const float length = std::max({ std::fabs(next[0]), std::fabs(next[1]), std::fabs(next[2]) });
+                if (length < 1e-6f)
+                {
+                    break;
+                }
+                for (int c = 0; c < 3; ++c)
+                {
+                    axis[c] = next[c] / length;
+                }
+            }
+
+            float min_t = 1e30f;
+            float max_t = -1e30f;
+            for (int i = 0; i < 16; ++i)
+            {
+                if (!transparent[i])
+                {
+                    const float t = (pixels[i][0] - mean[0]) * axis[0] + (pixels[i][1] - mean[1]) * axis[1] + (pixels[i][2] - mean[2]) * axis[2];
+                    min_t = std::min(min_t, t);
+                    max_t = std::max(max_t, t);
+                }
+            }
+            const float axis_length_squared = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+            // Insetting the endpoints by 1/16 of the range lowers the error of the interpolated colors
+            const float inset = (max_t - min_t) / 16.0f;
+            float endpoints[2][3];
+            for (int c = 0; c < 3; ++c)
+            {
+                endpoints[0][c] = mean[c] + axis[c] * (max_t - inset) / axis_length_squared;
+                endpoints[1][c] = mean[c] + axis[c] * (min_t + inset) / axis_length_squared;
+            }
+
+            uint16_t color0 = to_rgb565(endpoints[0]);
+            uint16_t color1 = to_rgb565(endpoints[1]);
+            const bool three_colors = has_transparent;
+            if (three_colors ? color0 > color1 : color0 < color1)
+            {
+                std::swap(color0, color1);
+            }
+
+            float palette[4][3];
+            from_rgb565(color0, palette[0]);
+            from_rgb565(color1, palette[1]);
+            const int palette_size = three_colors || color0 == color1 ? 3 : 4;
+            for (int c = 0; c < 3; ++c)
+            {
+                if (palette_size == 4)
+                {
+                    palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+                    palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+                }
+                else
+                {
+                    palette[2][c] = (palette[0][c] + palette[1][c]) / 2.0f;
+                }
+            }
+
+            uint32_t indices = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                uint32_t best_index = 3;
+                if (!transparent[i])
+                {
+                    float best_distance = 1e30f;
+                    for (int p = 0; p < palette_size; ++p)
+                    {
+                        const float d[3] = { pixels[i][0] - palette[p][0], pixels[i][1] - palette[p][1], pixels[i][2] - palette[p][2] };
+                        const float distance = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+                        if (distance < best_distance)
+                        {
+                            best_distance = distance;
+                            best_index = static_cast<uint32_t>(p);
+                        }
+                    }
+                }
+                indices |= best_index << (i * 2);
+            }
+
+            write_u16(out, color0);
+            write_u16(out + 2, color1);
+            for (int i = 0; i < 4; ++i)
+            {
+                out[4 + i] = static_cast<uint8_t>(indices >> (i * 8));
+            }
+        }
+
+        // BC4 block of one channel, in the 8-value mode (endpoint 0 > endpoint 1)
+        void encode_channel_block(const uint8_t pixels[16][4], const int channel, uint8_t* out)
+        {
+            uint8_t min_value = 255;
+            uint8_t max_value = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                min_value = std::min(min_value, pixels[i][channel]);
+                max_value = std::max(max_value, pixels[i][channel]);
+            }
+            out[0] = max_value;
+            out[1] = min_value;
+
+            uint64_t indices = 0;
+            if (max_value > min_value)
+            {
+                // Palette order: max, min, then 6 values from max to min
+                const float range = static_cast<float>(max_value - min_value);
+                for (int i = 0; i < 16; ++i)
+                {
+                    // Position between max (0) and min (7)
+                    const int step = static_cast<int>(std::lround(static_cast<float>(max_value - pixels[i][channel]) * 7.0f / range));
+                    const uint64_t index = step == 0 ? 0 : step == 7 ? 1 : static_cast<uint64_t>(step + 1);
+                    indices |= index << (i * 3);
+                }
+            }
+            for (int i = 0; i < 6; ++i)
+            {
+                out[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+            }
+        }
+    }
+
+    bool compress_image(const Image& image, const ETextureFormat format, std::vector<uint8_t>& blocks)
+    {
+        if (!can_compress_format(format) || image.is_empty())
+        {
+            return false;
+        }
+
+        const uint32_t blocks_x = (image.width + 3) / 4;
+        const uint32_t blocks_y = (image.height + 3) / 4;
+        const uint32_t block_size = get_format_block_size(format);
+        blocks.resize(static_cast<size_t>(blocks_x) * blocks_y * block_size);
+
+        uint8_t pixels[16][4];
+        uint8_t* out = blocks.data();
+        for (uint32_t block_y = 0; block_y < blocks_y; ++block_y)
+        {
+            for (uint32_t block_x = 0; block_x < blocks_x; ++block_x, out += block_size)
+            {
+                read_block(image, block_x, block_y, pixels);
+                switch (format)
+                {
+                    case ETextureFormat::BC1:
+                    case ETextureFormat::BC1_SRGB:
+                        encode_color_block(pixels, true, out);
+                        break;
+                    case ETextureFormat::BC3:
+                    case ETextureFormat::BC3_SRGB:
+                        encode_channel_block(pixels, 3, out);
+                        encode_color_block(pixels, false, out + 8);
+                        break;
+                    case ETextureFormat::BC4:
+                        encode_channel_block(pixels, 0, out);
+                        break;
+                    case ETextureFormat::BC5:
+                        encode_channel_block(pixels, 0, out);
+                        encode_channel_block(pixels, 1, out + 8);
+                        break;
+                    default:
+                        return false;
+                }
+            }
+        }
+        return true;
+    }
+}
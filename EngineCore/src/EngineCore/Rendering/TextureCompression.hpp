@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Image.hpp"
+#include "TextureFormat.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace GraphicsEngine {
+    constexpr bool can_compress_format(const ETextureFormat format)
+    {
+        return format == ETextureFormat::BC1 || format == ETextureFormat::BC1_SRGB ||
+               format == ETextureFormat::BC3 || format == ETextureFormat::BC3_SRGB ||
+               format == ETextureFormat::BC4 || format == ETextureFormat::BC5;
+    }
+
+    // Encodes image into 4x4 blocks, block rows from the first image row on, as
+    // glCompressedTexSubImage2D takes them. BC1 and BC3 store RGBA (BC1 with 1-bit alpha),
+    // BC4 the red and BC5 the red and green channels. Endpoints come from the principal
+    // axis of each block's colors: fast enough for load time, not archival quality.
+    // BC7 has no encoder; returns false for the formats can_compress_format rejects.
+    bool compress_image(const Image& image, const ETextureFormat format, std::vector<uint8_t>& blocks);
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace GraphicsEngine {
+    enum class ETextureFormat : uint8_t
+    {
+        R8,
+        RG8,
+        RGBA8,
+        SRGBA8,
+        // 4x4 blocks: BC1 and BC4 take 8 bytes per block, the others 16
+        BC1,
+        BC1_SRGB,
+        BC3,
+        BC3_SRGB,
+        BC4,
+        BC5,
+        BC7,
+        BC7_SRGB
+    };
+
+    enum class ETextureFilter : uint8_t
+    {
+        Nearest,
+        Linear,
+        // Linear within and between mip levels
+        Trilinear
+    };
+
+    enum class ETextureWrap : uint8_t
+    {
+        Repeat,
+        ClampToEdge
+    };
+
+    enum class EMipGeneration : uint8_t
+    {
+        None,
+        // Box filter on the CPU before upload; the only option for compressed formats
+        Cpu,
+        // glGenerateMipmap after level 0 is uploaded
+        Gpu
+    };
+
+    struct TextureDesc
+    {
+        uint32_t width = 1;
+        uint32_t height = 1;
+        // Array textures only
+        uint32_t layers = 1;
+        // 0 allocates the full chain down to 1x1
+        uint32_t mip_levels = 1;
+        ETextureFormat format = ETextureFormat::RGBA8;
+        ETextureFilter filter = ETextureFilter::Trilinear;
+        ETextureWrap wrap = ETextureWrap::Repeat;
+    };
+
+    // How an RGBA8 image becomes a texture
+    struct TextureImportSettings
+    {
+        // Stored as BC1 (opaque images) or BC3 when the driver supports them, RGBA8 otherwise
+        bool compress = true;
+        // Color data; mips are averaged in linear space
+        bool srgb = false;
+        EMipGeneration mip_generation = EMipGeneration::Cpu;
+        // 0 generates the full chain
+        uint32_t mip_levels = 0;
+        ETextureFilter filter = ETextureFilter::Trilinear;
+        ETextureWrap wrap = ETextureWrap::Repeat;
+    };
+
+    constexpr bool is_compressed_format(const ETextureFormat format)
+    {
+        return format >= ETextureFormat::BC1;
+    }
+
+    constexpr bool is_srgb_format(const ETextureFormat format)
+    {
+        return format == ETextureFormat::SRGBA8 || format == ETextureFormat::BC1_SRGB ||
+               format == ETextureFormat::BC3_SRGB || format == ETextureFormat::BC7_SRGB;
+    }
+
+    // Bytes per pixel, or per 4x4 block for compressed formats
+    constexpr uint32_t get_format_block_size(const ETextureFormat format)
+    {
+        switch (format)
+        {
+            case ETextureFormat::R8:       return 1;
+            case ETextureFormat::RG8:      return 2;
+            case ETextureFormat::RGBA8:
+            case ETextureFormat::SRGBA8:   return 4;
+            case ETextureFormat::BC1:
+            case ETextureFormat::BC1_SRGB:
+            case ETextureFormat::BC4:      return 8;
+            case ETextureFormat::BC3:
+            case ETextureFormat::BC3_SRGB:
+            case ETextureFormat::BC5:
+            case ETextureFormat::BC7:
+            case ETextureFormat::BC7_SRGB: return 16;
+        }
+        return 0;
+    }
+
+    constexpr uint32_t get_mip_size(const uint32_t size, const uint32_t level)
+    {
+        const uint32_t mip_size = size >> level;
+        return mip_size > 0 ? mip_size : 1;
+    }
+
+    constexpr uint32_t get_mip_levels_count(const uint32_t width, const uint32_t height)
+    {
+        uint32_t levels = 1;
+        for (uint32_t size = width > height ? width : height; size > 1; size >>= 1)
+        {
+            ++levels;
+        }
+        return levels;
+    }
+
+    // Bytes of one width x height image; compressed formats round up to whole blocks
+    constexpr size_t get_image_size(const ETextureFormat format, const uint32_t width, const uint32_t height)
+    {
+        if (is_compressed_format(format))
+        {
+            return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * get_format_block_size(format);
+        }
+        return static_cast<size_t>(width) * height * get_format_block_size(format);
+    }
+
+    constexpr const char* get_format_name(const ETextureFormat format)
+    {
+        constexpr const char* names[] = { "R8", "RG8", "RGBA8", "SRGBA8", "BC1", "BC1_SRGB", "BC3", "BC3_SRGB", "BC4", "BC5", "BC7", "BC7_SRGB" };
+        return names[static_cast<size_t>(format)];
+    }
+}
@@ -0,0 +1,232 @@
+#include "VertexQuantization.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define ENGINE_QUANTIZATION_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace GraphicsEngine {
+    namespace {
+        uint32_t float_bits(const float value)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        float bits_float(const uint32_t bits)
+        {
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        // nearbyint rounds to nearest even like the SSE conversions do
+        int32_t quantize(const float value, const float min, const float max, const float scale)
+        {
+            return static_cast<int32_t>(std::nearbyint(std::clamp(value, min, max) * scale));
+        }
+
+#ifdef ENGINE_QUANTIZATION_SSE
+        // float_to_half on 4 lanes, results in the low 16 bits of each lane
+        __m128i floats_to_halves(const __m128 value)
+        {
+            const __m128 sign = _mm_and_ps(value, _mm_set1_ps(-0.0f));
+            const __m128 absolute = _mm_xor_ps(value, sign);
+            const __m128i bits = _mm_castps_si128(absolute);
+
+            // Inputs at or above 65520 round to infinity; NaNs keep a quiet mantissa bit
+            const __m128i is_finite = _mm_cmpgt_epi32(_mm_set1_epi32((127 + 16) << 23), bits);
+            const __m128i nan_bit = _mm_and_si128(_mm_castps_si128(_mm_cmpunord_ps(absolute, absolute)), _mm_set1_epi32(0x200));
+            const __m128i infinity_or_nan = _mm_or_si128(nan_bit, _mm_set1_epi32(0x7C00));
+
+            // Subnormal halves: adding a magic value lets the FPU round the mantissa into place
+            const __m128i subnormal_magic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+            const __m128i is_subnormal = _mm_cmpgt_epi32(_mm_set1_epi32((127 - 14) << 23), bits);
+            const __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absolute, _mm_castsi128_ps(subnormal_magic))), subnormal_magic);
+
+            // Normal halves: rebias the exponent and round the mantissa to nearest even
+            const __m128i mantissa_odd = _mm_srai_epi32(_mm_slli_epi32(bits, 31 - 13), 31);
+            const __m128i rounded = _mm_sub_epi32(_mm_add_epi32(bits, _mm_set1_epi32(0xFFF - ((127 - 15) << 23))), mantissa_odd);
+            const __m128i normal = _mm_srli_epi32(rounded, 13);
+
+            const __m128i finite = _mm_or_si128(_mm_and_si128(is_subnormal, subnormal), _mm_andnot_si128(is_subnormal, normal));
+            const __m128i half = _mm_or_si128(_mm_and_si128(is_finite, finite), _mm_andnot_si128(is_finite, infinity_or_nan));
+            return _mm_or_si128(half, _mm_srli_epi32(_mm_castps_si128(sign), 16));
+        }
+
+        __m128i clamp_and_round(const __m128 value, const __m128 min, const __m128 max, const __m128 scale)
+        {
+            return _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(value, min), max), scale));
+        }
+#endif
+    }
+
+    uint16_t float_to_half(const float value)
+    {
+        const uint32_t bits = float_bits(value);
+        const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+        const uint32_t absolute = bits & 0x7FFFFFFF;
+
+        if (absolute >= 0x7F800000)
+        {
+            return sign | 0x7C00 | (absolute > 0x7F800000 ? 0x200 : 0);
+        }
+        if (absolute >= ((127 + 16) << 23))
+        {
+            return sign | 0x7C00;
+        }
+        if (absolute < ((127 - 14) << 23))
+        {
+            const uint32_t magic = ((127 - 15) + (23 - 10) + 1) << 23;
+            return sign | static_cast<uint16_t>(float_bits(bits_float(absolute) + bits_float(magic)) - magic);
+        }
+        const uint32_t mantissa_odd = (absolute >> 13) & 1;
+        return sign | static_cast<uint16_t>((absolute + 0xFFF - ((127 - 15) << 23) + mantissa_odd) >> 13);
+    }
+
+    float half_to_float(const uint16_t value)
+    {
+        const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+        const uint32_t exponent = (value >> 10) & 0x1F;
+        const uint32_t mantissa = value & 0x3FF;
+        if (exponent == 0)
+        {
+            // Zero or subnormal: mantissa * 2^-24
+            const float magnitude = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+            return sign ? -magnitude : magnitude;
+        }
+        if (exponent == 31)
+        {
+            return bits_float(sign | 0x7F800000 | (mantissa << 13));
+        }
+        return bits_float(sign | ((exponent + 127 - 15) << 23) | (mantissa << 13));
+    }
+
+    void quantize_half(const float* source, uint16_t* destination, const size_t count)
+    {
+        size_t i = 0;
+#ifdef ENGINE_QUANTIZATION_SSE
+        for (; i + 8 <= count; i += 8)
+        {
+            // packs_epi32 saturates signed values, so sign-extend the halves first
+            const __m128i low = floats_to_halves(_mm_loadu_ps(source + i));
+            const __m128i high = floats_to_halves(_mm_loadu_ps(source + i + 4));
+            const __m128i packed = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(low, 16), 16), _mm_srai_epi32(_mm_slli_epi32(high, 16), 16));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), packed);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            destination[i] = float_to_half(source[i]);
+        }
+    }
+
+    void quantize_unorm8(const float* source, uint8_t* destination, const size_t count)
+    {
+        size_t i = 0;
+#ifdef ENGINE_QUANTIZATION_SSE
+        const __m128 min = _mm_setzero_ps();
+        const __m128 max = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(255.0f);
+        for (; i + 16 <= count; i += 16)
+        {
+            const __m128i a = clamp_and_round(_mm_loadu_ps(source + i), min, max, scale);
+            const __m128i b = clamp_and_round(_mm_loadu_ps(source + i + 4), min, max, scale);
+            const __m128i c = clamp_and_round(_mm_loadu_ps(source + i + 8), min, max, scale);
+            const __m128i d = clamp_and_round(_mm_loadu_ps(source + i + 12), min, max, scale);
+            const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), packed);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            destination[i] = static_cast<uint8_t>(quantize(source[i], 0.0f, 1.0f, 255.0f));
+        }
+    }
+
+    void quantize_snorm16(const float* source, int16_t* destination, const size_t count)
+    {
+        size_t i = 0;
+#ifdef ENGINE_QUANTIZATION_SSE
+        const __m128 min = _mm_set1_ps(-1.0f);
+        const __m128 max = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(32767.0f);
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i low = clamp_and_round(_mm_loadu_ps(source + i), min, max, scale);
+            const __m128i high = clamp_and_round(_mm_loadu_ps(source + i + 4), min, max, scale);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packs_epi32(low, high));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            destination[i] = static_cast<int16_t>(quantize(source[i], -1.0f, 1.0f, 32767.0f));
+        }
+    }
+
+    uint32_t pack_snorm_2_10_10_10_rev(const float x, const float y, const float z, const float w)
+    {
+        return (static_cast<uint32_t>(quantize(x, -1.0f, 1.0f, 511.0f)) & 0x3FF)
+             | (static_cast<uint32_t>(quantize(y, -1.0f, 1.0f, 511.0f)) & 0x3FF) << 10
+             | (static_cast<uint32_t>(quantize(z, -1.0f, 1.0f, 511.0f)) & 0x3FF) << 20
+             | (static_cast<uint32_t>(quantize(w, -1.0f, 1.0f, 1.0f)) & 0x3) << 30;
+    }
+
+    void quantize_snorm_2_10_10_10_rev(const float* source, uint32_t* destination, const size_t count)
+    {
+        size_t i = 0;
+#ifdef ENGINE_QUANTIZATION_SSE
+        // Transposed so each register holds one field of 4 values, which then shift into place together
+        const __m128 min = _mm_set1_ps(-1.0f);
+        const __m128 max = _mm_set1_ps(1.0f);
+        const __m128 xyz_scale = _mm_set1_ps(511.0f);
+        const __m128i xyz_mask = _mm_set1_epi32(0x3FF);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 x = _mm_loadu_ps(source + i * 4);
+            __m128 y = _mm_loadu_ps(source + i * 4 + 4);
+            __m128 z = _mm_loadu_ps(source + i * 4 + 8);
+            __m128 w = _mm_loadu_ps(source + i * 4 + 12);
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+
+            const __m128i packed_x = _mm_and_si128(clamp_and_round(x, min, max, xyz_scale), xyz_mask);
+            const __m128i packed_y = _mm_slli_epi32(_mm_and_si128(clamp_and_round(y, min, max, xyz_scale), xyz_mask), 10);
+            const __m128i packed_z = _mm_slli_epi32(_mm_and_si128(clamp_and_round(z, min, max, xyz_scale), xyz_mask), 20);
+            const __m128i packed_w = _mm_slli_epi32(clamp_and_round(w, min, max, max), 30);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i),
+                             _mm_or_si128(_mm_or_si128(packed_x, packed_y), _mm_or_si128(packed_z, packed_w)));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            const float* value = source + i * 4;
+            destination[i] = pack_snorm_2_10_10_10_rev(value[0], value[1], value[2], value[3]);
+        }
+    }
+
+    float unorm8_to_float(const uint8_t value)
+    {
+        return static_cast<float>(value) / 255.0f;
+    }
+
+    float snorm16_to_float(const int16_t value)
+    {
+        // -32768 and -32767 both map to -1
+        return std::max(static_cast<float>(value) / 32767.0f, -1.0f);
+    }
+
+    void unpack_snorm_2_10_10_10_rev(const uint32_t value, float* destination)
+    {
+        // Shifting each field to the top and back sign-extends it
+        const int32_t bits = static_cast<int32_t>(value);
+        destination[0] = std::max(static_cast<float>((bits << 22) >> 22) / 511.0f, -1.0f);
+        destination[1] = std::max(static_cast<float>((bits << 12) >> 22) / 511.0f, -1.0f);
+        destination[2] = std::max(static_cast<float>((bits << 2) >> 22) / 511.0f, -1.0f);
+        destination[3] = std::max(static_cast<float>(bits >> 30), -1.0f);
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace GraphicsEngine {
+    // Conversions from float source data to the compressed ShaderDataTypes, for filling
+    // vertex buffers at bake or load time. Values are rounded to nearest and clamped to the
+    // type's range, matching how GL normalizes them back (GL 4.2 signed normalization).
+
+    // IEEE 754 half, round to nearest even; overflow becomes infinity, NaN stays NaN
+    uint16_t float_to_half(const float value);
+    float half_to_float(const uint16_t value);
+
+    // Each converts count floats
+    void quantize_half(const float* source, uint16_t* destination, const size_t count);
+    void quantize_unorm8(const float* source, uint8_t* destination, const size_t count);
+    void quantize_snorm16(const float* source, int16_t* destination, const size_t count);
+
+    // Int2_10_10_10_Rev: source holds 4 floats per value, x in the low bits and w in the top 2
+    uint32_t pack_snorm_2_10_10_10_rev(const float x, const float y, const float z, const float w);
+    void quantize_snorm_2_10_10_10_rev(const float* source, uint32_t* destination, const size_t count);
+
+    // The other way round, as GL reads the types back: for consumers that read vertex buffers on the CPU
+    float unorm8_to_float(const uint8_t value);
+    float snorm16_to_float(const int16_t value);
+    // Writes x, y, z and w
+    void unpack_snorm_2_10_10_10_rev(const uint32_t value, float* destination);
+}
@@ -4,6 +4,23 @@
 #include "EngineCore/Rendering/OpenGL/VertexBuffer.hpp"
 #include "EngineCore/Rendering/OpenGL/VertexArray.hpp"
 #include "EngineCore/Rendering/OpenGL/IndexBuffer.hpp"
+#include "EngineCore/Rendering/OpenGL/Renderer_OpenGL.hpp"
+#include "EngineCore/Rendering/OpenGL/BatchRenderer.hpp"
+#include "EngineCore/Rendering/OpenGL/UniformBuffer.hpp"
+#include "EngineCore/Rendering/OpenGL/StateCache_OpenGL.hpp"
+#include "EngineCore/Rendering/OpenGL/MeshPool.hpp"
+#include "EngineCore/Rendering/OpenGL/RenderBackend_OpenGL.hpp"
+#include "EngineCore/Rendering/Software/Renderer_Software.hpp"
+#include "EngineCore/Rendering/OpenGL/TextureArray.hpp"
+#include "EngineCore/Rendering/TextureAtlas.hpp"
+#include "EngineCore/Rendering/RenderThread.hpp"
+#include "EngineCore/ECS/Components.hpp"
+#include "EngineCore/Jobs/JobSystem.hpp"
+#include "EngineCore/Memory/FrameArena.hpp"
+#include "EngineCore/Memory/ScratchScope.hpp"
+#include "EngineCore/Profiling/Profiler.hpp"
+#include "EngineCore/Profiling/ProfilerOverlay.hpp"
+#include "EngineCore/Rendering/OpenGL/GpuProfiler_OpenGL.hpp"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -15,6 +32,12 @@
 
 #include <glm/mat4x4.hpp>
 #include <glm/trigonometric.hpp>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <span>
+#include <vector>
 
 namespace GraphicsEngine
 {
@@ -24,47 +47,442 @@ namespace GraphicsEngine
         -0.5f, 0.5f, 0.0f, 1.0f, 0.0f, 1.0f,
         0.5f, 0.5f, 0.0f, 1.0f, 0.0f, 0.0f};
 
-    GLuint indices[] = {
+    GLubyte indices[] = {
         0, 1, 2, 3, 2, 1};
+    constexpr EIndexType quad_index_type = select_index_type(4);
+    constexpr size_t quad_indices_count = sizeof(indices) / sizeof(indices[0]);
+
+    // Layout of BatchVertex, which every scene mesh uses
+    const BufferLayout quad_layout{
+        ShaderDataType::Float3,
+        ShaderDataType::Float4,
+        ShaderDataType::Float2
+    };
 
     const char *vertex_shader =
-        R"(#version 460
+        R"(#version 450
         layout(location = 0) in vec3 vertex_position;
-        layout(location = 1) in vec3 vertex_color;
-        uniform mat4 model_matrix;
-        out vec3 color;
+        layout(location = 1) in vec4 vertex_color;
+        layout(location = 2) in vec2 vertex_tex_coord;
+        #ifdef INSTANCED
+        layout(location = 3) in mat4 model_matrix;
+        layout(location = 7) in int instance_atlas_region;
+        #else
+        layout(location = 3) in int instance_atlas_region;
+        #endif
+        layout(std140, binding = 0) uniform FrameData {
+           mat4 view_projection_matrix;
+        };
+        #ifdef USE_TEXTURE
+        layout(std140, binding = 1) uniform AtlasData {
+           vec4 atlas_rects[MAX_ATLAS_REGIONS];
+           vec4 atlas_pages[MAX_ATLAS_REGIONS / 4];
+           int atlas_regions_count;
+        };
+        out vec3 tex_coord;
+        #endif
+        out vec4 color;
         void main() {
            color = vertex_color;
-           gl_Position = model_matrix * vec4(vertex_position, 1.0);
+        #ifdef USE_TEXTURE
+           int region = instance_atlas_region % atlas_regions_count;
+           tex_coord = vec3(atlas_rects[region].xy + vertex_tex_coord * atlas_rects[region].zw, atlas_pages[region / 4][region % 4]);
+        #endif
+        #ifdef INSTANCED
+           gl_Position = view_projection_matrix * model_matrix * vec4(vertex_position, 1.0);
+        #else
+           gl_Position = view_projection_matrix * vec4(vertex_position, 1.0);
+        #endif
         })";
 
     const char *fragment_shader =
-        R"(#version 460
-        in vec3 color;
+        R"(#version 450
+        in vec4 color;
+        #ifdef USE_TEXTURE
+        in vec3 tex_coord;
+        layout(binding = 0) uniform sampler2DArray atlas;
+        #endif
         out vec4 frag_color;
         void main() {
-           frag_color = vec4(color, 1.0);
+        #ifdef USE_TEXTURE
+           frag_color = color * texture(atlas, tex_coord);
+        #else
+           frag_color = color;
+        #endif
         })";
 
     std::unique_ptr<ShaderProgram> p_shader_program;
-    std::unique_ptr<VertexBuffer> p_positions_colors_vbo;
-    std::unique_ptr<IndexBuffer> p_index_buffer;
-    std::unique_ptr<VertexArray> p_vao;
-    float scale[3] = {1.0f, 1.0f, 1.0f};
-    float rotate = 0.f;
-    float position[3] = {0.0f, 0.0f, 0.0f};
+    std::unique_ptr<BatchRenderer> p_batch_renderer;
+    std::unique_ptr<UniformBuffer> p_frame_uniform_buffer;
+    UniformHandle view_projection_handle;
+    // Draws the batched mode
+    std::unique_ptr<RenderBackend_OpenGL> p_render_backend;
+
+    enum class DrawMode : int
+    {
+        Batched,
+        Instanced,
+        // One indirect command per object, all drawn from the mesh pool
+        MultiDrawIndirect
+    };
+    const char* draw_mode_names[] = { "batched", "instanced", "multi-draw indirect" };
+
+    // Instanced and indirect paths: one quad mesh plus a stream of per-instance model matrices
+    std::unique_ptr<ShaderProgram> p_instanced_shader_program;
+    std::unique_ptr<VertexBuffer> p_quad_vertex_buffer;
+    std::unique_ptr<IndexBuffer> p_quad_index_buffer;
+    std::unique_ptr<VertexBuffer> p_instance_buffer;
+    std::unique_ptr<VertexArray> p_instanced_vertex_array;
+    BatchVertex uploaded_quad_vertices[4];
+    size_t instances_capacity = 0;
+    std::unique_ptr<MeshPool> p_mesh_pool;
+    std::unique_ptr<GpuProfiler_OpenGL> p_gpu_profiler;
+    MeshHandle quad_mesh;
+
+    // Streamed mesh drawn instead of the quad while it is resident; the quad is its placeholder
+    const GpuMesh* p_scene_mesh = nullptr;
+    uint64_t scene_mesh_residency_id = 0;
+    MeshHandle scene_pool_mesh;
+
+    // Textured scene: every object samples one region of an atlas whose pages are array layers
+    constexpr size_t max_atlas_regions = 64;
+    struct AtlasData
+    {
+        glm::vec4 rects[max_atlas_regions];
+        // Four pages per vec4, as std140 pads scalar arrays to vec4s anyway
+        glm::vec4 pages[max_atlas_regions / 4];
+        int32_t regions_count;
+        int32_t padding[3];
+    };
+    std::unique_ptr<ShaderProgram> p_textured_shader_program;
+    std::unique_ptr<ShaderProgram> p_textured_instanced_shader_program;
+    std::unique_ptr<UniformBuffer> p_atlas_uniform_buffer;
+    std::unique_ptr<TextureArray> p_scene_textures;
+    int draw_mode = static_cast<int>(DrawMode::Instanced);
+
+    // Everything the render thread needs to draw one frame. There is one per command
+    // list, so the main thread fills one while the render thread reads the other.
+    struct SceneFrame
+    {
+        BatchVertex quad_vertices[4];
+        // In the frame arena; valid until the render thread is done with this frame
+        std::span<glm::mat4> model_matrices;
+        // Parallel to model_matrices; each object's transform id, so its texture stays put as others are culled
+        std::span<int32_t> atlas_regions;
+        // model_matrices is grouped by LOD: LOD i draws [lod_offsets[i], lod_offsets[i + 1])
+        std::array<size_t, LodSystem::max_lods + 1> lod_offsets = {};
+        size_t lods_count = 1;
+        ImDrawData imgui_draw_data;
+        std::vector<ImDrawList*> imgui_draw_lists;
+        size_t batches_count = 0;
+    };
+    std::array<SceneFrame, 2> scene_frames;
 
     static bool s_GLfW_initialized = false;
 
-    Window::Window(std::string title, const unsigned int width, const unsigned int height)
+    // Per-instance attributes of the instanced and pooled draws, in the order of instance_layout
+    struct InstanceData
+    {
+        glm::mat4 model_matrix;
+        int32_t atlas_region;
+    };
+
+    void create_instance_buffer(const size_t capacity)
+    {
+        static const BufferLayout instance_layout({ ShaderDataType::Mat4, ShaderDataType::Int }, 1);
+
+        p_instance_buffer = std::make_unique<VertexBuffer>(nullptr, capacity * sizeof(InstanceData), instance_layout, VertexBuffer::EUsage::PersistentStream);
+        if (p_instanced_vertex_array)
+        {
+            p_instanced_vertex_array->set_vertex_buffer(1, *p_instance_buffer);
+        }
+        else
+        {
+            p_instanced_vertex_array = std::make_unique<VertexArray>();
+            p_instanced_vertex_array->add_vertex_buffer(p_scene_mesh ? *p_scene_mesh->vertex_buffer : *p_quad_vertex_buffer);
+            p_instanced_vertex_array->add_vertex_buffer(*p_instance_buffer);
+            p_instanced_vertex_array->set_index_buffer(p_scene_mesh ? *p_scene_mesh->index_buffer : *p_quad_index_buffer);
+        }
+        VertexArray::unbind();
+        p_mesh_pool->attach_instance_buffer(p_instance_buffer.get());
+        instances_capacity = capacity;
+    }
+
+    // Points the instanced VAO and the mesh pool at the streamed mesh when it becomes resident or is evicted
+    void select_scene_mesh(const GpuMesh* mesh)
+    {
+        p_scene_mesh = mesh;
+        const uint64_t residency_id = mesh ? mesh->residency_id : 0;
+        if (residency_id == scene_mesh_residency_id)
+        {
+            return;
+        }
+        scene_mesh_residency_id = residency_id;
+
+        if (scene_pool_mesh.is_valid())
+        {
+            p_mesh_pool->remove_mesh(scene_pool_mesh);
+            scene_pool_mesh = {};
+        }
+        if (mesh)
+        {
+            scene_pool_mesh = p_mesh_pool->add_mesh(mesh->source.get_vertices(), mesh->source.get_vertices_count(),
+                                                    mesh->source.get_indices(), mesh->source.get_indices_count(), mesh->source.get_index_type());
+        }
+        // The mesh has the quad's vertex format, so the instanced VAO only needs its buffers re-pointed
+        p_instanced_vertex_array->set_vertex_buffer(0, mesh ? *mesh->vertex_buffer : *p_quad_vertex_buffer);
+        p_instanced_vertex_array->set_index_buffer(mesh ? *mesh->index_buffer : *p_quad_index_buffer);
+        VertexArray::unbind();
+    }
+
+    // Checkerboard in a color and size that vary with index
+    Image make_pattern_image(const uint32_t index)
+    {
+        Image image(32 + (index * 37 % 5) * 24, 32 + (index * 53 % 4) * 32);
+        const glm::vec3 hue = glm::vec3(0.5f) + 0.5f * glm::cos(6.2831853f * (static_cast<float>(index) / 13.0f + glm::vec3(0.0f, 0.33f, 0.67f)));
+        const uint32_t cell_size = 4u << (index % 3);
+        for (uint32_t y = 0; y < image.height; ++y)
+        {
+            for (uint32_t x = 0; x < image.width; ++x)
+            {
+                const bool border = x < 2 || y < 2 || x + 2 >= image.width || y + 2 >= image.height;
+                const float shade = border ? 1.0f : ((x / cell_size + y / cell_size) % 2 == 0 ? 1.0f : 0.35f);
+                uint8_t* pixel = image.get_pixel(x, y);
+                for (int channel = 0; channel < 3; ++channel)
+                {
+                    pixel[channel] = static_cast<uint8_t>((border ? 1.0f : hue[channel] * shade) * 255.0f);
+                }
+                pixel[3] = 255;
+            }
+        }
+        return image;
+    }
+
+    // Packs the pattern images into an atlas, uploads its pages as one array texture and compiles
+    // the textured programs. Runs once on the render thread
+    void create_scene_textures()
+    {
+        TextureAtlas atlas(512, 4);
+        for (uint32_t i = 0; i < 40; ++i)
+        {
+            atlas.add_image(make_pattern_image(i));
+        }
+        if (!atlas.build())
+        {
+            return;
+        }
+
+        TextureImportSettings settings;
+        settings.mip_levels = atlas.get_max_mip_levels();
+        settings.wrap = ETextureWrap::ClampToEdge;
+        std::unique_ptr<TextureArray> textures = TextureArray::create(atlas.get_pages(), settings);
+        const std::vector<std::string> defines = { "USE_TEXTURE", "MAX_ATLAS_REGIONS " + std::to_string(max_atlas_regions) };
+        auto program = std::make_unique<ShaderProgram>(vertex_shader, fragment_shader, defines);
+        std::vector<std::string> instanced_defines = defines;
+        instanced_defines.push_back("INSTANCED");
+        auto instanced_program = std::make_unique<ShaderProgram>(vertex_shader, fragment_shader, instanced_defines);
+        const UniformBlockInfo* atlas_block = program->isCompiled() ? program->get_uniform_block("AtlasData") : nullptr;
+        if (!textures || !atlas_block || !instanced_program->isCompiled())
+        {
+            LOG_ERROR("Failed to create the scene textures, drawing untextured");
+            return;
+        }
+
+        AtlasData data = {};
+        const std::vector<AtlasRegion>& regions = atlas.get_regions();
+        data.regions_count = static_cast<int32_t>(std::min(regions.size(), max_atlas_regions));
+        for (int32_t i = 0; i < data.regions_count; ++i)
+        {
+            data.rects[i] = regions[i].uv_rect;
+            data.pages[i / 4][i % 4] = static_cast<float>(regions[i].page);
+        }
+        p_atlas_uniform_buffer = std::make_unique<UniformBuffer>(*atlas_block);
+        p_atlas_uniform_buffer->set_data(0, &data, std::min(sizeof(data), p_atlas_uniform_buffer->get_size()));
+        p_atlas_uniform_buffer->upload();
+
+        size_t uncompressed_size = 0;
+        for (uint32_t level = 0; level < textures->get_mip_levels(); ++level)
+        {
+            uncompressed_size += get_image_size(ETextureFormat::RGBA8, get_mip_size(textures->get_width(), level), get_mip_size(textures->get_height(), level)) * textures->get_layers();
+        }
+        LOG_INFO("Scene textures: {} images on {} {}x{} pages ({:.0f}% used), {} with {} mips, {} KiB ({} KiB as RGBA8)",
+                 regions.size(), textures->get_layers(), textures->get_width(), textures->get_height(), atlas.get_occupancy() * 100.0f,
+                 get_format_name(textures->get_format()), textures->get_mip_levels(), textures->get_memory_size() / 1024, uncompressed_size / 1024);
+
+        p_scene_textures = std::move(textures);
+        p_textured_shader_program = std::move(program);
+        p_textured_instanced_shader_program = std::move(instanced_program);
+    }
+
+    ShaderProgram& get_scene_program(const bool instanced)
+    {
+        if (p_scene_textures)
+        {
+            return instanced ? *p_textured_instanced_shader_program : *p_textured_shader_program;
+        }
+        return instanced ? *p_instanced_shader_program : *p_shader_program;
+    }
+
+    // Uploads the quad if it changed and the frame's model matrices; returns the first instance of the frame
+    unsigned int upload_instances(SceneFrame& frame)
+    {
+        if (std::memcmp(uploaded_quad_vertices, frame.quad_vertices, sizeof(frame.quad_vertices)) != 0)
+        {
+            p_quad_vertex_buffer->update_buffer(frame.quad_vertices, sizeof(frame.quad_vertices));
+            p_mesh_pool->remove_mesh(quad_mesh);
+            quad_mesh = p_mesh_pool->add_mesh(frame.quad_vertices, 4, indices, quad_indices_count, quad_index_type);
+            std::memcpy(uploaded_quad_vertices, frame.quad_vertices, sizeof(frame.quad_vertices));
+        }
+
+        const size_t instances_count = frame.model_matrices.size();
+        if (instances_count > instances_capacity)
+        {
+            size_t capacity = std::max<size_t>(instances_capacity, 1024);
+            while (capacity < instances_count)
+            {
+                capacity *= 2;
+            }
+            create_instance_buffer(capacity);
+        }
+
+        StreamBuffer& stream = p_instance_buffer->get_stream();
+        InstanceData* instances = static_cast<InstanceData*>(stream.map_next_region());
+        for (size_t i = 0; i < instances_count; ++i)
+        {
+            instances[i] = { frame.model_matrices[i], frame.atlas_regions[i] };
+        }
+        stream.commit(instances_count * sizeof(InstanceData));
+        return static_cast<unsigned int>(stream.get_region_offset() / sizeof(InstanceData));
+    }
+
+    // The frame's LODs come from the mesh's header, so they match unless the file changed in between
+    const MeshLod& get_scene_lod(const MeshAsset& source, const size_t lod)
+    {
+        return source.get_lod(std::min(lod, source.get_lods_count() - 1));
+    }
+
+    // The mesh once per LOD with that LOD's objects, or the placeholder quad for every object; returns the draws written
+    size_t get_scene_draws(const SceneFrame& frame, const MeshAsset* mesh, MeshView& view, std::array<MeshDraw, LodSystem::max_lods>& draws)
+    {
+        if (!mesh)
+        {
+            view = { frame.quad_vertices, 4, &quad_layout, indices, quad_indices_count, quad_index_type };
+            draws[0] = { 0, quad_indices_count, frame.model_matrices, frame.atlas_regions };
+            return 1;
+        }
+
+        view = { mesh->get_vertices(), mesh->get_vertices_count(), &quad_layout, mesh->get_indices(), mesh->get_indices_count(), mesh->get_index_type() };
+        for (size_t lod = 0; lod < frame.lods_count; ++lod)
+        {
+            const MeshLod& range = get_scene_lod(*mesh, lod);
+            const size_t instances_count = frame.lod_offsets[lod + 1] - frame.lod_offsets[lod];
+            draws[lod] = { range.first_index, range.indices_count, frame.model_matrices.subspan(frame.lod_offsets[lod], instances_count),
+                           frame.atlas_regions.subspan(frame.lod_offsets[lod], instances_count) };
+        }
+        return frame.lods_count;
+    }
+
+    // The streamed mesh is drawn once per LOD with that LOD's index range; the placeholder quad draws every instance at once
+    void draw_instanced_quads(SceneFrame& frame)
+    {
+        const unsigned int base_instance = upload_instances(frame);
+
+        get_scene_program(true).bind();
+        if (p_scene_mesh)
+        {
+            frame.batches_count = 0;
+            for (size_t lod = 0; lod < frame.lods_count; ++lod)
+            {
+                const size_t instances_count = frame.lod_offsets[lod + 1] - frame.lod_offsets[lod];
+                if (instances_count == 0)
+                {
+                    continue;
+                }
+                const MeshLod& range = get_scene_lod(p_scene_mesh->source, lod);
+                Renderer_OpenGL::draw_instanced(*p_instanced_vertex_array, range.indices_count, instances_count, range.first_index, 0,
+                                                base_instance + static_cast<unsigned int>(frame.lod_offsets[lod]));
+                ++frame.batches_count;
+            }
+        }
+        else
+        {
+            Renderer_OpenGL::draw_instanced(*p_instanced_vertex_array, p_instanced_vertex_array->get_indices_count(),
+                                            frame.model_matrices.size(), 0, 0, base_instance);
+            frame.batches_count = 1;
+        }
+        p_instance_buffer->get_stream().fence();
+    }
+
+    void draw_pooled_quads(SceneFrame& frame)
+    {
+        const unsigned int base_instance = upload_instances(frame);
+
+        p_mesh_pool->begin();
+        if (scene_pool_mesh.is_valid())
+        {
+            for (size_t lod = 0; lod < frame.lods_count; ++lod)
+            {
+                const MeshLod& range = get_scene_lod(p_scene_mesh->source, lod);
+                for (size_t i = frame.lod_offsets[lod]; i < frame.lod_offsets[lod + 1]; ++i)
+                {
+                    p_mesh_pool->add_draw(scene_pool_mesh, range.first_index, range.indices_count, 1, base_instance + static_cast<unsigned int>(i));
+                }
+            }
+        }
+        else
+        {
+            for (unsigned int i = 0; i < frame.model_matrices.size(); ++i)
+            {
+                p_mesh_pool->add_draw(quad_mesh, 1, base_instance + i);
+            }
+        }
+        p_mesh_pool->end(get_scene_program(true));
+        p_instance_buffer->get_stream().fence();
+        frame.batches_count = 1;
+    }
+
+    void release_imgui_draw_lists(SceneFrame& frame)
+    {
+        for (ImDrawList* draw_list : frame.imgui_draw_lists)
+        {
+            IM_DELETE(draw_list);
+        }
+        frame.imgui_draw_lists.clear();
+        frame.imgui_draw_data.Clear();
+    }
+
+    Window::Window(std::string title, const unsigned int width, const unsigned int height, const bool headless, const bool multithreaded,
+                   const ERenderBackend backend)
         : m_data({std::move(title), width, height})
+        , m_headless(headless)
+        , m_backend(headless ? backend : ERenderBackend::OpenGL)
     {
+        if (m_backend != backend)
+        {
+            LOG_WARN("The software renderer only renders headless windows, using OpenGL");
+        }
+
         int resultCode = init();
+        m_initialized = resultCode == 0;
+        if (!m_initialized)
+        {
+            return;
+        }
+
+        if (!m_headless)
+        {
+            IMGUI_CHECKVERSION();
+            ImGui::CreateContext();
+            ImGui_ImplOpenGL3_Init();
+            ImGui_ImplGlfw_InitForOpenGL(m_window, true);
+            // Creates the backend's GL objects while the context is still current here
+            ImGui_ImplOpenGL3_NewFrame();
+        }
+
+        m_settings_transform = m_transforms.create(Transform());
 
-        IMGUI_CHECKVERSION();
-        ImGui::CreateContext();
-        ImGui_ImplOpenGL3_Init();
-        ImGui_ImplGlfw_InitForOpenGL(m_window, true);
+        // The software renderer draws on the main thread, where it can spread work over the job system
+        m_render_thread = std::make_unique<RenderThread>(m_window, m_state_cache.get(), multithreaded && m_backend == ERenderBackend::OpenGL);
     }
 
     Window::~Window()
@@ -76,6 +494,10 @@ namespace GraphicsEngine
     {
         if (!s_GLfW_initialized)
         {
+            if (m_headless)
+            {
+                glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+            }
             if (!glfwInit())
             {
                 LOG_CRITICAL("Failed to initialize GLFW");
@@ -84,20 +506,38 @@ namespace GraphicsEngine
             s_GLfW_initialized = true;
         }
 
-        m_window = glfwCreateWindow(m_data.width, m_data.height, m_data.title.c_str(), nullptr, nullptr);
+        if (m_backend == ERenderBackend::Software)
+        {
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+            glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+            m_window = glfwCreateWindow(m_data.width, m_data.height, m_data.title.c_str(), nullptr, nullptr);
+            glfwDefaultWindowHints();
+        }
+        else
+        {
+            m_window = m_headless ? create_headless_window()
+                                  : glfwCreateWindow(m_data.width, m_data.height, m_data.title.c_str(), nullptr, nullptr);
+        }
         if (!m_window)
         {
             LOG_CRITICAL("Failed to create window");
             glfwTerminate();
+            s_GLfW_initialized = false;
             return -2;
         }
 
-        glfwMakeContextCurrent(m_window);
+        if (m_backend == ERenderBackend::OpenGL)
+        {
+            m_state_cache = std::make_unique<StateCache_OpenGL>();
+            if (!Renderer_OpenGL::init(m_window, *m_state_cache))
+            {
+                return -3;
+            }
+        }
 
-        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+        if (m_backend == ERenderBackend::OpenGL && m_headless && !create_framebuffer())
         {
-            LOG_CRITICAL("Failed to initialize GLAD");
-            return -3;
+            return -4;
         }
 
         glfwSetWindowUserPointer(m_window, &m_data);
@@ -109,8 +549,10 @@ namespace GraphicsEngine
                                       data.height = height;
                                       data.width = width;
 
-                                      EventWindowResized event(width, height);
-                                      data.event_callback(event);
+                                      if (data.event_dispatcher)
+                                      {
+                                          data.event_dispatcher->post(EventWindowResized(width, height));
+                                      }
                                   });
 
         glfwSetCursorPosCallback(m_window,
@@ -118,83 +560,473 @@ namespace GraphicsEngine
                                  {
                                      WindowData &data = *static_cast<WindowData *>(glfwGetWindowUserPointer(window));
 
-                                     EventMouseMoved event(x, y);
-                                     data.event_callback(event);
+                                     if (data.event_dispatcher)
+                                     {
+                                         data.event_dispatcher->post(EventMouseMoved(x, y));
+                                     }
                                  });
 
         glfwSetWindowCloseCallback(m_window,
                                    [](GLFWwindow *window)
                                    {
                                        WindowData &data = *static_cast<WindowData *>(glfwGetWindowUserPointer(window));
-                                       EventWindowClose event;
-                                       data.event_callback(event);
+                                       if (data.event_dispatcher)
+                                       {
+                                           data.event_dispatcher->post(EventWindowClose());
+                                       }
                                    });
 
         glfwSetFramebufferSizeCallback(m_window,
                                        [](GLFWwindow *window, int width, int height)
                                        {
-                                           glViewport(0, 0, width, height);
+                                           // The context may be current on the render thread, so only record the size here
+                                           WindowData &data = *static_cast<WindowData *>(glfwGetWindowUserPointer(window));
+                                           data.framebuffer_width = width;
+                                           data.framebuffer_height = height;
+                                           data.framebuffer_resized = true;
                                        });
 
+        if (m_backend == ERenderBackend::Software)
+        {
+            m_software_renderer = std::make_unique<Renderer_Software>(m_data.width, m_data.height);
+            return 0;
+        }
+
         p_shader_program = std::make_unique<ShaderProgram>(vertex_shader, fragment_shader);
         if (!p_shader_program->isCompiled())
         {
-            return false;
+            return -5;
         }
 
-        BufferLayout buffer_layout_1vec3{
-            ShaderDataType::Float3};
-
-        BufferLayout buffer_layout_2vec3{
-            ShaderDataType::Float3,
-            ShaderDataType::Float3};
+        const UniformBlockInfo* frame_block = p_shader_program->get_uniform_block("FrameData");
+        if (!frame_block)
+        {
+            LOG_CRITICAL("Shader program has no FrameData uniform block");
+            return -6;
+        }
+        p_frame_uniform_buffer = std::make_unique<UniformBuffer>(*frame_block);
+        view_projection_handle = p_frame_uniform_buffer->get_member_handle("view_projection_matrix");
 
-        p_vao = std::make_unique<VertexArray>();
-        p_positions_colors_vbo = std::make_unique<VertexBuffer>(positions_colors2, sizeof(positions_colors2), buffer_layout_2vec3);
-        p_index_buffer = std::make_unique<IndexBuffer>(indices, sizeof(indices) / sizeof(GLuint));
+        p_batch_renderer = std::make_unique<BatchRenderer>();
+        p_render_backend = std::make_unique<RenderBackend_OpenGL>(*p_batch_renderer, *p_frame_uniform_buffer, view_projection_handle);
 
-        p_vao->add_vertex_buffer(*p_positions_colors_vbo);
-        p_vao->set_index_buffer(*p_index_buffer);
+        p_instanced_shader_program = std::make_unique<ShaderProgram>(vertex_shader, fragment_shader, std::vector<std::string>{ "INSTANCED" });
+        if (!p_instanced_shader_program->isCompiled())
+        {
+            return -7;
+        }
+        p_quad_vertex_buffer = std::make_unique<VertexBuffer>(uploaded_quad_vertices, sizeof(uploaded_quad_vertices), quad_layout, VertexBuffer::EUsage::Dynamic);
+        p_quad_index_buffer = std::make_unique<IndexBuffer>(indices, quad_indices_count, quad_index_type);
+        // Baked LOD chains take up to twice the indices of the full mesh
+        p_mesh_pool = std::make_unique<MeshPool>(quad_layout, 65536, 196608);
+        quad_mesh = p_mesh_pool->add_mesh(uploaded_quad_vertices, 4, indices, quad_indices_count, quad_index_type);
+        create_instance_buffer(1024);
+        p_gpu_profiler = std::make_unique<GpuProfiler_OpenGL>();
 
         return 0;
     }
 
+    GLFWwindow* Window::create_headless_window()
+    {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+        GLFWwindow* window = glfwCreateWindow(m_data.width, m_data.height, m_data.title.c_str(), nullptr, nullptr);
+        if (!window)
+        {
+            LOG_WARN("Failed to create EGL context, falling back to OSMesa");
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+            window = glfwCreateWindow(m_data.width, m_data.height, m_data.title.c_str(), nullptr, nullptr);
+        }
+
+        glfwDefaultWindowHints();
+        return window;
+    }
+
+    bool Window::create_framebuffer()
+    {
+        glGenRenderbuffers(1, &m_color_renderbuffer_id);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_color_renderbuffer_id);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_data.width, m_data.height);
+
+        glGenRenderbuffers(1, &m_depth_renderbuffer_id);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_depth_renderbuffer_id);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_data.width, m_data.height);
+
+        glGenFramebuffers(1, &m_framebuffer_id);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer_id);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_color_renderbuffer_id);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depth_renderbuffer_id);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            LOG_CRITICAL("Headless framebuffer is incomplete");
+            return false;
+        }
+
+        Renderer_OpenGL::set_viewport(m_data.width, m_data.height);
+        return true;
+    }
+
     void Window::on_update()
     {
-        glClearColor(m_background_color[0], m_background_color[1], m_background_color[2], m_background_color[3]);
-        glClear(GL_COLOR_BUFFER_BIT);
+        PROFILE_SCOPE("Window::on_update");
+        {
+            PROFILE_SCOPE("poll events");
+            glfwPollEvents();
+        }
+
+        SceneFrame& frame = scene_frames[m_frame_index];
+        m_frame_index = 1 - m_frame_index;
+
+        if (m_mesh.is_valid())
+        {
+            m_assets->touch(m_mesh);
+        }
+        m_assets->update();
+        update_mesh_bounds();
+
+        for (size_t i = 0; i < 4; ++i)
+        {
+            const GLfloat* vertex = positions_colors2 + i * 6;
+            frame.quad_vertices[i] = { glm::vec3(vertex[0], vertex[1], vertex[2]), glm::vec4(vertex[3], vertex[4], vertex[5], 1.0f), glm::vec2(vertex[0] + 0.5f, vertex[1] + 0.5f) };
+        }
+
+        update_scene();
+
+        {
+            PROFILE_SCOPE("cull");
+            m_visibility.cull(m_view_projection, m_visible_ids);
+        }
+
+        // Visible objects in the order their matrices are drawn in
+        const std::span<const TransformId> draw_ids = select_lods(frame);
+
+        {
+            PROFILE_SCOPE("gather matrices");
+            frame.model_matrices = { m_frame_arena->allocate_array<glm::mat4>(draw_ids.size()), draw_ids.size() };
+            frame.atlas_regions = { m_frame_arena->allocate_array<int32_t>(draw_ids.size()), draw_ids.size() };
+            auto gather_matrices = [this, &frame, draw_ids](const size_t begin, const size_t end) {
+                PROFILE_SCOPE("gather matrices chunk");
+                for (size_t i = begin; i < end; ++i)
+                {
+                    frame.model_matrices[i] = m_transforms.get_world_matrix(draw_ids[i]);
+                    frame.atlas_regions[i] = static_cast<int32_t>(draw_ids[i]);
+                }
+            };
+            if (m_job_system)
+            {
+                // Each chunk copies at least 64KiB, enough to outweigh the cost of a job
+                m_job_system->parallel_for(draw_ids.size(), gather_matrices, 1024);
+            }
+            else
+            {
+                gather_matrices(0, draw_ids.size());
+            }
+        }
+
+        if (m_software_renderer)
+        {
+            draw_software(frame);
+            return;
+        }
+
+        if (!m_headless)
+        {
+            PROFILE_SCOPE("record ui");
+            record_ui(frame);
+        }
+
+        RenderCommandList& commands = m_render_thread->get_command_list();
+
+        if (m_data.framebuffer_resized)
+        {
+            commands.submit([width = m_data.framebuffer_width, height = m_data.framebuffer_height]() {
+                p_render_backend->set_viewport(width, height);
+            });
+            m_data.framebuffer_resized = false;
+        }
+
+        // Streaming uploads go first so a mesh that finishes this frame is drawn this frame
+        commands.submit([assets = m_assets.get(), mesh = &m_mesh]() {
+            assets->upload();
+            select_scene_mesh(mesh->is_valid() ? assets->find_resident_mesh(*mesh) : nullptr);
+        });
+
+        if (m_textured && !m_textures_requested)
+        {
+            commands.submit([]() {
+                create_scene_textures();
+            });
+            m_textures_requested = true;
+        }
+
+        commands.submit([r = m_background_color[0], g = m_background_color[1], b = m_background_color[2], a = m_background_color[3]]() {
+            p_gpu_profiler->begin_frame();
+            p_render_backend->clear(glm::vec4(r, g, b, a));
+        });
+
+        commands.submit([&frame, mode = static_cast<DrawMode>(draw_mode), view_projection = m_view_projection]() {
+            GPU_PROFILE_SCOPE(*p_gpu_profiler, "scene");
+            if (p_scene_textures)
+            {
+                p_scene_textures->bind(0);
+                p_atlas_uniform_buffer->bind(1);
+            }
+
+            if (mode == DrawMode::Batched)
+            {
+                MeshView mesh;
+                std::array<MeshDraw, LodSystem::max_lods> draws;
+                const size_t draws_count = get_scene_draws(frame, p_scene_mesh ? &p_scene_mesh->source : nullptr, mesh, draws);
+                p_render_backend->set_program(&get_scene_program(false));
+                p_render_backend->draw(view_projection, mesh, { draws.data(), draws_count });
+                frame.batches_count = p_render_backend->get_batches_count();
+                return;
+            }
+
+            p_frame_uniform_buffer->setMatrix4(view_projection_handle, view_projection);
+            p_frame_uniform_buffer->upload();
+            p_frame_uniform_buffer->bind(0);
+            if (mode == DrawMode::Instanced)
+            {
+                draw_instanced_quads(frame);
+            }
+            else
+            {
+                draw_pooled_quads(frame);
+            }
+        });
+
+        if (m_headless)
+        {
+            commands.submit([]() {
+                p_gpu_profiler->end_frame();
+            });
+            commands.submit([]() {
+                glFlush();
+            });
+        }
+        else
+        {
+            commands.submit([&frame, window = m_window]() {
+                {
+                    GPU_PROFILE_SCOPE(*p_gpu_profiler, "imgui");
+                    ImGui_ImplOpenGL3_RenderDrawData(&frame.imgui_draw_data);
+                }
+                StateCache_OpenGL::invalidate();
+                p_gpu_profiler->end_frame();
+                glfwSwapBuffers(window);
+            });
+        }
+
+        PROFILE_SCOPE("submit frame");
+
+        m_render_thread->submit_frame();
+    }
+
+    std::span<const TransformId> Window::select_lods(SceneFrame& frame)
+    {
+        const size_t count = m_visible_ids.size();
+        frame.lods_count = m_lods.get_lods_count();
+        frame.lod_offsets.fill(count);
+        frame.lod_offsets[0] = 0;
+        m_lod_objects_counts.fill(0);
+        if (frame.lods_count == 1)
+        {
+            m_lod_objects_counts[0] = count;
+            return m_visible_ids;
+        }
+
+        PROFILE_SCOPE("select lods");
+        uint8_t* lods = m_frame_arena->allocate_array<uint8_t>(count);
+        auto select_chunk = [this, lods](const size_t begin, const size_t end) {
+            PROFILE_SCOPE("select lods chunk");
+            m_lods.select(m_transforms, m_view_projection, static_cast<float>(get_height()), m_visible_ids.data() + begin, end - begin, lods + begin);
+        };
+        if (m_job_system)
+        {
+            m_job_system->parallel_for(count, select_chunk, 1024);
+        }
+        else
+        {
+            select_chunk(0, count);
+        }
+
+        // Counting sort by LOD, which keeps each LOD's objects in culling order
+        for (size_t i = 0; i < count; ++i)
+        {
+            ++m_lod_objects_counts[lods[i]];
+        }
+        std::array<size_t, LodSystem::max_lods> cursors = {};
+        for (size_t lod = 0; lod < frame.lods_count; ++lod)
+        {
+            cursors[lod] = frame.lod_offsets[lod];
+            frame.lod_offsets[lod + 1] = frame.lod_offsets[lod] + m_lod_objects_counts[lod];
+        }
+        TransformId* sorted_ids = m_frame_arena->allocate_array<TransformId>(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            sorted_ids[cursors[lods[i]]++] = m_visible_ids[i];
+        }
+        return { sorted_ids, count };
+    }
+
+    void Window::update_scene()
+    {
+        PROFILE_SCOPE("update scene");
+        if (m_grid_entities.size() != m_objects_count)
+        {
+            while (m_grid_entities.size() > m_objects_count)
+            {
+                const TransformId id = m_registry.get_component<TransformNode>(m_grid_entities.back())->id;
+                m_visibility.remove(id);
+                m_lods.remove(id);
+                m_transforms.destroy(id);
+                m_registry.destroy_entity(m_grid_entities.back());
+                m_grid_entities.pop_back();
+            }
+            while (m_grid_entities.size() < m_objects_count)
+            {
+                const TransformNode node{ m_transforms.create(Transform(), m_settings_transform) };
+                m_grid_entities.push_back(m_registry.create_entity(node, Renderable()));
+                m_visibility.add(node.id, m_mesh_bounds);
+                m_lods.add(node.id, m_mesh_bounds);
+            }
 
-        p_shader_program->bind();
+            // Objects are laid out on a square grid; a single object keeps the original placement
+            const unsigned int grid_size = static_cast<unsigned int>(std::ceil(std::sqrt(static_cast<double>(m_objects_count))));
+            const float cell_size = 2.0f / static_cast<float>(grid_size);
+            for (unsigned int i = 0; i < m_objects_count; ++i)
+            {
+                Transform cell;
+                cell.position = glm::vec3(-1.0f + cell_size * (static_cast<float>(i % grid_size) + 0.5f),
+                                          -1.0f + cell_size * (static_cast<float>(i / grid_size) + 0.5f),
+                                          0.0f);
+                cell.scale = glm::vec3(cell_size * 0.5f);
+                m_transforms.set_local(m_registry.get_component<TransformNode>(m_grid_entities[i])->id, cell);
+            }
+        }
 
-        glm::mat4 scale_matrix(scale[0], 0,        0,        0, 
-                               0,        scale[1], 0,        0, 
-                               0,        0,        scale[2], 0, 
-                               0,        0,        0,        1);
+        // Only transforms changed since the last frame (and their children) are recomputed
+        {
+            PROFILE_SCOPE("update transforms");
+            m_transforms.update();
+        }
+        PROFILE_SCOPE("update visibility");
+        m_visibility.update(m_transforms);
+    }
+
+    bool Window::load_mesh(const std::string& path)
+    {
+        if (m_software_renderer)
+        {
+            // Nothing to upload: the software renderer reads the mapped file
+            auto mesh = std::make_unique<MeshAsset>();
+            if (!mesh->load(path))
+            {
+                return false;
+            }
+            if (!mesh->matches_layout(quad_layout))
+            {
+                LOG_ERROR("{} does not have the scene's vertex layout", path);
+                return false;
+            }
+            std::vector<MeshLod> lods;
+            for (size_t lod = 0; lod < mesh->get_lods_count(); ++lod)
+            {
+                lods.push_back(mesh->get_lod(lod));
+            }
+            m_software_mesh = std::move(mesh);
+            m_software_renderer->invalidate_vertices();
+            apply_mesh_bounds(m_software_mesh->get_bounds(), lods);
+            return true;
+        }
 
-        float rotate_in_radians = glm::radians(rotate);
-        glm::mat4 rotate_matrix(cos(rotate_in_radians),  sin(rotate_in_radians), 0, 0, 
-                               -sin(rotate_in_radians), cos(rotate_in_radians), 0, 0, 
-                               0,                       0,                      1, 0, 
-                               0,                       0,                      0, 1);
-                               
-        glm::mat4 position_matrix(1,           0,           0,           0, 
-                               0,           1,           0,           0, 
-                               0,           0,           1,           0, 
-                               position[0], position[1], position[2], 1);
+        m_mesh = m_assets->load_mesh(path, quad_layout);
+        m_mesh_bounds_applied = false;
+        return m_mesh.is_valid();
+    }
 
-        glm::mat4 model_matrix = position_matrix * rotate_matrix * scale_matrix;
-        p_shader_program->setMatrix4("model_matrix", model_matrix);
+    void Window::update_mesh_bounds()
+    {
+        AABB bounds;
+        if (m_mesh_bounds_applied || !m_mesh.is_valid() || !m_assets->get_bounds(m_mesh, bounds))
+        {
+            return;
+        }
+        m_mesh_bounds_applied = true;
+        std::vector<MeshLod> lods;
+        m_assets->get_lods(m_mesh, lods);
+        apply_mesh_bounds(bounds, lods);
+    }
 
-        p_vao->bind();
-        p_positions_colors_vbo->update_buffer(positions_colors2, sizeof(positions_colors2));
-        
-        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(p_vao->get_indices_count()), GL_UNSIGNED_INT, nullptr);
+    void Window::apply_mesh_bounds(const AABB& bounds, const std::vector<MeshLod>& lods)
+    {
+        m_mesh_bounds = bounds;
+        std::vector<float> lod_errors;
+        for (const MeshLod& lod : lods)
+        {
+            lod_errors.push_back(lod.error);
+        }
+        m_lods.set_lod_errors(lod_errors);
+        // Culls with the mesh's bounds already while the placeholder is drawn
+        for (const Entity entity : m_grid_entities)
+        {
+            const TransformId id = m_registry.get_component<TransformNode>(entity)->id;
+            m_visibility.remove(id);
+            m_visibility.add(id, m_mesh_bounds);
+            m_lods.add(id, m_mesh_bounds);
+        }
+    }
 
+    void Window::draw_software(SceneFrame& frame)
+    {
+        PROFILE_SCOPE("draw software");
+        if (m_textured && !m_textures_requested)
+        {
+            LOG_WARN("The software renderer draws vertex colors only");
+            m_textures_requested = true;
+        }
+        if (m_data.framebuffer_resized)
+        {
+            m_software_renderer->set_viewport(m_data.framebuffer_width, m_data.framebuffer_height);
+            m_data.framebuffer_resized = false;
+        }
+
+        MeshView mesh;
+        std::array<MeshDraw, LodSystem::max_lods> draws;
+        const size_t draws_count = get_scene_draws(frame, m_software_mesh.get(), mesh, draws);
+        if (!m_software_mesh)
+        {
+            // The quad's vertices are rewritten in place every frame
+            m_software_renderer->invalidate_vertices();
+        }
+        m_software_renderer->set_job_system(m_job_system);
+        m_software_renderer->clear(glm::vec4(m_background_color[0], m_background_color[1], m_background_color[2], m_background_color[3]));
+        m_software_renderer->draw(m_view_projection, mesh, { draws.data(), draws_count });
+        frame.batches_count = draws_count;
+    }
+
+    const SoftwareFramebuffer* Window::get_software_framebuffer() const
+    {
+        return m_software_renderer ? &m_software_renderer->get_framebuffer() : nullptr;
+    }
+
+    void Window::finish_rendering()
+    {
+        m_render_thread->flush();
+    }
+
+    void Window::record_ui(SceneFrame& frame)
+    {
         ImGuiIO &io = ImGui::GetIO();
         io.DisplaySize.x = static_cast<float>(get_width());
         io.DisplaySize.y = static_cast<float>(get_height());
 
-        ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
 
@@ -207,21 +1039,117 @@ namespace GraphicsEngine
         ImGui::ColorEdit3("color2", positions_colors2 + 9);
         ImGui::ColorEdit3("color3", positions_colors2 + 15);
         ImGui::ColorEdit3("color4", positions_colors2 + 21);
-        ImGui::SliderFloat3("scale", scale, 0.0f, 2.0f);
-        ImGui::SliderFloat("rotate", &rotate, 0.0f, 360.0f);
-        ImGui::SliderFloat3("position", position, -1.0f, 1.0f);
+        Transform transform = m_transforms.get_local(m_settings_transform);
+        bool transform_changed = ImGui::SliderFloat3("scale", &transform.scale.x, 0.0f, 2.0f);
+        transform_changed |= ImGui::SliderFloat("rotate", &m_settings_rotation, 0.0f, 360.0f);
+        transform_changed |= ImGui::SliderFloat3("position", &transform.position.x, -1.0f, 1.0f);
+        if (transform_changed)
+        {
+            transform.rotation = glm::angleAxis(glm::radians(m_settings_rotation), glm::vec3(0.0f, 0.0f, 1.0f));
+            m_transforms.set_local(m_settings_transform, transform);
+        }
+        static const unsigned int min_objects_count = 1;
+        static const unsigned int max_objects_count = 100000;
+        ImGui::SliderScalar("objects", ImGuiDataType_U32, &m_objects_count, &min_objects_count, &max_objects_count);
+        ImGui::Combo("draw mode", &draw_mode, draw_mode_names, IM_ARRAYSIZE(draw_mode_names));
+        // Filled by the render thread when it last used this frame slot
+        ImGui::Text("batches: %zu", frame.batches_count);
+        ImGui::Text("visible: %zu, culled: %zu", m_visibility.get_visible_count(), m_visibility.get_culled_count());
+        float lod_threshold = m_lods.get_threshold();
+        if (ImGui::SliderFloat("lod error (px)", &lod_threshold, 0.0f, 16.0f))
+        {
+            m_lods.set_threshold(lod_threshold);
+        }
+        for (size_t lod = 0; lod < m_lods.get_lods_count(); ++lod)
+        {
+            ImGui::Text("lod %zu: %zu objects", lod, m_lod_objects_counts[lod]);
+        }
+        const MemoryStats& chunk_pool_stats = m_registry.get_chunk_pool_stats();
+        ImGui::Text("frame arena: %zu KiB", m_frame_arena->get_bytes_in_use() / 1024);
+        ImGui::Text("scratch peak: %zu KiB", ScratchScope::get_thread_stats().peak_bytes_in_use / 1024);
+        ImGui::Text("ecs chunks: %zu / %zu KiB", chunk_pool_stats.bytes_in_use / 1024, chunk_pool_stats.capacity_bytes / 1024);
+        ImGui::Text("assets: %zu, resident %zu / %zu MiB, evictions %zu", m_assets->get_assets_count(),
+                    m_assets->get_resident_bytes() / (1024 * 1024), m_assets->get_memory_budget() / (1024 * 1024), m_assets->get_evictions_count());
         ImGui::End();
 
+        draw_profiler_overlay();
+
         ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
-        glfwSwapBuffers(m_window);
-        glfwPollEvents();
+        // ImGui reuses its draw lists next frame, so the render thread gets its own copy
+        release_imgui_draw_lists(frame);
+        const ImDrawData* draw_data = ImGui::GetDrawData();
+        frame.imgui_draw_data.Valid = draw_data->Valid;
+        frame.imgui_draw_data.DisplayPos = draw_data->DisplayPos;
+        frame.imgui_draw_data.DisplaySize = draw_data->DisplaySize;
+        frame.imgui_draw_data.FramebufferScale = draw_data->FramebufferScale;
+        frame.imgui_draw_data.OwnerViewport = draw_data->OwnerViewport;
+        for (const ImDrawList* draw_list : draw_data->CmdLists)
+        {
+            ImDrawList* draw_list_copy = draw_list->CloneOutput();
+            frame.imgui_draw_lists.push_back(draw_list_copy);
+            frame.imgui_draw_data.AddDrawList(draw_list_copy);
+        }
     }
 
     void Window::shutdown()
     {
+        // Joins the render thread and makes the context current here again
+        m_render_thread = nullptr;
+
+        for (SceneFrame& frame : scene_frames)
+        {
+            release_imgui_draw_lists(frame);
+            frame.model_matrices = {};
+            frame.atlas_regions = {};
+        }
+
+        if (m_initialized && !m_headless)
+        {
+            ImGui_ImplOpenGL3_Shutdown();
+            ImGui_ImplGlfw_Shutdown();
+            ImGui::DestroyContext();
+        }
+
+        p_gpu_profiler = nullptr;
+        p_instanced_vertex_array = nullptr;
+        p_mesh_pool = nullptr;
+        quad_mesh = {};
+        p_scene_mesh = nullptr;
+        scene_mesh_residency_id = 0;
+        scene_pool_mesh = {};
+        m_mesh = {};
+        m_assets->release_gpu_resources();
+        m_software_renderer = nullptr;
+        m_software_mesh = nullptr;
+        p_instance_buffer = nullptr;
+        p_quad_index_buffer = nullptr;
+        p_quad_vertex_buffer = nullptr;
+        p_instanced_shader_program = nullptr;
+        p_scene_textures = nullptr;
+        p_atlas_uniform_buffer = nullptr;
+        p_textured_instanced_shader_program = nullptr;
+        p_textured_shader_program = nullptr;
+        instances_capacity = 0;
+        p_render_backend = nullptr;
+        p_batch_renderer = nullptr;
+        p_frame_uniform_buffer = nullptr;
+        p_shader_program = nullptr;
+
+        if (m_framebuffer_id)
+        {
+            glDeleteFramebuffers(1, &m_framebuffer_id);
+            glDeleteRenderbuffers(1, &m_color_renderbuffer_id);
+            glDeleteRenderbuffers(1, &m_depth_renderbuffer_id);
+        }
+
         glfwDestroyWindow(m_window);
+        if (m_state_cache)
+        {
+            StateCache_OpenGL::make_current(nullptr);
+            m_state_cache = nullptr;
+        }
         glfwTerminate();
+        s_GLfW_initialized = false;
     }
 }
\ No newline at end of file
@@ -1,9 +1,20 @@
 #pragma once
 
 #include "EngineCore/Event.hpp"
+#include "EngineCore/ECS/Registry.hpp"
+#include "EngineCore/ECS/TransformSystem.hpp"
+#include "EngineCore/ECS/VisibilitySystem.hpp"
+#include "EngineCore/ECS/LodSystem.hpp"
+#include "EngineCore/Assets/AssetManager.hpp"
+#include "EngineCore/Rendering/RenderBackend.hpp"
 
+#include <glm/mat4x4.hpp>
+
+#include <array>
+#include <span>
 #include <string>
-#include <functional>
+#include <memory>
+#include <vector>
 
 struct GLFWwindow;
 
@@ -12,9 +23,9 @@ namespace GraphicsEngine
     class Window
     {
     public:
-        using EventCallback = std::function<void(Event&)>;
-
-        Window(std::string title, const unsigned int width, const unsigned int height);
+        // The software backend only renders headless windows; others fall back to OpenGL
+        Window(std::string title, const unsigned int width, const unsigned int height, const bool headless = false, const bool multithreaded = true,
+               const ERenderBackend backend = ERenderBackend::OpenGL);
         ~Window();
 
         Window(const Window &) = delete;
@@ -23,25 +34,106 @@ namespace GraphicsEngine
         Window &operator=(Window &&) = delete;
 
         void on_update();
+        // Blocks until the render thread has executed every submitted frame
+        void finish_rendering();
         unsigned int get_width() const { return m_data.width; }
         unsigned int get_height() const { return m_data.height; }
+        bool is_headless() const { return m_headless; }
+        bool is_initialized() const { return m_initialized; }
+        ERenderBackend get_render_backend() const { return m_backend; }
+        // The last frame rendered by the software backend; nullptr with OpenGL
+        const class SoftwareFramebuffer* get_software_framebuffer() const;
+
+        // Streams a baked mesh (see MeshBaker) that replaces the quad for every object once it is
+        // resident; call before the first on_update(). The mesh must use the scene's vertex layout
+        bool load_mesh(const std::string& path);
+        AssetManager& get_assets() { return *m_assets; }
+        // Objects sample generated patterns from a texture atlas; call before the first on_update()
+        void set_textured(const bool textured) { m_textured = textured; }
+
+        void set_objects_count(const unsigned int objects_count) { m_objects_count = objects_count > 0 ? objects_count : 1; }
+        // Objects are culled, given LODs and drawn through this matrix; the identity draws the grid straight in clip space
+        void set_view_projection(const glm::mat4& view_projection) { m_view_projection = view_projection; }
+        // Results of the last frame's frustum culling
+        size_t get_visible_objects_count() const { return m_visibility.get_visible_count(); }
+        size_t get_culled_objects_count() const { return m_visibility.get_culled_count(); }
 
-        void set_event_callback(const EventCallback& callback){
-            m_data.event_callback = callback;
+        // Per-frame scene work is spread over this job system's threads; nullptr runs it serially
+        void set_job_system(class JobSystem* job_system)
+        {
+            m_job_system = job_system;
+            m_assets->set_job_system(job_system);
+        }
+
+        // Per-frame scene data is allocated from this arena; must be set before on_update()
+        void set_frame_arena(class FrameArena* frame_arena) { m_frame_arena = frame_arena; }
+
+        // Window events are posted to this dispatcher's queue
+        void set_event_dispatcher(EventDispatcher* event_dispatcher){
+            m_data.event_dispatcher = event_dispatcher;
         }
     private:
     struct WindowData{
         std::string title;
         unsigned int width;
         unsigned int height;
-        EventCallback event_callback;
+        EventDispatcher* event_dispatcher = nullptr;
+        unsigned int framebuffer_width = 0;
+        unsigned int framebuffer_height = 0;
+        bool framebuffer_resized = false;
     };
 
     GLFWwindow *m_window = nullptr;
     WindowData m_data;
     float m_background_color[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    bool m_headless = false;
+    ERenderBackend m_backend = ERenderBackend::OpenGL;
+    bool m_initialized = false;
+    unsigned int m_objects_count = 1;
+    unsigned int m_framebuffer_id = 0;
+    unsigned int m_color_renderbuffer_id = 0;
+    unsigned int m_depth_renderbuffer_id = 0;
+    std::unique_ptr<class RenderThread> m_render_thread;
+    // Bindings of the OpenGL context; current wherever the context is
+    std::unique_ptr<class StateCache_OpenGL> m_state_cache;
+    // Software backend: draws on the main thread and the job system, reading the mesh straight from its file
+    std::unique_ptr<class Renderer_Software> m_software_renderer;
+    std::unique_ptr<MeshAsset> m_software_mesh;
+    size_t m_frame_index = 0;
+    class JobSystem* m_job_system = nullptr;
+    class FrameArena* m_frame_arena = nullptr;
+
+    Registry m_registry;
+    TransformSystem m_transforms;
+    // Edited in the settings window; parent of every grid object
+    TransformId m_settings_transform = invalid_transform;
+    // Degrees around the z axis, kept separately so the slider does not round-trip through the quaternion
+    float m_settings_rotation = 0.0f;
+    std::vector<Entity> m_grid_entities;
+    VisibilitySystem m_visibility;
+    LodSystem m_lods;
+    std::unique_ptr<AssetManager> m_assets = std::make_unique<AssetManager>();
+    AssetHandle m_mesh;
+    // Local bounds of the mesh every object draws; the default is the built-in quad's
+    AABB m_mesh_bounds = { glm::vec3(-0.5f, -0.5f, 0.0f), glm::vec3(0.5f, 0.5f, 0.0f) };
+    bool m_mesh_bounds_applied = false;
+    bool m_textured = false;
+    bool m_textures_requested = false;
+    std::vector<TransformId> m_visible_ids;
+    // Visible objects per LOD in the last frame
+    std::array<size_t, LodSystem::max_lods> m_lod_objects_counts = {};
+    glm::mat4 m_view_projection = glm::mat4(1.0f);
 
     int init();
+    GLFWwindow* create_headless_window();
+    bool create_framebuffer();
+    void update_scene();
+    // Picks each visible object's LOD; returns the visible ids grouped by LOD as frame.lod_offsets describes
+    std::span<const TransformId> select_lods(struct SceneFrame& frame);
+    void update_mesh_bounds();
+    void apply_mesh_bounds(const AABB& bounds, const std::vector<MeshLod>& lods);
+    void draw_software(struct SceneFrame& frame);
+    void record_ui(struct SceneFrame& frame);
     void shutdown();
     };
 }
\ No newline at end of file
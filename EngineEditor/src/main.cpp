@@ -1,5 +1,6 @@
 #include <iostream>
 #include <memory>
+#include <string>
 #include <EngineCore/Application.hpp>
 
 class MyApp : public GraphicsEngine::Application {
@@ -12,8 +13,17 @@ class MyApp : public GraphicsEngine::Application {
     int frame = 0;
 };
 
-int main(){
+int main(int argc, char** argv){
     auto myApp = std::make_unique<MyApp>();
+    myApp->set_shader_cache_directory("shader_cache");
+    // --single-threaded executes render commands on the main thread
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::string(argv[i]) == "--single-threaded")
+        {
+            myApp->set_multithreaded_rendering(false);
+        }
+    }
 
     int returnCode = myApp->start(1024, 768, "My app");
     
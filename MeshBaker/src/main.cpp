@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <filesystem>
+#include <string>
+#include <EngineCore/MeshBaker.hpp>
+
+// Usage: MeshBaker [--compact] [--lods N] model.obj [more.obj ...]
+// Each model is baked into a .mesh file next to it, which Application::set_mesh_path loads.
+// --compact quantizes colors and texture coordinates (EBakedVertexFormat::Compact).
+// --lods sets how many levels of detail are stored, the full mesh included (1 disables simplification).
+
+int main(int argc, char** argv){
+    GraphicsEngine::MeshBakeSettings settings;
+    int first_model = 1;
+    for (; first_model < argc && argv[first_model][0] == '-'; ++first_model)
+    {
+        const std::string option = argv[first_model];
+        if (option == "--compact")
+        {
+            settings.vertex_format = GraphicsEngine::EBakedVertexFormat::Compact;
+        }
+        else if (option == "--lods" && first_model + 1 < argc)
+        {
+            settings.lods_count = static_cast<size_t>(std::max(1, std::atoi(argv[++first_model])));
+        }
+        else
+        {
+            first_model = argc;
+        }
+    }
+    if (first_model >= argc)
+    {
+        std::cerr << "Usage: MeshBaker [--compact] [--lods N] model.obj [more.obj ...]" << std::endl;
+        return 1;
+    }
+
+    int failed_count = 0;
+    for (int i = first_model; i < argc; ++i)
+    {
+        const std::filesystem::path source_path = argv[i];
+        const std::filesystem::path output_path = std::filesystem::path(source_path).replace_extension(".mesh");
+
+        GraphicsEngine::MeshBakeStats stats;
+        if (!GraphicsEngine::bake_obj_mesh(source_path.string(), output_path.string(), &stats, settings))
+        {
+            ++failed_count;
+            continue;
+        }
+        std::cout << source_path.string() << " -> " << output_path.string() << ": " << stats.source_faces << " faces, "
+                  << stats.vertices << " vertices of " << stats.vertex_stride << " bytes, " << stats.indices << " " << stats.index_size * 8 << "-bit indices, ACMR "
+                  << stats.acmr_before << " -> " << stats.acmr_after << std::endl;
+        for (size_t lod = 0; lod < stats.lods.size(); ++lod)
+        {
+            std::cout << "  LOD " << lod << ": " << stats.lods[lod].triangles << " triangles, error " << stats.lods[lod].error << std::endl;
+        }
+    }
+
+    return failed_count == 0 ? 0 : 1;
+}